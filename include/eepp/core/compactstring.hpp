@@ -0,0 +1,202 @@
+#ifndef EE_COMPACTSTRING_HPP
+#define EE_COMPACTSTRING_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/string.hpp>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EE {
+
+/** @brief A memory compact alternative to String.
+ * The characters are stored as Latin-1 (one byte per character) when all of them fit in it, and
+ * as UTF-8 otherwise. Short strings are kept inline by the small string optimization of the
+ * underlying std::string. Indexing is O(1) for Latin-1 content (including all the ASCII
+ * content) and for UTF-8 content it only decodes from the closest index checkpoint, so the cost
+ * is bounded by IndexStep. All the positions and lengths are expressed in characters
+ * (codepoints), not bytes. */
+class EE_API CompactString {
+  public:
+	typedef String::StringBaseType CharType;
+
+	enum class Encoding : Uint8 {
+		Latin1, ///< One byte per character, every character is lower than 0x100
+		Utf8	///< UTF-8 encoded characters
+	};
+
+	/** Number of characters between two UTF-8 index checkpoints */
+	static constexpr std::size_t IndexStep = 16;
+
+	static const std::size_t InvalidPos;
+
+	/** @brief A non owning view of a CompactString or of a part of it.
+	 * It's as cheap to copy as a String::View and it's invalidated when the viewed string is
+	 * modified or destroyed. */
+	class EE_API View {
+	  public:
+		View() = default;
+
+		View( const CompactString& string );
+
+		/** @return The number of characters */
+		std::size_t size() const { return mLength; }
+
+		/** @return The number of characters */
+		std::size_t length() const { return mLength; }
+
+		bool empty() const { return 0 == mLength; }
+
+		/** @return The character at pos. pos must be lower than size() */
+		CharType operator[]( std::size_t pos ) const {
+			return Encoding::Latin1 == mEncoding
+					   ? static_cast<unsigned char>( mData[mStart + pos] )
+					   : utf8At( mData, mIndex, mStart + pos );
+		}
+
+		/** @return The character at pos. Throws std::out_of_range if pos is not lower than
+		 * size() */
+		CharType at( std::size_t pos ) const;
+
+		CharType front() const { return ( *this )[0]; }
+
+		CharType back() const { return ( *this )[mLength - 1]; }
+
+		/** @return A view of count characters starting at pos */
+		View substr( std::size_t pos, std::size_t count = InvalidPos ) const;
+
+		Encoding getEncoding() const { return mEncoding; }
+
+		/** @return True if the viewed string is only ASCII */
+		bool isAscii() const { return mAscii; }
+
+		/** @return The stored bytes of the viewed characters, in the view encoding */
+		std::string_view getBytes() const;
+
+		std::string toUtf8() const;
+
+		String toString() const;
+
+		bool operator==( const View& other ) const;
+
+		bool operator!=( const View& other ) const { return !( *this == other ); }
+
+	  protected:
+		friend class CompactString;
+
+		const char* mData{ nullptr };
+		const Uint32* mIndex{ nullptr };
+		Uint32 mStart{ 0 };
+		Uint32 mLength{ 0 };
+		Encoding mEncoding{ Encoding::Latin1 };
+		bool mAscii{ true };
+	};
+
+	static CompactString fromUtf8( const std::string_view& utf8String );
+
+	static CompactString fromLatin1( const std::string_view& latin1String );
+
+	CompactString() = default;
+
+	/** Creates the string from a UTF-8 encoded string */
+	CompactString( const char* utf8String );
+
+	/** Creates the string from a UTF-8 encoded string */
+	CompactString( const std::string& utf8String );
+
+	CompactString( const String& string );
+
+	CompactString( const String::View& string );
+
+	CompactString( const View& view );
+
+	CompactString( const CompactString& other );
+
+	/** The moved string is left empty */
+	CompactString( CompactString&& other ) noexcept;
+
+	CompactString& operator=( const CompactString& other );
+
+	/** The moved string is left empty */
+	CompactString& operator=( CompactString&& other ) noexcept;
+
+	/** @return The number of characters */
+	std::size_t size() const { return mLength; }
+
+	/** @return The number of characters */
+	std::size_t length() const { return mLength; }
+
+	bool empty() const { return 0 == mLength; }
+
+	/** @return The character at pos. pos must be lower than size() */
+	CharType operator[]( std::size_t pos ) const {
+		return Encoding::Latin1 == mEncoding ? static_cast<unsigned char>( mData[pos] )
+											 : utf8At( mData.data(), mIndex->data(), pos );
+	}
+
+	/** @return The character at pos. Throws std::out_of_range if pos is not lower than size() */
+	CharType at( std::size_t pos ) const;
+
+	View view() const { return View( *this ); }
+
+	/** @return A view of count characters starting at pos */
+	View substr( std::size_t pos, std::size_t count = InvalidPos ) const;
+
+	Encoding getEncoding() const { return mEncoding; }
+
+	/** @return True if all the characters are ASCII. ASCII strings are valid UTF-8 and Latin-1
+	 * strings at the same time, so they are converted without any decoding */
+	bool isAscii() const { return mAscii; }
+
+	/** @return The stored bytes, in the string encoding */
+	const std::string& getBytes() const { return mData; }
+
+	std::string toUtf8() const;
+
+	String toString() const;
+
+	void clear();
+
+	void reserve( std::size_t bytes );
+
+	void push_back( CharType codepoint );
+
+	CompactString& append( const View& view );
+
+	CompactString& operator+=( const View& view ) { return append( view ); }
+
+	CompactString& operator+=( CharType codepoint );
+
+	String::HashType getHash() const;
+
+	/** @return The bytes used by the string, including its heap allocations */
+	std::size_t getMemoryUsage() const;
+
+	bool operator==( const CompactString& other ) const;
+
+	bool operator!=( const CompactString& other ) const { return !( *this == other ); }
+
+  protected:
+	std::string mData;
+	/** Byte offset of every IndexStep-th character, only used by UTF-8 strings */
+	std::unique_ptr<std::vector<Uint32>> mIndex;
+	Uint32 mLength{ 0 };
+	Encoding mEncoding{ Encoding::Latin1 };
+	bool mAscii{ true };
+
+	static CharType utf8At( const char* data, const Uint32* index, std::size_t pos );
+
+	static std::size_t utf8Offset( const char* data, const Uint32* index, std::size_t pos );
+
+	void assign( const CharType* begin, const CharType* end );
+
+	void promoteToUtf8();
+
+	void appendUtf8( CharType codepoint );
+};
+
+} // namespace EE
+
+#endif
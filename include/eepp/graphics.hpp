@@ -8,6 +8,7 @@
 #include <eepp/graphics/convexshapedrawable.hpp>
 #include <eepp/graphics/drawablegroup.hpp>
 #include <eepp/graphics/drawablesearcher.hpp>
+#include <eepp/graphics/drawcommandlist.hpp>
 #include <eepp/graphics/font.hpp>
 #include <eepp/graphics/fontbmfont.hpp>
 #include <eepp/graphics/fontfamily.hpp>
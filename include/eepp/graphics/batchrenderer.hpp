@@ -3,6 +3,7 @@
 
 #include <eepp/graphics/base.hpp>
 #include <eepp/graphics/blendmode.hpp>
+#include <eepp/graphics/drawcommandlist.hpp>
 #include <eepp/graphics/primitivetype.hpp>
 #include <eepp/math/originpoint.hpp>
 #include <eepp/math/polygon2.hpp>
@@ -14,15 +15,8 @@ using namespace EE::System;
 
 namespace EE { namespace Graphics {
 
-/// Holds the position texture UV and color of a vertex.
-struct VertexData {
-	Vector2f pos;
-	Vector2f tex;
-	Color color;
-};
-
 /** @brief A batch rendering class. */
-class EE_API BatchRenderer {
+class EE_API BatchRenderer : protected DrawCommandList::Backend {
   public:
 	static BatchRenderer* New();
 
@@ -52,6 +46,39 @@ class EE_API BatchRenderer {
 	/** Get if the rendering is force on every batch call */
 	bool getBatchForceRendering() const { return mForceRendering; }
 
+	/** Enables the deferred mode. In deferred mode the texture, blend mode and primitive changes
+	 * don't render the batched vertexs, they are recorded as draw commands and rendered on the
+	 * next draw call, where the commands with the same state are merged when the painter's order
+	 * allows it. Any change of the GL state not made through the batch renderer (clipping,
+	 * shaders, matrices, frame buffers) must call draw() first, as it's already done by the
+	 * engine for the global batch renderer. */
+	void setDeferred( const bool& deferred );
+
+	/** @return True if the deferred mode is enabled */
+	bool isDeferred() const { return mDeferred; }
+
+	/** Starts copying every batch rendered and every scissor clip change into the capture list.
+	 * The pending vertexs are rendered before. NULL stops the capture.
+	 * The capture is invalidated if something that the list can't represent is rendered during
+	 * the capture, see DrawCommandList::isValid. */
+	void setCapture( DrawCommandList* capture );
+
+	/** @return The current capture list */
+	DrawCommandList* getCapture() const { return mCapture; }
+
+	/** @return The number of draw calls issued by the batch renderer since it was created */
+	const Uint64& getDrawCallsCount() const { return mDrawCallsCount; }
+
+	/** Renders a draw command list as it was recorded, translated by offset.
+	 * @return False if the list can't be rendered anymore (it uses a destroyed texture). */
+	bool play( DrawCommandList& list, const Vector2f& offset = Vector2f::Zero );
+
+	/** Renders the vertexs immediately with the texture, blend mode and primitive passed (the
+	 * batched vertexs are rendered first). Lets already built geometry be rendered through the
+	 * batch renderer, so it's recorded by the capture. */
+	void drawVertexs( const Texture* texture, const BlendMode& blend, const PrimitiveType& mode,
+					  const VertexData* vertices, const Uint32& count );
+
 	/** Force the batch rendering */
 	void draw();
 
@@ -328,9 +355,25 @@ class EE_API BatchRenderer {
 
 	bool mForceRendering{ false };
 	bool mForceBlendMode{ true };
+	bool mDeferred{ false };
+
+	DrawCommandList mDrawCommands;
+	DrawCommandList* mCapture{ nullptr };
+	Uint64 mDrawCallsCount{ 0 };
 
 	void flush();
 
+	DrawCommandState getDrawCommandState() const;
+
+	Float getPrimitiveSize( const Texture* texture, const PrimitiveType& mode ) const;
+
+	void drawCommand( const DrawCommandState& state, const VertexData* vertices,
+					  const Uint32& count ) override;
+
+	void clipEnable( const Rectf& rect ) override;
+
+	void clipDisable() override;
+
 	void init();
 
 	void addVertexs( const unsigned int& num );
@@ -0,0 +1,184 @@
+#ifndef EE_GRAPHICS_DRAWCOMMANDLIST_HPP
+#define EE_GRAPHICS_DRAWCOMMANDLIST_HPP
+
+#include <eepp/graphics/base.hpp>
+#include <eepp/graphics/blendmode.hpp>
+#include <eepp/graphics/primitivetype.hpp>
+#include <eepp/graphics/texture.hpp>
+#include <eepp/system/color.hpp>
+#include <vector>
+
+using namespace EE::System;
+
+namespace EE { namespace Graphics {
+
+/// Holds the position texture UV and color of a vertex.
+struct VertexData {
+	Vector2f pos;
+	Vector2f tex;
+	Color color;
+};
+
+/** @brief The render state needed to draw a run of batched vertices. */
+struct EE_API DrawCommandState {
+	const Texture* texture{ nullptr };
+	Texture::CoordinateType coordinateType{ Texture::CoordinateType::Normalized };
+	BlendMode blend{ BlendMode::Alpha() };
+	PrimitiveType mode{ PRIMITIVE_QUADS };
+	Float rotation{ 0.f };
+	Vector2f scale{ 1.f, 1.f };
+	Vector2f position{ 0.f, 0.f };
+	Vector2f center{ 0.f, 0.f };
+	bool lineSmooth{ false };
+	bool polygonSmooth{ false };
+	/** The line width or point size of line and point primitives. It's only used to compute
+	 * the area covered by the vertices, the replay doesn't change it. */
+	Float primitiveSize{ 1.f };
+
+	/** @return True if the vertices are transformed before being drawn */
+	bool hasTransform() const;
+
+	bool operator==( const DrawCommandState& other ) const;
+
+	bool operator!=( const DrawCommandState& other ) const { return !( *this == other ); }
+};
+
+/** @brief Records draw commands and replays them with the minimum number of draw calls.
+ * Commands are replayed in painter's order, except that a command can be moved back and merged
+ * into an earlier command with the same state when it doesn't overlap any command drawn in
+ * between. Only primitives that can be concatenated (quads, triangles, lines and points) are
+ * merged, strips, loops, fans and polygons are kept as they were recorded.
+ * Scissor clip changes can be recorded too, commands are never moved across them (every clip
+ * change starts a new clip scope). The list doesn't know anything about any other GL state
+ * (shaders, matrices, stencil), it must be replayed every time any of them changes.
+ * The list can also be played as recorded, without reordering, and translated (this is used to
+ * cache the rendering of a node).
+ */
+class EE_API DrawCommandList {
+  public:
+	/** @brief The target of a replay. */
+	class EE_API Backend {
+	  public:
+		virtual ~Backend() {}
+
+		/** Draws count contiguous vertices with the state. */
+		virtual void drawCommand( const DrawCommandState& state, const VertexData* vertices,
+								  const Uint32& count ) = 0;
+
+		/** Pushes a scissor clip rectangle (in screen coordinates). */
+		virtual void clipEnable( const Rectf& rect ) = 0;
+
+		/** Pops the last scissor clip rectangle. */
+		virtual void clipDisable() = 0;
+	};
+
+	/** @brief A backend that doesn't draw, only counts the draw calls and the state changes
+	 * that a replay would have issued. Useful to measure the batching without a GL context. */
+	class EE_API Recorder : public Backend {
+	  public:
+		void drawCommand( const DrawCommandState& state, const VertexData* vertices,
+						  const Uint32& count ) override;
+
+		void clipEnable( const Rectf& rect ) override;
+
+		void clipDisable() override;
+
+		void reset();
+
+		Uint32 getDrawCalls() const { return mDrawCalls; }
+
+		Uint32 getTextureChanges() const { return mTextureChanges; }
+
+		Uint32 getBlendChanges() const { return mBlendChanges; }
+
+		Uint32 getModeChanges() const { return mModeChanges; }
+
+		Uint32 getVertexCount() const { return mVertexCount; }
+
+		Uint32 getClipChanges() const { return mClipChanges; }
+
+		/** @return The states of the draw calls in the order they were issued */
+		const std::vector<DrawCommandState>& getStates() const { return mStates; }
+
+	  protected:
+		std::vector<DrawCommandState> mStates;
+		Uint32 mDrawCalls{ 0 };
+		Uint32 mTextureChanges{ 0 };
+		Uint32 mBlendChanges{ 0 };
+		Uint32 mModeChanges{ 0 };
+		Uint32 mVertexCount{ 0 };
+		Uint32 mClipChanges{ 0 };
+	};
+
+	/** Maximum number of recorded draw runs that a command can be moved back over. */
+	static constexpr size_t LookBehind = 64;
+
+	/** Records a command, the vertices are copied. */
+	void add( const DrawCommandState& state, const VertexData* vertices, const Uint32& count );
+
+	/** Records a scissor clip push. */
+	void addClipEnable( const Rectf& rect );
+
+	/** Records a scissor clip pop. */
+	void addClipDisable();
+
+	/** Appends all the commands of another list. */
+	void append( const DrawCommandList& other );
+
+	/** Replays the recorded commands into the backend, merging them when possible, and clears
+	 * the list. */
+	void replay( Backend& backend );
+
+	/** Plays the recorded commands into the backend as they were recorded, translated by offset.
+	 * The list is kept.
+	 * @return False (and nothing is played) if any of the textures used was destroyed. */
+	bool play( Backend& backend, const Vector2f& offset = Vector2f::Zero );
+
+	/** Clears the list, it also becomes valid again. */
+	void clear();
+
+	/** Flags the list as not representing what was rendered, used when something that can't be
+	 * recorded was rendered while recording. */
+	void invalidate() { mValid = false; }
+
+	/** @return False if something that couldn't be recorded was rendered while recording */
+	bool isValid() const { return mValid; }
+
+	bool empty() const { return mCommands.empty(); }
+
+	/** @return The number of recorded commands */
+	size_t getCommandsCount() const { return mCommands.size(); }
+
+  protected:
+	enum class CommandType : Uint8 { Draw, ClipEnable, ClipDisable };
+
+	struct Command {
+		CommandType type;
+		DrawCommandState state;
+		Uint32 textureId;
+		Uint32 first;
+		Uint32 count;
+		Rectf bounds; // The clip rectangle for ClipEnable
+		Int32 next;	  // Next command merged into the same run
+	};
+
+	struct Run {
+		Uint32 head;
+		Uint32 tail;
+		Uint32 count;
+		Rectf bounds;
+		bool mergeable;
+	};
+
+	std::vector<VertexData> mVertices;
+	std::vector<Command> mCommands;
+	std::vector<Run> mRuns;
+	std::vector<VertexData> mScratch;
+	bool mValid{ true };
+
+	void replayScope( Backend& backend, Uint32 begin, Uint32 end );
+};
+
+}} // namespace EE::Graphics
+
+#endif
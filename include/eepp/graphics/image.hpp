@@ -307,6 +307,12 @@ class EE_API Image {
 	/** Flip the image ( rotate the image 90º ) */
 	virtual void flip();
 
+	/** Flip the image rows ( upside down ) */
+	void flipVertical();
+
+	/** Multiplies the color of each pixel by its alpha ( only RGBA images ) */
+	void premultiplyAlpha();
+
 	/** Create a thumnail of the image */
 	Graphics::Image* thumbnail( const Uint32& maxWidth, const Uint32& maxHeight,
 								ResamplerFilter filter = ResamplerFilter::RESAMPLER_LANCZOS4 );
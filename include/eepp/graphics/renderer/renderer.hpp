@@ -88,9 +88,13 @@ class EE_API Renderer {
 
 	const char* getString( unsigned int name );
 
-	void drawArrays( unsigned int mode, int first, int count );
+	virtual void drawArrays( unsigned int mode, int first, int count );
 
-	void drawElements( unsigned int mode, int count, unsigned int type, const void* indices );
+	virtual void drawElements( unsigned int mode, int count, unsigned int type,
+							   const void* indices );
+
+	/** @return The number of draw calls issued since the renderer was created */
+	const Uint64& getDrawCallsCount() const;
 
 	void bindTexture( unsigned int target, unsigned int texture );
 
@@ -112,6 +116,8 @@ class EE_API Renderer {
 
 	void lineWidth( float width );
 
+	float lineWidth() const;
+
 	/** Reapply the line smooth state */
 	void lineSmooth();
 
@@ -245,6 +251,14 @@ class EE_API Renderer {
 
 	const int& quadVertexs() const;
 
+	/** @return True if quads of four vertices can be drawn with drawQuadsIndexed even when
+	 * GL_QUADS is not supported. */
+	const bool& quadsIndexedSupported() const;
+
+	/** Draws the quads (four vertices each) of the current arrays, starting at vertex first
+	 * (must be a multiple of four). */
+	virtual void drawQuadsIndexed( int first, int count );
+
 	ClippingMask* getClippingMask() const;
 
 	void genFramebuffers( int n, unsigned int* framebuffers );
@@ -292,9 +306,11 @@ class EE_API Renderer {
 	Uint32 mExtensions;
 	Uint32 mStateFlags;
 	bool mQuadsSupported;
+	bool mQuadsIndexedSupported;
 	int mQuadVertexs;
 	float mLineWidth;
 	unsigned int mCurVAO;
+	Uint64 mDrawCallsCount;
 
 	ClippingMask* mClippingMask;
 
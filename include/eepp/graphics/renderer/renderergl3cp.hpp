@@ -72,7 +72,6 @@ class EE_API RendererGL3CP : public RendererGLShader {
   protected:
 	ShaderProgram* mShaders[EEGL3CP_SHADERS_COUNT];
 	unsigned int mVAO;
-	unsigned int mVBO[8];
 	int mAttribsLoc[EEGL_ARRAY_STATES_COUNT];
 	int mAttribsLocStates[EEGL_ARRAY_STATES_COUNT];
 	int mPlanes[EE_MAX_PLANES];
@@ -85,8 +84,6 @@ class EE_API RendererGL3CP : public RendererGLShader {
 	int mTextureUnits[EE_MAX_TEXTURE_UNITS];
 	int mTextureUnitsStates[EE_MAX_TEXTURE_UNITS];
 	int mCurActiveTex;
-	unsigned int mCurTexCoordArray;
-	Uint32 mVBOSizeAlloc;
 	Uint32 mBiggestAlloc;
 	bool mLoaded;
 	std::string mBaseVertexShader;
@@ -94,8 +91,6 @@ class EE_API RendererGL3CP : public RendererGLShader {
 	void planeStateCheck( bool tryEnable );
 
 	void reloadShader( ShaderProgram* Shader );
-
-	void allocateBuffers( const Uint32& size );
 };
 
 }} // namespace EE::Graphics
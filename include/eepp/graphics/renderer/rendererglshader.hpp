@@ -54,6 +54,12 @@ class EE_API RendererGLShader : public Renderer {
 				   const float projMatrix[16], const int viewport[4], float* objx, float* objy,
 				   float* objz );
 
+	void drawArrays( unsigned int mode, int first, int count );
+
+	void drawElements( unsigned int mode, int count, unsigned int type, const void* indices );
+
+	void drawQuadsIndexed( int first, int count );
+
   protected:
 	Private::MatrixStack* mStack;
 	int mProjectionMatrix_id; // cpu-side hook to shader uniform
@@ -62,8 +68,29 @@ class EE_API RendererGLShader : public Renderer {
 	unsigned int mCurrentMode;
 	ShaderProgram* mCurShader;
 	ShaderProgram* mShaderPrev;
+	unsigned int mStreamVBO;
+	unsigned int mStreamSize;
+	unsigned int mStreamOffset;
+	const char* mStreamPointer;
+	int mStreamStride;
+	unsigned int mStreamAllocate;
+	unsigned int mStreamPointerOffset;
+	Uint32 mStreamAttributes;
+	bool mStreamMapBufferRange;
+	unsigned int mQuadsIBO;
+	unsigned int mQuadsIBOCount;
 
 	void updateMatrix();
+
+	void initStreamBuffers();
+
+	void releaseStreamBuffers();
+
+	/** Copies the client array into the streaming vertex buffer (leaving it bound) and returns
+	 * the buffer offset of the pointer. The attributes of an interleaved array, set one after
+	 * the other until the next draw call, share a single copy. */
+	unsigned int streamVertexData( Uint32 attribute, const void* pointer, int stride,
+								   unsigned int allocate );
 };
 
 }} // namespace EE::Graphics
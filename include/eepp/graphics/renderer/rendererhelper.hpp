@@ -31,7 +31,8 @@ enum GraphicsLibraryExtension {
 	EEGL_IMG_texture_compression_pvrtc,
 	EEGL_OES_compressed_ETC1_RGB8_texture,
 	EEGL_EXT_blend_minmax,
-	EEGL_EXT_blend_subtract
+	EEGL_EXT_blend_subtract,
+	EEGL_ARB_map_buffer_range
 };
 
 /// Graphics Library Renderer version available.
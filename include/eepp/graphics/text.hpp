@@ -1,6 +1,7 @@
 #ifndef EE_GRAPHICS_TEXT_HPP
 #define EE_GRAPHICS_TEXT_HPP
 
+#include <eepp/core/compactstring.hpp>
 #include <eepp/graphics/font.hpp>
 #include <eepp/graphics/fontstyleconfig.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
@@ -57,6 +58,22 @@ class EE_API Text {
 	static Sizef draw( const String::View& string, const Vector2f& pos,
 					   const FontStyleConfig& config, const Uint32& tabWidth = 4 );
 
+	static Float getTextWidth( Font* font, const Uint32& fontSize,
+							   const CompactString::View& string, const Uint32& style,
+							   const Uint32& tabWidth = 4, const Float& outlineThickness = 0.f );
+
+	static Float getTextWidth( const CompactString::View& string, const FontStyleConfig& config,
+							   const Uint32& tabWidth = 4 );
+
+	static Sizef draw( const CompactString::View& string, const Vector2f& pos, Font* font,
+					   Float fontSize, const Color& fontColor, Uint32 style = 0,
+					   Float outlineThickness = 0.f, const Color& outlineColor = Color::Black,
+					   const Color& shadowColor = Color::Black,
+					   const Vector2f& shadowOffset = { 1, 1 }, const Uint32& tabWidth = 4 );
+
+	static Sizef draw( const CompactString::View& string, const Vector2f& pos,
+					   const FontStyleConfig& config, const Uint32& tabWidth = 4 );
+
 	static void drawUnderline( const Vector2f& pos, Float width, Font* font, Float fontSize,
 							   const Color& fontColor, const Uint32& style, Float outlineThickness,
 							   const Color& outlineColor, const Color& shadowColor,
@@ -300,6 +317,11 @@ class EE_API Text {
 			   const std::vector<Color>& colors, const std::vector<Color>& outlineColors,
 			   const Color& backgroundColor );
 
+	/** Draws the text through the global batch renderer (used while it's capturing) */
+	void drawBatched( const Float& X, const Float& Y, const BlendMode& effect,
+					  const std::vector<Color>& colors, const std::vector<Color>& outlineColors,
+					  const Color& backgroundColor );
+
 	void onNewString();
 
 	template <typename StringType>
@@ -5,6 +5,7 @@
 #include <eepp/graphics/packerhelper.hpp>
 #include <eepp/graphics/texturefactory.hpp>
 #include <eepp/graphics/textureloader.hpp>
+#include <eepp/graphics/texturepacker.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/resourceloader.hpp>
 
@@ -112,6 +113,14 @@ class EE_API TextureAtlasLoader {
 	 */
 	void loadFromPack( Pack* Pack, const std::string& FilePackPath );
 
+	/** Creates the textures already decoded by a threaded loader. Unless the shared GL context is
+	 * enabled ( then the textures are created in the loader threads ), it must be called every
+	 * frame from the thread that owns the GL context while the texture atlas is loading, the
+	 * texture atlas is not loaded until all its textures were created.
+	 * @param budget The maximum time to spend creating textures
+	 * @return True if the texture atlas is loaded. */
+	bool update( const Time& budget = Milliseconds( 4 ) );
+
 	/** @return If the loader is threaded ( asynchronous ). */
 	bool isThreaded() const;
 
@@ -133,9 +142,12 @@ class EE_API TextureAtlasLoader {
 	 * @param ImagesPath The directory where the source images are located.
 	 * @param maxImageSize Maximum texture size allowed for the new texture atlas created. Default
 	 * value will use the current image size.
+	 * @param packingMethod The algorithm used to place the images if the atlas is recreated.
 	 */
 	bool updateTextureAtlas( std::string TextureAtlasPath, std::string ImagesPath,
-							 Sizei maxImageSize = Sizei::Zero );
+							 Sizei maxImageSize = Sizei::Zero,
+							 const TexturePacker::PackingMethod& packingMethod =
+								 TexturePacker::PackingMethod::FreeList );
 
 	/** Rewrites the texture atlas file. Usefull if the TextureRegions where modified and need to be
 	 * updated inside the texture atlas. */
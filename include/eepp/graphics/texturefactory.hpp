@@ -5,6 +5,7 @@
 #include <eepp/graphics/texture.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/pack.hpp>
+#include <eepp/system/resourceloader.hpp>
 #include <eepp/system/singleton.hpp>
 using namespace EE::System;
 
@@ -126,6 +127,50 @@ class EE_API TextureFactory : protected Mutex {
 		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
 		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
 
+	/** Queues a texture from a pack file to be loaded by a resource loader. The image is decoded
+	 * in the loader thread pool and the texture is created in the thread that calls
+	 * ResourceLoader::update() ( or right after decoding it if the loader is not threaded ). If
+	 * the shared GL context is enabled the texture is created in the loader thread pool instead,
+	 * and ResourceLoader::update() is not needed.
+	 * @param loader The resource loader that will load the texture
+	 * @param Pack Pointer to the pack instance
+	 * @param FilePackPath The path of the file inside the pack
+	 * @param Mipmap Create Mipmap?
+	 * @param ClampMode Defines the CLAMP MODE
+	 * @param CompressTexture If use the DXT compression on the texture loading ( if the card can
+	 * display them, will convert RGB to DXT1, RGBA to DXT5 )
+	 * @param KeepLocalCopy Keep the array data copy. ( useful if want to reload the texture )
+	 * @param imageformatConfiguration The specific image format configuration to use when decoding
+	 * the image.
+	 */
+	void loadFromPack(
+		ResourceLoader& loader, Pack* Pack, const std::string& FilePackPath,
+		const bool& Mipmap = false,
+		const Texture::ClampMode& ClampMode = Texture::ClampMode::ClampToEdge,
+		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
+		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
+
+	/** Queues a texture from a file path to be loaded by a resource loader. The image is decoded
+	 * in the loader thread pool and the texture is created in the thread that calls
+	 * ResourceLoader::update() ( or right after decoding it if the loader is not threaded ). If
+	 * the shared GL context is enabled the texture is created in the loader thread pool instead,
+	 * and ResourceLoader::update() is not needed.
+	 * @param loader The resource loader that will load the texture
+	 * @param Filepath The path for the texture
+	 * @param Mipmap Use mipmaps?
+	 * @param ClampMode Defines the CLAMP MODE
+	 * @param CompressTexture If use the DXT compression on the texture loading ( if the card can
+	 * display them, will convert RGB to DXT1, RGBA to DXT5 )
+	 * @param KeepLocalCopy Keep the array data copy. ( useful if want to reload the texture )
+	 * @param imageformatConfiguration The specific image format configuration to use when decoding
+	 * the image.
+	 */
+	void loadFromFile(
+		ResourceLoader& loader, const std::string& Filepath, const bool& Mipmap = false,
+		const Texture::ClampMode& ClampMode = Texture::ClampMode::ClampToEdge,
+		const bool& CompressTexture = false, const bool& KeepLocalCopy = false,
+		const Image::FormatConfiguration& imageformatConfiguration = Image::FormatConfiguration() );
+
 	/** Removes and Unload the Texture Id
 	 * @param TexId
 	 * @return True if was removed
@@ -11,7 +11,10 @@ using namespace EE::System;
 
 namespace EE { namespace Graphics {
 
-/** @brief The Texture loader loads a texture in synchronous or asynchronous mode. */
+/** @brief The Texture loader loads a texture in synchronous or asynchronous mode.
+ * The loading has two stages: decode() reads and decodes the image into memory and doesn't need
+ * a GL context, so it can run in any thread, and upload() creates the GL texture from the decoded
+ * image in the thread that owns the GL context. load() runs both. */
 class EE_API TextureLoader {
   public:
 	typedef std::function<void( Uint32, Texture* )> OnTextureLoaded;
@@ -117,6 +120,21 @@ class EE_API TextureLoader {
 	/** Starts loading the texture */
 	void load();
 
+	/** Decodes the image into memory ( the first loading stage ). It can be called from any
+	 * thread. */
+	void decode();
+
+	/** Creates the texture from the decoded image ( the second loading stage ), decoding it first
+	 * if it wasn't. It must be called from the thread that owns the GL context, or from a thread
+	 * with a shared GL context. */
+	void upload();
+
+	/** @return True if the image was decoded */
+	bool isDecoded() const;
+
+	/** @return True if the texture loading finished ( successfully or not ) */
+	bool isLoaded() const;
+
   protected:
 	Uint32 mLoadType{ 0 };	   // From memory, from path, from pack
 	Uint8* mPixels{ nullptr }; // Texture Info
@@ -46,6 +46,13 @@ using namespace Private;
  */
 class EE_API TexturePacker {
   public:
+	/** The algorithm used to place the images inside the texture atlas. */
+	enum class PackingMethod {
+		FreeList, //! The free nodes list packer, fast but not very dense
+		MaxRects, //! MaxRects, tries several heuristics in parallel and keeps the densest result
+		Skyline	  //! Skyline, faster than MaxRects but usually less dense
+	};
+
 	static TexturePacker* New();
 
 	/** Creates a new instance of the texture packer indicating the maximum size of the texture
@@ -170,6 +177,13 @@ class EE_API TexturePacker {
 					 const Texture::Filter& textureFilter = Texture::Filter::Linear,
 					 const bool& allowChilds = false, const bool& allowFlipping = false );
 
+	/** Sets the algorithm used to place the images, it must be set before packing the textures.
+	 * MaxRects and Skyline rotate the images only if flipping is allowed. */
+	void setPackingMethod( const PackingMethod& method );
+
+	/** @return The algorithm used to place the images */
+	const PackingMethod& getPackingMethod() const;
+
 	/** @return The texture atlas to generate width. */
 	const Int32& getWidth() const;
 
@@ -206,6 +220,7 @@ class EE_API TexturePacker {
 	bool mKeepExtensions;
 	bool mScalableSVG;
 	Image::SaveType mFormat;
+	PackingMethod mPackingMethod{ PackingMethod::FreeList };
 
 	TexturePacker* getChild() const;
 
@@ -250,6 +265,10 @@ class EE_API TexturePacker {
 
 	void reset();
 
+	Int32 packRects();
+
+	Int32 packFinished();
+
 	Uint32 getAtlasNumChannels();
 };
 
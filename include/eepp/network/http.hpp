@@ -12,6 +12,7 @@
 #include <eepp/system/threadlocalptr.hpp>
 #include <eepp/system/threadpool.hpp>
 #include <eepp/system/time.hpp>
+#include <deque>
 #include <map>
 #include <string>
 
@@ -450,6 +451,7 @@ class EE_API Http : NonCopyable {
 	**  application, or use a timeout to limit the time to wait. A value
 	**  of Time::Zero means that the client will use the system defaut timeout
 	**  (which is usually pretty long).
+	**  The content is written to the file in large blocks aligned to the file offsets.
 	**  @param request Request to send
 	**  @param writePath The path of the file to write the downloaded content
 	**  @param timeout Maximum time to wait
@@ -457,28 +459,56 @@ class EE_API Http : NonCopyable {
 	Response downloadRequest( const Request& request, std::string writePath,
 							  Time timeout = Time::Zero );
 
+	/** Definition of the body consumer. It receives the response body as it arrives, already
+	 * decoded ( chunked transfer encoding ) and inflated ( gzip and deflate content encodings ).
+	 * The data is only valid during the call.
+	 * @return True to keep receiving the body, false cancels the request. */
+	typedef std::function<bool( const char* data, std::size_t size )> BodyConsumer;
+
+	/** @brief Send a HTTP request and hands the server's response body to a consumer as it
+	**  arrives.
+	**  The body is never stored: it's received, decoded and inflated on fixed size buffers, so
+	**  the memory used doesn't depend on the body size. The consumer is called from the thread
+	**  that reads the socket, and the socket is not read again until it returns, so a slow
+	**  consumer slows down the server ( backpressure ) instead of accumulating data.
+	**  @param request Request to send
+	**  @param consumer The body consumer
+	**  @param timeout Maximum time to wait
+	**  @return Server's response, without body */
+	Response streamRequest( const Request& request, const BodyConsumer& consumer,
+							Time timeout = Time::Zero );
+
 	/** Definition of the async callback response */
 	typedef std::function<void( const Http&, Http::Request&, Http::Response& )>
 		AsyncResponseCallback;
 
-	/** @brief Sends the request and creates a new thread, when got the response informs the result
-	 *to the callback. *	This function does not lock the caller thread.
+	/** @brief Queues the request to be sent from the HTTP I/O threads, when got the response
+	 *informs the result to the callback. *	This function does not lock the caller thread.
+	 **  The async requests to the same host share a queue that is consumed by up to
+	 **  getMaxAsyncConnections() keep-alive connections.
 	 **  @see sendRequest */
 	void sendAsyncRequest( const AsyncResponseCallback& cb, const Http::Request& request,
 						   Time timeout = Time::Zero );
 
-	/** @brief Sends the request and creates a new thread, when got the response informs the result
-	 *to the callback. *	This function does not lock the caller thread.
+	/** @brief Queues the request to be sent from the HTTP I/O threads, when got the response
+	 *informs the result to the callback. *	This function does not lock the caller thread.
 	 **  @see downloadRequest */
 	void downloadAsyncRequest( const AsyncResponseCallback& cb, const Http::Request& request,
 							   IOStream& writeTo, Time timeout = Time::Zero );
 
-	/** @brief Sends the request and creates a new thread, when got the response informs the result
-	 *to the callback. *	This function does not lock the caller thread.
+	/** @brief Queues the request to be sent from the HTTP I/O threads, when got the response
+	 *informs the result to the callback. *	This function does not lock the caller thread.
 	 **  @see downloadRequest */
 	void downloadAsyncRequest( const AsyncResponseCallback& cb, const Http::Request& request,
 							   std::string writePath, Time timeout = Time::Zero );
 
+	/** @brief Queues the request to be sent from the HTTP I/O threads. The response body is handed
+	 *to the consumer from the I/O thread as it arrives, and the callback is informed when the
+	 *request ends. This function does not lock the caller thread.
+	 **  @see streamRequest */
+	void streamAsyncRequest( const AsyncResponseCallback& cb, const Http::Request& request,
+							 const BodyConsumer& consumer, Time timeout = Time::Zero );
+
 	/** @return The host address */
 	const IpAddress& getHost() const;
 
@@ -503,6 +533,22 @@ class EE_API Http : NonCopyable {
 	/** @return Is a proxy is need to be used */
 	bool isProxied() const;
 
+	/** Enables or disables keeping the connections to the host alive. The idle connections are
+	 * kept in a per host pool and reused by the next requests ( sync or async, plain or TLS ),
+	 * avoiding a new TCP and TLS handshake for each request. Enabled by default. */
+	void setKeepAlive( bool keepAlive );
+
+	/** @return If the connections to the host are kept alive between requests */
+	bool isKeepAlive() const;
+
+	/** Sets the maximum number of connections that the async requests can open concurrently to
+	 * the host. The requests beyond that number wait in the host queue and are sent through the
+	 * already open connections as soon as they're free. Default: 6. */
+	void setMaxAsyncConnections( Uint32 maxConnections );
+
+	/** @return The maximum number of concurrent connections used by the async requests */
+	Uint32 getMaxAsyncConnections() const;
+
 	/** Helper class to build the body of a multipart/form-data request. */
 	class EE_API MultipartEntitiesBuilder {
 	  public:
@@ -647,11 +693,22 @@ class EE_API Http : NonCopyable {
 	/** It will try to get the proxy from the environment variables. */
 	static URI getEnvProxyURI();
 
-	/** Set the thread pool to consume for async requests, otherwise it will use its own */
+	/** Set the thread pool to consume for async requests, otherwise it will use its own I/O thread
+	 * pool shared by all the hosts */
 	static void setThreadPool( std::shared_ptr<ThreadPool> pool );
 
+	/** Sets for how long a resolved host address is reused before resolving it again. The cache
+	 * is shared by all the HTTP clients. Default: 60 seconds. */
+	static void setDNSCacheTTL( const Time& ttl );
+
+	/** @return For how long a resolved host address is reused */
+	static Time getDNSCacheTTL();
+
+	/** Removes all the resolved host addresses from the cache */
+	static void clearDNSCache();
+
   private:
-	class AsyncRequest : public Thread {
+	class AsyncRequest {
 	  public:
 		AsyncRequest( Http* http, const AsyncResponseCallback& cb, Http::Request request,
 					  Time timeout );
@@ -662,6 +719,9 @@ class EE_API Http : NonCopyable {
 		AsyncRequest( Http* http, const AsyncResponseCallback& cb, Http::Request request,
 					  std::string writePath, Time timeout );
 
+		AsyncRequest( Http* http, const AsyncResponseCallback& cb, Http::Request request,
+					  const BodyConsumer& consumer, Time timeout );
+
 		~AsyncRequest();
 
 		void run();
@@ -672,7 +732,6 @@ class EE_API Http : NonCopyable {
 		AsyncResponseCallback mCb;
 		Http::Request mRequest;
 		Time mTimeout;
-		bool mRunning;
 		bool mStreamed;
 		bool mStreamOwned;
 		IOStream* mStream;
@@ -708,26 +767,47 @@ class EE_API Http : NonCopyable {
 
 		void setKeepAlive( const bool& isKeepAlive );
 
+		/** @return True if the idle connection was closed by the server */
+		bool isStale();
+
+		/** @return The time elapsed since the connection was returned to the pool */
+		Time getIdleTime() const;
+
+		void resetIdleTime();
+
 	  protected:
 		TcpSocket* mSocket;
 		bool mIsConnected;
 		bool mIsTunneled;
 		bool mIsSSL;
 		bool mIsKeepAlive;
+		Uint64 mIdleSince;
 	};
 
 	friend class AsyncRequest;
-	ThreadLocalPtr<HttpConnection> mConnection; ///< Connection to the host
+	ThreadLocalPtr<HttpConnection> mConnection; ///< Connection to the host used by the thread
 	IpAddress mHost;							///< Web host address
 	std::string mHostName;						///< Web host name
 	unsigned short mPort;						///< Port used for connection with host
-	std::vector<AsyncRequest*> mThreads;
-	Mutex mThreadsMutex;
+	std::vector<HttpConnection*> mIdleConnections; ///< Keep-alive connections ready to be reused
+	Mutex mConnectionsMutex;
+	std::deque<AsyncRequest*> mAsyncQueue; ///< Async requests waiting for a connection
+	Mutex mAsyncMutex;
+	Uint32 mAsyncWorkers;
+	Uint32 mMaxAsyncConnections;
 	bool mIsSSL;
-	bool mHostSolved;
+	bool mKeepAlive;
 	URI mProxy;
 
-	void removeOldThreads();
+	HttpConnection* acquireConnection();
+
+	void releaseConnection();
+
+	void clearIdleConnections();
+
+	void queueAsyncRequest( AsyncRequest* asyncRequest );
+
+	void processAsyncQueue();
 
 	Request prepareFields( const Http::Request& request );
 };
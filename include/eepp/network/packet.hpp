@@ -29,6 +29,23 @@ class EE_API Packet {
 	**  @see Clear */
 	void append( const void* data, std::size_t sizeInBytes );
 
+	/** @brief Append a reference to external data to the end of the packet
+	**  The data is not copied: TcpSocket sends it directly from its
+	**  original location, so it must remain valid and unmodified until
+	**  the packet has been completely sent or cleared.
+	**  Reading from the packet, calling getData or sending it through an
+	**  UdpSocket copies the referenced data into the packet first.
+	**  TcpSocket doesn't call onSend for packets with references, so
+	**  packets that transform their data in onSend shouldn't use them.
+	**  @param data		Pointer to the sequence of bytes to reference
+	**  @param sizeInBytes Number of bytes to reference
+	**  @see append */
+	void appendReference( const void* data, std::size_t sizeInBytes );
+
+	/** @return True if the packet contains references to external data
+	**  @see appendReference */
+	bool hasReferences() const;
+
 	/** @brief Clear the packet
 	**  After calling Clear, the packet is empty.
 	**  @see Append */
@@ -168,11 +185,25 @@ class EE_API Packet {
 	**  @return True if @a size bytes can be read from the packet */
 	bool checkSize( std::size_t size );
 
+	/** Copies the referenced data into the packet data */
+	void flatten();
+
+	/** @brief A range of the packet data, either stored in the packet or referenced */
+	struct Segment {
+		const char* Data;	///< Referenced data, NULL if the data is stored in the packet
+		std::size_t Offset;	///< Offset in the packet data when stored in the packet
+		std::size_t Size;	///< Size of the range
+	};
+
 	// Member data
 	std::vector<char> mData; ///< Data stored in the packet
 	std::size_t mReadPos;	 ///< Current reading position in the packet
 	std::size_t mSendPos;	 ///< Current send position in the packet (for handling partial sends)
 	bool mIsValid;			 ///< Reading state of the packet
+
+	// Ranges of the packet data, only used while the packet references external data
+	std::vector<Segment> mSegments;
+	std::size_t mReferencedSize; ///< Number of referenced bytes
 };
 
 }} // namespace EE::Network
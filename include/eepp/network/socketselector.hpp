@@ -3,6 +3,7 @@
 
 #include <eepp/core.hpp>
 #include <eepp/system/time.hpp>
+#include <vector>
 using namespace EE::System;
 
 namespace EE { namespace Network {
@@ -68,6 +69,28 @@ class EE_API SocketSelector {
 	**  @see IsReady */
 	bool isReady( Socket& socket ) const;
 
+	/** @brief Get the sockets that are ready to receive data
+	**  The list is built by wait(). With the epoll backend ( Linux and
+	**  Android ) it only contains the sockets reported by the kernel,
+	**  so iterating it costs O(ready sockets) instead of calling isReady
+	**  for every socket in the selector.
+	**  @return The sockets that were ready in the last wait call */
+	const std::vector<Socket*>& getReadySockets() const;
+
+	/** @brief Enables edge-triggered readiness for the sockets added after the call
+	**  An edge-triggered socket is only reported when new data arrives,
+	**  so it must be read until it returns Socket::NotReady before waiting
+	**  again. It's only available with the epoll backend, the select
+	**  backend ignores it.
+	**  @param edgeTriggered True to enable it ( disabled by default ) */
+	void setEdgeTriggered( bool edgeTriggered );
+
+	/** @return True if the sockets added are edge-triggered */
+	bool isEdgeTriggered() const;
+
+	/** @return The number of sockets in the selector */
+	std::size_t getSocketCount() const;
+
 	/** @brief Overload of assignment operator
 	**  @param right Instance to assign
 	**  @return Reference to self */
@@ -6,6 +6,10 @@
 #include <thread>
 using namespace EE::System;
 
+namespace EE { namespace System {
+class IOStreamFile;
+}} // namespace EE::System
+
 namespace EE { namespace Network {
 
 class TcpListener;
@@ -15,6 +19,18 @@ class Packet;
 /** @brief Specialized socket using the TCP protocol */
 class EE_API TcpSocket : public Socket {
   public:
+	/** @brief A buffer of data to send */
+	struct ConstBuffer {
+		const void* data;
+		std::size_t size;
+	};
+
+	/** @brief A buffer to fill with received data */
+	struct MutableBuffer {
+		void* data;
+		std::size_t size;
+	};
+
 	static TcpSocket* New();
 
 	/** @brief Default constructor */
@@ -94,6 +110,52 @@ class EE_API TcpSocket : public Socket {
 	**  @see Send */
 	virtual Status receive( void* data, std::size_t size, std::size_t& received );
 
+	/** @brief Send several buffers of raw data to the remote peer
+	**  The buffers are sent in order as a single stream of bytes, without
+	**  copying them into a contiguous block first (scatter/gather I/O).
+	**  This function will fail if the socket is not connected.
+	**  @param buffers Pointer to the array of buffers to send
+	**  @param count   Number of buffers in the array
+	**  @param sent	The total number of bytes sent will be written here
+	**  @return Status code
+	**  @see receivev */
+	virtual Status sendv( const ConstBuffer* buffers, std::size_t count, std::size_t& sent );
+
+	/** @brief Receive raw data from the remote peer into several buffers
+	**  The buffers are filled in order. As with receive, in blocking mode
+	**  this function waits until some bytes are received, but it doesn't
+	**  wait until all the buffers are full.
+	**  This function will fail if the socket is not connected.
+	**  @param buffers  Pointer to the array of buffers to fill
+	**  @param count	Number of buffers in the array
+	**  @param received This variable is filled with the total number of bytes received
+	**  @return Status code
+	**  @see sendv */
+	virtual Status receivev( const MutableBuffer* buffers, std::size_t count,
+							 std::size_t& received );
+
+	/** @brief Send a range of a file to the remote peer
+	**  On Linux the data is sent by the kernel straight from the file
+	**  ( sendfile ), without copying it to user space. On other platforms,
+	**  or when the file can't be sent that way, it's read and sent in chunks.
+	**  To be able to handle partial sends over non-blocking sockets, use the
+	**  sendFile(IOStreamFile&, Uint64, Uint64, Uint64&) overload instead.
+	**  This function will fail if the socket is not connected.
+	**  @param file   The file to send. Its read position is not preserved.
+	**  @param offset Position of the first byte to send
+	**  @param length Number of bytes to send, 0 sends until the end of the file
+	**  @return Status code */
+	virtual Status sendFile( IOStreamFile& file, Uint64 offset = 0, Uint64 length = 0 );
+
+	/** @brief Send a range of a file to the remote peer
+	**  @param file   The file to send. Its read position is not preserved.
+	**  @param offset Position of the first byte to send
+	**  @param length Number of bytes to send, 0 sends until the end of the file
+	**  @param sent   The number of bytes sent will be written here. When the
+	**  send is Partial it can be resumed from offset + sent.
+	**  @return Status code */
+	virtual Status sendFile( IOStreamFile& file, Uint64 offset, Uint64 length, Uint64& sent );
+
 	/** @brief Send a formatted packet of data to the remote peer
 	 *
 	 **  In non-blocking mode, if this function returns sf::Socket::Partial,
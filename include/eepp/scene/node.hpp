@@ -63,7 +63,8 @@ enum NodeFlags {
 
 	NODE_FLAG_LOADING = ( 1 << 27 ),
 	NODE_FLAG_CLOSING_CHILDREN = ( 1 << 28 ),
-	NODE_FLAG_FREE_USE = ( 1 << 29 )
+	NODE_FLAG_FREE_USE = ( 1 << 29 ),
+	NODE_FLAG_POLYGON_TRANSFORMED = ( 1 << 30 )
 };
 
 class EE_API Node : public Transformable {
@@ -281,6 +282,29 @@ class EE_API Node : public Transformable {
 
 	void invalidateDraw();
 
+	/** Enables the retained draw mode. A retained node records the batches and clips rendered
+	 * by its subtree, and replays them (translated if the node only moved) instead of drawing
+	 * the subtree again while nothing inside it calls invalidateDraw.
+	 * A subtree that renders anything that can't be recorded (vertex buffers, frame buffers,
+	 * clip planes, stencil masks or scaled and rotated nodes) is drawn as usual, and it isn't
+	 * recorded again until it's invalidated. */
+	void setRetainedDraw( bool retained );
+
+	bool isRetainedDraw() const;
+
+	/** Enables a spatial index of the children bounds. Drawing then only visits the children
+	 * that intersect the active clip rectangle, and hit testing (overFind) only the children
+	 * under the point, instead of walking the whole child list. Useful for containers with
+	 * thousands of absolutely positioned children that don't move often, the index is rebuilt
+	 * after any child is added, removed, moved, resized, rotated or scaled. */
+	void setChildsSpatialIndexed( bool indexed );
+
+	bool isChildsSpatialIndexed() const;
+
+	/** Notifies the parent that the area where the node draws changed without a position, size,
+	 * rotation, scale or clipping change. */
+	void invalidateDrawCulling();
+
 	void setRotation( float angle );
 
 	void setRotation( const Float& angle, const OriginPoint& center );
@@ -484,6 +508,11 @@ class EE_API Node : public Transformable {
 	OriginPoint mScaleOriginPoint;
 	Float mAlpha;
 
+	struct RetainedDraw;
+	RetainedDraw* mRetainedDraw;
+	struct SpatialIndex;
+	SpatialIndex* mSpatialIndex;
+
 	virtual Uint32 onMessage( const NodeMessage* msg );
 
 	virtual Uint32 onTextInput( const TextInputEvent& event );
@@ -536,6 +565,15 @@ class EE_API Node : public Transformable {
 
 	virtual void drawChilds();
 
+	/** @return True if the node and its children never draw outside the node world bounds, so
+	 * it can be skipped when its bounds are outside the active clip rectangle. */
+	virtual bool isDrawCullable() const;
+
+	/** Gets the active clip rectangle where the children are drawn, in world coordinates.
+	 * @return False if the children can't be culled (there's no clip, or the clip isn't in
+	 * world coordinates because the node or a parent is scaled, rotated or a frame buffer). */
+	bool getDrawCullingRect( Rectf& rect ) const;
+
 	virtual void onChildCountChange( Node* child, const bool& removed );
 
 	virtual void onAngleChange();
@@ -611,6 +649,20 @@ class EE_API Node : public Transformable {
 	void unsubscribeScheduledUpdate();
 
 	bool isSubscribedForScheduledUpdate();
+
+	/** @return True if the node draw must go through the retained draw (it's enabled and the
+	 * last recording didn't fail). */
+	bool retainedDrawRecording() const;
+
+	/** Replays the retained draw if it's still valid. @return True if it was replayed. */
+	bool retainedDrawPlay();
+
+	void retainedDrawBegin();
+
+	void retainedDrawEnd();
+
+	/** Flags as dirty the retained draws of the node and its parents */
+	void invalidateRetainedDraw( Node* node );
 };
 
 }} // namespace EE::Scene
@@ -10,6 +10,7 @@
 #include <eepp/system/directorypack.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/functionstring.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
 #include <eepp/system/inifile.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/iostreamdeflate.hpp>
@@ -22,6 +23,7 @@
 #include <eepp/system/log.hpp>
 #include <eepp/system/luapattern.hpp>
 #include <eepp/system/md5.hpp>
+#include <eepp/system/memorymappedfile.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/pack.hpp>
 #include <eepp/system/packmanager.hpp>
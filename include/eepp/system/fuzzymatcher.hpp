@@ -0,0 +1,85 @@
+#ifndef EE_SYSTEM_FUZZYMATCHER_HPP
+#define EE_SYSTEM_FUZZYMATCHER_HPP
+
+#include <eepp/config.hpp>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EE { namespace System {
+
+/** @brief Ranks a set of candidate strings against a fuzzy pattern.
+ * Scores are compatible with String::fuzzyMatch (spaces in the pattern are ignored). Each
+ * candidate can have several fields (for example a file name and its path), the best scoring
+ * field is used as the candidate score.
+ * Candidates are prefiltered with a character bitmask computed when they are added, so only
+ * candidates that contain every pattern character are scored. Consecutive queries where the
+ * new pattern extends the previous one only score the previous query survivors.
+ * The candidate strings are not copied, they must be kept alive and unmodified until the
+ * matcher is cleared or destroyed. The matcher is not thread-safe.
+ */
+class EE_API FuzzyMatcher {
+  public:
+	struct Match {
+		Uint32 index;
+		int score;
+	};
+
+	/** @return The fuzzy match score of the string against the pattern. Same semantics as
+	 * String::fuzzyMatch. */
+	static int score( const std::string_view& string, const std::string_view& pattern,
+					  bool allowUneven = false, bool permissive = false );
+
+	/** @return A bitmask of the (case-insensitive) characters present in the string. If
+	 * the pattern mask has bits not present in the string mask the string can't match the
+	 * pattern. */
+	static Uint64 charMask( const std::string_view& string );
+
+	/** @param fieldsPerCandidate Number of strings added per candidate.
+	 * @param allowUneven Candidates that don't contain the whole pattern still get a score.
+	 * @param permissive The unmatched tail of a candidate doesn't penalize the score. */
+	explicit FuzzyMatcher( Uint32 fieldsPerCandidate = 1, bool allowUneven = false,
+						   bool permissive = false );
+
+	void reserve( size_t candidatesCount );
+
+	void clear();
+
+	/** Adds a candidate with a single field. @return The candidate index. */
+	Uint32 add( const std::string_view& field );
+
+	/** Adds a candidate, the number of fields must match the fields per candidate. @return The
+	 * candidate index. */
+	Uint32 add( std::initializer_list<std::string_view> fields );
+
+	/** @return The number of candidates */
+	size_t size() const { return mMasks.size() / mFieldsPerCandidate; }
+
+	bool empty() const { return mMasks.empty(); }
+
+	/** Ranks the candidates against the pattern.
+	 * @param pattern The pattern to match.
+	 * @param max Maximum number of results, only the best max results are fully sorted.
+	 * @param includeUnmatched Fill the remaining result slots with the candidates that didn't
+	 * match (with score INT_MIN) in insertion order.
+	 * @return The best matches sorted by score descending, ties keep the insertion order. */
+	std::vector<Match> match( const std::string_view& pattern, size_t max,
+							  bool includeUnmatched = false );
+
+  protected:
+	Uint32 mFieldsPerCandidate;
+	bool mAllowUneven;
+	bool mPermissive;
+	std::vector<std::string_view> mFields;
+	std::vector<Uint64> mMasks;
+	std::string mLastPattern;
+	std::vector<Uint32> mLastSurvivors;
+	bool mLastSurvivorsValid{ false };
+
+	int scoreCandidate( Uint32 index, const std::string_view& pattern, Uint64 patternMask ) const;
+};
+
+}} // namespace EE::System
+
+#endif
@@ -38,6 +38,9 @@ class EE_API IOStreamFile : public IOStream {
 
 	void close();
 
+	/** @return The underlying C file stream, NULL if the file is not open */
+	std::FILE* getFileHandle() const;
+
   protected:
 	std::FILE* mFS;
 	ios_size mSize;
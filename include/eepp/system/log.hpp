@@ -5,6 +5,10 @@
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/singleton.hpp>
 #include <eepp/system/sys.hpp>
+#include <eepp/system/time.hpp>
+#include <atomic>
+#include <functional>
+#include <tuple>
 #include <unordered_map>
 
 namespace EE { namespace System {
@@ -27,6 +31,24 @@ enum class LogLevel : int {
 	Assert,	  ///< Asserted critical condition.
 };
 
+/** @brief Converts a log argument to a type that can be kept until the message is formatted by the
+ * asynchronous writer ( the strings pointed by the arguments may not exist anymore ). */
+template <typename T> struct LogLazyArg {
+	static const T& get( const T& arg ) { return arg; }
+};
+
+template <> struct LogLazyArg<const char*> {
+	static std::string get( const char* arg ) { return NULL != arg ? arg : "(null)"; }
+};
+
+template <> struct LogLazyArg<char*> {
+	static std::string get( const char* arg ) { return NULL != arg ? arg : "(null)"; }
+};
+
+template <> struct LogLazyArg<std::string_view> {
+	static std::string get( const std::string_view& arg ) { return std::string( arg ); }
+};
+
 /** @brief Global log file. The engine will log everything in this file. */
 class EE_API Log : protected Mutex {
 	SINGLETON_DECLARE_HEADERS( Log )
@@ -81,6 +103,10 @@ class EE_API Log : protected Mutex {
 	void writef( const LogLevel& level, std::string_view format, Args&&... args ) {
 		if ( mLogLevelThreshold > level )
 			return;
+		if ( isAsync() ) {
+			writeAsync( level, true, true, lazyFormat( format, std::forward<Args>( args )... ) );
+			return;
+		}
 		auto result = String::format(
 			format, FormatArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... );
 		write( logLevelWithTimestamp( level, result, true ) );
@@ -89,6 +115,11 @@ class EE_API Log : protected Mutex {
 	/** @brief Writes a formated string to the log */
 	template <typename... Args>
 	void writef( std::string_view format, Args&&... args ) {
+		if ( isAsync() ) {
+			writeAsync( LogLevel::Info, false, true,
+						lazyFormat( format, std::forward<Args>( args )... ) );
+			return;
+		}
 		auto result = String::format(
 			format, FormatArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... );
 		write( result );
@@ -137,6 +168,39 @@ class EE_API Log : protected Mutex {
 	/** Enable/Disable to keep a copy of the logs into memory (disabled by default) */
 	void setKeepLog( bool keepLog );
 
+	/** @return The maximum size in bytes of the copy of the logs kept in memory */
+	size_t getKeepLogMaxSize() const;
+
+	/** Sets the maximum size in bytes of the copy of the logs kept in memory, the oldest lines are
+	 * discarded once it's reached ( 8 MiB by default, 0 means unbounded ). */
+	void setKeepLogMaxSize( size_t maxSize );
+
+	/** @return True if the log is written asynchronously */
+	bool isAsync() const;
+
+	/** Enables or disables the asynchronous mode. In asynchronous mode the messages are queued in
+	 * a lock-free ring buffer, and a background thread formats them and writes them in batches to
+	 * every output. The writer wakes up every flush interval, when a message with a level equal
+	 * or greater than the flush level is written, or when the queue is full. The callers only
+	 * block if the queue is full. It's meant to be set once at startup, disabling it waits until
+	 * the threads that are queueing messages are done and writes every queued message. */
+	void setAsync( bool async );
+
+	/** @return The maximum time the asynchronous writer waits before writing the queued messages */
+	const Time& getAsyncFlushInterval() const;
+
+	/** Sets the maximum time the asynchronous writer waits before writing the queued messages. */
+	void setAsyncFlushInterval( const Time& interval );
+
+	/** @return The minimum message level that wakes up the asynchronous writer immediately */
+	const LogLevel& getAsyncFlushLevel() const;
+
+	/** Sets the minimum message level that wakes up the asynchronous writer immediately. */
+	void setAsyncFlushLevel( const LogLevel& level );
+
+	/** Blocks until every message queued by the asynchronous mode is written. */
+	void flush();
+
 	static void debug( const std::string_view& text ) {
 		Log::instance()->writel( LogLevel::Debug, text );
 	}
@@ -212,12 +276,22 @@ class EE_API Log : protected Mutex {
 
 	Log( const std::string& logPath, const LogLevel& level, bool stdOutLog, bool liveWrite );
 
+	struct AsyncWriter;
+	friend struct AsyncWriter;
+
 	std::string mData;
 	std::string mFilePath;
 	bool mSave;
 	bool mStdOutEnabled;
 	bool mLiveWrite;
 	bool mKeepLog{ false };
+	size_t mKeepLogMaxSize{ 8 * 1024 * 1024 };
+	std::atomic<AsyncWriter*> mAsync{ nullptr };
+	std::atomic<Uint32> mAsyncUsers[2]{};
+	std::atomic<Uint32> mAsyncEpoch{ 0 };
+	Mutex mAsyncMutex;
+	Time mAsyncFlushInterval{ Milliseconds( 250 ) };
+	LogLevel mAsyncFlushLevel{ LogLevel::Warning };
 	LogLevel mLogLevelThreshold{ getDefaultLogLevel() };
 	IOStreamFile* mFS;
 	std::vector<LogReaderInterface*> mReaders;
@@ -228,6 +302,30 @@ class EE_API Log : protected Mutex {
 
 	void writeToReaders( const std::string_view& text );
 
+	void writeToOutputs( const std::string_view& text );
+
+	void appendToBuffer( const std::string_view& text );
+
+	void writeAsync( const LogLevel& level, bool timestamp, bool newLine, std::string&& text );
+
+	void writeAsync( const LogLevel& level, bool timestamp, bool newLine,
+					 std::function<std::string()>&& format );
+
+	/** @return A function that formats the message, the arguments are copied so it can be called
+	 * later from the asynchronous writer thread. */
+	template <typename... Args>
+	static std::function<std::string()> lazyFormat( std::string_view format, Args&&... args ) {
+		return [format = std::string( format ),
+				captured = std::make_tuple(
+					LogLazyArg<std::decay_t<Args>>::get( std::forward<Args>( args ) )... )] {
+			return std::apply(
+				[&format]( const auto&... arguments ) {
+					return String::format( format, arguments... );
+				},
+				captured );
+		};
+	}
+
 	std::string logLevelWithTimestamp( const LogLevel& level, const std::string_view& text,
 									   bool appendNewLine );
 };
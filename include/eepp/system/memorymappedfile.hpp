@@ -0,0 +1,55 @@
+#ifndef EE_SYSTEMCMEMORYMAPPEDFILE_HPP
+#define EE_SYSTEMCMEMORYMAPPEDFILE_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/noncopyable.hpp>
+#include <eepp/system/scopedbuffer.hpp>
+#include <string>
+#include <string_view>
+
+namespace EE { namespace System {
+
+/** @brief A read only view of a whole file mapped into memory.
+ * When the platform can't map the file it's read into memory instead, so the data is always
+ * available while the file is open. The data is invalidated after close(). */
+class EE_API MemoryMappedFile : NonCopyable {
+  public:
+	MemoryMappedFile();
+
+	~MemoryMappedFile();
+
+	/** Maps the file. Closes the previously mapped file, if any.
+	 * @return True if the file data is available */
+	bool open( const std::string& path );
+
+	/** Unmaps the file */
+	void close();
+
+	/** @return True if the file data is available */
+	bool isOpen() const;
+
+	/** @return True if the data is mapped and not a copy of the file */
+	bool isMapped() const;
+
+	/** @return The file data */
+	const Uint8* getData() const;
+
+	/** @return The file size */
+	size_t getSize() const;
+
+	/** @return A view of size bytes of the file starting at offset, or an empty view if the range
+	 * is not inside the file. */
+	std::string_view getView( size_t offset, size_t size ) const;
+
+  protected:
+	const Uint8* mData;
+	size_t mSize;
+	bool mOpen;
+	bool mMapped;
+	void* mMapHandle;
+	ScopedBuffer mBuffer;
+};
+
+}} // namespace EE::System
+
+#endif
@@ -2,9 +2,12 @@
 #define EE_SYSTEMCPACK_HPP
 
 #include <eepp/system/iostream.hpp>
+#include <eepp/system/memorymappedfile.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/scopedbuffer.hpp>
 #include <map>
+#include <string_view>
+#include <vector>
 
 namespace EE { namespace System {
 
@@ -78,8 +81,31 @@ class EE_API Pack : protected Mutex {
 	/** Open a file stream for reading */
 	virtual IOStream* getFileStream( const std::string& path ) = 0;
 
+	/** Sets if the pack file must be memory mapped while open. A mapped pack serves its stored
+	 * ( uncompressed ) files as views of the mapping, without any copy or file seek. Must be set
+	 * before opening the pack. Disabled by default. */
+	void setMemoryMapped( bool memoryMapped );
+
+	/** @return If the pack file is memory mapped while open */
+	bool isMemoryMapped() const;
+
+	/** @return A view of the file data inside the mapped pack file, or an empty view if the pack
+	 * is not mapped or the file is not stored uncompressed. The view is valid until the pack is
+	 * closed or modified. */
+	virtual std::string_view getFileView( const std::string& path );
+
+	/** Extract several files to memory from the pack file. Packs with compressed files can
+	 * decompress them in parallel.
+	 * @param paths The files to extract
+	 * @param data The extracted files, in the same order as paths
+	 * @return True if all the files were extracted */
+	virtual bool extractFilesToMemory( const std::vector<std::string>& paths,
+									   std::vector<std::vector<Uint8>>& data );
+
   protected:
 	bool mIsOpen;
+	bool mMemoryMapped;
+	MemoryMappedFile mMapping;
 
 	void onPackOpened();
 
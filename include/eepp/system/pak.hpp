@@ -1,6 +1,7 @@
 #ifndef EE_SYSTEMCPAK_HPP
 #define EE_SYSTEMCPAK_HPP
 
+#include <eepp/core/containers.hpp>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/pack.hpp>
 
@@ -76,6 +77,8 @@ class EE_API Pak : public Pack {
 
 	IOStream* getFileStream( const std::string& path );
 
+	std::string_view getFileView( const std::string& path );
+
   protected:
 	friend class IOStreamPak;
 
@@ -101,6 +104,7 @@ class EE_API Pak : public Pack {
 
 	pakFile mPak;
 	std::vector<pakEntry> mPakFiles;
+	UnorderedMap<std::string, Uint32> mPakFilesIndex;
 
 	pakEntry getPackEntry( Uint32 index );
 };
@@ -1,8 +1,12 @@
 #ifndef EE_SYSTEMCRESOURCELOADER
 #define EE_SYSTEMCRESOURCELOADER
 
+#include <atomic>
+#include <deque>
 #include <eepp/core.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/system/thread.hpp>
+#include <eepp/system/time.hpp>
 #include <vector>
 
 namespace EE { namespace System {
@@ -10,12 +14,20 @@ namespace EE { namespace System {
 #define THREADS_AUTO ( eeINDEX_NOT_FOUND )
 
 /** @brief A simple resource loader that can load a batch of resources synchronously or
- * asynchronously */
+ * asynchronously
+ * A resource can be loaded in two stages: the load task runs in the thread pool and, once it's
+ * done, its upload task is queued to run in the thread that calls update() ( usually the render
+ * thread, since the upload task is the one that creates the GPU resources ). */
 class EE_API ResourceLoader {
   public:
 	typedef std::function<void( ResourceLoader* )> ResLoadCallback;
 	typedef std::function<void()> ObjectLoaderTask;
 
+	enum class Stage {
+		Load,  //! The tasks that run in the thread pool
+		Upload //! The tasks that run in the thread that calls update()
+	};
+
 	/** @param MaxThreads Set the maximun simultaneous threads to load resources, THREADS_AUTO will
 	 * use the cpu number of cores. */
 	ResourceLoader( const Uint32& MaxThreads = THREADS_AUTO );
@@ -30,6 +42,14 @@ class EE_API ResourceLoader {
 	*/
 	void add( const ObjectLoaderTask& objectLoaderTask );
 
+	/** @brief Adds a resource to load in two stages.
+	**	Must be called before the loading starts.
+	**	@param loadTask The function that loads the resource, it runs in the thread pool
+	**	@param uploadTask The function called once loadTask finished. If the loader is threaded it
+	*will run in the thread that calls update(), otherwise it runs right after loadTask.
+	*/
+	void add( const ObjectLoaderTask& loadTask, const ObjectLoaderTask& uploadTask );
+
 	/** @brief Starts loading the resources.
 	**	@param callback A callback that is called when the resources finished loading. */
 	void load( const ResLoadCallback& callback );
@@ -37,6 +57,15 @@ class EE_API ResourceLoader {
 	/** @brief Starts loading the resources. */
 	void load();
 
+	/** @brief Runs the upload tasks of the resources already loaded.
+	**	Must be called every frame while the threaded loader is loading resources with upload
+	*tasks, the loading doesn't finish until all of them ran. At least one task runs every call,
+	*and the next ones while the time spent is less than the budget. The load callbacks are called
+	*from here once everything is done.
+	**	@param budget The maximum time to spend running upload tasks
+	**	@returns If the resources were loaded. */
+	bool update( const Time& budget = Milliseconds( 4 ) );
+
 	/** @returns If the resources were loaded. */
 	virtual bool isLoaded();
 
@@ -57,6 +86,9 @@ class EE_API ResourceLoader {
 	/** @return The aproximate percent of progress ( between 0 and 100 ) */
 	Float getProgress();
 
+	/** @return The aproximate percent of progress of a stage ( between 0 and 100 ) */
+	Float getProgress( const Stage& stage );
+
 	/** @returns The number of resources added to load. */
 	Uint32 getCount() const;
 
@@ -70,6 +102,12 @@ class EE_API ResourceLoader {
 
 	std::vector<ResLoadCallback> mLoadCbs;
 	std::vector<ObjectLoaderTask> mTasks;
+	std::vector<ObjectLoaderTask> mUploadTasks;
+	std::deque<size_t> mUploadQueue;
+	Mutex mUploadMutex;
+	Uint32 mUploadCount{ 0 };
+	std::atomic<Uint32> mTotalUploaded{ 0 };
+	std::atomic<bool> mLoadStageDone{ false };
 
 	void setThreads();
 
@@ -78,6 +116,8 @@ class EE_API ResourceLoader {
 	void taskRunner();
 
 	void serializedLoad();
+
+	void finishLoading();
 };
 
 }} // namespace EE::System
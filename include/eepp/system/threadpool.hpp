@@ -1,21 +1,53 @@
 #ifndef EE_SYSTEM_THREADPOOL_HPP
 #define EE_SYSTEM_THREADPOOL_HPP
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <eepp/core/noncopyable.hpp>
 #include <eepp/system/lock.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/thread.hpp>
+#include <eepp/system/threadlocalptr.hpp>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace EE { namespace System {
 
+/** @brief A shared flag to request the cancellation of one or more tasks.
+ * Copies of the token share the same state. Tasks are expected to check isCancelled() from time
+ * to time and return early, queued tasks of a cancelled TaskGroup are not started. */
+class EE_API CancellationToken {
+  public:
+	CancellationToken() : mCancelled( std::make_shared<std::atomic<bool>>( false ) ) {}
+
+	void cancel() { mCancelled->store( true, std::memory_order_relaxed ); }
+
+	bool isCancelled() const { return mCancelled->load( std::memory_order_relaxed ); }
+
+  protected:
+	std::shared_ptr<std::atomic<bool>> mCancelled;
+};
+
+class TaskGroup;
+
+/** @brief A pool of worker threads that runs the queued tasks.
+ * Each worker has its own task queue for every priority: the tasks queued from a worker go to
+ * its own queue and the idle workers steal from the busy ones, so the tasks spawned by other
+ * tasks ( TaskGroup, parallelFor ) don't compete for a single queue. The tasks queued from other
+ * threads go to a shared queue. Workers always take the highest priority task available. */
 class EE_API ThreadPool : NonCopyable {
   public:
+	/** The task priority lanes, High tasks run before Normal ones and Normal before Low. */
+	enum class Priority : Uint8 { High = 0, Normal = 1, Low = 2 };
+
 	static std::shared_ptr<ThreadPool> createShared( Uint32 numThreads,
 													 bool terminateOnClose = false );
 
@@ -31,7 +63,29 @@ class EE_API ThreadPool : NonCopyable {
 	Uint64 run(
 		const std::function<void()>& func,
 		const std::function<void( const Uint64& )>& doneCallback = []( const Uint64& ) {},
-		const Uint64& tag = 0 );
+		const Uint64& tag = 0, const Priority& priority = Priority::Normal );
+
+	/** Queues any callable. Small callables are stored inside the task, without allocating.
+	 * @return The task id */
+	template <typename F>
+	Uint64 post( F&& func, const Priority& priority = Priority::Normal, const Uint64& tag = 0 );
+
+	/** Calls func( i ) for every i in [begin, end) from the pool workers and the calling thread,
+	 * and waits until all the calls finish.
+	 * @param grainSize Minimum number of indexes processed by each task, 0 to choose it from the
+	 * number of threads. */
+	template <typename Index, typename F>
+	void parallelFor( Index begin, Index end, F&& func, Index grainSize = 0,
+					  const Priority& priority = Priority::High );
+
+	/** Reduces the values map( i ) for every i in [begin, end) with reduce( a, b ) in parallel.
+	 * Each task reduces a contiguous range and the results of the ranges are reduced in order, so
+	 * reduce only needs to be associative.
+	 * @param identity The value that doesn't change the result of reduce ( 0 for a sum ).
+	 * @return The reduced value, identity for an empty range. */
+	template <typename Index, typename T, typename Map, typename Reduce>
+	T parallelReduce( Index begin, Index end, T identity, Map&& map, Reduce&& reduce,
+					  Index grainSize = 0, const Priority& priority = Priority::High );
 
 	Uint32 numThreads() const;
 
@@ -47,25 +101,321 @@ class EE_API ThreadPool : NonCopyable {
 
 	bool removeWithTag( const Uint64& tag );
 
-  private:
+	/** Runs one of the queued tasks in the calling thread, if any.
+	 * @return True if a task was run */
+	bool runPendingTask();
+
+	/** Runs one of the queued tasks of the group in the calling thread, if any.
+	 * @return True if a task was run */
+	bool runPendingTask( TaskGroup* group );
+
+  protected:
+	friend class TaskGroup;
+
+	/** @brief A type erased callable with inline storage for small callables */
+	class Task {
+	  public:
+		static constexpr std::size_t INLINE_SIZE = 6 * sizeof( void* );
+
+		Task() {}
+
+		template <typename F, typename Fn = typename std::decay<F>::type,
+				  typename = typename std::enable_if<!std::is_same<Fn, Task>::value>::type>
+		Task( F&& func ) {
+			if constexpr ( sizeof( Fn ) <= INLINE_SIZE &&
+						   alignof( Fn ) <= alignof( std::max_align_t ) &&
+						   std::is_nothrow_move_constructible<Fn>::value ) {
+				new ( &mStorage ) Fn( std::forward<F>( func ) );
+				mOps = &inlineOps<Fn>;
+			} else {
+				*reinterpret_cast<Fn**>( &mStorage ) = new Fn( std::forward<F>( func ) );
+				mOps = &heapOps<Fn>;
+			}
+		}
+
+		Task( Task&& other ) noexcept { moveFrom( other ); }
+
+		Task& operator=( Task&& other ) noexcept {
+			if ( this != &other ) {
+				reset();
+				moveFrom( other );
+			}
+			return *this;
+		}
+
+		~Task() { reset(); }
+
+		void operator()() { mOps->invoke( &mStorage ); }
+
+		explicit operator bool() const { return NULL != mOps; }
+
+	  protected:
+		struct Ops {
+			void ( *invoke )( void* storage );
+			void ( *move )( void* from, void* to );
+			void ( *destroy )( void* storage );
+		};
+
+		template <typename Fn> static void inlineInvoke( void* storage ) {
+			( *static_cast<Fn*>( storage ) )();
+		}
+
+		template <typename Fn> static void inlineMove( void* from, void* to ) {
+			new ( to ) Fn( std::move( *static_cast<Fn*>( from ) ) );
+			static_cast<Fn*>( from )->~Fn();
+		}
+
+		template <typename Fn> static void inlineDestroy( void* storage ) {
+			static_cast<Fn*>( storage )->~Fn();
+		}
+
+		template <typename Fn> static void heapInvoke( void* storage ) {
+			( **static_cast<Fn**>( storage ) )();
+		}
+
+		static void heapMove( void* from, void* to ) {
+			*static_cast<void**>( to ) = *static_cast<void**>( from );
+		}
+
+		template <typename Fn> static void heapDestroy( void* storage ) {
+			delete *static_cast<Fn**>( storage );
+		}
+
+		template <typename Fn> static constexpr Ops inlineOps = { &inlineInvoke<Fn>,
+																  &inlineMove<Fn>,
+																  &inlineDestroy<Fn> };
+
+		template <typename Fn>
+		static constexpr Ops heapOps = { &heapInvoke<Fn>, &heapMove, &heapDestroy<Fn> };
+
+		typename std::aligned_storage<INLINE_SIZE, alignof( std::max_align_t )>::type mStorage;
+		const Ops* mOps{ NULL };
+
+		void moveFrom( Task& other ) {
+			if ( NULL != other.mOps ) {
+				other.mOps->move( &other.mStorage, &mStorage );
+				mOps = other.mOps;
+				other.mOps = NULL;
+			}
+		}
+
+		void reset() {
+			if ( NULL != mOps ) {
+				mOps->destroy( &mStorage );
+				mOps = NULL;
+			}
+		}
+	};
+
 	struct Work {
 		Uint64 id{ 0 };
-		const std::function<void()> func;
-		const std::function<void( const Uint64& )> callback;
+		Task func;
+		std::function<void( const Uint64& )> callback;
 		Uint64 tag{ 0 };
+		TaskGroup* group{ NULL };
+	};
+
+	static constexpr std::size_t PRIORITY_COUNT = 3;
+
+	/** A task queue for every priority */
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Work> work[PRIORITY_COUNT];
 	};
 
-	void threadFunc();
+	struct Worker {
+		Uint32 index{ 0 };
+		Queue queue;
+	};
+
+	void threadFunc( Worker* worker );
+
+	Uint64 push( Task&& func, std::function<void( const Uint64& )>&& callback, const Uint64& tag,
+				 const Priority& priority, TaskGroup* group );
+
+	/** Takes the next task to run, only the tasks of the group if it's not NULL */
+	bool pop( Worker* worker, Work& work, TaskGroup* group = NULL );
+
+	void execute( Work& work );
+
+	template <typename Pred> bool removeIf( Pred pred, bool firstOnly );
 
 	std::vector<std::unique_ptr<Thread>> mThreads;
-	std::deque<std::unique_ptr<Work>> mWork;
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+	Queue mQueue; ///< Tasks queued from threads outside the pool
+	ThreadLocalPtr<Worker> mCurrentWorker;
 	std::atomic<Uint64> mLastWorkId;
-	bool mShuttingDown = false;
+	std::atomic<Int64> mPendingWork{ 0 }; ///< Number of queued tasks
+	std::atomic<Uint32> mStealSeed{ 0 };
+	std::atomic<bool> mShuttingDown{ false };
 	bool mTerminateOnClose = false;
 	mutable std::mutex mMutex;
 	std::condition_variable mWorkAvailable;
 };
 
+/** @brief A set of tasks that can be waited and cancelled together.
+ * The tasks run in the pool with the priority of the group. wait() runs the queued tasks of the
+ * group in the calling thread while the group is not finished, so it can be safely called from a
+ * pool worker. The destructor waits for the pending tasks. */
+class EE_API TaskGroup : NonCopyable {
+  public:
+	TaskGroup( ThreadPool& pool,
+			   const ThreadPool::Priority& priority = ThreadPool::Priority::Normal );
+
+	~TaskGroup();
+
+	/** Queues a task in the group */
+	template <typename F> void run( F&& func );
+
+	/** Waits until all the tasks in the group finished or were discarded */
+	void wait();
+
+	/** Cancels the group: the queued tasks that didn't start are discarded and the token is
+	 * cancelled, so the running ones can stop early. */
+	void cancel();
+
+	bool isCancelled() const;
+
+	/** @return The cancellation token of the group */
+	const CancellationToken& getToken() const;
+
+	ThreadPool& getPool() const;
+
+  protected:
+	friend class ThreadPool;
+
+	ThreadPool& mPool;
+	ThreadPool::Priority mPriority;
+	CancellationToken mToken;
+	std::atomic<Uint64> mPending{ 0 };
+	std::mutex mMutex;
+	std::condition_variable mDone;
+
+	void taskDone();
+};
+
+template <typename F>
+Uint64 ThreadPool::post( F&& func, const Priority& priority, const Uint64& tag ) {
+	return push( Task( std::forward<F>( func ) ), nullptr, tag, priority, NULL );
+}
+
+template <typename Pred> bool ThreadPool::removeIf( Pred pred, bool firstOnly ) {
+	std::vector<Work> removed;
+
+	auto removeFrom = [&]( Queue& queue ) {
+		std::lock_guard<std::mutex> lock( queue.mutex );
+
+		for ( auto& work : queue.work ) {
+			for ( auto it = work.begin(); it != work.end(); ) {
+				if ( pred( *it ) ) {
+					removed.emplace_back( std::move( *it ) );
+					it = work.erase( it );
+
+					if ( firstOnly )
+						return true;
+				} else {
+					++it;
+				}
+			}
+		}
+
+		return false;
+	};
+
+	if ( !removeFrom( mQueue ) ) {
+		for ( auto& worker : mWorkers )
+			if ( removeFrom( worker->queue ) )
+				break;
+	}
+
+	for ( auto& work : removed ) {
+		--mPendingWork;
+
+		if ( NULL != work.group )
+			work.group->taskDone();
+	}
+
+	return !removed.empty();
+}
+
+template <typename F> void TaskGroup::run( F&& func ) {
+	++mPending;
+
+	if ( 0 == mPool.push( ThreadPool::Task( std::forward<F>( func ) ), nullptr, 0, mPriority,
+						  this ) )
+		taskDone();
+}
+
+template <typename Index, typename F>
+void ThreadPool::parallelFor( Index begin, Index end, F&& func, Index grainSize,
+							  const Priority& priority ) {
+	if ( end <= begin )
+		return;
+
+	Index count = end - begin;
+	Index chunks = static_cast<Index>( eemax<Uint32>( 1, numThreads() ) * 4 );
+
+	if ( grainSize <= 0 )
+		grainSize = eemax<Index>( 1, ( count + chunks - 1 ) / chunks );
+
+	// Nothing to split
+	if ( count <= grainSize ) {
+		for ( Index i = begin; i < end; ++i )
+			func( i );
+		return;
+	}
+
+	TaskGroup group( *this, priority );
+
+	for ( Index from = begin; from < end; from += eemin<Index>( grainSize, end - from ) ) {
+		Index to = from + eemin<Index>( grainSize, end - from );
+
+		group.run( [from, to, &func] {
+			for ( Index i = from; i < to; ++i )
+				func( i );
+		} );
+	}
+
+	group.wait();
+}
+
+template <typename Index, typename T, typename Map, typename Reduce>
+T ThreadPool::parallelReduce( Index begin, Index end, T identity, Map&& map, Reduce&& reduce,
+							  Index grainSize, const Priority& priority ) {
+	if ( end <= begin )
+		return identity;
+
+	Index count = end - begin;
+	Index chunks = static_cast<Index>( eemax<Uint32>( 1, numThreads() ) * 4 );
+
+	if ( grainSize <= 0 )
+		grainSize = eemax<Index>( 1, ( count + chunks - 1 ) / chunks );
+
+	std::vector<T> results( static_cast<std::size_t>( ( count + grainSize - 1 ) / grainSize ),
+							identity );
+
+	parallelFor(
+		Index( 0 ), static_cast<Index>( results.size() ),
+		[&]( Index chunk ) {
+			Index from = begin + chunk * grainSize;
+			Index to = from + eemin<Index>( grainSize, end - from );
+			T value( identity );
+
+			for ( Index i = from; i < to; ++i )
+				value = reduce( value, map( i ) );
+
+			results[static_cast<std::size_t>( chunk )] = std::move( value );
+		},
+		Index( 1 ), priority );
+
+	T value( identity );
+
+	for ( auto& result : results )
+		value = reduce( value, result );
+
+	return value;
+}
+
 }} // namespace EE::System
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef EE_SYSTEMCZIP_HPP
 #define EE_SYSTEMCZIP_HPP
 
+#include <eepp/core/containers.hpp>
 #include <eepp/system/pack.hpp>
 
 struct zip;
@@ -74,14 +75,40 @@ class EE_API Zip : public Pack {
 
 	IOStream* getFileStream( const std::string& path );
 
+	/** @return A view of the file data inside the mapped zip file, only available for files
+	 * stored without compression. */
+	std::string_view getFileView( const std::string& path );
+
+	/** Extract several files to memory. When the zip is memory mapped the deflated files are
+	 * decompressed in parallel straight from the mapping. */
+	bool extractFilesToMemory( const std::vector<std::string>& paths,
+							   std::vector<std::vector<Uint8>>& data );
+
   protected:
 	friend class IOStreamZip;
 
+	//! Location of an entry data inside the memory mapped zip file
+	struct MappedEntry {
+		Uint32 offset{ 0 };
+		Uint32 compSize{ 0 };
+		Uint32 size{ 0 };
+		Uint16 method{ 0 };
+		bool valid{ false };
+	};
+
 	struct zip* mZip;
 
 	std::string mZipPath;
 
+	UnorderedMap<std::string, Int32> mFilesIndex;
+
+	std::vector<MappedEntry> mMappedEntries;
+
 	struct zip* getZip();
+
+	void onZipOpened();
+
+	bool extractMappedEntry( Int32 index, Uint8* data );
 };
 
 }} // namespace EE::System
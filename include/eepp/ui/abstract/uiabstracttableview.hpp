@@ -132,6 +132,14 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 
 	void setRowHeaderWidth( Float rowHeaderWidth );
 
+	const size_t& getColumnMeasureSampleSize() const;
+
+	/** Sets the maximum number of rows measured to fit a column to its content (10000 by
+	 * default), 0 measures every row. Larger models are sampled at regular intervals. Only the
+	 * automatic fits are sampled (the column auto-size and a double click on the column edge),
+	 * getMaxColumnContentWidth measures every row unless bestGuess is requested. */
+	void setColumnMeasureSampleSize( const size_t& sampleSize );
+
   protected:
 	friend class EE::UI::UITableHeaderColumn;
 
@@ -163,6 +171,9 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 	size_t mMainColumn{ 0 };
 	std::unordered_map<UIWidget*, std::vector<Uint32>> mWidgetsClickCbId;
 	Float mRowHeaderWidth{ 0 };
+	size_t mColumnMeasureSampleSize{ 10000 };
+	std::unordered_map<std::string, Float> mTextWidthCache;
+	FontStyleConfig mTextWidthCacheStyle;
 
 	virtual ~UIAbstractTableView();
 
@@ -224,6 +235,19 @@ class EE_API UIAbstractTableView : public UIAbstractView {
 	void buildRowHeader();
 
 	void updateRowHeader( int realRowIndex, const ModelIndex& index, Float yOffset );
+
+	/** Measures the widest cell of a column. The cells width is estimated from the model data and
+	 * the font metrics, and only the widest estimated cells are laid out to get their real width.
+	 * @param rowCount The number of rows to measure
+	 * @param getRow Returns the index and the indentation level of a row
+	 * @param indentWidth The width of every indentation level
+	 * @param sample If the rows can be sampled (see setColumnMeasureSampleSize) */
+	Float measureColumnContentWidth(
+		const size_t& rowCount,
+		const std::function<std::pair<ModelIndex, size_t>( size_t )>& getRow,
+		const Float& indentWidth, bool sample );
+
+	Float getCachedTextWidth( const std::string& text, const FontStyleConfig& style );
 };
 
 }}} // namespace EE::UI::Abstract
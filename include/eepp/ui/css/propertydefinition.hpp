@@ -112,6 +112,7 @@ enum class PropertyId : Uint32 {
 	ColumnWidth = String::hash( "column-width" ),
 	RowWeight = String::hash( "row-weight" ),
 	ReverseDraw = String::hash( "reverse-draw" ),
+	RetainedDraw = String::hash( "retained-draw" ),
 	Orientation = String::hash( "orientation" ),
 	Indeterminate = String::hash( "indeterminate" ),
 	MaxProgress = String::hash( "max-progress" ),
@@ -19,6 +19,14 @@ struct EE_API TokenizedLine {
 	static Uint64 calcSignature( const std::vector<SyntaxTokenPosition>& tokens );
 };
 
+/** A splice over the semantic tokens array: removes deleteCount integers at start and inserts
+ * data in their place. */
+struct EE_API SemanticTokensEdit {
+	Uint32 start{ 0 };
+	Uint32 deleteCount{ 0 };
+	std::vector<Int32> data;
+};
+
 class EE_API SyntaxHighlighter {
   public:
 	explicit SyntaxHighlighter( TextDocument* doc );
@@ -69,7 +77,41 @@ class EE_API SyntaxHighlighter {
 
 	void setStopTokenizingAsync() { mStopTokenizing = true; }
 
+	/** Sets the style type of each semantic token type index (the server legend). */
+	void setSemanticTokenTypes( std::vector<SyntaxStyleType>&& types );
+
+	/** Replaces the semantic tokens overlay. The data is kept as sent by the language server
+	 * (5 integers per token, delta encoded), it's merged with the syntax tokens of a line only
+	 * when the line is requested. */
+	void setSemanticTokens( std::vector<Int32>&& data );
+
+	/** Replaces the semantic tokens of the lines between fromLine and toLine (inclusive) with the
+	 * tokens of a range response, the tokens of the rest of the lines are kept. The range is
+	 * widened to contain every line present in data. */
+	void mergeSemanticTokens( std::vector<Int32>&& data, Int64 fromLine, Int64 toLine );
+
+	/** Applies the edits in order as in-place splices over the current semantic tokens. */
+	void editSemanticTokens( const std::vector<SemanticTokensEdit>& edits );
+
+	void clearSemanticTokens();
+
+	bool hasSemanticTokens();
+
   protected:
+	struct SemanticLine {
+		Int64 line;
+		String::HashType hash;
+		Uint32 offset;
+		Uint32 count;
+		Uint64 signature;
+	};
+
+	struct SemanticMergedLine {
+		Uint64 syntaxSignature{ 0 };
+		Uint64 semanticSignature{ 0 };
+		std::vector<SyntaxTokenPosition> tokens;
+	};
+
 	TextDocument* mDoc;
 	std::unordered_map<size_t, TokenizedLine> mLines;
 	UnorderedMap<size_t, TokenizedLine> mTokenizerLines;
@@ -81,6 +123,15 @@ class EE_API SyntaxHighlighter {
 	std::condition_variable mAsyncTokenizeConf;
 	bool mTokenizeAsync{ false };
 	bool mStopTokenizing{ false };
+	std::vector<Int32> mSemanticTokens;
+	std::vector<SyntaxStyleType> mSemanticTokenTypes;
+	std::vector<SemanticLine> mSemanticLines;
+	std::unordered_map<size_t, SemanticMergedLine> mSemanticMergedLines;
+
+	void updateSemanticLines();
+
+	const std::vector<SyntaxTokenPosition>& resolveSemanticLine( const size_t& index,
+																 const TokenizedLine& line );
 };
 
 }}} // namespace EE::UI::Doc
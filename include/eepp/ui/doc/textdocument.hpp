@@ -219,6 +219,11 @@ class EE_API TextDocument {
 
 	bool replaceCurrentLine( const String& text );
 
+	/** Replaces the document contents with the text, editing only the lines that changed (a
+	 * line diff between both). Unchanged lines keep their highlighting and fold state, and
+	 * document clients only receive the touched ranges. */
+	void applyTextDiff( String text );
+
 	void print() const;
 
 	// Translations
@@ -6,10 +6,15 @@
 #include <memory>
 
 #include <eepp/system/fileinfo.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/system/translator.hpp>
 #include <eepp/ui/models/model.hpp>
 #include <eepp/ui/uiicon.hpp>
 
+namespace EE { namespace UI {
+class UISceneNode;
+}} // namespace EE::UI
+
 namespace EE { namespace UI { namespace Models {
 
 enum FileSystemEventType {
@@ -92,7 +97,9 @@ class EE_API FileSystemModel : public Model {
 
 		const std::string& fullPath() const;
 
-		const std::string& getMimeType() const { return mMimeType; }
+		/** The mime type is resolved the first time it's requested, usually when the row is
+		 * displayed */
+		const std::string& getMimeType() const;
 
 		size_t childCount() const { return mChildren.size(); }
 
@@ -119,6 +126,12 @@ class EE_API FileSystemModel : public Model {
 
 		const Uint32& getHash() { return mHash; }
 
+		/** @return True if the node is the row displayed while its parent children are loaded */
+		bool isPlaceholder() const { return mPlaceholder; }
+
+		/** @return True while the children of the node are being loaded in background */
+		bool isLoading() const { return mLoading != nullptr; }
+
 	  private:
 		friend class FileSystemModel;
 
@@ -131,12 +144,17 @@ class EE_API FileSystemModel : public Model {
 		friend class FileSystemModel;
 		std::string mName;
 		String mDisplayName;
-		std::string mMimeType;
+		mutable std::string mMimeType;
 		Node* mParent{ nullptr };
 		FileInfo mInfo;
 		std::vector<Node*> mChildren;
+		// Points to the node while its children are loaded in background, the load is abandoned
+		// when the node is destroyed or traversed again
+		std::shared_ptr<Node*> mLoading;
 		bool mHasTraversed{ false };
 		bool mInfoDirty{ true };
+		mutable bool mMimeTypeResolved{ false };
+		bool mPlaceholder{ false };
 		Uint32 mHash{ 0 };
 
 		ModelIndex index( const FileSystemModel& model, int column ) const;
@@ -149,12 +167,27 @@ class EE_API FileSystemModel : public Model {
 
 		bool fetchData( const String& fullPath );
 
-		void updateMimeType();
+		void cancelLoad();
 	};
 
+	/** Number of files of the first chunk inserted by a background load, the next chunks double
+	 * their size */
+	static constexpr size_t LoadChunkSize = 256;
+
+	/** @param asyncLoading Reads the directories in the scene thread pool ( if any ) instead of
+	 * blocking the main thread. A directory being loaded displays a placeholder row and receives
+	 * its children in chunks. Looking up a path inside it with getNodeFromPath finishes its
+	 * load synchronously. */
 	static std::shared_ptr<FileSystemModel>
 	New( const std::string& rootPath, const Mode& mode = Mode::FilesAndDirectories,
-		 const DisplayConfig& displayConfig = DisplayConfig(), Translator* translator = nullptr );
+		 const DisplayConfig& displayConfig = DisplayConfig(), Translator* translator = nullptr,
+		 bool asyncLoading = false );
+
+	/** The directory listings are cached and shared by all the models for a few seconds, while
+	 * the directories aren't modified. This drops the cached listings. */
+	static void clearStatCache();
+
+	bool isAsyncLoading() const { return mAsyncLoading; }
 
 	const Mode& getMode() const { return mMode; }
 
@@ -208,13 +241,34 @@ class EE_API FileSystemModel : public Model {
 	Mode mMode{ Mode::FilesAndDirectories };
 	DisplayConfig mDisplayConfig;
 	std::array<std::string, Column::Count> mColumnNames;
+	String mLoadingText;
+	bool mAsyncLoading{ false };
+	CancellationToken mLoadToken;
 
 	ModelIndex mPreviouslySelectedIndex{};
 
 	Node& nodeRef( const ModelIndex& index ) const;
 
 	FileSystemModel( const std::string& rootPath, const Mode& mode,
-					 const DisplayConfig& displayConfig, Translator* translator );
+					 const DisplayConfig& displayConfig, Translator* translator,
+					 bool asyncLoading );
+
+	bool isFileVisible( const FileInfo& file ) const;
+
+	bool loadChildrenAsync( Node* node ) const;
+
+	static void postLoadedChildren( FileSystemModel* model, UISceneNode* scene,
+									const std::shared_ptr<Node*>& loading,
+									const CancellationToken& token,
+									const std::shared_ptr<std::vector<FileInfo>>& files,
+									size_t from, size_t chunkSize );
+
+	/** @return If the node is still loading and expects the next chunk */
+	bool insertLoadedChildren( const std::shared_ptr<Node*>& loading,
+							   const std::vector<FileInfo>& files, size_t from, size_t to );
+
+	/** Inserts synchronously the children of a node being loaded that aren't inserted yet */
+	void finishLoading( Node* node );
 
 	size_t getFileIndex( Node* parent, const FileInfo& file );
 
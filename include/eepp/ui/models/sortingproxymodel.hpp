@@ -1,6 +1,7 @@
 #ifndef EE_UI_MODELS_SORTINGPROXYMODEL_HPP
 #define EE_UI_MODELS_SORTINGPROXYMODEL_HPP
 
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/models/model.hpp>
 #include <memory>
 
@@ -56,12 +57,36 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 
 	virtual bool classModelRoleEnabled();
 
+	/** Mappings with at least this number of rows are sorted in parallel when a thread pool is
+	 * set */
+	static constexpr size_t ParallelSortThreshold = 16384;
+
+	std::shared_ptr<ThreadPool> getThreadPool() const;
+
+	/** Sets the thread pool used to sort the large mappings. Without a pool the sort runs in the
+	 * calling thread. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& threadPool );
+
   private:
+	// The sort role data of a row, fetched and normalized only once per sort instead of on every
+	// comparison
+	struct SortKey {
+		enum Kind : Uint8 { Empty, Number, Text };
+		Kind kind{ Empty };
+		double number{ 0 };
+		std::string text;
+	};
+
 	// NOTE: The data() of indexes points to the corresponding Mapping object for that index.
 	struct Mapping {
 		std::vector<int> sourceRows;
 		std::vector<int> proxyRows;
 		ModelIndex sourceParent;
+		// The sort keys indexed by source row, valid while keysColumn is the sorted column
+		std::vector<SortKey> keys;
+		int keysColumn{ -1 };
+		// The keys were updated by a rows insertion or deletion since the last source update
+		bool keysPatched{ false };
 	};
 
 	using InternalMapIterator = UnorderedMap<ModelIndex, std::shared_ptr<Mapping>>::iterator;
@@ -70,12 +95,29 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 
 	virtual void onModelUpdated( unsigned );
 
+	virtual void modelDidInsertRows( const ModelIndex& parent, int first, int last );
+
+	virtual void modelDidDeleteRows( const ModelIndex& parent, int first, int last );
+
 	Model& source();
 
 	const Model& source() const;
 
+	SortKey makeSortKey( const Variant& data ) const;
+
+	void updateSortKeys( Mapping&, int column );
+
+	void invalidateSortKeys();
+
 	void sortMapping( Mapping&, int column, SortOrder );
 
+	static void updateProxyRows( Mapping& );
+
+	/** Moves the selected rows of the mapping to their new position. sourceRowMap translates the
+	 * source rows from before the source change to the current ones ( -1 if removed ). */
+	void remapSelection( const Mapping&, const std::vector<int>& oldSourceRows,
+						 const std::function<int( int )>& sourceRowMap = nullptr );
+
 	InternalMapIterator buildMapping( const ModelIndex& proxyIndex );
 
 	void invalidate( unsigned flags = Model::UpdateFlag::DontInvalidateIndexes );
@@ -90,6 +132,7 @@ class EE_API SortingProxyModel final : public Model, private Model::Client {
 	SortOrder mSortOrder{ SortOrder::Ascending };
 	ModelRole mSortRole{ ModelRole::Sort };
 	bool mSortingCaseSensitive{ false };
+	std::shared_ptr<ThreadPool> mThreadPool;
 };
 
 }}} // namespace EE::UI::Models
@@ -62,6 +62,8 @@ class EE_API TextureAtlasEditor {
 
 	void openTextureAtlas( const Event* Event );
 
+	void loadTextureAtlas( const std::string& path );
+
 	void saveTextureAtlas( const Event* Event );
 
 	void onTextureAtlasClose( const Event* Event );
@@ -364,6 +364,8 @@ class EE_API UINode : public Node {
 
 	virtual void drawBorder();
 
+	virtual bool isDrawCullable() const;
+
 	virtual void onThemeLoaded();
 
 	virtual void onChildCountChange( Node* child, const bool& removed );
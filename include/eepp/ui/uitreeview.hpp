@@ -1,6 +1,7 @@
 #ifndef EE_UI_UITREEVIEW_HPP
 #define EE_UI_UITREEVIEW_HPP
 
+#include <atomic>
 #include <eepp/ui/abstract/uiabstracttableview.hpp>
 #include <eepp/ui/uiicon.hpp>
 #include <eepp/ui/uitablerow.hpp>
@@ -36,10 +37,12 @@ class EE_API UITreeViewCell : public UITableCell {
 	virtual UIWidget* getExtraInnerWidget() const;
 };
 
-class EE_API UITreeView : public UIAbstractTableView {
+class EE_API UITreeView : public UIAbstractTableView, private Model::Client {
   public:
 	static UITreeView* New();
 
+	virtual ~UITreeView();
+
 	Uint32 getType() const;
 
 	bool isType( const Uint32& type ) const;
@@ -145,6 +148,47 @@ class EE_API UITreeView : public UIAbstractTableView {
 
 	mutable std::unordered_map<void*, MetadataForIndex> mViewMetadata;
 
+	struct VisibleRow {
+		ModelIndex index;
+		size_t indentLevel{ 0 };
+	};
+
+	/** The rows currently displayed, in display order. All the rows share the same height, so
+	 * the row at any y-offset is found directly. It's rebuilt lazily after the model structure
+	 * changes and it's updated in place when a node is expanded or collapsed. */
+	mutable std::vector<VisibleRow> mVisibleRows;
+	mutable std::atomic<bool> mVisibleRowsDirty{ true };
+	std::shared_ptr<Model> mClientModel;
+
+	/** The model resource mutex must be held while the rows are used */
+	const std::vector<VisibleRow>& getVisibleRows() const;
+
+	void invalidateVisibleRows();
+
+	void collectVisibleRows( const ModelIndex& parent, size_t indentLevel,
+							 std::vector<VisibleRow>& rows ) const;
+
+	/** @return The visible row of the index, or -1 if the index is not visible */
+	Int64 findVisibleRow( const ModelIndex& index ) const;
+
+	/** @return The first row that can be visible with the current scroll offset */
+	size_t getFirstVisibleRow() const;
+
+	Float getRowOffset( const size_t& row ) const;
+
+	void setIndexOpen( const ModelIndex& index, bool open );
+
+	virtual void onModelUpdate( unsigned flags );
+
+	virtual void onModelUpdated( unsigned flags );
+
+	virtual void modelDidInsertRows( ModelIndex const& parent, int first, int last );
+
+	virtual void modelDidMoveRows( ModelIndex const& sourceParent, int first, int last,
+								   ModelIndex const& targetParent, int targetIndex );
+
+	virtual void modelDidDeleteRows( ModelIndex const& parent, int first, int last );
+
 	virtual size_t getItemCount() const;
 
 	UITreeView::MetadataForIndex& getIndexMetadata( const ModelIndex& index ) const;
@@ -283,6 +283,8 @@ class EE_API UIWindow : public UIWidget {
 
 	virtual void drawShadow();
 
+	virtual bool isDrawCullable() const;
+
 	virtual void onPaddingChange();
 
 	virtual void preDraw();
@@ -0,0 +1,397 @@
+#include <eepp/core/compactstring.hpp>
+#include <eepp/core/utf.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace EE {
+
+namespace {
+
+inline std::size_t utf8SequenceLength( unsigned char lead ) {
+	return lead < 0x80 ? 1 : ( lead < 0xE0 ? 2 : ( lead < 0xF0 ? 3 : 4 ) );
+}
+
+// The stored UTF-8 is always well formed, since it's encoded by the string itself, so it can be
+// decoded without any validation
+inline std::size_t utf8Decode( const char* data, CompactString::CharType& codepoint ) {
+	const unsigned char* p = reinterpret_cast<const unsigned char*>( data );
+
+	if ( p[0] < 0x80 ) {
+		codepoint = p[0];
+		return 1;
+	} else if ( p[0] < 0xE0 ) {
+		codepoint = ( ( p[0] & 0x1F ) << 6 ) | ( p[1] & 0x3F );
+		return 2;
+	} else if ( p[0] < 0xF0 ) {
+		codepoint = ( ( p[0] & 0x0F ) << 12 ) | ( ( p[1] & 0x3F ) << 6 ) | ( p[2] & 0x3F );
+		return 3;
+	}
+
+	codepoint = ( ( p[0] & 0x07 ) << 18 ) | ( ( p[1] & 0x3F ) << 12 ) | ( ( p[2] & 0x3F ) << 6 ) |
+				( p[3] & 0x3F );
+	return 4;
+}
+
+inline bool isAsciiBytes( const char* data, std::size_t size ) {
+	return std::all_of( data, data + size,
+						[]( char c ) { return static_cast<unsigned char>( c ) < 0x80; } );
+}
+
+template <typename Callback> void forEachCodepoint( const CompactString::View& view, Callback cb ) {
+	std::string_view bytes( view.getBytes() );
+
+	if ( CompactString::Encoding::Latin1 == view.getEncoding() ) {
+		for ( char c : bytes )
+			cb( static_cast<unsigned char>( c ) );
+		return;
+	}
+
+	CompactString::CharType codepoint;
+
+	for ( std::size_t pos = 0; pos < bytes.size(); ) {
+		pos += utf8Decode( bytes.data() + pos, codepoint );
+		cb( codepoint );
+	}
+}
+
+} // namespace
+
+const std::size_t CompactString::InvalidPos = std::string::npos;
+
+CompactString::View::View( const CompactString& string ) :
+	mData( string.mData.data() ),
+	mIndex( string.mIndex ? string.mIndex->data() : nullptr ),
+	mLength( string.mLength ),
+	mEncoding( string.mEncoding ),
+	mAscii( string.mAscii ) {}
+
+CompactString::CharType CompactString::View::at( std::size_t pos ) const {
+	if ( pos >= mLength )
+		throw std::out_of_range( "CompactString::View::at" );
+
+	return ( *this )[pos];
+}
+
+CompactString::View CompactString::View::substr( std::size_t pos, std::size_t count ) const {
+	View view( *this );
+	pos = eemin<std::size_t>( pos, mLength );
+	view.mStart = mStart + static_cast<Uint32>( pos );
+	view.mLength = static_cast<Uint32>( eemin<std::size_t>( count, mLength - pos ) );
+	return view;
+}
+
+std::string_view CompactString::View::getBytes() const {
+	if ( 0 == mLength )
+		return std::string_view();
+
+	if ( Encoding::Latin1 == mEncoding )
+		return std::string_view( mData + mStart, mLength );
+
+	// The end is found from the last character since the checkpoint of the end position may not
+	// exist
+	std::size_t start = utf8Offset( mData, mIndex, mStart );
+	std::size_t last = utf8Offset( mData, mIndex, mStart + mLength - 1 );
+	std::size_t end = last + utf8SequenceLength( static_cast<unsigned char>( mData[last] ) );
+
+	return std::string_view( mData + start, end - start );
+}
+
+std::string CompactString::View::toUtf8() const {
+	std::string_view bytes( getBytes() );
+
+	if ( Encoding::Utf8 == mEncoding || mAscii || isAsciiBytes( bytes.data(), bytes.size() ) )
+		return std::string( bytes );
+
+	std::string output;
+	output.reserve( bytes.size() * 2 );
+	forEachCodepoint( *this,
+					  [&output]( CharType codepoint ) {
+						  Utf8::encode( codepoint, std::back_inserter( output ) );
+					  } );
+	return output;
+}
+
+String CompactString::View::toString() const {
+	String::StringType output;
+	output.reserve( mLength );
+	forEachCodepoint( *this, [&output]( CharType codepoint ) { output.push_back( codepoint ); } );
+	return String( output );
+}
+
+bool CompactString::View::operator==( const View& other ) const {
+	if ( mLength != other.mLength )
+		return false;
+
+	// The encoding is chosen from the content, so equal strings share the encoding, but a view of
+	// a UTF-8 string can still contain only Latin-1 characters
+	if ( mEncoding == other.mEncoding )
+		return getBytes() == other.getBytes();
+
+	for ( std::size_t i = 0; i < mLength; ++i )
+		if ( ( *this )[i] != other[i] )
+			return false;
+
+	return true;
+}
+
+CompactString CompactString::fromUtf8( const std::string_view& utf8String ) {
+	CompactString string;
+	std::string_view bytes( utf8String );
+
+	// Skip BOM
+	if ( bytes.size() >= 3 && (char)0xef == bytes[0] && (char)0xbb == bytes[1] &&
+		 (char)0xbf == bytes[2] ) {
+		bytes.remove_prefix( 3 );
+	}
+
+	// ASCII is stored as is
+	if ( isAsciiBytes( bytes.data(), bytes.size() ) ) {
+		string.mData.assign( bytes.data(), bytes.size() );
+		string.mLength = static_cast<Uint32>( bytes.size() );
+		return string;
+	}
+
+	string.reserve( bytes.size() );
+
+	Uint32 codepoint;
+	auto it = bytes.begin();
+
+	while ( it < bytes.end() ) {
+		it = Utf8::decode( it, bytes.end(), codepoint );
+		string.push_back( codepoint );
+	}
+
+	return string;
+}
+
+CompactString CompactString::fromLatin1( const std::string_view& latin1String ) {
+	CompactString string;
+	string.mData.assign( latin1String.data(), latin1String.size() );
+	string.mLength = static_cast<Uint32>( latin1String.size() );
+	string.mAscii = isAsciiBytes( latin1String.data(), latin1String.size() );
+	return string;
+}
+
+CompactString::CompactString( const char* utf8String ) :
+	CompactString( fromUtf8( NULL != utf8String ? std::string_view( utf8String )
+												: std::string_view() ) ) {}
+
+CompactString::CompactString( const std::string& utf8String ) :
+	CompactString( fromUtf8( std::string_view( utf8String ) ) ) {}
+
+CompactString::CompactString( const String& string ) {
+	assign( string.data(), string.data() + string.size() );
+}
+
+CompactString::CompactString( const String::View& string ) {
+	assign( string.data(), string.data() + string.size() );
+}
+
+CompactString::CompactString( const View& view ) {
+	append( view );
+}
+
+CompactString::CompactString( const CompactString& other ) :
+	mData( other.mData ),
+	mIndex( other.mIndex ? std::make_unique<std::vector<Uint32>>( *other.mIndex ) : nullptr ),
+	mLength( other.mLength ),
+	mEncoding( other.mEncoding ),
+	mAscii( other.mAscii ) {}
+
+// The moved string must be left empty, a UTF-8 string without its index can't be read
+CompactString::CompactString( CompactString&& other ) noexcept :
+	mData( std::move( other.mData ) ),
+	mIndex( std::move( other.mIndex ) ),
+	mLength( other.mLength ),
+	mEncoding( other.mEncoding ),
+	mAscii( other.mAscii ) {
+	other.clear();
+}
+
+CompactString& CompactString::operator=( const CompactString& other ) {
+	if ( this != &other ) {
+		mData = other.mData;
+		mIndex = other.mIndex ? std::make_unique<std::vector<Uint32>>( *other.mIndex ) : nullptr;
+		mLength = other.mLength;
+		mEncoding = other.mEncoding;
+		mAscii = other.mAscii;
+	}
+
+	return *this;
+}
+
+CompactString& CompactString::operator=( CompactString&& other ) noexcept {
+	if ( this != &other ) {
+		mData = std::move( other.mData );
+		mIndex = std::move( other.mIndex );
+		mLength = other.mLength;
+		mEncoding = other.mEncoding;
+		mAscii = other.mAscii;
+		other.clear();
+	}
+
+	return *this;
+}
+
+CompactString::CharType CompactString::at( std::size_t pos ) const {
+	if ( pos >= mLength )
+		throw std::out_of_range( "CompactString::at" );
+
+	return ( *this )[pos];
+}
+
+CompactString::View CompactString::substr( std::size_t pos, std::size_t count ) const {
+	return View( *this ).substr( pos, count );
+}
+
+std::string CompactString::toUtf8() const {
+	if ( Encoding::Utf8 == mEncoding || mAscii )
+		return mData;
+
+	return View( *this ).toUtf8();
+}
+
+String CompactString::toString() const {
+	return View( *this ).toString();
+}
+
+void CompactString::clear() {
+	mData.clear();
+	mIndex.reset();
+	mLength = 0;
+	mEncoding = Encoding::Latin1;
+	mAscii = true;
+}
+
+void CompactString::reserve( std::size_t bytes ) {
+	mData.reserve( bytes );
+}
+
+void CompactString::push_back( CharType codepoint ) {
+	if ( Encoding::Latin1 == mEncoding ) {
+		if ( codepoint < 0x100 ) {
+			mData.push_back( static_cast<char>( codepoint ) );
+			mAscii = mAscii && codepoint < 0x80;
+			++mLength;
+			return;
+		}
+
+		promoteToUtf8();
+	}
+
+	appendUtf8( codepoint );
+}
+
+CompactString& CompactString::append( const View& view ) {
+	if ( view.empty() )
+		return *this;
+
+	// Appending a view of itself would read from the reallocated buffer
+	if ( view.mData == mData.data() && Encoding::Utf8 == view.mEncoding ) {
+		CompactString copy( *this );
+		return append( View( copy ).substr( view.mStart, view.mLength ) );
+	}
+
+	if ( Encoding::Latin1 == mEncoding && Encoding::Latin1 == view.mEncoding ) {
+		std::string_view bytes( view.getBytes() );
+		mAscii = mAscii && ( view.mAscii || isAsciiBytes( bytes.data(), bytes.size() ) );
+		mData.append( bytes.data(), bytes.size() );
+		mLength += view.mLength;
+		return *this;
+	}
+
+	forEachCodepoint( view, [this]( CharType codepoint ) { push_back( codepoint ); } );
+
+	return *this;
+}
+
+CompactString& CompactString::operator+=( CharType codepoint ) {
+	push_back( codepoint );
+	return *this;
+}
+
+String::HashType CompactString::getHash() const {
+	return String::hash( mData.data(), mData.size() );
+}
+
+std::size_t CompactString::getMemoryUsage() const {
+	std::size_t size = sizeof( CompactString );
+	const char* data = mData.data();
+
+	// Only count the buffer when it isn't stored inline
+	if ( data < reinterpret_cast<const char*>( this ) ||
+		 data >= reinterpret_cast<const char*>( this ) + sizeof( CompactString ) )
+		size += mData.capacity() + 1;
+
+	if ( mIndex )
+		size += sizeof( std::vector<Uint32> ) + mIndex->capacity() * sizeof( Uint32 );
+
+	return size;
+}
+
+bool CompactString::operator==( const CompactString& other ) const {
+	return mLength == other.mLength && mEncoding == other.mEncoding && mData == other.mData;
+}
+
+CompactString::CharType CompactString::utf8At( const char* data, const Uint32* index,
+											   std::size_t pos ) {
+	CharType codepoint;
+	utf8Decode( data + utf8Offset( data, index, pos ), codepoint );
+	return codepoint;
+}
+
+std::size_t CompactString::utf8Offset( const char* data, const Uint32* index, std::size_t pos ) {
+	std::size_t offset = index[pos / IndexStep];
+
+	for ( std::size_t i = pos % IndexStep; i > 0; --i )
+		offset += utf8SequenceLength( static_cast<unsigned char>( data[offset] ) );
+
+	return offset;
+}
+
+void CompactString::assign( const CharType* begin, const CharType* end ) {
+	clear();
+
+	// Choose the final encoding first to avoid promoting the string while it's filled
+	if ( std::any_of( begin, end, []( CharType codepoint ) { return codepoint >= 0x100; } ) ) {
+		promoteToUtf8();
+		mData.reserve( ( end - begin ) * 2 );
+	} else {
+		mData.reserve( end - begin );
+	}
+
+	for ( const CharType* it = begin; it != end; ++it )
+		push_back( *it );
+}
+
+void CompactString::promoteToUtf8() {
+	std::string latin1( std::move( mData ) );
+	Uint32 length = mLength;
+
+	mData.clear();
+	mData.reserve( latin1.size() + latin1.size() / 2 + 4 );
+	mIndex = std::make_unique<std::vector<Uint32>>();
+	mIndex->reserve( length / IndexStep + 1 );
+	mEncoding = Encoding::Utf8;
+	mLength = 0;
+
+	for ( char c : latin1 )
+		appendUtf8( static_cast<unsigned char>( c ) );
+}
+
+void CompactString::appendUtf8( CharType codepoint ) {
+	// Invalid codepoints must still take one character or the index would be broken
+	if ( codepoint > 0x10FFFF || ( codepoint >= 0xD800 && codepoint <= 0xDFFF ) )
+		codepoint = 0xFFFD;
+
+	if ( 0 == mLength % IndexStep )
+		mIndex->push_back( static_cast<Uint32>( mData.size() ) );
+
+	Utf8::encode( codepoint, std::back_inserter( mData ) );
+	mAscii = mAscii && codepoint < 0x80;
+	++mLength;
+}
+
+} // namespace EE
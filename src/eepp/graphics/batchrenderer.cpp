@@ -1,11 +1,18 @@
 #include <eepp/graphics/batchrenderer.hpp>
 #include <eepp/graphics/globalbatchrenderer.hpp>
+#include <eepp/graphics/renderer/clippingmask.hpp>
 #include <eepp/graphics/renderer/openglext.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/texture.hpp>
 
 namespace EE { namespace Graphics {
 
+// Quads are batched as four vertices if the renderer can draw them without expanding them into
+// two triangles
+static inline bool quadsAsFourVertexs() {
+	return GLi->quadsSupported() || GLi->quadsIndexedSupported();
+}
+
 BatchRenderer* BatchRenderer::New() {
 	return eeNew( BatchRenderer, () );
 }
@@ -41,11 +48,60 @@ void BatchRenderer::allocVertexs( const unsigned int& size ) {
 
 void BatchRenderer::drawOpt() {
 	if ( mForceRendering )
-		flush();
+		draw();
 }
 
 void BatchRenderer::draw() {
 	flush();
+
+	if ( !mDrawCommands.empty() ) {
+		if ( GlobalBatchRenderer::instance() != this )
+			GlobalBatchRenderer::instance()->draw();
+
+		mDrawCommands.replay( *this );
+	}
+}
+
+void BatchRenderer::setDeferred( const bool& deferred ) {
+	if ( mDeferred == deferred )
+		return;
+
+	draw();
+
+	mDeferred = deferred;
+}
+
+void BatchRenderer::setCapture( DrawCommandList* capture ) {
+	draw();
+
+	mCapture = capture;
+}
+
+bool BatchRenderer::play( DrawCommandList& list, const Vector2f& offset ) {
+	draw();
+
+	return list.play( *this, offset );
+}
+
+void BatchRenderer::drawVertexs( const Texture* texture, const BlendMode& blend,
+								 const PrimitiveType& mode, const VertexData* vertices,
+								 const Uint32& count ) {
+	draw();
+
+	if ( 0 == count )
+		return;
+
+	DrawCommandState state;
+	state.texture = texture;
+	state.coordinateType =
+		NULL != texture ? texture->getCoordinateType() : Texture::CoordinateType::Normalized;
+	state.blend = blend;
+	state.mode = mode;
+	state.lineSmooth = GLi->isLineSmooth();
+	state.polygonSmooth = GLi->isPolygonSmooth();
+	state.primitiveSize = getPrimitiveSize( texture, mode );
+
+	drawCommand( state, vertices, count );
 }
 
 void BatchRenderer::setTexture( const Texture* texture, Texture::CoordinateType coordinateType ) {
@@ -90,82 +146,156 @@ void BatchRenderer::flush() {
 	if ( mNumVertex == 0 )
 		return;
 
+	Uint32 NumVertex = mNumVertex;
+	mNumVertex = 0;
+
+	if ( mDeferred ) {
+		mDrawCommands.add( getDrawCommandState(), mVertex, NumVertex );
+		return;
+	}
+
 	if ( GlobalBatchRenderer::instance() != this )
 		GlobalBatchRenderer::instance()->draw();
 
-	Uint32 NumVertex = mNumVertex;
-	mNumVertex = 0;
+	drawCommand( getDrawCommandState(), mVertex, NumVertex );
+}
+
+DrawCommandState BatchRenderer::getDrawCommandState() const {
+	DrawCommandState state;
+	state.texture = mTexture;
+	state.coordinateType = mCoordinateType;
+	state.blend = mBlend;
+	state.mode = mCurrentMode;
+	state.rotation = mRotation;
+	state.scale = mScale;
+	state.position = mPosition;
+	state.center = mCenter;
+	state.lineSmooth = GLi->isLineSmooth();
+	state.polygonSmooth = GLi->isPolygonSmooth();
+	state.primitiveSize = getPrimitiveSize( mTexture, mCurrentMode );
+	return state;
+}
+
+Float BatchRenderer::getPrimitiveSize( const Texture* texture, const PrimitiveType& mode ) const {
+	switch ( mode ) {
+		case PRIMITIVE_POINTS:
+			// Textured points are drawn as point sprites of the texture size
+			return NULL != texture ? (Float)texture->getWidth() : GLi->pointSize();
+		case PRIMITIVE_LINES:
+		case PRIMITIVE_LINE_LOOP:
+		case PRIMITIVE_LINE_STRIP:
+			return GLi->lineWidth();
+		default:
+			return 1.f;
+	}
+}
+
+void BatchRenderer::drawCommand( const DrawCommandState& state, const VertexData* vertices,
+								 const Uint32& NumVertex ) {
+	const Texture* texture = state.texture;
+	bool createMatrix = state.hasTransform();
+	bool lineSmooth = GLi->isLineSmooth();
+	bool polygonSmooth = GLi->isPolygonSmooth();
+
+	if ( NULL != mCapture )
+		mCapture->add( state, vertices, NumVertex );
 
-	bool createMatrix = ( mRotation || mScale != 1.0f || mPosition.x || mPosition.y );
+	// Recorded commands can be rendered after the smoothing state was restored
+	if ( lineSmooth != state.lineSmooth )
+		GLi->lineSmooth( state.lineSmooth );
 
-	BlendMode::setMode( mBlend );
+	if ( polygonSmooth != state.polygonSmooth )
+		GLi->polygonSmooth( state.polygonSmooth );
 
-	if ( mCurrentMode == PRIMITIVE_POINTS && NULL != mTexture ) {
+	BlendMode::setMode( state.blend );
+
+	if ( state.mode == PRIMITIVE_POINTS && NULL != texture ) {
 		GLi->enable( GL_POINT_SPRITE );
-		GLi->pointSize( (float)mTexture->getWidth() );
+		GLi->pointSize( (float)texture->getWidth() );
 	}
 
 	if ( createMatrix ) {
 		GLi->loadIdentity();
 		GLi->pushMatrix();
 
-		GLi->translatef( mPosition.x + mCenter.x, mPosition.y + mCenter.y, 0.0f );
-		GLi->rotatef( mRotation, 0.0f, 0.0f, 1.0f );
-		GLi->scalef( mScale.x, mScale.y, 1.0f );
-		GLi->translatef( -mCenter.x, -mCenter.y, 0.0f );
+		GLi->translatef( state.position.x + state.center.x, state.position.y + state.center.y,
+						 0.0f );
+		GLi->rotatef( state.rotation, 0.0f, 0.0f, 1.0f );
+		GLi->scalef( state.scale.x, state.scale.y, 1.0f );
+		GLi->translatef( -state.center.x, -state.center.y, 0.0f );
 	}
 
 	Uint32 alloc = sizeof( VertexData ) * NumVertex;
+	const char* data = reinterpret_cast<const char*>( vertices );
+
+	// The vertex pointer goes first so the streaming renderers upload the array only once
+	GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), data, alloc );
 
-	if ( NULL != mTexture ) {
-		const_cast<Texture*>( mTexture )->bind( mCoordinateType );
-		GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ),
-							  reinterpret_cast<char*>( &mVertex[0] ) + sizeof( Vector2f ), alloc );
+	if ( NULL != texture ) {
+		const_cast<Texture*>( texture )->bind( state.coordinateType );
+		GLi->texCoordPointer( 2, GL_FP, sizeof( VertexData ), data + sizeof( Vector2f ), alloc );
 	} else {
 		GLi->disable( GL_TEXTURE_2D );
 		GLi->disableClientState( GL_TEXTURE_COORD_ARRAY );
 	}
 
-	GLi->vertexPointer( 2, GL_FP, sizeof( VertexData ), reinterpret_cast<char*>( &mVertex[0] ),
-						alloc );
-	GLi->colorPointer(
-		4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
-		reinterpret_cast<char*>( &mVertex[0] ) + sizeof( Vector2f ) + sizeof( Vector2f ), alloc );
+	GLi->colorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VertexData ),
+					   data + sizeof( Vector2f ) + sizeof( Vector2f ), alloc );
 
 	if ( !GLi->quadsSupported() ) {
-		if ( PRIMITIVE_QUADS == mCurrentMode ) {
-			GLi->drawArrays( PRIMITIVE_TRIANGLES, 0, NumVertex );
-		} else if ( PRIMITIVE_POLYGON == mCurrentMode ) {
+		if ( PRIMITIVE_QUADS == state.mode ) {
+			if ( GLi->quadsIndexedSupported() ) {
+				GLi->drawQuadsIndexed( 0, NumVertex );
+			} else {
+				GLi->drawArrays( PRIMITIVE_TRIANGLES, 0, NumVertex );
+			}
+		} else if ( PRIMITIVE_POLYGON == state.mode ) {
 			GLi->drawArrays( PRIMITIVE_TRIANGLE_FAN, 0, NumVertex );
 		} else {
-			GLi->drawArrays( mCurrentMode, 0, NumVertex );
+			GLi->drawArrays( state.mode, 0, NumVertex );
 		}
 	} else {
-		GLi->drawArrays( mCurrentMode, 0, NumVertex );
+		GLi->drawArrays( state.mode, 0, NumVertex );
 	}
 
 	if ( createMatrix ) {
 		GLi->popMatrix();
 	}
 
-	if ( mCurrentMode == PRIMITIVE_POINTS && NULL != mTexture ) {
+	if ( state.mode == PRIMITIVE_POINTS && NULL != texture ) {
 		GLi->disable( GL_POINT_SPRITE );
 	}
 
-	if ( NULL == mTexture ) {
+	if ( NULL == texture ) {
 		GLi->enable( GL_TEXTURE_2D );
 		GLi->enableClientState( GL_TEXTURE_COORD_ARRAY );
 	}
+
+	if ( lineSmooth != state.lineSmooth )
+		GLi->lineSmooth( lineSmooth );
+
+	if ( polygonSmooth != state.polygonSmooth )
+		GLi->polygonSmooth( polygonSmooth );
+
+	mDrawCallsCount++;
+}
+
+void BatchRenderer::clipEnable( const Rectf& rect ) {
+	GLi->getClippingMask()->clipEnable( rect.Left, rect.Top, rect.getWidth(), rect.getHeight() );
+}
+
+void BatchRenderer::clipDisable() {
+	GLi->getClippingMask()->clipDisable();
 }
 
 void BatchRenderer::batchQuad( const Float& x, const Float& y, const Float& width,
 							   const Float& height ) {
-	if ( mNumVertex + ( GLi->quadsSupported() ? 3 : 5 ) >= mVertexSize )
+	if ( mNumVertex + ( quadsAsFourVertexs() ? 3 : 5 ) >= mVertexSize )
 		return;
 
 	setDrawMode( PRIMITIVE_QUADS, mForceBlendMode );
 
-	if ( GLi->quadsSupported() ) {
+	if ( quadsAsFourVertexs() ) {
 		mTVertex = &mVertex[mNumVertex];
 		mTVertex->pos.x = x;
 		mTVertex->pos.y = y;
@@ -231,12 +361,12 @@ void BatchRenderer::batchQuad( const Float& x, const Float& y, const Float& widt
 }
 
 void BatchRenderer::batchQuad( const Rectf& rect ) {
-	if ( mNumVertex + ( GLi->quadsSupported() ? 3 : 5 ) >= mVertexSize )
+	if ( mNumVertex + ( quadsAsFourVertexs() ? 3 : 5 ) >= mVertexSize )
 		return;
 
 	setDrawMode( PRIMITIVE_QUADS, mForceBlendMode );
 
-	if ( GLi->quadsSupported() ) {
+	if ( quadsAsFourVertexs() ) {
 		mTVertex = &mVertex[mNumVertex];
 		mTVertex->pos.x = rect.Left;
 		mTVertex->pos.y = rect.Top;
@@ -303,7 +433,7 @@ void BatchRenderer::batchQuad( const Rectf& rect ) {
 
 void BatchRenderer::batchQuadEx( Float x, Float y, Float width, Float height, Float angle,
 								 Vector2f scale, OriginPoint originPoint ) {
-	if ( mNumVertex + ( GLi->quadsSupported() ? 3 : 5 ) >= mVertexSize )
+	if ( mNumVertex + ( quadsAsFourVertexs() ? 3 : 5 ) >= mVertexSize )
 		return;
 
 	if ( originPoint.OriginType == OriginPoint::OriginCenter ) {
@@ -324,7 +454,7 @@ void BatchRenderer::batchQuadEx( Float x, Float y, Float width, Float height, Fl
 
 	setDrawMode( PRIMITIVE_QUADS, mForceBlendMode );
 
-	if ( GLi->quadsSupported() ) {
+	if ( quadsAsFourVertexs() ) {
 		mTVertex = &mVertex[mNumVertex];
 		mTVertex->pos.x = x;
 		mTVertex->pos.y = y;
@@ -400,12 +530,12 @@ void BatchRenderer::batchQuadEx( Float x, Float y, Float width, Float height, Fl
 void BatchRenderer::batchQuadFree( const Float& x0, const Float& y0, const Float& x1,
 								   const Float& y1, const Float& x2, const Float& y2,
 								   const Float& x3, const Float& y3 ) {
-	if ( mNumVertex + ( GLi->quadsSupported() ? 3 : 5 ) >= mVertexSize )
+	if ( mNumVertex + ( quadsAsFourVertexs() ? 3 : 5 ) >= mVertexSize )
 		return;
 
 	setDrawMode( PRIMITIVE_QUADS, mForceBlendMode );
 
-	if ( GLi->quadsSupported() ) {
+	if ( quadsAsFourVertexs() ) {
 		mTVertex = &mVertex[mNumVertex];
 		mTVertex->pos.x = x0;
 		mTVertex->pos.y = y0;
@@ -476,7 +606,7 @@ void BatchRenderer::batchQuadFreeEx( const Float& x0, const Float& y0, const Flo
 									 const Float& y1, const Float& x2, const Float& y2,
 									 const Float& x3, const Float& y3, const Float& Angle,
 									 const Float& Scale ) {
-	if ( mNumVertex + ( GLi->quadsSupported() ? 3 : 5 ) >= mVertexSize )
+	if ( mNumVertex + ( quadsAsFourVertexs() ? 3 : 5 ) >= mVertexSize )
 		return;
 
 	Quad2f mQ;
@@ -498,7 +628,7 @@ void BatchRenderer::batchQuadFreeEx( const Float& x0, const Float& y0, const Flo
 
 	setDrawMode( PRIMITIVE_QUADS, mForceBlendMode );
 
-	if ( GLi->quadsSupported() ) {
+	if ( quadsAsFourVertexs() ) {
 		mTVertex = &mVertex[mNumVertex];
 		mTVertex->pos.x = mQ[0].x;
 		mTVertex->pos.y = mQ[0].y;
@@ -983,6 +1113,9 @@ void BatchRenderer::batchPolygonByPoint( const Vector2f& Vector ) {
 }
 
 void BatchRenderer::setLineWidth( const Float& lineWidth ) {
+	if ( mDeferred )
+		draw();
+
 	GLi->lineWidth( lineWidth );
 }
 
@@ -997,6 +1130,9 @@ Float BatchRenderer::getLineWidth() {
 }
 
 void BatchRenderer::setPointSize( const Float& pointSize ) {
+	if ( mDeferred )
+		draw();
+
 	GLi->pointSize( pointSize );
 }
 
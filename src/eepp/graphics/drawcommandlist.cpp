@@ -0,0 +1,283 @@
+#include <cfloat>
+#include <eepp/graphics/drawcommandlist.hpp>
+#include <eepp/graphics/texturefactory.hpp>
+
+namespace EE { namespace Graphics {
+
+bool DrawCommandState::hasTransform() const {
+	return rotation != 0.f || scale != Vector2f::One || position != Vector2f::Zero;
+}
+
+bool DrawCommandState::operator==( const DrawCommandState& other ) const {
+	return texture == other.texture && coordinateType == other.coordinateType &&
+		   blend == other.blend && mode == other.mode && rotation == other.rotation &&
+		   scale == other.scale && position == other.position && center == other.center &&
+		   lineSmooth == other.lineSmooth && polygonSmooth == other.polygonSmooth;
+}
+
+static bool isMergeableMode( const PrimitiveType& mode ) {
+	switch ( mode ) {
+		case PRIMITIVE_QUADS:
+		case PRIMITIVE_TRIANGLES:
+		case PRIMITIVE_LINES:
+		case PRIMITIVE_POINTS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool isLineOrPointMode( const PrimitiveType& mode ) {
+	switch ( mode ) {
+		case PRIMITIVE_POINTS:
+		case PRIMITIVE_LINES:
+		case PRIMITIVE_LINE_LOOP:
+		case PRIMITIVE_LINE_STRIP:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Inclusive test, degenerate bounds (a single point, an horizontal or vertical line) still
+// overlap whatever they touch.
+static bool boundsOverlap( const Rectf& a, const Rectf& b ) {
+	return a.Left <= b.Right && a.Top <= b.Bottom && b.Left <= a.Right && b.Top <= a.Bottom;
+}
+
+void DrawCommandList::Recorder::drawCommand( const DrawCommandState& state, const VertexData*,
+											 const Uint32& count ) {
+	if ( !mStates.empty() ) {
+		const DrawCommandState& last = mStates.back();
+		if ( last.texture != state.texture || last.coordinateType != state.coordinateType )
+			mTextureChanges++;
+		if ( last.blend != state.blend )
+			mBlendChanges++;
+		if ( last.mode != state.mode )
+			mModeChanges++;
+	}
+
+	mStates.push_back( state );
+	mDrawCalls++;
+	mVertexCount += count;
+}
+
+void DrawCommandList::Recorder::clipEnable( const Rectf& ) {
+	mClipChanges++;
+}
+
+void DrawCommandList::Recorder::clipDisable() {
+	mClipChanges++;
+}
+
+void DrawCommandList::Recorder::reset() {
+	mStates.clear();
+	mDrawCalls = 0;
+	mTextureChanges = 0;
+	mBlendChanges = 0;
+	mModeChanges = 0;
+	mVertexCount = 0;
+	mClipChanges = 0;
+}
+
+void DrawCommandList::add( const DrawCommandState& state, const VertexData* vertices,
+						   const Uint32& count ) {
+	if ( 0 == count )
+		return;
+
+	Command cmd;
+	cmd.type = CommandType::Draw;
+	cmd.state = state;
+	cmd.textureId = NULL != state.texture ? state.texture->getTextureId() : 0;
+	cmd.first = static_cast<Uint32>( mVertices.size() );
+	cmd.count = count;
+	cmd.next = -1;
+
+	if ( state.hasTransform() ) {
+		// The vertices are in the batch space, assume that they can cover anything
+		cmd.bounds = Rectf( -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX );
+	} else {
+		cmd.bounds = Rectf( vertices[0].pos.x, vertices[0].pos.y, vertices[0].pos.x,
+							vertices[0].pos.y );
+		for ( Uint32 i = 1; i < count; i++ )
+			cmd.bounds.expand( vertices[i].pos );
+
+		// Lines and points cover half their width around the vertices
+		if ( isLineOrPointMode( state.mode ) ) {
+			Float half = eemax( state.primitiveSize, 1.f ) * 0.5f;
+			cmd.bounds = Rectf( cmd.bounds.Left - half, cmd.bounds.Top - half,
+								cmd.bounds.Right + half, cmd.bounds.Bottom + half );
+		}
+	}
+
+	mVertices.insert( mVertices.end(), vertices, vertices + count );
+	mCommands.emplace_back( std::move( cmd ) );
+}
+
+void DrawCommandList::addClipEnable( const Rectf& rect ) {
+	Command cmd{};
+	cmd.type = CommandType::ClipEnable;
+	cmd.bounds = rect;
+	cmd.next = -1;
+	mCommands.emplace_back( std::move( cmd ) );
+}
+
+void DrawCommandList::addClipDisable() {
+	Command cmd{};
+	cmd.type = CommandType::ClipDisable;
+	cmd.next = -1;
+	mCommands.emplace_back( std::move( cmd ) );
+}
+
+void DrawCommandList::append( const DrawCommandList& other ) {
+	Uint32 vertexOffset = static_cast<Uint32>( mVertices.size() );
+	mVertices.insert( mVertices.end(), other.mVertices.begin(), other.mVertices.end() );
+	mCommands.reserve( mCommands.size() + other.mCommands.size() );
+	for ( const Command& cmd : other.mCommands ) {
+		mCommands.push_back( cmd );
+		mCommands.back().first += vertexOffset;
+		mCommands.back().next = -1;
+	}
+	if ( !other.mValid )
+		mValid = false;
+}
+
+void DrawCommandList::replay( Backend& backend ) {
+	Uint32 begin = 0;
+	Uint32 size = static_cast<Uint32>( mCommands.size() );
+
+	for ( Uint32 i = 0; i < size; i++ ) {
+		const Command& cmd = mCommands[i];
+		if ( cmd.type == CommandType::Draw )
+			continue;
+
+		replayScope( backend, begin, i );
+
+		if ( cmd.type == CommandType::ClipEnable ) {
+			backend.clipEnable( cmd.bounds );
+		} else {
+			backend.clipDisable();
+		}
+
+		begin = i + 1;
+	}
+
+	replayScope( backend, begin, size );
+
+	clear();
+}
+
+void DrawCommandList::replayScope( Backend& backend, Uint32 begin, Uint32 end ) {
+	mRuns.clear();
+
+	for ( Uint32 i = begin; i < end; i++ ) {
+		Command& cmd = mCommands[i];
+		bool mergeable = isMergeableMode( cmd.state.mode );
+		Int64 target = -1;
+
+		if ( mergeable ) {
+			// Walk back over the runs that don't overlap the command looking for one with the
+			// same state. Stop at the first overlapping run, the command can't be drawn before it.
+			size_t stop = mRuns.size() > LookBehind ? mRuns.size() - LookBehind : 0;
+			for ( size_t r = mRuns.size(); r > stop; r-- ) {
+				const Run& run = mRuns[r - 1];
+				if ( run.mergeable && mCommands[run.head].state == cmd.state ) {
+					target = static_cast<Int64>( r - 1 );
+					break;
+				}
+				if ( boundsOverlap( run.bounds, cmd.bounds ) )
+					break;
+			}
+		}
+
+		if ( target >= 0 ) {
+			Run& run = mRuns[target];
+			mCommands[run.tail].next = static_cast<Int32>( i );
+			run.tail = i;
+			run.count += cmd.count;
+			run.bounds.expand( cmd.bounds );
+		} else {
+			mRuns.push_back( { i, i, cmd.count, cmd.bounds, mergeable } );
+		}
+	}
+
+	for ( const Run& run : mRuns ) {
+		const Command& head = mCommands[run.head];
+
+		if ( run.head == run.tail ) {
+			backend.drawCommand( head.state, &mVertices[head.first], head.count );
+			continue;
+		}
+
+		mScratch.clear();
+		mScratch.reserve( run.count );
+		for ( Int32 c = static_cast<Int32>( run.head ); c != -1; c = mCommands[c].next ) {
+			const Command& cmd = mCommands[c];
+			mScratch.insert( mScratch.end(), mVertices.begin() + cmd.first,
+							 mVertices.begin() + cmd.first + cmd.count );
+		}
+
+		backend.drawCommand( head.state, mScratch.data(), run.count );
+	}
+
+	mRuns.clear();
+}
+
+bool DrawCommandList::play( Backend& backend, const Vector2f& offset ) {
+	TextureFactory* textureFactory = TextureFactory::instance();
+	bool translate = offset != Vector2f::Zero;
+
+	for ( const Command& cmd : mCommands ) {
+		if ( cmd.type != CommandType::Draw )
+			continue;
+
+		if ( NULL != cmd.state.texture &&
+			 ( !textureFactory->existsId( cmd.textureId ) ||
+			   textureFactory->getTexture( cmd.textureId ) != cmd.state.texture ) )
+			return false;
+
+		// Translating the vertices of a rotated or scaled batch would also move them
+		if ( translate && cmd.state.hasTransform() )
+			return false;
+	}
+
+	for ( const Command& cmd : mCommands ) {
+		switch ( cmd.type ) {
+			case CommandType::Draw: {
+				if ( !translate ) {
+					backend.drawCommand( cmd.state, &mVertices[cmd.first], cmd.count );
+					break;
+				}
+
+				mScratch.assign( mVertices.begin() + cmd.first,
+								 mVertices.begin() + cmd.first + cmd.count );
+				for ( VertexData& vertex : mScratch )
+					vertex.pos += offset;
+
+				backend.drawCommand( cmd.state, mScratch.data(), cmd.count );
+				break;
+			}
+			case CommandType::ClipEnable: {
+				backend.clipEnable( Rectf( cmd.bounds.Left + offset.x, cmd.bounds.Top + offset.y,
+										   cmd.bounds.Right + offset.x,
+										   cmd.bounds.Bottom + offset.y ) );
+				break;
+			}
+			case CommandType::ClipDisable: {
+				backend.clipDisable();
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+void DrawCommandList::clear() {
+	mVertices.clear();
+	mCommands.clear();
+	mRuns.clear();
+	mValid = true;
+}
+
+}} // namespace EE::Graphics
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <eepp/graphics/image.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
+#include <eepp/graphics/pixelkernels.hpp>
 #include <eepp/graphics/stbi_iocb.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/log.hpp>
@@ -20,6 +21,8 @@
 
 namespace EE { namespace Graphics {
 
+using namespace Private;
+
 static const char* get_resampler_name( Image::ResamplerFilter filter ) {
 	switch ( filter ) {
 		case Image::ResamplerFilter::RESAMPLER_BOX:
@@ -771,42 +774,10 @@ bool Image::saveToFile( const std::string& filepath, const SaveType& Format ) {
 }
 
 void Image::replaceColor( const Color& ColorKey, const Color& NewColor ) {
-	unsigned int Pos = 0;
-
 	if ( NULL == mPixels )
 		return;
 
-	unsigned int size = mWidth * mHeight;
-
-	for ( unsigned int i = 0; i < size; i++ ) {
-		Pos = i * mChannels;
-
-		if ( 4 == mChannels ) {
-			if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g &&
-				 mPixels[Pos + 2] == ColorKey.b && mPixels[Pos + 3] == ColorKey.a ) {
-				mPixels[Pos] = NewColor.r;
-				mPixels[Pos + 1] = NewColor.g;
-				mPixels[Pos + 2] = NewColor.b;
-				mPixels[Pos + 3] = NewColor.a;
-			}
-		} else if ( 3 == mChannels ) {
-			if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g &&
-				 mPixels[Pos + 2] == ColorKey.b ) {
-				mPixels[Pos] = NewColor.r;
-				mPixels[Pos + 1] = NewColor.g;
-				mPixels[Pos + 2] = NewColor.b;
-			}
-		} else if ( 2 == mChannels ) {
-			if ( mPixels[Pos] == ColorKey.r && mPixels[Pos + 1] == ColorKey.g ) {
-				mPixels[Pos] = NewColor.r;
-				mPixels[Pos + 1] = NewColor.g;
-			}
-		} else if ( 1 == mChannels ) {
-			if ( mPixels[Pos] == ColorKey.r ) {
-				mPixels[Pos] = NewColor.r;
-			}
-		}
-	}
+	PixelKernels::replaceColor( mPixels, mWidth * mHeight, mChannels, ColorKey, NewColor );
 }
 
 void Image::createMaskFromColor( const Color& ColorKey, Uint8 Alpha ) {
@@ -821,21 +792,7 @@ void Image::fillWithColor( const Color& Color ) {
 	if ( NULL == mPixels )
 		return;
 
-	unsigned int z;
-	unsigned int size = mWidth * mHeight;
-
-	for ( unsigned int i = 0; i < size; i += mChannels ) {
-		for ( z = 0; z < mChannels; z++ ) {
-			if ( 0 == z )
-				mPixels[i + z] = Color.r;
-			else if ( 1 == z )
-				mPixels[i + z] = Color.g;
-			else if ( 2 == z )
-				mPixels[i + z] = Color.b;
-			else if ( 3 == z )
-				mPixels[i + z] = Color.a;
-		}
-	}
+	PixelKernels::fill( mPixels, mWidth * mHeight, mChannels, Color );
 }
 
 void Image::copyImage( Graphics::Image* image, const Uint32& x, const Uint32& y ) {
@@ -845,10 +802,14 @@ void Image::copyImage( Graphics::Image* image, const Uint32& x, const Uint32& y
 		unsigned int dHeight = image->getHeight();
 
 		if ( mChannels != image->getChannels() ) {
+			// Convert per row
 			for ( unsigned int ty = 0; ty < dHeight; ty++ ) {
-				for ( unsigned int tx = 0; tx < dWidth; tx++ ) {
-					setPixel( x + tx, y + ty, image->getPixel( tx, ty ) );
-				}
+				Uint8* pDst = &mPixels[( x + ( ( ty + y ) * mWidth ) ) * mChannels];
+				const Uint8* pSrc =
+					&( ( image->getPixelsPtr() )[( ty * dWidth ) * image->getChannels()] );
+
+				PixelKernels::convertChannels( pSrc, image->getChannels(), pDst, mChannels,
+											   dWidth );
 			}
 		} else {
 			// Copy per row
@@ -935,9 +896,7 @@ void Image::flip() {
 	if ( NULL != mPixels ) {
 		Image tImg( mHeight, mWidth, mChannels );
 
-		for ( unsigned int y = 0; y < mHeight; y++ )
-			for ( unsigned int x = 0; x < mWidth; x++ )
-				tImg.setPixel( y, x, getPixel( x, mHeight - 1 - y ) );
+		PixelKernels::rotateClockwise( mPixels, mWidth, mHeight, mChannels, tImg.getPixels() );
 
 		clearCache();
 
@@ -950,6 +909,16 @@ void Image::flip() {
 	}
 }
 
+void Image::flipVertical() {
+	if ( NULL != mPixels )
+		PixelKernels::flipVertical( mPixels, mWidth, mHeight, mChannels );
+}
+
+void Image::premultiplyAlpha() {
+	if ( NULL != mPixels && 4 == mChannels )
+		PixelKernels::premultiplyAlpha( mPixels, mWidth * mHeight );
+}
+
 void Image::avoidFreeImage( const bool& AvoidFree ) {
 	mAvoidFree = AvoidFree;
 }
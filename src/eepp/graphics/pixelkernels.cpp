@@ -0,0 +1,431 @@
+#include <cstring>
+#include <eepp/graphics/pixelkernels.hpp>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define EE_PIXEL_KERNELS_SSE2
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define EE_PIXEL_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace EE { namespace Graphics { namespace Private { namespace PixelKernels {
+
+static inline Uint32 packColor( const Color& color ) {
+	const Uint8 bytes[4] = { color.r, color.g, color.b, color.a };
+	Uint32 value;
+	memcpy( &value, bytes, sizeof( value ) );
+	return value;
+}
+
+static inline Uint8 luma( Uint8 r, Uint8 g, Uint8 b ) {
+	return static_cast<Uint8>( ( r * 77 + g * 150 + b * 29 ) >> 8 );
+}
+
+static inline Uint8 mulDiv255( Uint32 c, Uint32 a ) {
+	Uint32 t = c * a + 128;
+	return static_cast<Uint8>( ( t + ( t >> 8 ) ) >> 8 );
+}
+
+void fill( Uint8* pixels, size_t count, Uint32 channels, const Color& color ) {
+	if ( 0 == count || 0 == channels )
+		return;
+
+	if ( 1 == channels ) {
+		memset( pixels, color.r, count );
+		return;
+	}
+
+	size_t i = 0;
+
+	if ( 4 == channels ) {
+		Uint32 value = packColor( color );
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+		const __m128i vValue = _mm_set1_epi32( static_cast<int>( value ) );
+		for ( ; i + 4 <= count; i += 4 )
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( pixels + i * 4 ), vValue );
+#elif defined( EE_PIXEL_KERNELS_NEON )
+		const uint32x4_t vValue = vdupq_n_u32( value );
+		for ( ; i + 4 <= count; i += 4 )
+			vst1q_u8( pixels + i * 4, vreinterpretq_u8_u32( vValue ) );
+#endif
+		for ( ; i < count; i++ )
+			memcpy( pixels + i * 4, &value, 4 );
+		return;
+	}
+
+	// Write one pixel and keep doubling the filled span, memcpy does the wide stores
+	const Uint8 bytes[4] = { color.r, color.g, color.b, color.a };
+	size_t size = count * channels;
+	size_t filled = channels;
+	memcpy( pixels, bytes, channels );
+
+	while ( filled < size ) {
+		size_t copy = eemin( filled, size - filled );
+		memcpy( pixels + filled, pixels, copy );
+		filled += copy;
+	}
+}
+
+void replaceColor( Uint8* pixels, size_t count, Uint32 channels, const Color& key,
+				   const Color& value ) {
+	size_t i = 0;
+
+	switch ( channels ) {
+		case 4: {
+			Uint32 vKey = packColor( key );
+			Uint32 vNew = packColor( value );
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+			const __m128i keys = _mm_set1_epi32( static_cast<int>( vKey ) );
+			const __m128i news = _mm_set1_epi32( static_cast<int>( vNew ) );
+			for ( ; i + 4 <= count; i += 4 ) {
+				__m128i* ptr = reinterpret_cast<__m128i*>( pixels + i * 4 );
+				__m128i px = _mm_loadu_si128( ptr );
+				__m128i mask = _mm_cmpeq_epi32( px, keys );
+				_mm_storeu_si128( ptr, _mm_or_si128( _mm_and_si128( mask, news ),
+													 _mm_andnot_si128( mask, px ) ) );
+			}
+#elif defined( EE_PIXEL_KERNELS_NEON )
+			const uint32x4_t keys = vdupq_n_u32( vKey );
+			const uint32x4_t news = vdupq_n_u32( vNew );
+			for ( ; i + 4 <= count; i += 4 ) {
+				uint32x4_t px = vreinterpretq_u32_u8( vld1q_u8( pixels + i * 4 ) );
+				uint32x4_t mask = vceqq_u32( px, keys );
+				vst1q_u8( pixels + i * 4, vreinterpretq_u8_u32( vbslq_u32( mask, news, px ) ) );
+			}
+#endif
+			for ( ; i < count; i++ ) {
+				Uint32 px;
+				memcpy( &px, pixels + i * 4, 4 );
+				if ( px == vKey )
+					memcpy( pixels + i * 4, &vNew, 4 );
+			}
+			break;
+		}
+		case 3: {
+			for ( ; i < count; i++ ) {
+				Uint8* px = pixels + i * 3;
+				if ( px[0] == key.r && px[1] == key.g && px[2] == key.b ) {
+					px[0] = value.r;
+					px[1] = value.g;
+					px[2] = value.b;
+				}
+			}
+			break;
+		}
+		case 2: {
+			const Uint8 keyBytes[2] = { key.r, key.g };
+			const Uint8 newBytes[2] = { value.r, value.g };
+			Uint16 vKey, vNew;
+			memcpy( &vKey, keyBytes, 2 );
+			memcpy( &vNew, newBytes, 2 );
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+			const __m128i keys = _mm_set1_epi16( static_cast<short>( vKey ) );
+			const __m128i news = _mm_set1_epi16( static_cast<short>( vNew ) );
+			for ( ; i + 8 <= count; i += 8 ) {
+				__m128i* ptr = reinterpret_cast<__m128i*>( pixels + i * 2 );
+				__m128i px = _mm_loadu_si128( ptr );
+				__m128i mask = _mm_cmpeq_epi16( px, keys );
+				_mm_storeu_si128( ptr, _mm_or_si128( _mm_and_si128( mask, news ),
+													 _mm_andnot_si128( mask, px ) ) );
+			}
+#elif defined( EE_PIXEL_KERNELS_NEON )
+			const uint16x8_t keys = vdupq_n_u16( vKey );
+			const uint16x8_t news = vdupq_n_u16( vNew );
+			for ( ; i + 8 <= count; i += 8 ) {
+				uint16x8_t px = vreinterpretq_u16_u8( vld1q_u8( pixels + i * 2 ) );
+				uint16x8_t mask = vceqq_u16( px, keys );
+				vst1q_u8( pixels + i * 2, vreinterpretq_u8_u16( vbslq_u16( mask, news, px ) ) );
+			}
+#endif
+			for ( ; i < count; i++ ) {
+				Uint16 px;
+				memcpy( &px, pixels + i * 2, 2 );
+				if ( px == vKey )
+					memcpy( pixels + i * 2, &vNew, 2 );
+			}
+			break;
+		}
+		case 1: {
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+			const __m128i keys = _mm_set1_epi8( static_cast<char>( key.r ) );
+			const __m128i news = _mm_set1_epi8( static_cast<char>( value.r ) );
+			for ( ; i + 16 <= count; i += 16 ) {
+				__m128i* ptr = reinterpret_cast<__m128i*>( pixels + i );
+				__m128i px = _mm_loadu_si128( ptr );
+				__m128i mask = _mm_cmpeq_epi8( px, keys );
+				_mm_storeu_si128( ptr, _mm_or_si128( _mm_and_si128( mask, news ),
+													 _mm_andnot_si128( mask, px ) ) );
+			}
+#elif defined( EE_PIXEL_KERNELS_NEON )
+			const uint8x16_t keys = vdupq_n_u8( key.r );
+			const uint8x16_t news = vdupq_n_u8( value.r );
+			for ( ; i + 16 <= count; i += 16 ) {
+				uint8x16_t px = vld1q_u8( pixels + i );
+				vst1q_u8( pixels + i, vbslq_u8( vceqq_u8( px, keys ), news, px ) );
+			}
+#endif
+			for ( ; i < count; i++ ) {
+				if ( pixels[i] == key.r )
+					pixels[i] = value.r;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static void grayToRGBA( const Uint8* src, Uint8* dst, size_t count ) {
+	size_t i = 0;
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+	const __m128i alpha = _mm_set1_epi16( static_cast<short>( 0xFF00 ) );
+	for ( ; i + 16 <= count; i += 16 ) {
+		__m128i gray = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		// gg pairs for r,g and g|0xFF00 pairs for b,a
+		__m128i ggLo = _mm_unpacklo_epi8( gray, gray );
+		__m128i ggHi = _mm_unpackhi_epi8( gray, gray );
+		__m128i gaLo = _mm_or_si128( _mm_unpacklo_epi8( gray, _mm_setzero_si128() ), alpha );
+		__m128i gaHi = _mm_or_si128( _mm_unpackhi_epi8( gray, _mm_setzero_si128() ), alpha );
+		__m128i* out = reinterpret_cast<__m128i*>( dst + i * 4 );
+		_mm_storeu_si128( out, _mm_unpacklo_epi16( ggLo, gaLo ) );
+		_mm_storeu_si128( out + 1, _mm_unpackhi_epi16( ggLo, gaLo ) );
+		_mm_storeu_si128( out + 2, _mm_unpacklo_epi16( ggHi, gaHi ) );
+		_mm_storeu_si128( out + 3, _mm_unpackhi_epi16( ggHi, gaHi ) );
+	}
+#elif defined( EE_PIXEL_KERNELS_NEON )
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x4_t out;
+		out.val[0] = out.val[1] = out.val[2] = vld1q_u8( src + i );
+		out.val[3] = vdupq_n_u8( 255 );
+		vst4q_u8( dst + i * 4, out );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		Uint8* px = dst + i * 4;
+		px[0] = px[1] = px[2] = src[i];
+		px[3] = 255;
+	}
+}
+
+static void rgbToRGBA( const Uint8* src, Uint8* dst, size_t count ) {
+	size_t i = 0;
+#if defined( EE_PIXEL_KERNELS_NEON )
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x3_t in = vld3q_u8( src + i * 3 );
+		uint8x16x4_t out;
+		out.val[0] = in.val[0];
+		out.val[1] = in.val[1];
+		out.val[2] = in.val[2];
+		out.val[3] = vdupq_n_u8( 255 );
+		vst4q_u8( dst + i * 4, out );
+	}
+#endif
+	// SSE2 has no byte shuffle, the scalar loop is already bound by the memory bandwidth
+	for ( ; i < count; i++ ) {
+		const Uint8* in = src + i * 3;
+		Uint8* px = dst + i * 4;
+		px[0] = in[0];
+		px[1] = in[1];
+		px[2] = in[2];
+		px[3] = 255;
+	}
+}
+
+static void rgbaToRGB( const Uint8* src, Uint8* dst, size_t count ) {
+	size_t i = 0;
+#if defined( EE_PIXEL_KERNELS_NEON )
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x4_t in = vld4q_u8( src + i * 4 );
+		uint8x16x3_t out;
+		out.val[0] = in.val[0];
+		out.val[1] = in.val[1];
+		out.val[2] = in.val[2];
+		vst3q_u8( dst + i * 3, out );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		const Uint8* in = src + i * 4;
+		Uint8* px = dst + i * 3;
+		px[0] = in[0];
+		px[1] = in[1];
+		px[2] = in[2];
+	}
+}
+
+void convertChannels( const Uint8* src, Uint32 srcChannels, Uint8* dst, Uint32 dstChannels,
+					  size_t count ) {
+	if ( srcChannels == dstChannels ) {
+		memcpy( dst, src, count * srcChannels );
+		return;
+	}
+
+	switch ( srcChannels * 8 + dstChannels ) {
+		case 1 * 8 + 4:
+			grayToRGBA( src, dst, count );
+			return;
+		case 3 * 8 + 4:
+			rgbToRGBA( src, dst, count );
+			return;
+		case 4 * 8 + 3:
+			rgbaToRGB( src, dst, count );
+			return;
+		default:
+			break;
+	}
+
+	for ( size_t i = 0; i < count; i++ ) {
+		const Uint8* in = src + i * srcChannels;
+		Uint8* out = dst + i * dstChannels;
+		Uint8 r, g, b, a;
+
+		switch ( srcChannels ) {
+			case 1:
+				r = g = b = in[0];
+				a = 255;
+				break;
+			case 2:
+				r = g = b = in[0];
+				a = in[1];
+				break;
+			case 3:
+				r = in[0];
+				g = in[1];
+				b = in[2];
+				a = 255;
+				break;
+			default:
+				r = in[0];
+				g = in[1];
+				b = in[2];
+				a = in[3];
+				break;
+		}
+
+		switch ( dstChannels ) {
+			case 1:
+				out[0] = srcChannels <= 2 ? r : luma( r, g, b );
+				break;
+			case 2:
+				out[0] = srcChannels <= 2 ? r : luma( r, g, b );
+				out[1] = a;
+				break;
+			case 3:
+				out[0] = r;
+				out[1] = g;
+				out[2] = b;
+				break;
+			default:
+				out[0] = r;
+				out[1] = g;
+				out[2] = b;
+				out[3] = a;
+				break;
+		}
+	}
+}
+
+void premultiplyAlpha( Uint8* pixels, size_t count ) {
+	size_t i = 0;
+#if defined( EE_PIXEL_KERNELS_SSE2 )
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rgbMask = _mm_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1 );
+	const __m128i alphaOne = _mm_set_epi16( 255, 0, 0, 0, 255, 0, 0, 0 );
+	const __m128i half = _mm_set1_epi16( 128 );
+
+	auto multiply = [&]( __m128i px ) {
+		// Broadcast the alpha of each pixel to its RGB lanes, and keep the alpha itself
+		__m128i alpha = _mm_shufflehi_epi16(
+			_mm_shufflelo_epi16( px, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		alpha = _mm_or_si128( _mm_and_si128( alpha, rgbMask ), alphaOne );
+		__m128i t = _mm_add_epi16( _mm_mullo_epi16( px, alpha ), half );
+		return _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+	};
+
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128i* ptr = reinterpret_cast<__m128i*>( pixels + i * 4 );
+		__m128i px = _mm_loadu_si128( ptr );
+		__m128i lo = multiply( _mm_unpacklo_epi8( px, zero ) );
+		__m128i hi = multiply( _mm_unpackhi_epi8( px, zero ) );
+		_mm_storeu_si128( ptr, _mm_packus_epi16( lo, hi ) );
+	}
+#elif defined( EE_PIXEL_KERNELS_NEON )
+	auto multiply = []( uint8x16_t c, uint8x16_t a ) {
+		uint16x8_t lo = vmull_u8( vget_low_u8( c ), vget_low_u8( a ) );
+		uint16x8_t hi = vmull_u8( vget_high_u8( c ), vget_high_u8( a ) );
+		return vcombine_u8( vraddhn_u16( lo, vrshrq_n_u16( lo, 8 ) ),
+							vraddhn_u16( hi, vrshrq_n_u16( hi, 8 ) ) );
+	};
+
+	for ( ; i + 16 <= count; i += 16 ) {
+		uint8x16x4_t px = vld4q_u8( pixels + i * 4 );
+		px.val[0] = multiply( px.val[0], px.val[3] );
+		px.val[1] = multiply( px.val[1], px.val[3] );
+		px.val[2] = multiply( px.val[2], px.val[3] );
+		vst4q_u8( pixels + i * 4, px );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		Uint8* px = pixels + i * 4;
+		px[0] = mulDiv255( px[0], px[3] );
+		px[1] = mulDiv255( px[1], px[3] );
+		px[2] = mulDiv255( px[2], px[3] );
+	}
+}
+
+void flipVertical( Uint8* pixels, Uint32 width, Uint32 height, Uint32 channels ) {
+	size_t stride = static_cast<size_t>( width ) * channels;
+	std::vector<Uint8> row( stride );
+
+	for ( Uint32 y = 0; y < height / 2; y++ ) {
+		Uint8* top = pixels + y * stride;
+		Uint8* bottom = pixels + ( height - 1 - y ) * stride;
+		memcpy( row.data(), top, stride );
+		memcpy( top, bottom, stride );
+		memcpy( bottom, row.data(), stride );
+	}
+}
+
+template <Uint32 Channels>
+static void rotateTiled( const Uint8* src, Uint32 width, Uint32 height, Uint8* dst ) {
+	// Work in tiles so both the source rows and the destination rows stay in the cache
+	const Uint32 tile = 32;
+
+	for ( Uint32 ty = 0; ty < height; ty += tile ) {
+		Uint32 yEnd = eemin( ty + tile, height );
+		for ( Uint32 tx = 0; tx < width; tx += tile ) {
+			Uint32 xEnd = eemin( tx + tile, width );
+			for ( Uint32 x = tx; x < xEnd; x++ ) {
+				Uint8* out = dst + ( static_cast<size_t>( x ) * height ) * Channels;
+				for ( Uint32 y = ty; y < yEnd; y++ ) {
+					const Uint8* in =
+						src + ( static_cast<size_t>( height - 1 - y ) * width + x ) * Channels;
+					memcpy( out + y * Channels, in, Channels );
+				}
+			}
+		}
+	}
+}
+
+void rotateClockwise( const Uint8* src, Uint32 width, Uint32 height, Uint32 channels,
+					  Uint8* dst ) {
+	switch ( channels ) {
+		case 1:
+			rotateTiled<1>( src, width, height, dst );
+			break;
+		case 2:
+			rotateTiled<2>( src, width, height, dst );
+			break;
+		case 3:
+			rotateTiled<3>( src, width, height, dst );
+			break;
+		case 4:
+			rotateTiled<4>( src, width, height, dst );
+			break;
+		default:
+			break;
+	}
+}
+
+}}}} // namespace EE::Graphics::Private::PixelKernels
@@ -0,0 +1,42 @@
+#ifndef EE_GRAPHICSPRIVATEPIXELKERNELS
+#define EE_GRAPHICSPRIVATEPIXELKERNELS
+
+#include <eepp/graphics/base.hpp>
+#include <eepp/system/color.hpp>
+
+using namespace EE::System;
+
+namespace EE { namespace Graphics { namespace Private {
+
+/** Pixel operations over tightly packed 8 bits per channel buffers. The common cases are
+ * vectorized with SSE2 or NEON when available, every kernel has a scalar fallback. */
+namespace PixelKernels {
+
+/** Fills count pixels with the color (only the first channels components are used). */
+EE_API void fill( Uint8* pixels, size_t count, Uint32 channels, const Color& color );
+
+/** Replaces every pixel equal to key (comparing the first channels components) with value. */
+EE_API void replaceColor( Uint8* pixels, size_t count, Uint32 channels, const Color& key,
+						  const Color& value );
+
+/** Converts count pixels between channel counts, with the same rules as stb_image: gray is
+ * replicated to RGB, missing alpha is opaque and RGB to gray uses the luma weights.
+ * src and dst must not overlap. */
+EE_API void convertChannels( const Uint8* src, Uint32 srcChannels, Uint8* dst,
+							 Uint32 dstChannels, size_t count );
+
+/** Multiplies the RGB components of count RGBA pixels by their alpha. */
+EE_API void premultiplyAlpha( Uint8* pixels, size_t count );
+
+/** Flips the image rows in place. */
+EE_API void flipVertical( Uint8* pixels, Uint32 width, Uint32 height, Uint32 channels );
+
+/** Writes to dst (height x width pixels) the image rotated 90º clockwise. */
+EE_API void rotateClockwise( const Uint8* src, Uint32 width, Uint32 height, Uint32 channels,
+							 Uint8* dst );
+
+} // namespace PixelKernels
+
+}}} // namespace EE::Graphics::Private
+
+#endif
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <eepp/graphics/rectpacker.hpp>
+#include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <limits>
+#include <numeric>
+
+using namespace EE::System;
+
+namespace EE { namespace Graphics { namespace Private {
+
+namespace {
+
+struct PackRect {
+	Int32 x;
+	Int32 y;
+	Int32 w;
+	Int32 h;
+
+	bool intersects( const PackRect& r ) const {
+		return x < r.x + r.w && x + w > r.x && y < r.y + r.h && y + h > r.y;
+	}
+
+	bool contains( const PackRect& r ) const {
+		return r.x >= x && r.y >= y && r.x + r.w <= x + w && r.y + r.h <= y + h;
+	}
+};
+
+enum class Heuristic {
+	MaxRectsBestShortSideFit,
+	MaxRectsBestLongSideFit,
+	MaxRectsBestAreaFit,
+	MaxRectsBottomLeft,
+	SkylineBottomLeft,
+	SkylineMinWaste
+};
+
+enum class SortOrder { Area, MaxSide, Height, Width, Perimeter };
+
+static constexpr Int64 WorstScore = std::numeric_limits<Int64>::max();
+
+class MaxRectsBin {
+  public:
+	MaxRectsBin( Int32 width, Int32 height, bool allowRotation, Heuristic heuristic ) :
+		mAllowRotation( allowRotation ), mHeuristic( heuristic ) {
+		mFree.push_back( { 0, 0, width, height } );
+	}
+
+	bool insert( Int32 width, Int32 height, RectPacker::Placement& placement ) {
+		PackRect best{ 0, 0, 0, 0 };
+		Int64 bestScore1 = WorstScore;
+		Int64 bestScore2 = WorstScore;
+		bool rotated = false;
+
+		for ( const PackRect& free : mFree ) {
+			score( free, width, height, false, best, bestScore1, bestScore2, rotated );
+
+			if ( mAllowRotation && width != height )
+				score( free, height, width, true, best, bestScore1, bestScore2, rotated );
+		}
+
+		if ( WorstScore == bestScore1 )
+			return false;
+
+		place( best );
+
+		placement.x = best.x;
+		placement.y = best.y;
+		placement.rotated = rotated;
+		placement.placed = true;
+		return true;
+	}
+
+  protected:
+	std::vector<PackRect> mFree;
+	std::vector<PackRect> mSplit;
+	bool mAllowRotation;
+	Heuristic mHeuristic;
+
+	void score( const PackRect& free, Int32 w, Int32 h, bool rotate, PackRect& best,
+				Int64& bestScore1, Int64& bestScore2, bool& rotated ) const {
+		if ( w > free.w || h > free.h )
+			return;
+
+		Int64 leftoverH = free.w - w;
+		Int64 leftoverV = free.h - h;
+		Int64 score1;
+		Int64 score2;
+
+		switch ( mHeuristic ) {
+			case Heuristic::MaxRectsBestLongSideFit:
+				score1 = std::max( leftoverH, leftoverV );
+				score2 = std::min( leftoverH, leftoverV );
+				break;
+			case Heuristic::MaxRectsBestAreaFit:
+				score1 = (Int64)free.w * free.h - (Int64)w * h;
+				score2 = std::min( leftoverH, leftoverV );
+				break;
+			case Heuristic::MaxRectsBottomLeft:
+				score1 = free.y + h;
+				score2 = free.x;
+				break;
+			case Heuristic::MaxRectsBestShortSideFit:
+			default:
+				score1 = std::min( leftoverH, leftoverV );
+				score2 = std::max( leftoverH, leftoverV );
+				break;
+		}
+
+		if ( score1 < bestScore1 || ( score1 == bestScore1 && score2 < bestScore2 ) ) {
+			best = { free.x, free.y, w, h };
+			bestScore1 = score1;
+			bestScore2 = score2;
+			rotated = rotate;
+		}
+	}
+
+	void split( const PackRect& free, const PackRect& used ) {
+		if ( used.x > free.x )
+			mSplit.push_back( { free.x, free.y, used.x - free.x, free.h } );
+
+		if ( used.x + used.w < free.x + free.w )
+			mSplit.push_back(
+				{ used.x + used.w, free.y, free.x + free.w - used.x - used.w, free.h } );
+
+		if ( used.y > free.y )
+			mSplit.push_back( { free.x, free.y, free.w, used.y - free.y } );
+
+		if ( used.y + used.h < free.y + free.h )
+			mSplit.push_back(
+				{ free.x, used.y + used.h, free.w, free.y + free.h - used.y - used.h } );
+	}
+
+	void place( const PackRect& used ) {
+		mSplit.clear();
+
+		for ( size_t i = 0; i < mFree.size(); ) {
+			if ( mFree[i].intersects( used ) ) {
+				split( mFree[i], used );
+				mFree[i] = mFree.back();
+				mFree.pop_back();
+			} else {
+				i++;
+			}
+		}
+
+		// The free rectangles that weren't split were already maximal, so only the new ones can
+		// be contained by other free rectangles.
+		for ( size_t i = 0; i < mSplit.size(); i++ ) {
+			bool contained = false;
+
+			for ( size_t j = 0; j < mSplit.size() && !contained; j++ )
+				contained = i != j && mSplit[j].contains( mSplit[i] ) &&
+							( !mSplit[i].contains( mSplit[j] ) || j < i );
+
+			for ( size_t j = 0; j < mFree.size() && !contained; j++ )
+				contained = mFree[j].contains( mSplit[i] );
+
+			if ( !contained )
+				mFree.push_back( mSplit[i] );
+		}
+	}
+};
+
+class SkylineBin {
+  public:
+	SkylineBin( Int32 width, Int32 height, bool allowRotation, Heuristic heuristic ) :
+		mWidth( width ),
+		mHeight( height ),
+		mAllowRotation( allowRotation ),
+		mHeuristic( heuristic ) {
+		mSkyline.push_back( { 0, 0, width } );
+	}
+
+	bool insert( Int32 width, Int32 height, RectPacker::Placement& placement ) {
+		size_t bestIndex = 0;
+		PackRect best{ 0, 0, 0, 0 };
+		Int64 bestScore1 = WorstScore;
+		Int64 bestScore2 = WorstScore;
+		bool rotated = false;
+
+		for ( size_t i = 0; i < mSkyline.size(); i++ ) {
+			if ( score( i, width, height, best, bestScore1, bestScore2 ) ) {
+				bestIndex = i;
+				rotated = false;
+			}
+
+			if ( mAllowRotation && width != height &&
+				 score( i, height, width, best, bestScore1, bestScore2 ) ) {
+				bestIndex = i;
+				rotated = true;
+			}
+		}
+
+		if ( WorstScore == bestScore1 )
+			return false;
+
+		add( bestIndex, best );
+
+		placement.x = best.x;
+		placement.y = best.y;
+		placement.rotated = rotated;
+		placement.placed = true;
+		return true;
+	}
+
+  protected:
+	struct Segment {
+		Int32 x;
+		Int32 y;
+		Int32 width;
+	};
+
+	std::vector<Segment> mSkyline;
+	Int32 mWidth;
+	Int32 mHeight;
+	bool mAllowRotation;
+	Heuristic mHeuristic;
+
+	bool score( size_t index, Int32 w, Int32 h, PackRect& best, Int64& bestScore1,
+				Int64& bestScore2 ) const {
+		Int32 x = mSkyline[index].x;
+
+		if ( x + w > mWidth )
+			return false;
+
+		Int32 y = mSkyline[index].y;
+		Int32 widthLeft = w;
+
+		for ( size_t i = index; widthLeft > 0; i++ ) {
+			if ( i == mSkyline.size() )
+				return false;
+
+			y = std::max( y, mSkyline[i].y );
+
+			if ( y + h > mHeight )
+				return false;
+
+			widthLeft -= mSkyline[i].width;
+		}
+
+		Int64 score1;
+		Int64 score2;
+
+		if ( Heuristic::SkylineMinWaste == mHeuristic ) {
+			// The area left below the rectangle, that can't be used anymore
+			Int64 waste = 0;
+			Int32 right = x + w;
+
+			for ( size_t i = index; i < mSkyline.size() && mSkyline[i].x < right; i++ ) {
+				Int32 segmentRight = std::min( right, mSkyline[i].x + mSkyline[i].width );
+				waste += (Int64)( segmentRight - mSkyline[i].x ) * ( y - mSkyline[i].y );
+			}
+
+			score1 = waste;
+			score2 = y + h;
+		} else {
+			score1 = y + h;
+			score2 = mSkyline[index].width;
+		}
+
+		if ( score1 < bestScore1 || ( score1 == bestScore1 && score2 < bestScore2 ) ) {
+			best = { x, y, w, h };
+			bestScore1 = score1;
+			bestScore2 = score2;
+			return true;
+		}
+
+		return false;
+	}
+
+	void add( size_t index, const PackRect& rect ) {
+		mSkyline.insert( mSkyline.begin() + index, { rect.x, rect.y + rect.h, rect.w } );
+
+		// Shrink or remove the segments covered by the new one
+		for ( size_t i = index + 1; i < mSkyline.size(); ) {
+			const Segment& prev = mSkyline[i - 1];
+			Segment& cur = mSkyline[i];
+			Int32 shrink = prev.x + prev.width - cur.x;
+
+			if ( shrink <= 0 )
+				break;
+
+			if ( shrink < cur.width ) {
+				cur.x += shrink;
+				cur.width -= shrink;
+				break;
+			}
+
+			mSkyline.erase( mSkyline.begin() + i );
+		}
+
+		for ( size_t i = 0; i + 1 < mSkyline.size(); ) {
+			if ( mSkyline[i].y == mSkyline[i + 1].y ) {
+				mSkyline[i].width += mSkyline[i + 1].width;
+				mSkyline.erase( mSkyline.begin() + i + 1 );
+			} else {
+				i++;
+			}
+		}
+	}
+};
+
+static std::vector<size_t> sortItems( const std::vector<RectPacker::Item>& items,
+									  const SortOrder& order ) {
+	std::vector<size_t> indices( items.size() );
+	std::iota( indices.begin(), indices.end(), 0 );
+
+	auto key = [&items, &order]( size_t index ) -> std::pair<Int64, Int64> {
+		const RectPacker::Item& item = items[index];
+		Int64 maxSide = std::max( item.width, item.height );
+		Int64 minSide = std::min( item.width, item.height );
+
+		switch ( order ) {
+			case SortOrder::MaxSide:
+				return { maxSide, minSide };
+			case SortOrder::Height:
+				return { item.height, item.width };
+			case SortOrder::Width:
+				return { item.width, item.height };
+			case SortOrder::Perimeter:
+				return { maxSide + minSide, maxSide };
+			case SortOrder::Area:
+			default:
+				return { (Int64)item.width * item.height, maxSide };
+		}
+	};
+
+	std::stable_sort( indices.begin(), indices.end(),
+					  [&key]( size_t a, size_t b ) { return key( a ) > key( b ); } );
+
+	return indices;
+}
+
+template <typename Bin>
+static RectPacker::Result packWith( const std::vector<RectPacker::Item>& items, Int32 width,
+									Int32 height, bool allowRotation, const Heuristic& heuristic,
+									const SortOrder& order ) {
+	RectPacker::Result result;
+	result.placements.resize( items.size() );
+
+	Bin bin( width, height, allowRotation, heuristic );
+
+	for ( size_t index : sortItems( items, order ) ) {
+		const RectPacker::Item& item = items[index];
+
+		if ( bin.insert( item.width, item.height, result.placements[index] ) ) {
+			result.area += (Int64)item.width * item.height;
+			result.count++;
+		}
+	}
+
+	return result;
+}
+
+} // namespace
+
+RectPacker::Result RectPacker::pack( const Method& method, const std::vector<Item>& items,
+									 Int32 width, Int32 height, bool allowRotation ) {
+	static const SortOrder sortOrders[] = { SortOrder::Area, SortOrder::MaxSide,
+											SortOrder::Height, SortOrder::Width,
+											SortOrder::Perimeter };
+	std::vector<Heuristic> heuristics;
+
+	if ( Method::Skyline == method ) {
+		heuristics = { Heuristic::SkylineBottomLeft, Heuristic::SkylineMinWaste };
+	} else {
+		heuristics = { Heuristic::MaxRectsBestShortSideFit, Heuristic::MaxRectsBestLongSideFit,
+					   Heuristic::MaxRectsBestAreaFit, Heuristic::MaxRectsBottomLeft };
+	}
+
+	std::vector<std::pair<Heuristic, SortOrder>> candidates;
+
+	for ( const Heuristic& heuristic : heuristics )
+		for ( const SortOrder& order : sortOrders )
+			candidates.push_back( { heuristic, order } );
+
+	std::vector<Result> results( candidates.size() );
+
+	auto run = [&]( size_t i ) {
+		if ( Method::Skyline == method ) {
+			results[i] = packWith<SkylineBin>( items, width, height, allowRotation,
+											   candidates[i].first, candidates[i].second );
+		} else {
+			results[i] = packWith<MaxRectsBin>( items, width, height, allowRotation,
+												candidates[i].first, candidates[i].second );
+		}
+	};
+
+	Uint32 threads = eemin( (Uint32)Sys::getCPUCount(), (Uint32)candidates.size() );
+
+	if ( items.size() < 2 || threads <= 1 ) {
+		for ( size_t i = 0; i < candidates.size(); i++ )
+			run( i );
+	} else {
+		// The pool destructor waits for all the candidates to finish
+		auto pool = ThreadPool::createUnique( threads );
+
+		for ( size_t i = 0; i < candidates.size(); i++ )
+			pool->run( [&run, i] { run( i ); } );
+	}
+
+	size_t best = 0;
+
+	for ( size_t i = 1; i < results.size(); i++ ) {
+		if ( results[i].count > results[best].count ||
+			 ( results[i].count == results[best].count && results[i].area > results[best].area ) )
+			best = i;
+	}
+
+	return std::move( results[best] );
+}
+
+}}} // namespace EE::Graphics::Private
@@ -0,0 +1,48 @@
+#ifndef EE_GRAPHICSPRIVATERECTPACKER
+#define EE_GRAPHICSPRIVATERECTPACKER
+
+#include <eepp/graphics/base.hpp>
+#include <vector>
+
+namespace EE { namespace Graphics { namespace Private {
+
+/** @brief Packs rectangles into a fixed size bin.
+ * Two algorithms are available: MaxRects, that keeps the list of maximal free rectangles, and
+ * Skyline, that keeps the top edge of the packed rectangles ( faster and less dense ). pack()
+ * tries every heuristic of the algorithm with several orderings of the input in parallel and
+ * keeps the densest result. */
+class EE_API RectPacker {
+  public:
+	enum class Method { MaxRects, Skyline };
+
+	struct Item {
+		Int32 width;
+		Int32 height;
+	};
+
+	struct Placement {
+		Int32 x{ 0 };
+		Int32 y{ 0 };
+		bool rotated{ false }; // The item was rotated 90º, it uses height x width
+		bool placed{ false };
+	};
+
+	struct Result {
+		std::vector<Placement> placements; // One placement for each item, in the same order
+		Int64 area{ 0 };				   // The area of the placed items
+		Uint32 count{ 0 };				   // The number of placed items
+	};
+
+	/** Packs the items into a width x height bin.
+	 * @param method The packing algorithm
+	 * @param items The sizes of the rectangles to pack
+	 * @param allowRotation If the items can be rotated 90º to fit better
+	 * @return The result that placed most items ( or area when the count is the same ) of all the
+	 * heuristics tried. */
+	static Result pack( const Method& method, const std::vector<Item>& items, Int32 width,
+						Int32 height, bool allowRotation );
+};
+
+}}} // namespace EE::Graphics::Private
+
+#endif
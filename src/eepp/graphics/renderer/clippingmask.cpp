@@ -17,6 +17,10 @@ void ClippingMask::clipEnable( const Int32& x, const Int32& y, const Int32& Widt
 
 	Rectf r( x, y, x + Width, y + Height );
 
+	DrawCommandList* capture = GlobalBatchRenderer::instance()->getCapture();
+	if ( NULL != capture && mPushScissorClip )
+		capture->addClipEnable( r );
+
 	if ( !mScissorsClipped.empty() ) {
 		Rectf r2 = mScissorsClipped.back();
 		r.shrink( r2 );
@@ -33,6 +37,10 @@ void ClippingMask::clipEnable( const Int32& x, const Int32& y, const Int32& Widt
 void ClippingMask::clipDisable() {
 	GlobalBatchRenderer::instance()->draw();
 
+	DrawCommandList* capture = GlobalBatchRenderer::instance()->getCapture();
+	if ( NULL != capture )
+		capture->addClipDisable();
+
 	if ( !mScissorsClipped.empty() ) { // This should always be true
 		mScissorsClipped.pop_back();
 	}
@@ -51,6 +59,11 @@ void ClippingMask::clipPlaneEnable( const Int32& x, const Int32& y, const Int32&
 									const Int32& Height ) {
 	GlobalBatchRenderer::instance()->draw();
 
+	// Clip planes aren't recorded
+	DrawCommandList* capture = GlobalBatchRenderer::instance()->getCapture();
+	if ( NULL != capture )
+		capture->invalidate();
+
 	Rectf r( x, y, x + Width, y + Height );
 
 	if ( !mPlanesClipped.empty() ) {
@@ -120,6 +133,10 @@ void ClippingMask::setMaskMode( Mode theMode ) {
 void ClippingMask::stencilMaskEnable() {
 	GlobalBatchRenderer::instance()->draw();
 
+	DrawCommandList* capture = GlobalBatchRenderer::instance()->getCapture();
+	if ( NULL != capture )
+		capture->invalidate();
+
 	GLi->enable( GL_STENCIL_TEST );
 	GLi->stencilMask( 0xFF );
 	GLi->stencilFunc( GL_NEVER, 1, 0xFF );
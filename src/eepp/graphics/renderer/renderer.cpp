@@ -196,9 +196,11 @@ Renderer::Renderer() :
 	mExtensions( 0 ),
 	mStateFlags( 1 << RSF_LINE_SMOOTH ),
 	mQuadsSupported( true ),
+	mQuadsIndexedSupported( false ),
 	mQuadVertexs( 4 ),
 	mLineWidth( 1 ),
 	mCurVAO( 0 ),
+	mDrawCallsCount( 0 ),
 	mClippingMask( eeNew( ClippingMask, () ) ) {
 	GLi = this;
 }
@@ -252,6 +254,8 @@ void Renderer::init() {
 		writeExtension( EEGL_EXT_blend_func_separate, GLEW_EXT_blend_func_separate );
 		writeExtension( EEGL_EXT_blend_minmax, GLEW_EXT_blend_minmax );
 		writeExtension( EEGL_EXT_blend_subtract, GLEW_EXT_blend_subtract );
+		writeExtension( EEGL_ARB_map_buffer_range,
+						GLEW_ARB_map_buffer_range || GLEW_VERSION_3_0 );
 	} else
 #endif
 	{
@@ -275,6 +279,7 @@ void Renderer::init() {
 		writeExtension( EEGL_EXT_blend_func_separate, isExtension( "GL_EXT_blend_func_separate" ) );
 		writeExtension( EEGL_EXT_blend_minmax, isExtension( "GL_EXT_blend_minmax" ) );
 		writeExtension( EEGL_EXT_blend_subtract, isExtension( "GL_EXT_blend_subtract" ) );
+		writeExtension( EEGL_ARB_map_buffer_range, isExtension( "GL_ARB_map_buffer_range" ) );
 	}
 
 	// NVIDIA added support for GL_OES_compressed_ETC1_RGB8_texture in desktop GPUs
@@ -450,11 +455,17 @@ void Renderer::polygonMode( unsigned int face, unsigned int mode ) {
 
 void Renderer::drawArrays( unsigned int mode, int first, int count ) {
 	glDrawArrays( mode, first, count );
+	mDrawCallsCount++;
 }
 
 void Renderer::drawElements( unsigned int mode, int count, unsigned int type,
 							 const void* indices ) {
 	glDrawElements( mode, count, type, indices );
+	mDrawCallsCount++;
+}
+
+const Uint64& Renderer::getDrawCallsCount() const {
+	return mDrawCallsCount;
 }
 
 void Renderer::bindTexture( unsigned int target, unsigned int texture ) {
@@ -568,6 +579,10 @@ void Renderer::lineWidth( float width ) {
 	}
 }
 
+float Renderer::lineWidth() const {
+	return mLineWidth;
+}
+
 void Renderer::polygonMode() {
 	PrimitiveFillMode Mode = DRAW_FILL;
 
@@ -709,6 +724,14 @@ const int& Renderer::quadVertexs() const {
 	return mQuadVertexs;
 }
 
+const bool& Renderer::quadsIndexedSupported() const {
+	return mQuadsIndexedSupported;
+}
+
+void Renderer::drawQuadsIndexed( int first, int count ) {
+	drawArrays( GL_QUADS, first, count );
+}
+
 ClippingMask* Renderer::getClippingMask() const {
 	return mClippingMask;
 }
@@ -48,20 +48,15 @@ RendererGL3CP::RendererGL3CP() :
 	mPointSpriteLoc( -1 ),
 	mPointSize( 1.f ),
 	mCurActiveTex( 0 ),
-	mCurTexCoordArray( 0 ),
-	mVBOSizeAlloc( 1024 * 1024 ),
 	mBiggestAlloc( 0 ),
 	mLoaded( false ) {
 	mQuadsSupported = false;
+	mQuadsIndexedSupported = true;
 	mQuadVertexs = 6;
 }
 
 RendererGL3CP::~RendererGL3CP() {
-	for ( Uint32 i = 0; i < eeARRAY_SIZE( mVBO ); i++ ) {
-		if ( 0 != mVBO[i] ) {
-			glDeleteBuffersARB( 1, &mVBO[i] );
-		}
-	}
+	releaseStreamBuffers();
 
 	deleteVertexArrays( 1, &mVAO );
 
@@ -98,9 +93,6 @@ void RendererGL3CP::init() {
 			mAttribsLocStates[i] = 0;
 		}
 
-		for ( i = 0; i < eeARRAY_SIZE( mVBO ); i++ )
-			mVBO[i] = 0;
-
 		for ( i = 0; i < EE_MAX_PLANES; i++ ) {
 			mPlanes[i] = -1;
 			mPlanesStates[i] = 0;
@@ -128,9 +120,7 @@ void RendererGL3CP::init() {
 	genVertexArrays( 1, &mVAO );
 	bindVertexArray( mVAO );
 
-	glGenBuffersARB( EEGL_ARRAY_STATES_COUNT + 5, &mVBO[0] );
-
-	allocateBuffers( mVBOSizeAlloc );
+	initStreamBuffers();
 
 	clientActiveTexture( GL_TEXTURE0 );
 
@@ -361,12 +351,8 @@ void RendererGL3CP::vertexPointer( int size, unsigned int type, int stride, cons
 	if ( -1 != index ) {
 		bindVertexArray( mVAO );
 
-		if ( allocate > mVBOSizeAlloc ) {
-			allocateBuffers( allocate );
-		}
-
-		glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_VERTEX_ARRAY] );
-		glBufferSubDataARB( GL_ARRAY_BUFFER, 0, allocate, pointer );
+		const char* offset =
+			(char*)NULL + streamVertexData( EEGL_VERTEX_ARRAY, pointer, stride, allocate );
 
 		if ( 0 == mAttribsLocStates[EEGL_VERTEX_ARRAY] ) {
 			mAttribsLocStates[EEGL_VERTEX_ARRAY] = 1;
@@ -375,9 +361,9 @@ void RendererGL3CP::vertexPointer( int size, unsigned int type, int stride, cons
 		}
 
 		if ( type == GL_UNSIGNED_BYTE ) {
-			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, 0 );
+			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, offset );
 		} else {
-			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, 0 );
+			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, offset );
 		}
 	}
 }
@@ -393,12 +379,8 @@ void RendererGL3CP::colorPointer( int size, unsigned int type, int stride, const
 	if ( -1 != index ) {
 		bindVertexArray( mVAO );
 
-		if ( allocate > mVBOSizeAlloc ) {
-			allocateBuffers( allocate );
-		}
-
-		glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_COLOR_ARRAY] );
-		glBufferSubDataARB( GL_ARRAY_BUFFER, 0, allocate, pointer );
+		const char* offset =
+			(char*)NULL + streamVertexData( EEGL_COLOR_ARRAY, pointer, stride, allocate );
 
 		if ( 0 == mAttribsLocStates[EEGL_COLOR_ARRAY] ) {
 			mAttribsLocStates[EEGL_COLOR_ARRAY] = 1;
@@ -407,9 +389,9 @@ void RendererGL3CP::colorPointer( int size, unsigned int type, int stride, const
 		}
 
 		if ( type == GL_UNSIGNED_BYTE ) {
-			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, 0 );
+			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, offset );
 		} else {
-			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, 0 );
+			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, offset );
 		}
 	}
 }
@@ -425,12 +407,9 @@ void RendererGL3CP::texCoordPointer( int size, unsigned int type, int stride, co
 	if ( -1 != index ) {
 		bindVertexArray( mVAO );
 
-		if ( allocate > mVBOSizeAlloc ) {
-			allocateBuffers( allocate );
-		}
-
-		glBindBufferARB( GL_ARRAY_BUFFER, mCurTexCoordArray );
-		glBufferSubDataARB( GL_ARRAY_BUFFER, 0, allocate, pointer );
+		const char* offset =
+			(char*)NULL + streamVertexData( EEGL_TEXTURE_COORD_ARRAY + mCurActiveTex, pointer,
+											stride, allocate );
 
 		if ( 0 == mTextureUnitsStates[mCurActiveTex] ) {
 			mTextureUnitsStates[mCurActiveTex] = 1;
@@ -438,7 +417,7 @@ void RendererGL3CP::texCoordPointer( int size, unsigned int type, int stride, co
 			glEnableVertexAttribArray( index );
 		}
 
-		glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, 0 );
+		glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, offset );
 	}
 }
 
@@ -542,21 +521,6 @@ void RendererGL3CP::clientActiveTexture( unsigned int texture ) {
 
 	if ( mCurActiveTex >= EE_MAX_TEXTURE_UNITS )
 		mCurActiveTex = 0;
-
-	switch ( mCurActiveTex ) {
-		case 0:
-			mCurTexCoordArray = mVBO[EEGL_TEXTURE_COORD_ARRAY];
-			break;
-		case 1:
-			mCurTexCoordArray = mVBO[EEGL_TEXTURE_COORD_ARRAY + 1];
-			break;
-		case 2:
-			mCurTexCoordArray = mVBO[EEGL_TEXTURE_COORD_ARRAY + 2];
-			break;
-		case 3:
-			mCurTexCoordArray = mVBO[EEGL_TEXTURE_COORD_ARRAY + 3];
-			break;
-	}
 }
 
 std::string RendererGL3CP::getBaseVertexShader() {
@@ -567,31 +531,6 @@ void RendererGL3CP::bindGlobalVAO() {
 	bindVertexArray( mVAO );
 }
 
-void RendererGL3CP::allocateBuffers( const Uint32& size ) {
-	if ( mVBOSizeAlloc != size )
-		Log::instance()->writel( "Allocating new VBO buffers size: " + String::toString( size ) );
-
-	mVBOSizeAlloc = size;
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_VERTEX_ARRAY] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_COLOR_ARRAY] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_TEXTURE_COORD_ARRAY] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_TEXTURE_COORD_ARRAY + 1] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_TEXTURE_COORD_ARRAY + 2] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-
-	glBindBufferARB( GL_ARRAY_BUFFER, mVBO[EEGL_TEXTURE_COORD_ARRAY + 3] );
-	glBufferDataARB( GL_ARRAY_BUFFER, mVBOSizeAlloc, NULL, GL_STREAM_DRAW );
-}
-
 }} // namespace EE::Graphics
 
 #endif
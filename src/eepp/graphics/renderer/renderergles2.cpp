@@ -137,6 +137,14 @@ void RendererGLES2::init() {
 
 	clientActiveTexture( GL_TEXTURE0 );
 
+	initStreamBuffers();
+
+#ifdef EE_GLES
+	mQuadsIndexedSupported = isExtension( "GL_OES_element_index_uint" );
+#else
+	mQuadsIndexedSupported = true;
+#endif
+
 	mLoaded = true;
 }
 
@@ -395,7 +403,7 @@ void RendererGLES2::disableClientState( unsigned int array ) {
 }
 
 void RendererGLES2::vertexPointer( int size, unsigned int type, int stride, const void* pointer,
-								   unsigned int /*allocate*/ ) {
+								   unsigned int allocate ) {
 	const int index = mAttribsLoc[EEGL_VERTEX_ARRAY];
 
 	if ( -1 != index ) {
@@ -405,12 +413,14 @@ void RendererGLES2::vertexPointer( int size, unsigned int type, int stride, cons
 			glEnableVertexAttribArray( index );
 		}
 
-		glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, pointer );
+		glVertexAttribPointerARB(
+			index, size, type, GL_FALSE, stride,
+			(char*)NULL + streamVertexData( EEGL_VERTEX_ARRAY, pointer, stride, allocate ) );
 	}
 }
 
 void RendererGLES2::colorPointer( int size, unsigned int type, int stride, const void* pointer,
-								  unsigned int /*allocate*/ ) {
+								  unsigned int allocate ) {
 	const int index = mAttribsLoc[EEGL_COLOR_ARRAY];
 
 	if ( -1 != index ) {
@@ -420,16 +430,19 @@ void RendererGLES2::colorPointer( int size, unsigned int type, int stride, const
 			glEnableVertexAttribArray( index );
 		}
 
+		const char* offset =
+			(char*)NULL + streamVertexData( EEGL_COLOR_ARRAY, pointer, stride, allocate );
+
 		if ( type == GL_UNSIGNED_BYTE ) {
-			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, pointer );
+			glVertexAttribPointerARB( index, size, type, GL_TRUE, stride, offset );
 		} else {
-			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, pointer );
+			glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, offset );
 		}
 	}
 }
 
 void RendererGLES2::texCoordPointer( int size, unsigned int type, int stride, const void* pointer,
-									 unsigned int /*allocate*/ ) {
+									 unsigned int allocate ) {
 	if ( mCurShaderLocal ) {
 		if ( 1 == mTexActive ) {
 			if ( mCurShader == mShaders[EEGLES2_SHADER_PRIMITIVE] ) {
@@ -453,7 +466,10 @@ void RendererGLES2::texCoordPointer( int size, unsigned int type, int stride, co
 			glEnableVertexAttribArray( index );
 		}
 
-		glVertexAttribPointerARB( index, size, type, GL_FALSE, stride, pointer );
+		glVertexAttribPointerARB( index, size, type, GL_FALSE, stride,
+								  (char*)NULL +
+									  streamVertexData( EEGL_TEXTURE_COORD_ARRAY + mCurActiveTex,
+														pointer, stride, allocate ) );
 	}
 }
 
@@ -1,6 +1,8 @@
 #include <eepp/graphics/renderer/openglext.hpp>
 #include <eepp/graphics/renderer/rendererglshader.hpp>
 #include <eepp/graphics/renderer/rendererstackhelper.hpp>
+#include <cstring>
+#include <vector>
 
 namespace EE { namespace Graphics {
 
@@ -10,7 +12,18 @@ RendererGLShader::RendererGLShader() :
 	mTextureMatrix_id( 0 ),
 	mCurrentMode( 0 ),
 	mCurShader( NULL ),
-	mShaderPrev( NULL ) {
+	mShaderPrev( NULL ),
+	mStreamVBO( 0 ),
+	mStreamSize( 4 * 1024 * 1024 ),
+	mStreamOffset( 0 ),
+	mStreamPointer( NULL ),
+	mStreamStride( 0 ),
+	mStreamAllocate( 0 ),
+	mStreamPointerOffset( 0 ),
+	mStreamAttributes( 0 ),
+	mStreamMapBufferRange( false ),
+	mQuadsIBO( 0 ),
+	mQuadsIBOCount( 0 ) {
 	mStack = eeNew( Private::MatrixStack, () );
 	mStack->mProjectionMatrix.push( glm::mat4( 1.0f ) ); // identity matrix
 	mStack->mModelViewMatrix.push( glm::mat4( 1.0f ) );	 // identity matrix
@@ -18,9 +31,153 @@ RendererGLShader::RendererGLShader() :
 }
 
 RendererGLShader::~RendererGLShader() {
+	releaseStreamBuffers();
 	eeSAFE_DELETE( mStack );
 }
 
+void RendererGLShader::initStreamBuffers() {
+	// init() can run more than once, don't leak the buffers of the previous context setup
+	releaseStreamBuffers();
+	glGenBuffersARB( 1, &mStreamVBO );
+	glBindBufferARB( GL_ARRAY_BUFFER, mStreamVBO );
+	glBufferDataARB( GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW );
+	glGenBuffersARB( 1, &mQuadsIBO );
+	mQuadsIBOCount = 0;
+	mStreamOffset = 0;
+	mStreamPointer = NULL;
+	mStreamAttributes = 0;
+#ifndef EE_GLES
+	mStreamMapBufferRange = isExtension( EEGL_ARB_map_buffer_range );
+#endif
+}
+
+void RendererGLShader::releaseStreamBuffers() {
+	if ( 0 != mStreamVBO ) {
+		glDeleteBuffersARB( 1, &mStreamVBO );
+		mStreamVBO = 0;
+	}
+
+	if ( 0 != mQuadsIBO ) {
+		glDeleteBuffersARB( 1, &mQuadsIBO );
+		mQuadsIBO = 0;
+	}
+}
+
+unsigned int RendererGLShader::streamVertexData( Uint32 attribute, const void* pointer,
+												 int stride, unsigned int allocate ) {
+	const char* data = static_cast<const char*>( pointer );
+	const Uint32 attributeFlag = 1 << attribute;
+
+	glBindBufferARB( GL_ARRAY_BUFFER, mStreamVBO );
+
+	if ( NULL != mStreamPointer && !( mStreamAttributes & attributeFlag ) && stride > 0 &&
+		 stride == mStreamStride && allocate == mStreamAllocate && data >= mStreamPointer &&
+		 data < mStreamPointer + stride ) {
+		mStreamAttributes |= attributeFlag;
+		return mStreamPointerOffset + static_cast<unsigned int>( data - mStreamPointer );
+	}
+
+	unsigned int offset = ( mStreamOffset + 15 ) & ~15u;
+
+	if ( allocate > mStreamSize ) {
+		while ( mStreamSize < allocate )
+			mStreamSize *= 2;
+
+		glBufferDataARB( GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW );
+		offset = 0;
+	} else if ( offset + allocate > mStreamSize ) {
+		// Orphan the storage, the driver keeps the old one alive for the pending draw calls
+		glBufferDataARB( GL_ARRAY_BUFFER, mStreamSize, NULL, GL_STREAM_DRAW );
+		offset = 0;
+	}
+
+#ifndef EE_GLES
+	if ( mStreamMapBufferRange ) {
+		// The range written was never used since the last orphaning, no need to synchronize
+		void* dst = glMapBufferRange(
+			GL_ARRAY_BUFFER, offset, allocate,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT );
+
+		if ( NULL != dst ) {
+			memcpy( dst, data, allocate );
+			glUnmapBuffer( GL_ARRAY_BUFFER );
+		} else {
+			glBufferSubDataARB( GL_ARRAY_BUFFER, offset, allocate, data );
+		}
+	} else
+#endif
+	{
+		// Without buffer mapping the storage is still orphaned when full (above), so the
+		// sub data upload only touches a range the pending draw calls don't use
+		glBufferSubDataARB( GL_ARRAY_BUFFER, offset, allocate, data );
+	}
+
+	mStreamOffset = offset + allocate;
+	mStreamPointer = data;
+	mStreamStride = stride;
+	mStreamAllocate = allocate;
+	mStreamPointerOffset = offset;
+	mStreamAttributes = attributeFlag;
+
+	return offset;
+}
+
+void RendererGLShader::drawArrays( unsigned int mode, int first, int count ) {
+	Renderer::drawArrays( mode, first, count );
+	mStreamPointer = NULL;
+}
+
+void RendererGLShader::drawElements( unsigned int mode, int count, unsigned int type,
+									 const void* indices ) {
+	Renderer::drawElements( mode, count, type, indices );
+	mStreamPointer = NULL;
+}
+
+void RendererGLShader::drawQuadsIndexed( int first, int count ) {
+	if ( !mQuadsIndexedSupported ) {
+		Renderer::drawQuadsIndexed( first, count );
+		return;
+	}
+
+	unsigned int firstQuad = first / 4;
+	unsigned int quads = count / 4;
+
+	if ( 0 == quads )
+		return;
+
+	glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER, mQuadsIBO );
+
+	if ( firstQuad + quads > mQuadsIBOCount ) {
+		unsigned int newCount = eemax( 4096u, mQuadsIBOCount );
+		while ( newCount < firstQuad + quads )
+			newCount *= 2;
+
+		// Same triangles used by the six vertices quads: (1, 0, 3) and (1, 2, 3)
+		std::vector<Uint32> indices( newCount * 6 );
+		for ( Uint32 i = 0; i < newCount; i++ ) {
+			Uint32 vertex = i * 4;
+			Uint32* quad = &indices[i * 6];
+			quad[0] = vertex + 1;
+			quad[1] = vertex;
+			quad[2] = vertex + 3;
+			quad[3] = vertex + 1;
+			quad[4] = vertex + 2;
+			quad[5] = vertex + 3;
+		}
+
+		glBufferDataARB( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof( Uint32 ),
+						 indices.data(), GL_STATIC_DRAW );
+		mQuadsIBOCount = newCount;
+	}
+
+	Renderer::drawElements( GL_TRIANGLES, quads * 6, GL_UNSIGNED_INT,
+							(char*)NULL + firstQuad * 6 * sizeof( Uint32 ) );
+
+	// Client side indices are still used by drawElements
+	glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	mStreamPointer = NULL;
+}
+
 void RendererGLShader::updateMatrix() {
 	switch ( mCurrentMode ) {
 		case GL_PROJECTION: {
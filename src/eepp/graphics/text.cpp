@@ -150,6 +150,15 @@ static bool shapeAndRun( const String& string, const FontStyleConfig& config,
 						config.Style, config.OutlineThickness, cb );
 }
 
+// The shaper works with UTF-32, the cluster indexes of the shaped String are the same character
+// indexes of the compact string
+static bool shapeAndRun( const CompactString::View& string, FontTrueType* font,
+						 Uint32 characterSize, Uint32 style, Float outlineThickness,
+						 const std::function<bool( hb_glyph_info_t*, hb_glyph_position_t*, Uint32,
+												   TextShapeRun& )>& cb ) {
+	return shapeAndRun( string.toString(), font, characterSize, style, outlineThickness, cb );
+}
+
 #endif
 
 } // namespace
@@ -262,6 +271,33 @@ Sizef Text::draw( const String::View& string, const Vector2f& pos, const FontSty
 	return draw<String::View>( string, pos, config, tabWidth );
 }
 
+Float Text::getTextWidth( Font* font, const Uint32& fontSize, const CompactString::View& string,
+						  const Uint32& style, const Uint32& tabWidth,
+						  const Float& outlineThickness ) {
+	return getTextWidth<CompactString::View>( font, fontSize, string, style, tabWidth,
+											  outlineThickness );
+}
+
+Float Text::getTextWidth( const CompactString::View& string, const FontStyleConfig& config,
+						  const Uint32& tabWidth ) {
+	return getTextWidth<CompactString::View>( config.Font, config.CharacterSize, string,
+											  config.Style, tabWidth, config.OutlineThickness );
+}
+
+Sizef Text::draw( const CompactString::View& string, const Vector2f& pos, Font* font,
+				  Float fontSize, const Color& fontColor, Uint32 style, Float outlineThickness,
+				  const Color& outlineColor, const Color& shadowColor, const Vector2f& shadowOffset,
+				  const Uint32& tabWidth ) {
+	return draw<CompactString::View>( string, pos, font, fontSize, fontColor, style,
+									  outlineThickness, outlineColor, shadowColor, shadowOffset,
+									  tabWidth );
+}
+
+Sizef Text::draw( const CompactString::View& string, const Vector2f& pos,
+				  const FontStyleConfig& config, const Uint32& tabWidth ) {
+	return draw<CompactString::View>( string, pos, config, tabWidth );
+}
+
 Text* Text::New() {
 	return eeNew( Text, () );
 }
@@ -1601,6 +1637,12 @@ void Text::draw( const Float& X, const Float& Y, const Vector2f& scale, const Fl
 
 	GlobalBatchRenderer::instance()->draw();
 
+	if ( NULL != GlobalBatchRenderer::instance()->getCapture() && rotation == 0.0f &&
+		 scale == 1.0f ) {
+		drawBatched( X, Y, effect, colors, outlineColors, backgroundColor );
+		return;
+	}
+
 	if ( rotation != 0.0f || scale != 1.0f ) {
 		Float cX = (Float)( (Int32)X );
 		Float cY = (Float)( (Int32)Y );
@@ -1645,7 +1687,7 @@ void Text::draw( const Float& X, const Float& Y, const Vector2f& scale, const Fl
 	BlendMode::setMode( effect );
 
 	Uint32 alloc = numvert * sizeof( VertexCoords );
-	Uint32 allocC = numvert * GLi->quadVertexs();
+	Uint32 allocC = numvert * sizeof( Color );
 
 	if ( 0 != mFontStyleConfig.OutlineThickness ) {
 		GLi->colorPointer( 4, GL_UNSIGNED_BYTE, 0,
@@ -1683,6 +1725,43 @@ void Text::draw( const Float& X, const Float& Y, const Vector2f& scale, const Fl
 	}
 }
 
+void Text::drawBatched( const Float& X, const Float& Y, const BlendMode& effect,
+						const std::vector<Color>& colors, const std::vector<Color>& outlineColors,
+						const Color& backgroundColor ) {
+	if ( backgroundColor != Color::Transparent ) {
+		Rectf bounds( getLocalBounds() );
+		Primitives p;
+		p.setForceDraw( true );
+		p.setColor( backgroundColor );
+		p.drawRectangle(
+			Rectf( bounds.Left + X, bounds.Top + Y, bounds.Right + X, bounds.Bottom + Y ) );
+	}
+
+	Texture* texture = mFontStyleConfig.Font->getTexture( mFontStyleConfig.CharacterSize );
+	if ( !texture )
+		return;
+
+	BatchRenderer* BR = GlobalBatchRenderer::instance();
+	PrimitiveType mode = GLi->quadsSupported() ? PRIMITIVE_QUADS : PRIMITIVE_TRIANGLES;
+	std::vector<VertexData> vertices( eemax( mVertices.size(), mOutlineVertices.size() ) );
+
+	auto drawVertices = [&]( const std::vector<VertexCoords>& coords,
+							 const std::vector<Color>& vertexColors ) {
+		size_t count = eemin( eemin( coords.size(), vertexColors.size() ), vertices.size() );
+		for ( size_t i = 0; i < count; i++ ) {
+			vertices[i].pos = Vector2f( coords[i].position.x + X, coords[i].position.y + Y );
+			vertices[i].tex = coords[i].texCoords;
+			vertices[i].color = vertexColors[i];
+		}
+		BR->drawVertexs( texture, effect, mode, vertices.data(), count );
+	};
+
+	if ( 0 != mFontStyleConfig.OutlineThickness )
+		drawVertices( mOutlineVertices, outlineColors );
+
+	drawVertices( mVertices, colors );
+}
+
 void Text::draw( const Float& X, const Float& Y, const Vector2f& scale, const Float& rotation,
 				 BlendMode effect, const OriginPoint& rotationCenter,
 				 const OriginPoint& scaleCenter ) {
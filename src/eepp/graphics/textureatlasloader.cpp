@@ -147,9 +147,9 @@ void TextureAtlasLoader::loadFromStream( IOStream& IOS ) {
 
 				if ( !mSkipResourceLoad && NULL == tTex ) {
 					if ( NULL != mPack ) {
-						mRL.add( [=] { TextureFactory::instance()->loadFromPack( mPack, path ); } );
+						TextureFactory::instance()->loadFromPack( mRL, mPack, path );
 					} else {
-						mRL.add( [=] { TextureFactory::instance()->loadFromFile( path ); } );
+						TextureFactory::instance()->loadFromFile( mRL, path );
 					}
 				}
 
@@ -171,6 +171,10 @@ void TextureAtlasLoader::loadFromStream( IOStream& IOS ) {
 	}
 }
 
+bool TextureAtlasLoader::update( const Time& budget ) {
+	return mRL.update( budget );
+}
+
 void TextureAtlasLoader::loadFromFile( const std::string& TextureAtlasPath ) {
 	if ( TextureAtlasPath.size() )
 		mTextureAtlasPath = TextureAtlasPath;
@@ -381,7 +385,8 @@ bool TextureAtlasLoader::updateTextureAtlas() {
 #define ATLAS_NEEDS_HDR_REWRITE 1
 
 bool TextureAtlasLoader::updateTextureAtlas( std::string TextureAtlasPath, std::string ImagesPath,
-											 Sizei maxImageSize ) {
+											 Sizei maxImageSize,
+											 const TexturePacker::PackingMethod& packingMethod ) {
 	if ( !TextureAtlasPath.size() || !ImagesPath.size() ||
 		 !FileSystem::fileExists( TextureAtlasPath ) || !FileSystem::isDirectory( ImagesPath ) )
 		return false;
@@ -486,6 +491,7 @@ bool TextureAtlasLoader::updateTextureAtlas( std::string TextureAtlasPath, std::
 				(Texture::Filter)mTexGrHdr.TextureFilter,
 				mTexGrHdr.Flags & HDR_TEXTURE_ATLAS_ALLOW_FLIPPING );
 
+			tp.setPackingMethod( packingMethod );
 			tp.addTexturesPath( ImagesPath );
 
 			if ( tp.packTextures() <= 0 ) {
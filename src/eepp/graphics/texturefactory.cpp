@@ -8,7 +8,11 @@
 #include <eepp/graphics/textureloader.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/log.hpp>
+#include <eepp/window/engine.hpp>
 #include <jpeg-compressor/jpge.h>
+#include <memory>
+
+using namespace EE::Window;
 
 namespace EE { namespace Graphics {
 
@@ -97,6 +101,37 @@ TextureFactory::loadFromFile( const std::string& Filepath, const bool& Mipmap,
 	return myTex.getTexture();
 }
 
+// With a shared GL context the texture is created in the loader thread as a single task, so the
+// loading doesn't depend on ResourceLoader::update() being called
+static void addTextureLoader( ResourceLoader& loader, std::shared_ptr<TextureLoader> myTex ) {
+	if ( loader.isThreaded() && Engine::instance()->isSharedGLContextEnabled() ) {
+		loader.add( [myTex] { myTex->load(); } );
+	} else {
+		loader.add( [myTex] { myTex->decode(); }, [myTex] { myTex->upload(); } );
+	}
+}
+
+void TextureFactory::loadFromPack( ResourceLoader& loader, Pack* Pack,
+								   const std::string& FilePackPath, const bool& Mipmap,
+								   const Texture::ClampMode& ClampMode, const bool& CompressTexture,
+								   const bool& KeepLocalCopy,
+								   const Image::FormatConfiguration& imageformatConfiguration ) {
+	auto myTex = std::make_shared<TextureLoader>( Pack, FilePackPath, Mipmap, ClampMode,
+												  CompressTexture, KeepLocalCopy );
+	myTex->setFormatConfiguration( imageformatConfiguration );
+	addTextureLoader( loader, myTex );
+}
+
+void TextureFactory::loadFromFile( ResourceLoader& loader, const std::string& Filepath,
+								   const bool& Mipmap, const Texture::ClampMode& ClampMode,
+								   const bool& CompressTexture, const bool& KeepLocalCopy,
+								   const Image::FormatConfiguration& imageformatConfiguration ) {
+	auto myTex = std::make_shared<TextureLoader>( Filepath, Mipmap, ClampMode, CompressTexture,
+												  KeepLocalCopy );
+	myTex->setFormatConfiguration( imageformatConfiguration );
+	addTextureLoader( loader, myTex );
+}
+
 Texture* TextureFactory::pushTexture( const std::string& Filepath, const Uint32& TexId,
 									  const unsigned int& Width, const unsigned int& Height,
 									  const unsigned int& ImgWidth, const unsigned int& ImgHeight,
@@ -1,5 +1,6 @@
 #include <SOIL2/src/SOIL2/SOIL2.h>
 #include <SOIL2/src/SOIL2/stb_image.h>
+#include <eepp/graphics/pixelkernels.hpp>
 #include <eepp/graphics/renderer/opengl.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/scopedtexture.hpp>
@@ -102,6 +103,15 @@ TextureLoader::~TextureLoader() {
 }
 
 void TextureLoader::load() {
+	decode();
+
+	upload();
+}
+
+void TextureLoader::decode() {
+	if ( mTexLoaded )
+		return;
+
 	mTE.restart();
 
 	if ( TEX_LT_PATH == mLoadType )
@@ -114,10 +124,23 @@ void TextureLoader::load() {
 		loadFromStream();
 
 	mTexLoaded = true;
+}
+
+void TextureLoader::upload() {
+	if ( !mTexLoaded )
+		decode();
 
 	loadFromPixels();
 }
 
+bool TextureLoader::isDecoded() const {
+	return mTexLoaded;
+}
+
+bool TextureLoader::isLoaded() const {
+	return mLoaded;
+}
+
 void TextureLoader::loadFile() {
 	IOStreamFile fs( mFilepath );
 
@@ -315,20 +338,28 @@ void TextureLoader::loadFromPixels() {
 																	SOIL_CREATE_NEW_ID, flags );
 					}
 				} else {
-					if ( NULL != mColorKey ) {
-						mChannels = STBI_rgb_alpha;
-
-						Image* tImg = Image::New( mPixels, mImgWidth, mImgHeight, mChannels );
+					Uint8* pixels = mPixels;
+					std::vector<Uint8> converted;
 
-						tImg->createMaskFromColor(
-							Color( mColorKey->r, mColorKey->g, mColorKey->b, 255 ), 0 );
-
-						tImg->avoidFreeImage( true );
+					if ( NULL != mColorKey ) {
+						size_t count = static_cast<size_t>( mImgWidth ) * mImgHeight;
+
+						// The color key is applied to the alpha channel
+						if ( STBI_rgb_alpha != mChannels ) {
+							converted.resize( count * STBI_rgb_alpha );
+							PixelKernels::convertChannels( mPixels, mChannels, converted.data(),
+														   STBI_rgb_alpha, count );
+							pixels = converted.data();
+							mChannels = STBI_rgb_alpha;
+						}
 
-						eeSAFE_DELETE( tImg );
+						PixelKernels::replaceColor(
+							pixels, count, mChannels,
+							Color( mColorKey->r, mColorKey->g, mColorKey->b, 255 ),
+							Color( mColorKey->r, mColorKey->g, mColorKey->b, 0 ) );
 					}
 
-					tTexId = SOIL_create_OGL_texture( mPixels, &width, &height, mChannels,
+					tTexId = SOIL_create_OGL_texture( pixels, &width, &height, mChannels,
 													  SOIL_CREATE_NEW_ID, flags );
 				}
 			}
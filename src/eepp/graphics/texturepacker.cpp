@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <atomic>
+#include <eepp/graphics/rectpacker.hpp>
 #include <eepp/graphics/texturepacker.hpp>
 #include <eepp/graphics/texturepackernode.hpp>
 #include <eepp/graphics/texturepackertex.hpp>
@@ -7,6 +9,7 @@
 #include <eepp/system/log.hpp>
 #include <eepp/system/md5.hpp>
 #include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
 
 namespace EE { namespace Graphics {
 
@@ -403,6 +406,7 @@ void TexturePacker::insertTexture( TexturePackerTex* t, TexturePackerNode* bestF
 void TexturePacker::createChild() {
 	mChild = TexturePacker::New( mWidth, mHeight, mPixelDensity / 100.f, mForcePowOfTwo,
 								 mScalableSVG, mPixelBorder, mTextureFilter, mAllowFlipping );
+	mChild->setPackingMethod( mPackingMethod );
 
 	std::vector<TexturePackerTex*>::iterator it;
 	std::vector<std::vector<TexturePackerTex*>::iterator> remove;
@@ -508,6 +512,9 @@ bool TexturePacker::addTexture( const std::string& TexturePath ) {
 }
 
 Int32 TexturePacker::packTextures() {
+	if ( PackingMethod::FreeList != mPackingMethod )
+		return packRects();
+
 	TexturePackerTex* t = NULL;
 
 	addBorderToTextures( (Int32)mPixelBorder );
@@ -594,11 +601,74 @@ Int32 TexturePacker::packTextures() {
 
 	addBorderToTextures( -( (Int32)mPixelBorder ) );
 
+	return packFinished();
+}
+
+Int32 TexturePacker::packRects() {
+	std::vector<RectPacker::Item> items;
+	Int64 itemsArea = 0;
+
+	items.reserve( mTextures.size() );
+
+	for ( TexturePackerTex* t : mTextures ) {
+		items.push_back( { t->width() + mPixelBorder, t->height() + mPixelBorder } );
+		itemsArea += (Int64)items.back().width * items.back().height;
+	}
+
+	RectPacker::Method method = PackingMethod::Skyline == mPackingMethod
+									? RectPacker::Method::Skyline
+									: RectPacker::Method::MaxRects;
+	RectPacker::Result result;
+
+	while ( true ) {
+		bool canGrow = mWidth < mMaxSize.getWidth() || mHeight < mMaxSize.getHeight();
+
+		// Don't try the sizes that can't hold all the images
+		if ( !canGrow || itemsArea <= (Int64)mWidth * mHeight ) {
+			result = RectPacker::pack( method, items, mWidth, mHeight, mAllowFlipping );
+
+			if ( result.count == items.size() || !canGrow )
+				break;
+		}
+
+		if ( ( mWidth <= mHeight && mWidth < mMaxSize.getWidth() ) ||
+			 mHeight >= mMaxSize.getHeight() ) {
+			mWidth = eemin( mWidth * 2, mMaxSize.getWidth() );
+		} else {
+			mHeight = eemin( mHeight * 2, mMaxSize.getHeight() );
+		}
+	}
+
+	if ( result.count < items.size() && !mAllowChilds ) {
+		Log::warning( "TexturePacker: %d textures don't fit in the maximum atlas size.",
+					  (Int32)( items.size() - result.count ) );
+		return 0;
+	}
+
+	for ( size_t i = 0; i < mTextures.size(); i++ ) {
+		const RectPacker::Placement& placement = result.placements[i];
+
+		if ( placement.placed )
+			mTextures[i]->place( placement.x, placement.y, placement.rotated );
+	}
+
+	mCount = (Int32)( items.size() - result.count );
+
+	if ( mCount > 0 ) {
+		Log::debug( "Creating a new image as a child. Some textures couldn't get it: %d",
+					mCount );
+		createChild();
+	}
+
+	return packFinished();
+}
+
+Int32 TexturePacker::packFinished() {
 	mPacked = true;
 
-	for ( it = mTextures.begin(); it != mTextures.end(); ++it ) {
-		if ( !( *it )->placed() )
-			mTotalArea -= ( *it )->area();
+	for ( TexturePackerTex* t : mTextures ) {
+		if ( !t->placed() )
+			mTotalArea -= t->area();
 	}
 
 	Log::debug( "Total Area Used: %d. This represents the %4.3f percent", mTotalArea,
@@ -622,43 +692,45 @@ void TexturePacker::save( const std::string& Filepath, const Image::SaveType& Fo
 
 	Img.fillWithColor( Color( 0, 0, 0, 0 ) );
 
-	TexturePackerTex* t = NULL;
-	std::vector<TexturePackerTex*>::iterator it;
-
-	for ( it = mTextures.begin(); it != mTextures.end(); ++it ) {
-		t = ( *it );
+	std::atomic<Int32> placedCount{ 0 };
 
-		if ( t->placed() ) {
-			Uint8* data;
+	// Every image is copied to its own region of the atlas, so they can be loaded and copied in
+	// parallel
+	auto copyTexture = [&Img, &placedCount]( TexturePackerTex* t ) {
+		if ( NULL == t->getImage() ) {
+			Image imageLoaded( t->name() );
 
-			if ( NULL == t->getImage() ) {
-				Image imageLoaded( t->name() );
+			if ( NULL != imageLoaded.getPixelsPtr() && t->width() == (int)imageLoaded.getWidth() &&
+				 t->height() == (int)imageLoaded.getHeight() ) {
+				if ( t->flipped() )
+					imageLoaded.flip();
 
-				if ( NULL != imageLoaded.getPixelsPtr() &&
-					 t->width() == (int)imageLoaded.getWidth() &&
-					 t->height() == (int)imageLoaded.getHeight() ) {
-					if ( t->flipped() )
-						imageLoaded.flip();
+				Img.copyImage( &imageLoaded, t->x(), t->y() );
 
-					Img.copyImage( &imageLoaded, t->x(), t->y() );
+				placedCount++;
+			}
+		} else if ( NULL != t->getImage()->getPixels() ) {
+			if ( t->flipped() )
+				t->getImage()->flip();
 
-					mPlacedCount++;
-				}
-			} else {
-				data = t->getImage()->getPixels();
+			Img.copyImage( t->getImage(), t->x(), t->y() );
 
-				if ( NULL != data ) {
-					if ( t->flipped() )
-						t->getImage()->flip();
+			placedCount++;
+		}
+	};
 
-					Img.copyImage( t->getImage(), t->x(), t->y() );
+	{
+		// The pool destructor waits for all the textures to be copied
+		auto pool = ThreadPool::createUnique( eemax( (Uint32)Sys::getCPUCount(), 1u ) );
 
-					mPlacedCount++;
-				}
-			}
+		for ( TexturePackerTex* t : mTextures ) {
+			if ( t->placed() )
+				pool->run( [&copyTexture, t] { copyTexture( t ); } );
 		}
 	}
 
+	mPlacedCount += placedCount;
+
 	mFormat = Format;
 
 	Img.saveToFile( Filepath, Format );
@@ -825,6 +897,14 @@ void TexturePacker::childSave( const Image::SaveType& Format ) {
 	}
 }
 
+void TexturePacker::setPackingMethod( const PackingMethod& method ) {
+	mPackingMethod = method;
+}
+
+const TexturePacker::PackingMethod& TexturePacker::getPackingMethod() const {
+	return mPackingMethod;
+}
+
 TexturePacker* TexturePacker::getChild() const {
 	return mChild;
 }
@@ -2,6 +2,9 @@
 #include <cctype>
 #include <eepp/network/http.hpp>
 #include <eepp/network/http/httpstreamchunked.hpp>
+#include <eepp/network/http/httpstreamconsumer.hpp>
+#include <eepp/network/http/httpstreamfile.hpp>
+#include <eepp/network/socketselector.hpp>
 #include <eepp/network/ssl/sslsocket.hpp>
 #include <eepp/network/uri.hpp>
 #include <eepp/system/compression.hpp>
@@ -550,6 +553,63 @@ static Http::Pool sGlobalHttpPool = Http::Pool();
 
 static std::shared_ptr<ThreadPool> sGlobalThreadPool = nullptr;
 
+// The async requests spend most of their time waiting for the network, a few I/O threads serve
+// the queues of all the hosts
+static constexpr Uint32 HTTP_IO_THREADS = 8;
+
+static constexpr Uint32 HTTP_MAX_ASYNC_CONNECTIONS = 6;
+
+// Idle connections older than this are closed instead of reused
+static constexpr Time HTTP_KEEP_ALIVE_TIMEOUT = Seconds( 60 );
+
+static std::shared_ptr<ThreadPool> sIOThreadPool = nullptr;
+
+static Mutex sIOThreadPoolMutex;
+
+struct DNSCacheEntry {
+	IpAddress address;
+	Uint64 resolvedAt;
+};
+
+static UnorderedMap<std::string, DNSCacheEntry> sDNSCache;
+
+static Mutex sDNSCacheMutex;
+
+static Time sDNSCacheTTL = Seconds( 60 );
+
+static std::shared_ptr<ThreadPool> getIOThreadPool() {
+	if ( sGlobalThreadPool )
+		return sGlobalThreadPool;
+
+	Lock l( sIOThreadPoolMutex );
+
+	if ( !sIOThreadPool )
+		sIOThreadPool = ThreadPool::createShared( HTTP_IO_THREADS );
+
+	return sIOThreadPool;
+}
+
+static IpAddress resolveHost( const std::string& hostName ) {
+	{
+		Lock l( sDNSCacheMutex );
+		auto it = sDNSCache.find( hostName );
+
+		if ( it != sDNSCache.end() &&
+			 Milliseconds( Sys::getTicks() - it->second.resolvedAt ) < sDNSCacheTTL )
+			return it->second.address;
+	}
+
+	IpAddress address( hostName );
+
+	// Failed resolutions are not cached, the next request will try again
+	if ( 0 != address.toInteger() && sDNSCacheTTL > Time::Zero ) {
+		Lock l( sDNSCacheMutex );
+		sDNSCache[hostName] = { address, Sys::getTicks() };
+	}
+
+	return address;
+}
+
 Http::Response Http::request( const URI& uri, Request::Method method, const Time& timeout,
 							  const Http::Request::ProgressCallback& progressCallback,
 							  const Http::Request::FieldTable& headers, const std::string& body,
@@ -613,32 +673,46 @@ void Http::postAsync( const Http::AsyncResponseCallback& cb, const URI& uri, con
 				  validateCertificate, proxy );
 }
 
-Http::Http() : mConnection( NULL ), mHost(), mPort( 0 ), mIsSSL( false ), mHostSolved( false ) {}
+Http::Http() :
+	mConnection( NULL ),
+	mHost(),
+	mPort( 0 ),
+	mAsyncWorkers( 0 ),
+	mMaxAsyncConnections( HTTP_MAX_ASYNC_CONNECTIONS ),
+	mIsSSL( false ),
+	mKeepAlive( true ) {}
 
 Http::Http( const std::string& host, unsigned short port, bool useSSL, URI proxy ) :
 	mConnection( NULL ),
 	mHostName( host ),
 	mPort( port ),
+	mAsyncWorkers( 0 ),
+	mMaxAsyncConnections( HTTP_MAX_ASYNC_CONNECTIONS ),
 	mIsSSL( useSSL ),
-	mHostSolved( false ),
+	mKeepAlive( true ),
 	mProxy( proxy ) {
 	setHost( host, port, useSSL, proxy );
 }
 
 Http::~Http() {
 	// First we wait to finish any request pending
-	for ( auto&& itt : mThreads ) {
-		itt->wait();
-	}
+	while ( true ) {
+		{
+			Lock l( mAsyncMutex );
 
-	for ( auto&& itt : mThreads ) {
-		eeDelete( itt );
+			if ( 0 == mAsyncWorkers )
+				break;
+		}
+
+		Sys::sleep( Milliseconds( 1 ) );
 	}
 
-	// Then we destroy the last open connection
+	// Then we destroy the open connections
 	HttpConnection* connection = mConnection;
 
 	eeSAFE_DELETE( connection );
+
+	clearIdleConnections();
 }
 
 void Http::setHost( const std::string& host, unsigned short port, bool useSSL, URI proxy ) {
@@ -688,6 +762,9 @@ void Http::setHost( const std::string& host, unsigned short port, bool useSSL, U
 		eeSAFE_DELETE( connection );
 		mConnection = NULL;
 	}
+
+	if ( !sameHost )
+		clearIdleConnections();
 }
 
 Http::Response Http::sendRequest( const Http::Request& request, Time timeout ) {
@@ -697,6 +774,25 @@ Http::Response Http::sendRequest( const Http::Request& request, Time timeout ) {
 	return response;
 }
 
+Http::Response Http::streamRequest( const Http::Request& request,
+									const Http::BodyConsumer& consumer, Time timeout ) {
+	HttpStreamConsumer stream( [&request, &consumer]( const char* data, std::size_t size ) {
+		if ( consumer( data, size ) )
+			return true;
+
+		request.mCancel = true;
+		return false;
+	} );
+
+	return downloadRequest( request, stream, timeout );
+}
+
+// Requests that can be sent again if the connection was lost before receiving the response
+static bool isRetryable( const Http::Request& request ) {
+	return request.getMethod() != Http::Request::Post &&
+		   request.getMethod() != Http::Request::Patch && !request.isCancelled();
+}
+
 static bool sendProgress( const Http& http, const Http::Request& request,
 						  const Http::Response& response, const Http::Request::Status& status,
 						  const std::size_t& totalBytes, const std::size_t& currentBytes ) {
@@ -708,20 +804,22 @@ static bool sendProgress( const Http& http, const Http::Request& request,
 
 Http::Response Http::downloadRequest( const Http::Request& request, IOStream& writeTo,
 									  Time timeout ) {
-	// Solve the host IP only when the request starts.
-	if ( !mHostSolved ) {
-		if ( !mProxy.empty() ) {
-			mHost = IpAddress( mProxy.getHost() );
-		} else {
-			mHost = IpAddress( mHostName );
-		}
-		mHostSolved = true;
+	// Solve the host IP only when the request starts ( the DNS cache keeps it for a while ).
+	IpAddress host = resolveHost( !mProxy.empty() ? mProxy.getHost() : mHostName );
+
+	{
+		Lock l( mConnectionsMutex );
+		mHost = host;
 	}
 
-	if ( 0 == mHost.toInteger() ) {
+	if ( 0 == host.toInteger() ) {
 		return Response();
 	}
 
+	// Reuse an idle keep-alive connection to the host if there's one
+	if ( NULL == mConnection )
+		mConnection = acquireConnection();
+
 	if ( NULL == mConnection ) {
 		HttpConnection* connection = eeNew( HttpConnection, () );
 		TcpSocket* socket = NULL;
@@ -751,10 +849,16 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 		}
 
 		connection->setSocket( socket );
+		connection->setKeepAlive( mKeepAlive );
 
 		mConnection = connection;
+	} else if ( mConnection->isConnected() && mConnection->isStale() ) {
+		mConnection->disconnect();
 	}
 
+	// A connection that was already open can be closed by the server at any moment
+	bool reused = mConnection->isConnected();
+
 	// First make sure that the request is valid -- add missing mandatory fields
 	Request toSend( prepareFields( request ) );
 
@@ -768,14 +872,14 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 			SSLSocket* sslSocket = reinterpret_cast<SSLSocket*>( mConnection->getSocket() );
 
 			// For an HTTP Tunnel first we need to connect to the proxy server ( without TLS )
-			if ( sslSocket->tcpConnect( mHost, mProxy.getPort(), timeout ) != Socket::Done ) {
+			if ( sslSocket->tcpConnect( host, mProxy.getPort(), timeout ) != Socket::Done ) {
 				return received;
 			} else {
 				mConnection->setConnected( true );
 			}
 		} else {
 			if ( mConnection->getSocket()->connect(
-					 mHost, mProxy.empty() ? mPort : mProxy.getPort(), timeout ) != Socket::Done ) {
+					 host, mProxy.empty() ? mPort : mProxy.getPort(), timeout ) != Socket::Done ) {
 				return received;
 			} else {
 				mConnection->setConnected( true );
@@ -815,7 +919,7 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 
 					if ( tunnelResponse.getStatus() == Response::Ok ) {
 						// Stablish the SSL connection if the response is positive
-						if ( sslSocket->sslConnect( mHost, mProxy.getPort(), timeout ) !=
+						if ( sslSocket->sslConnect( host, mProxy.getPort(), timeout ) !=
 							 Socket::Done ) {
 							return received;
 						}
@@ -867,7 +971,7 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 		}
 
 		if ( !requestStr.empty() ) {
-			Socket::Status status;
+			Socket::Status status = Socket::Done;
 
 			// Send it through the socket
 			if ( mConnection->getSocket()->send( requestStr.c_str(), requestStr.size() ) ==
@@ -886,6 +990,9 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 				bool isnheader = false;
 				bool chunked = false;
 				bool compressed = false;
+				bool hasContentLength = false;
+				bool bodyless = false;
+				bool messageComplete = false;
 				Uint64 contentLength = 0;
 				std::string headerBuffer;
 				HttpStreamChunked* chunkedStream = NULL;
@@ -964,13 +1071,21 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 
 									// Get the content length
 									if ( !received.getField( "content-length" ).empty() ) {
-										if ( !String::fromString(
-												 contentLength,
-												 received.getField( "content-length" ) ) )
+										hasContentLength = String::fromString(
+											contentLength, received.getField( "content-length" ) );
+
+										if ( !hasContentLength )
 											contentLength = 0;
 									}
 
-									if ( received.getField( "connection" ) == "closed" ) {
+									// Responses that never have a body
+									bodyless = request.getMethod() == Request::Head ||
+											   received.getStatus() < 200 ||
+											   received.getStatus() == Response::NoContent ||
+											   received.getStatus() == Response::NotModified;
+
+									if ( String::toLower( received.getField( "connection" ) ) ==
+										 "close" ) {
 										mConnection->setConnected( false );
 										mConnection->setTunneled( false );
 									}
@@ -988,9 +1103,9 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 											std::string location( received.getField( "location" ) );
 											URI uri( location );
 
-											// Close the connection
-											if ( !mConnection->isKeepAlive() )
-												mConnection->disconnect();
+											// Close the connection, the body of the
+											// redirection is not read so it can't be reused
+											mConnection->disconnect();
 
 											eeSAFE_DELETE( chunkedStream );
 											eeSAFE_DELETE( inflateStream );
@@ -1049,16 +1164,27 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 						if ( readed > 0 )
 							bufferStream->write( readBuffer, readed );
 
+						// The body consumer cancelled the request or the body is malformed
+						if ( request.isCancelled() || ( chunked && chunkedStream->hasFailed() ) )
+							break;
+
 						if ( !sendProgress( *this, request, received, Request::ContentReceived,
 											contentLength, currentTotalBytes ) ) {
 							request.mCancel = true;
 							break;
 						}
 
+						// The message ended, the connection is ready for the next request
+						if ( bodyless ||
+							 ( hasContentLength && contentLength == currentTotalBytes ) ||
+							 ( chunked && chunkedStream->isComplete() ) ) {
+							messageComplete = true;
+							break;
+						}
+
 						// If the response is compressed and the stream ended means that we received
 						// the message. So we can skip the socket receive call.
-						if ( ( compressed && NULL != inflateStream && !inflateStream->isOpen() ) ||
-							 ( contentLength > 0 && contentLength == currentTotalBytes ) ) {
+						if ( compressed && NULL != inflateStream && !inflateStream->isOpen() ) {
 							break;
 						}
 					}
@@ -1077,13 +1203,26 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 				if ( status == Socket::Status::Disconnected ) {
 					mConnection->setConnected( false );
 					mConnection->setTunneled( false );
+				} else if ( !messageComplete ) {
+					// Unread data could remain in the connection
+					mConnection->disconnect();
 				}
 
 				eeSAFE_DELETE( chunkedStream );
 				eeSAFE_DELETE( inflateStream );
+
+				// The server closed the reused connection before answering, try once again with a
+				// new connection
+				if ( reused && status == Socket::Status::Disconnected && !isnheader &&
+					 0 == len && isRetryable( request ) ) {
+					return downloadRequest( request, writeTo, timeout );
+				}
 			} else {
 				mConnection->setConnected( false );
 				mConnection->setTunneled( false );
+
+				if ( reused && isRetryable( request ) )
+					return downloadRequest( request, writeTo, timeout );
 			}
 		}
 
@@ -1097,7 +1236,7 @@ Http::Response Http::downloadRequest( const Http::Request& request, IOStream& wr
 
 Http::Response Http::downloadRequest( const Http::Request& request, std::string writePath,
 									  Time timeout ) {
-	IOStreamFile file( writePath, request.isContinue() ? "ab+" : "wb+" );
+	HttpStreamFile file( writePath, request.isContinue() ? "ab+" : "wb+" );
 	return downloadRequest( request, file, timeout );
 }
 
@@ -1111,7 +1250,6 @@ Http::AsyncRequest::AsyncRequest( Http* http, const Http::AsyncResponseCallback&
 	mCb( cb ),
 	mRequest( request ),
 	mTimeout( timeout ),
-	mRunning( true ),
 	mStreamed( false ),
 	mStreamOwned( false ),
 	mStream( NULL ) {}
@@ -1122,7 +1260,6 @@ Http::AsyncRequest::AsyncRequest( Http* http, const Http::AsyncResponseCallback&
 	mCb( cb ),
 	mRequest( request ),
 	mTimeout( timeout ),
-	mRunning( true ),
 	mStreamed( true ),
 	mStreamOwned( false ),
 	mStream( &writeTo ) {}
@@ -1133,10 +1270,26 @@ Http::AsyncRequest::AsyncRequest( Http* http, const Http::AsyncResponseCallback&
 	mCb( cb ),
 	mRequest( request ),
 	mTimeout( timeout ),
-	mRunning( true ),
 	mStreamed( true ),
 	mStreamOwned( true ),
-	mStream( IOStreamFile::New( writePath, "wb" ) ) {}
+	mStream( eeNew( HttpStreamFile, ( writePath, "wb" ) ) ) {}
+
+Http::AsyncRequest::AsyncRequest( Http* http, const Http::AsyncResponseCallback& cb,
+								  Http::Request request, const Http::BodyConsumer& consumer,
+								  Time timeout ) :
+	mHttp( http ),
+	mCb( cb ),
+	mRequest( request ),
+	mTimeout( timeout ),
+	mStreamed( true ),
+	mStreamOwned( true ),
+	mStream( eeNew( HttpStreamConsumer, ( [this, consumer]( const char* data, std::size_t size ) {
+		if ( consumer( data, size ) )
+			return true;
+
+		mRequest.cancel();
+		return false;
+	} ) ) ) {}
 
 Http::AsyncRequest::~AsyncRequest() {
 	if ( mStreamOwned )
@@ -1147,39 +1300,96 @@ void Http::AsyncRequest::run() {
 	Http::Response response = mStreamed ? mHttp->downloadRequest( mRequest, *mStream, mTimeout )
 										: mHttp->sendRequest( mRequest, mTimeout );
 
-	mCb( *mHttp, mRequest, response );
+	// The connection goes back to the host pool, ready for the next queued request
+	mHttp->releaseConnection();
 
+	// Close the owned stream first, so the downloaded file is complete in the callback
 	if ( mStreamed && mStreamOwned ) {
 		eeSAFE_DELETE( mStream );
 	}
 
-	// The Async Request destroys the socket used to create the request
-	HttpConnection* connection = mHttp->mConnection;
-	eeSAFE_DELETE( connection );
-	mHttp->mConnection = NULL;
+	mCb( *mHttp, mRequest, response );
+}
+
+Http::HttpConnection* Http::acquireConnection() {
+	Lock l( mConnectionsMutex );
+
+	while ( !mIdleConnections.empty() ) {
+		HttpConnection* connection = mIdleConnections.back();
+		mIdleConnections.pop_back();
+
+		if ( connection->isConnected() && connection->getIdleTime() < HTTP_KEEP_ALIVE_TIMEOUT &&
+			 !connection->isStale() )
+			return connection;
+
+		eeDelete( connection );
+	}
 
-	mRunning = false;
+	return NULL;
 }
 
-void Http::removeOldThreads() {
-	std::vector<AsyncRequest*> remove;
+void Http::releaseConnection() {
+	HttpConnection* connection = mConnection;
+	mConnection = NULL;
+
+	if ( NULL == connection )
+		return;
+
+	if ( mKeepAlive && connection->isKeepAlive() && connection->isConnected() ) {
+		connection->resetIdleTime();
+		Lock l( mConnectionsMutex );
+		mIdleConnections.push_back( connection );
+	} else {
+		eeDelete( connection );
+	}
+}
+
+void Http::clearIdleConnections() {
+	Lock l( mConnectionsMutex );
+
+	for ( HttpConnection* connection : mIdleConnections )
+		eeDelete( connection );
 
-	for ( AsyncRequest* ar : mThreads ) {
-		if ( ar->mRunning )
-			continue;
-		// We need to be sure, since the state is set in the thread, this will not block the
-		// thread anyway
-		ar->wait();
+	mIdleConnections.clear();
+}
+
+void Http::queueAsyncRequest( AsyncRequest* asyncRequest ) {
+	bool newWorker = false;
 
-		eeDelete( ar );
+	{
+		Lock l( mAsyncMutex );
+		mAsyncQueue.push_back( asyncRequest );
 
-		remove.push_back( ar );
+		if ( mAsyncWorkers < mMaxAsyncConnections ) {
+			mAsyncWorkers++;
+			newWorker = true;
+		}
 	}
 
-	for ( auto rem : remove ) {
-		auto found = std::find( mThreads.begin(), mThreads.end(), rem );
-		if ( found != mThreads.end() )
-			mThreads.erase( found );
+	// Each worker owns a connection to the host and consumes the queue until it's empty
+	if ( newWorker )
+		getIOThreadPool()->run( [this] { processAsyncQueue(); } );
+}
+
+void Http::processAsyncQueue() {
+	while ( true ) {
+		AsyncRequest* asyncRequest = NULL;
+
+		{
+			Lock l( mAsyncMutex );
+
+			if ( mAsyncQueue.empty() ) {
+				mAsyncWorkers--;
+				return;
+			}
+
+			asyncRequest = mAsyncQueue.front();
+			mAsyncQueue.pop_front();
+		}
+
+		asyncRequest->run();
+
+		eeDelete( asyncRequest );
 	}
 }
 
@@ -1239,18 +1449,59 @@ bool Http::isProxied() const {
 	return !mProxy.empty();
 }
 
+void Http::setKeepAlive( bool keepAlive ) {
+	mKeepAlive = keepAlive;
+
+	if ( !mKeepAlive )
+		clearIdleConnections();
+}
+
+bool Http::isKeepAlive() const {
+	return mKeepAlive;
+}
+
+void Http::setMaxAsyncConnections( Uint32 maxConnections ) {
+	Lock l( mAsyncMutex );
+	mMaxAsyncConnections = eemax( maxConnections, 1u );
+}
+
+Uint32 Http::getMaxAsyncConnections() const {
+	return mMaxAsyncConnections;
+}
+
+void Http::setDNSCacheTTL( const Time& ttl ) {
+	Lock l( sDNSCacheMutex );
+	sDNSCacheTTL = ttl;
+}
+
+Time Http::getDNSCacheTTL() {
+	Lock l( sDNSCacheMutex );
+	return sDNSCacheTTL;
+}
+
+void Http::clearDNSCache() {
+	Lock l( sDNSCacheMutex );
+	sDNSCache.clear();
+}
+
 #if EE_PLATFORM == EE_PLATFORM_EMSCRIPTEN
 struct WGetAsyncRequest {
 	Http* http;
 	Http::Request request;
 	Http::AsyncResponseCallback cb;
 	IOStream* writeTo{ nullptr };
+	Http::BodyConsumer consumer;
 };
 
 void emscripten_async_wget2_got_data( unsigned, void* vwget, void* buffer, unsigned bufferSize ) {
 	WGetAsyncRequest* wget = reinterpret_cast<WGetAsyncRequest*>( vwget );
 	Http::Response::Status status = Http::Response::Status::Ok;
-	if ( wget->writeTo ) {
+	if ( wget->consumer ) {
+		wget->consumer( (const char*)buffer, bufferSize );
+		Http::Response response =
+			Http::Response::createFakeResponse( Http::Response::FieldTable(), status, "" );
+		wget->cb( *wget->http, wget->request, response );
+	} else if ( wget->writeTo ) {
 		wget->writeTo->write( (const char*)buffer, bufferSize );
 		Http::Response response =
 			Http::Response::createFakeResponse( Http::Response::FieldTable(), status, "" );
@@ -1309,18 +1560,7 @@ void Http::sendAsyncRequest( const Http::AsyncResponseCallback& cb, const Http::
 								 emscripten_async_wget2_got_data,
 								 emscripten_async_wget2_got_error_data, NULL );
 #else
-	if ( sGlobalThreadPool ) {
-		sGlobalThreadPool->run( [this, cb, request, timeout] {
-			AsyncRequest asyncRequest( this, cb, request, timeout );
-			asyncRequest.run();
-		} );
-		return;
-	}
-	AsyncRequest* thread = eeNew( AsyncRequest, ( this, cb, request, timeout ) );
-	thread->launch();
-	Lock l( mThreadsMutex );
-	removeOldThreads();
-	mThreads.push_back( thread );
+	queueAsyncRequest( eeNew( AsyncRequest, ( this, cb, request, timeout ) ) );
 #endif
 }
 
@@ -1338,18 +1578,7 @@ void Http::downloadAsyncRequest( const Http::AsyncResponseCallback& cb,
 								 emscripten_async_wget2_got_data,
 								 emscripten_async_wget2_got_error_data, NULL );
 #else
-	if ( sGlobalThreadPool ) {
-		sGlobalThreadPool->run( [this, cb, request, &writeTo, timeout] {
-			AsyncRequest asyncRequest( this, cb, request, writeTo, timeout );
-			asyncRequest.run();
-		} );
-		return;
-	}
-	AsyncRequest* thread = eeNew( AsyncRequest, ( this, cb, request, writeTo, timeout ) );
-	thread->launch();
-	Lock l( mThreadsMutex );
-	removeOldThreads();
-	mThreads.push_back( thread );
+	queueAsyncRequest( eeNew( AsyncRequest, ( this, cb, request, writeTo, timeout ) ) );
 #endif
 }
 
@@ -1367,18 +1596,26 @@ void Http::downloadAsyncRequest( const Http::AsyncResponseCallback& cb,
 							emscripten_async_wget2_got_file, emscripten_async_wget2_got_error_file,
 							NULL );
 #else
-	if ( sGlobalThreadPool ) {
-		sGlobalThreadPool->run( [this, cb, request, writePath, timeout] {
-			AsyncRequest asyncRequest( this, cb, request, writePath, timeout );
-			asyncRequest.run();
-		} );
-		return;
-	}
-	AsyncRequest* thread = eeNew( AsyncRequest, ( this, cb, request, writePath, timeout ) );
-	thread->launch();
-	Lock l( mThreadsMutex );
-	removeOldThreads();
-	mThreads.push_back( thread );
+	queueAsyncRequest( eeNew( AsyncRequest, ( this, cb, request, writePath, timeout ) ) );
+#endif
+}
+
+void Http::streamAsyncRequest( const Http::AsyncResponseCallback& cb,
+							   const Http::Request& request, const Http::BodyConsumer& consumer,
+							   Time timeout ) {
+#if EE_PLATFORM == EE_PLATFORM_EMSCRIPTEN
+	WGetAsyncRequest* wget = new WGetAsyncRequest();
+	wget->http = this;
+	wget->cb = cb;
+	wget->consumer = consumer;
+	wget->request = Http::Request( request );
+	emscripten_async_wget2_data( ( getURI().toString() + request.getUri() ).c_str(),
+								 Request::methodToString( request.getMethod() ).c_str(),
+								 URI( request.getUri() ).getQuery().c_str(), wget, 1,
+								 emscripten_async_wget2_got_data,
+								 emscripten_async_wget2_got_error_data, NULL );
+#else
+	queueAsyncRequest( eeNew( AsyncRequest, ( this, cb, request, consumer, timeout ) ) );
 #endif
 }
 
@@ -1408,10 +1645,16 @@ Http::HttpConnection::HttpConnection() :
 	mIsConnected( false ),
 	mIsTunneled( false ),
 	mIsSSL( false ),
-	mIsKeepAlive( false ) {}
+	mIsKeepAlive( false ),
+	mIdleSince( 0 ) {}
 
 Http::HttpConnection::HttpConnection( TcpSocket* socket ) :
-	mSocket( socket ), mIsConnected( false ), mIsTunneled( false ), mIsSSL( false ) {}
+	mSocket( socket ),
+	mIsConnected( false ),
+	mIsTunneled( false ),
+	mIsSSL( false ),
+	mIsKeepAlive( false ),
+	mIdleSince( 0 ) {}
 
 Http::HttpConnection::~HttpConnection() {
 	eeSAFE_DELETE( mSocket );
@@ -1430,6 +1673,7 @@ void Http::HttpConnection::disconnect() {
 		mSocket->disconnect();
 
 	mIsConnected = false;
+	mIsTunneled = false;
 }
 
 const bool& Http::HttpConnection::isConnected() const {
@@ -1464,6 +1708,24 @@ void Http::HttpConnection::setKeepAlive( const bool& isKeepAlive ) {
 	mIsKeepAlive = isKeepAlive;
 }
 
+bool Http::HttpConnection::isStale() {
+	if ( NULL == mSocket )
+		return true;
+
+	// Nothing should be readable from an idle connection, unless the server closed it
+	SocketSelector selector;
+	selector.add( *mSocket );
+	return selector.wait( Microseconds( 1 ) ) && selector.isReady( *mSocket );
+}
+
+Time Http::HttpConnection::getIdleTime() const {
+	return Milliseconds( Sys::getTicks() - mIdleSince );
+}
+
+void Http::HttpConnection::resetIdleTime() {
+	mIdleSince = Sys::getTicks();
+}
+
 Http::Pool& Http::Pool::getGlobal() {
 	return sGlobalHttpPool;
 }
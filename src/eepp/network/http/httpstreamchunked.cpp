@@ -1,105 +1,88 @@
+#include <cstring>
 #include <eepp/network/http/httpstreamchunked.hpp>
 
 namespace EE { namespace Network { namespace Private {
 
-HttpStreamChunked::HttpStreamChunked( IOStream& mWriteTo ) :
-	mWriteTo( mWriteTo ), mChunkNewBuffer( false ), mChunkEnded( false ) {}
+// Longest chunk size line accepted ( the size plus the chunk extensions )
+static constexpr std::size_t HTTP_CHUNK_SIZE_LINE_MAX = 4096;
+
+HttpStreamChunked::HttpStreamChunked( IOStream& mWriteTo ) : mWriteTo( mWriteTo ) {}
 
 ios_size HttpStreamChunked::write( const char* data, ios_size size ) {
 	ios_size writeTotal = 0;
+	const char* end = data + size;
 
-	// If the chunk reading ended we just add the buffer received as a header
-	// Otherwise we process the buffer data as chunk
-	if ( !mChunkEnded ) {
-		// Keep a chunk buffer until the end of chunk is found
-		mChunkBuffer.append( data, size );
-
-		// If the new chunk starts with \r\n and the last removed chunk
-		// did not contain the trailing \r\n, we remove it to detect
-		// correctly the next length data
-		if ( mChunkNewBuffer ) {
-			if ( mChunkBuffer.substr( 0, 2 ) == "\r\n" ) {
-				mChunkBuffer = mChunkBuffer.substr( 2 );
-			}
+	while ( data < end ) {
+		switch ( mState ) {
+			case State::Size: {
+				// Keep the size line until it's complete
+				const char* eol = static_cast<const char*>( memchr( data, '\n', end - data ) );
 
-			mChunkNewBuffer = false;
-		}
+				if ( NULL == eol ) {
+					mChunkBuffer.append( data, end - data );
+					data = end;
+
+					if ( mChunkBuffer.size() > HTTP_CHUNK_SIZE_LINE_MAX )
+						mState = State::Failed;
+
+					break;
+				}
+
+				mChunkBuffer.append( data, eol - data );
+				data = eol + 1;
+
+				// Ignore the chunk extensions
+				std::string::size_type sizeEnd = mChunkBuffer.find_first_of( ";\r" );
+				std::string sizeStr( String::trim( mChunkBuffer.substr( 0, sizeEnd ) ) );
+				mChunkBuffer.clear();
 
-		bool retry;
-
-		do {
-			retry = false;
-
-			// Check for the first \r\n to find the end of the length definition
-			std::string::size_type lenEnd = mChunkBuffer.find( "\r\n" );
-
-			if ( lenEnd != std::string::npos ) {
-				std::string::size_type firstCharPos = lenEnd + 2;
-				Uint64 length;
-
-				// Get the length of the chunk
-				bool res = String::fromString( length, mChunkBuffer.substr( 0, lenEnd ), 16 );
-
-				// If the length is solved...
-				if ( res ) {
-					// And it's bigger than 0, means that there are more chunks
-					if ( length > 0 ) {
-						// Check if the chunk buffer size at least equals to the length reported
-						if ( mChunkBuffer.size() - firstCharPos >= length ) {
-							// In that case write the chunk to the file buffer
-							writeTotal = mWriteTo.write( &mChunkBuffer[firstCharPos], length );
-
-							// And keep the remaining not completed chunk
-							mChunkBuffer = mChunkBuffer.substr( firstCharPos + length );
-
-							// Check if already have the \r\n of the next length in the buffer
-							if ( !mChunkBuffer.empty() ) {
-								std::size_t pos = 0;
-
-								// Remove al the \r\n remaining
-								while ( pos < mChunkBuffer.size() &&
-										0 == strncmp( &mChunkBuffer[pos], "\r\n", 2 ) ) {
-									pos += 2;
-								}
-
-								if ( pos > 0 ) {
-									// Remove it to be able to read the next length
-									mChunkBuffer = mChunkBuffer.substr( pos );
-								}
-
-								// If still the chunk is not empty it could be another chunk
-								// already received, so we check that retrying
-								if ( !mChunkBuffer.empty() ) {
-									std::string::size_type lenEnd =
-										mChunkBuffer.find_first_of( "\r\n" );
-
-									if ( lenEnd != std::string::npos ) {
-										bool res = String::fromString(
-											length, mChunkBuffer.substr( 0, lenEnd ), 16 );
-
-										if ( res && length > 0 ) {
-											retry = true;
-										}
-									}
-								}
-							}
-
-							// If the next chunk received starts with \r\n it's because
-							// it's part of the chunk size information, so we need to flag it
-							// to remove it
-							mChunkNewBuffer = true;
-						}
-					} else {
-						// If the value is 0 means that the data ended
-						// But after this we can receive extra headers
-						mChunkEnded = true;
-						mChunkBuffer.clear();
-					}
+				// Some servers send an extra empty line between the chunks
+				if ( sizeStr.empty() )
+					break;
+
+				if ( !String::fromString( mChunkRemaining, sizeStr, 16 ) ) {
+					mState = State::Failed;
+					break;
 				}
+
+				// A zero length chunk means that the data ended, but after this we can receive
+				// the trailer headers
+				mState = mChunkRemaining > 0 ? State::Data : State::Trailer;
+				break;
 			}
-		} while ( retry );
-	} else {
-		mHeaderBuffer.append( data, size );
+			case State::Data: {
+				// Write the chunk data straight from the received buffer
+				std::size_t length =
+					static_cast<std::size_t>( eemin<Uint64>( mChunkRemaining, end - data ) );
+
+				writeTotal += mWriteTo.write( data, length );
+				data += length;
+				mChunkRemaining -= length;
+
+				if ( 0 == mChunkRemaining )
+					mState = State::DataEnd;
+				break;
+			}
+			case State::DataEnd: {
+				// Skip the \r\n that ends the chunk data
+				if ( *data == '\n' )
+					mState = State::Size;
+				else if ( *data != '\r' )
+					mState = State::Failed;
+
+				++data;
+				break;
+			}
+			case State::Trailer: {
+				mHeaderBuffer.append( data, end - data );
+				data = end;
+				break;
+			}
+			case State::Failed: {
+				data = end;
+				break;
+			}
+		}
 	}
 
 	return writeTotal;
@@ -109,4 +92,15 @@ const std::string& HttpStreamChunked::getHeaderBuffer() const {
 	return mHeaderBuffer;
 }
 
+bool HttpStreamChunked::isComplete() const {
+	// The trailer headers end with an empty line
+	return mState == State::Trailer && ( mHeaderBuffer.compare( 0, 2, "\r\n" ) == 0 ||
+										 mHeaderBuffer.compare( 0, 1, "\n" ) == 0 ||
+										 mHeaderBuffer.find( "\r\n\r\n" ) != std::string::npos );
+}
+
+bool HttpStreamChunked::hasFailed() const {
+	return mState == State::Failed;
+}
+
 }}} // namespace EE::Network::Private
@@ -8,6 +8,9 @@ using namespace EE::System;
 
 namespace EE { namespace Network { namespace Private {
 
+/** @brief Decodes a chunked transfer encoded body as it arrives.
+ * The chunk data is written straight from the received buffers to the output stream, only the
+ * chunk size lines and the trailer headers are buffered. */
 class HttpStreamChunked : public IOStreamString {
   public:
 	HttpStreamChunked( IOStream& mWriteTo );
@@ -16,12 +19,20 @@ class HttpStreamChunked : public IOStreamString {
 
 	const std::string& getHeaderBuffer() const;
 
+	/** @return True if the last chunk and the trailer headers were received */
+	bool isComplete() const;
+
+	/** @return True if the stream is not a valid chunked body */
+	bool hasFailed() const;
+
   protected:
+	enum class State { Size, Data, DataEnd, Trailer, Failed };
+
 	IOStream& mWriteTo;
-	std::string mChunkBuffer;
+	std::string mChunkBuffer; // The chunk size line being received
 	std::string mHeaderBuffer;
-	bool mChunkNewBuffer = false;
-	bool mChunkEnded = false;
+	Uint64 mChunkRemaining = 0;
+	State mState = State::Size;
 };
 
 }}} // namespace EE::Network::Private
@@ -0,0 +1,42 @@
+#include <eepp/network/http/httpstreamconsumer.hpp>
+
+namespace EE { namespace Network { namespace Private {
+
+HttpStreamConsumer::HttpStreamConsumer( const Consumer& consumer ) : mConsumer( consumer ) {}
+
+ios_size HttpStreamConsumer::read( char*, ios_size ) {
+	return 0;
+}
+
+ios_size HttpStreamConsumer::write( const char* data, ios_size size ) {
+	if ( !mOpen || size <= 0 )
+		return 0;
+
+	if ( !mConsumer( data, static_cast<std::size_t>( size ) ) ) {
+		mOpen = false;
+		return 0;
+	}
+
+	mPosition += size;
+
+	return size;
+}
+
+ios_size HttpStreamConsumer::seek( ios_size ) {
+	return mPosition;
+}
+
+ios_size HttpStreamConsumer::tell() {
+	return mPosition;
+}
+
+ios_size HttpStreamConsumer::getSize() {
+	// Nothing is kept, a continued download always starts from the beginning
+	return 0;
+}
+
+bool HttpStreamConsumer::isOpen() {
+	return mOpen;
+}
+
+}}} // namespace EE::Network::Private
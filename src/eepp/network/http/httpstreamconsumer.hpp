@@ -0,0 +1,39 @@
+#ifndef EE_NETWORK_HTTPSTREAMCONSUMER_HPP
+#define EE_NETWORK_HTTPSTREAMCONSUMER_HPP
+
+#include <eepp/system/iostream.hpp>
+#include <functional>
+
+using namespace EE::System;
+
+namespace EE { namespace Network { namespace Private {
+
+/** @brief A write only stream that hands every buffer written to a callback.
+ * Once the callback returns false the stream is closed and ignores the following writes. */
+class HttpStreamConsumer : public IOStream {
+  public:
+	typedef std::function<bool( const char* data, std::size_t size )> Consumer;
+
+	HttpStreamConsumer( const Consumer& consumer );
+
+	ios_size read( char* data, ios_size size );
+
+	ios_size write( const char* data, ios_size size );
+
+	ios_size seek( ios_size position );
+
+	ios_size tell();
+
+	ios_size getSize();
+
+	bool isOpen();
+
+  protected:
+	Consumer mConsumer;
+	ios_size mPosition{ 0 };
+	bool mOpen{ true };
+};
+
+}}} // namespace EE::Network::Private
+
+#endif // EE_NETWORK_HTTPSTREAMCONSUMER_HPP
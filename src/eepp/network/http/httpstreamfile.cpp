@@ -0,0 +1,105 @@
+#include <cstring>
+#include <eepp/network/http/httpstreamfile.hpp>
+#include <new>
+
+namespace EE { namespace Network { namespace Private {
+
+HttpStreamFile::HttpStreamFile( const std::string& path, const std::string& modes,
+								std::size_t blockSize ) :
+	mFile( path, modes ),
+	mBuffer( NULL ),
+	mBlockSize( eemax<std::size_t>( blockSize, BUFFER_ALIGNMENT ) ),
+	mBufferUsed( 0 ),
+	mBufferLimit( mBlockSize ) {
+	if ( mFile.isOpen() ) {
+		// The data is already buffered here
+		std::setvbuf( mFile.getFileHandle(), NULL, _IONBF, 0 );
+
+		mBuffer = static_cast<char*>(
+			::operator new( mBlockSize, std::align_val_t( BUFFER_ALIGNMENT ) ) );
+
+		alignToFilePosition();
+	}
+}
+
+HttpStreamFile::~HttpStreamFile() {
+	flush();
+
+	if ( NULL != mBuffer )
+		::operator delete( mBuffer, std::align_val_t( BUFFER_ALIGNMENT ) );
+}
+
+ios_size HttpStreamFile::read( char* data, ios_size size ) {
+	flush();
+	return mFile.read( data, size );
+}
+
+ios_size HttpStreamFile::write( const char* data, ios_size size ) {
+	if ( NULL == mBuffer || size <= 0 )
+		return 0;
+
+	std::size_t left = static_cast<std::size_t>( size );
+
+	while ( left > 0 ) {
+		std::size_t length = eemin( left, mBufferLimit - mBufferUsed );
+
+		std::memcpy( mBuffer + mBufferUsed, data, length );
+		mBufferUsed += length;
+		data += length;
+		left -= length;
+
+		if ( mBufferUsed == mBufferLimit )
+			flush();
+	}
+
+	return size;
+}
+
+ios_size HttpStreamFile::seek( ios_size position ) {
+	flush();
+	ios_size res = mFile.seek( position );
+	alignToFilePosition();
+	return res;
+}
+
+ios_size HttpStreamFile::tell() {
+	return mFile.tell() + static_cast<ios_size>( mBufferUsed );
+}
+
+ios_size HttpStreamFile::getSize() {
+	flush();
+
+	// IOStreamFile keeps the first size solved, and the file grows while downloading
+	std::FILE* fs = mFile.getFileHandle();
+
+	if ( NULL == fs )
+		return 0;
+
+	ios_size position = std::ftell( fs );
+	std::fseek( fs, 0, SEEK_END );
+	ios_size size = std::ftell( fs );
+	std::fseek( fs, position, SEEK_SET );
+
+	return size;
+}
+
+bool HttpStreamFile::isOpen() {
+	return mFile.isOpen();
+}
+
+void HttpStreamFile::flush() {
+	if ( mBufferUsed > 0 ) {
+		mFile.write( mBuffer, static_cast<ios_size>( mBufferUsed ) );
+		mBufferUsed = 0;
+		mBufferLimit = mBlockSize;
+	}
+}
+
+void HttpStreamFile::alignToFilePosition() {
+	ios_size position = mFile.tell();
+
+	mBufferLimit = position > 0 ? mBlockSize - static_cast<std::size_t>( position ) % mBlockSize
+								: mBlockSize;
+}
+
+}}} // namespace EE::Network::Private
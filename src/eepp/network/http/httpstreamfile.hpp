@@ -0,0 +1,52 @@
+#ifndef EE_NETWORK_HTTPSTREAMFILE_HPP
+#define EE_NETWORK_HTTPSTREAMFILE_HPP
+
+#include <eepp/system/iostreamfile.hpp>
+
+using namespace EE::System;
+
+namespace EE { namespace Network { namespace Private {
+
+/** @brief A file stream for downloads that writes in large blocks.
+ * The received data is collected in an aligned buffer and written to the file one whole block at
+ * a time, with the blocks aligned to the file offsets, instead of the small writes of each
+ * received packet. The C stream buffering is disabled to avoid copying the data twice. */
+class HttpStreamFile : public IOStream {
+  public:
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+	static constexpr std::size_t BUFFER_ALIGNMENT = 4096;
+
+	HttpStreamFile( const std::string& path, const std::string& modes,
+					std::size_t blockSize = DEFAULT_BLOCK_SIZE );
+
+	virtual ~HttpStreamFile();
+
+	ios_size read( char* data, ios_size size );
+
+	ios_size write( const char* data, ios_size size );
+
+	ios_size seek( ios_size position );
+
+	ios_size tell();
+
+	ios_size getSize();
+
+	bool isOpen();
+
+	/** Writes the buffered data to the file */
+	void flush();
+
+  protected:
+	IOStreamFile mFile;
+	char* mBuffer;
+	std::size_t mBlockSize;
+	std::size_t mBufferUsed;
+	std::size_t mBufferLimit; // Size of the current block, the first one ends at a block boundary
+
+	void alignToFilePosition();
+};
+
+}}} // namespace EE::Network::Private
+
+#endif // EE_NETWORK_HTTPSTREAMFILE_HPP
@@ -8,7 +8,7 @@
 
 namespace EE { namespace Network {
 
-Packet::Packet() : mReadPos( 0 ), mSendPos( 0 ), mIsValid( true ) {}
+Packet::Packet() : mReadPos( 0 ), mSendPos( 0 ), mIsValid( true ), mReferencedSize( 0 ) {}
 
 Packet::~Packet() {}
 
@@ -17,25 +17,71 @@ void Packet::append( const void* data, std::size_t sizeInBytes ) {
 		std::size_t start = mData.size();
 		mData.resize( start + sizeInBytes );
 		std::memcpy( &mData[start], data, sizeInBytes );
+
+		if ( !mSegments.empty() ) {
+			if ( NULL == mSegments.back().Data ) {
+				mSegments.back().Size += sizeInBytes;
+			} else {
+				mSegments.push_back( { NULL, start, sizeInBytes } );
+			}
+		}
 	}
 }
 
+void Packet::appendReference( const void* data, std::size_t sizeInBytes ) {
+	if ( data && ( sizeInBytes > 0 ) ) {
+		// The data already stored becomes the first range
+		if ( mSegments.empty() && !mData.empty() )
+			mSegments.push_back( { NULL, 0, mData.size() } );
+
+		mSegments.push_back( { static_cast<const char*>( data ), 0, sizeInBytes } );
+		mReferencedSize += sizeInBytes;
+	}
+}
+
+bool Packet::hasReferences() const {
+	return !mSegments.empty();
+}
+
+void Packet::flatten() {
+	if ( mSegments.empty() )
+		return;
+
+	std::vector<char> data( mData.size() + mReferencedSize );
+	std::size_t pos = 0;
+
+	for ( const auto& segment : mSegments ) {
+		std::memcpy( &data[pos], segment.Data ? segment.Data : &mData[segment.Offset],
+					 segment.Size );
+		pos += segment.Size;
+	}
+
+	mData.swap( data );
+	mSegments.clear();
+	mReferencedSize = 0;
+}
+
 void Packet::clear() {
 	mData.clear();
+	mSegments.clear();
+	mReferencedSize = 0;
 	mReadPos = 0;
 	mIsValid = true;
 }
 
 const void* Packet::getData() const {
+	// Copying the referenced data doesn't change the packet contents
+	const_cast<Packet*>( this )->flatten();
+
 	return !mData.empty() ? &mData[0] : NULL;
 }
 
 std::size_t Packet::getDataSize() const {
-	return mData.size();
+	return mData.size() + mReferencedSize;
 }
 
 bool Packet::endOfPacket() const {
-	return mReadPos >= mData.size();
+	return mReadPos >= getDataSize();
 }
 
 Packet::operator BoolType() const {
@@ -328,6 +374,8 @@ Packet& Packet::operator<<( const String& data ) {
 }
 
 bool Packet::checkSize( std::size_t size ) {
+	flatten();
+
 	mIsValid = mIsValid && ( mReadPos + size <= mData.size() );
 	return mIsValid;
 }
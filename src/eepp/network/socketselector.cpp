@@ -1,10 +1,18 @@
 #include <algorithm>
+#include <eepp/core/containers.hpp>
 #include <eepp/network/platform/platformimpl.hpp>
 #include <eepp/network/socket.hpp>
 #include <eepp/network/socketselector.hpp>
 #include <eepp/system/log.hpp>
 #include <utility>
 
+#if EE_PLATFORM == EE_PLATFORM_LINUX || EE_PLATFORM == EE_PLATFORM_ANDROID
+#define EE_SOCKETSELECTOR_EPOLL
+#include <cerrno>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 #if EE_PLATFORM == EE_PLATFORM_HAIKU
 #include <sys/select.h>
 #endif
@@ -17,10 +25,55 @@
 namespace EE { namespace Network {
 
 struct SocketSelector::SocketSelectorImpl {
+	struct Entry {
+		Socket* socket;
+		Uint64 readyWait; ///< The wait call that reported the socket as ready
+		bool edgeTriggered;
+	};
+
+	UnorderedMap<SocketHandle, Entry> Sockets; ///< All the sockets, by handle
+	std::vector<Socket*> Ready;				   ///< The sockets ready in the last wait call
+	Uint64 WaitCount{ 0 };					   ///< Number of wait calls
+	bool EdgeTriggered{ false };
+#ifdef EE_SOCKETSELECTOR_EPOLL
+	int EpollHandle;				 ///< The epoll instance
+	std::vector<epoll_event> Events; ///< Buffer for the events returned by epoll_wait
+
+	SocketSelectorImpl() : EpollHandle( epoll_create1( EPOLL_CLOEXEC ) ) {}
+
+	SocketSelectorImpl( const SocketSelectorImpl& copy ) :
+		Sockets( copy.Sockets ),
+		Ready( copy.Ready ),
+		WaitCount( copy.WaitCount ),
+		EdgeTriggered( copy.EdgeTriggered ),
+		EpollHandle( epoll_create1( EPOLL_CLOEXEC ) ) {
+		// The epoll instance can't be shared, register the sockets again
+		for ( const auto& socket : Sockets )
+			registerHandle( socket.first, socket.second.edgeTriggered );
+	}
+
+	~SocketSelectorImpl() {
+		if ( -1 != EpollHandle )
+			::close( EpollHandle );
+	}
+
+	bool registerHandle( SocketHandle handle, bool edgeTriggered ) {
+		epoll_event event{};
+		event.events = EPOLLIN | ( edgeTriggered ? static_cast<uint32_t>( EPOLLET ) : 0 );
+		event.data.fd = handle;
+
+		if ( 0 == epoll_ctl( EpollHandle, EPOLL_CTL_ADD, handle, &event ) )
+			return true;
+
+		// Still registered ( the same socket added again ), just update its events
+		return EEXIST == errno && 0 == epoll_ctl( EpollHandle, EPOLL_CTL_MOD, handle, &event );
+	}
+#else
 	fd_set AllSockets;	 ///< Set containing all the sockets handles
 	fd_set SocketsReady; ///< Set containing handles of the sockets that are ready
 	int MaxSocket;		 ///< Maximum socket handle
 	int SocketCount;	 ///< Number of socket handles
+#endif
 };
 
 SocketSelector::SocketSelector() : mImpl( eeNew( SocketSelectorImpl, () ) ) {
@@ -38,7 +91,28 @@ void SocketSelector::add( Socket& socket ) {
 	SocketHandle handle = socket.getHandle();
 
 	if ( handle != Private::SocketImpl::invalidSocket() ) {
-#if EE_PLATFORM == EE_PLATFORM_WIN
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		// The handle can belong to a socket that was closed without being removed ( closing it
+		// unregistered it from epoll ) and whose handle was reused, so the entry is replaced and
+		// the handle registered again
+		auto it = mImpl->Sockets.find( handle );
+
+		if ( it != mImpl->Sockets.end() && it->second.socket != &socket ) {
+			auto ready = std::find( mImpl->Ready.begin(), mImpl->Ready.end(), it->second.socket );
+
+			if ( ready != mImpl->Ready.end() )
+				mImpl->Ready.erase( ready );
+		}
+
+		if ( !mImpl->registerHandle( handle, mImpl->EdgeTriggered ) ) {
+			Log::error( "The socket can't be added to the selector: epoll_ctl failed." );
+
+			if ( it != mImpl->Sockets.end() )
+				mImpl->Sockets.erase( it );
+
+			return;
+		}
+#elif EE_PLATFORM == EE_PLATFORM_WIN
 		if ( mImpl->SocketCount >= FD_SETSIZE ) {
 			Log::error( "The socket can't be added to the selector because its ID is too high. "
 						"This is a limitation of your operating system's FD_SETSIZE setting." );
@@ -60,7 +134,11 @@ void SocketSelector::add( Socket& socket ) {
 		mImpl->MaxSocket = std::max( mImpl->MaxSocket, handle );
 #endif
 
+#ifndef EE_SOCKETSELECTOR_EPOLL
 		FD_SET( handle, &mImpl->AllSockets );
+#endif
+
+		mImpl->Sockets[handle] = { &socket, 0, mImpl->EdgeTriggered };
 	}
 }
 
@@ -68,30 +146,78 @@ void SocketSelector::remove( Socket& socket ) {
 	SocketHandle handle = socket.getHandle();
 
 	if ( handle != Private::SocketImpl::invalidSocket() ) {
-#if EE_PLATFORM == EE_PLATFORM_WIN
-		if ( !FD_ISSET( handle, &mImpl->AllSockets ) )
+		auto it = mImpl->Sockets.find( handle );
+
+		if ( it == mImpl->Sockets.end() )
 			return;
 
-		mImpl->SocketCount--;
+		mImpl->Sockets.erase( it );
+
+		auto ready = std::find( mImpl->Ready.begin(), mImpl->Ready.end(), &socket );
+
+		if ( ready != mImpl->Ready.end() )
+			mImpl->Ready.erase( ready );
+
+#ifdef EE_SOCKETSELECTOR_EPOLL
+		// It fails if the socket was already closed, closing it already unregistered it
+		epoll_ctl( mImpl->EpollHandle, EPOLL_CTL_DEL, handle, NULL );
 #else
-		if ( handle >= FD_SETSIZE )
-			return;
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		mImpl->SocketCount--;
 #endif
 
 		FD_CLR( handle, &mImpl->AllSockets );
 		FD_CLR( handle, &mImpl->SocketsReady );
+#endif
 	}
 }
 
 void SocketSelector::clear() {
+#ifdef EE_SOCKETSELECTOR_EPOLL
+	// Recreating the epoll instance unregisters all the sockets at once
+	if ( !mImpl->Sockets.empty() || -1 == mImpl->EpollHandle ) {
+		if ( -1 != mImpl->EpollHandle )
+			::close( mImpl->EpollHandle );
+
+		mImpl->EpollHandle = epoll_create1( EPOLL_CLOEXEC );
+	}
+#else
 	FD_ZERO( &mImpl->AllSockets );
 	FD_ZERO( &mImpl->SocketsReady );
 
 	mImpl->MaxSocket = 0;
 	mImpl->SocketCount = 0;
+#endif
+
+	mImpl->Sockets.clear();
+	mImpl->Ready.clear();
 }
 
 bool SocketSelector::wait( Time timeout ) {
+	mImpl->WaitCount++;
+	mImpl->Ready.clear();
+
+#ifdef EE_SOCKETSELECTOR_EPOLL
+	// epoll works with milliseconds, shorter timeouts just poll the sockets
+	int timeoutMs =
+		timeout != Time::Zero ? static_cast<int>( timeout.asMicroseconds() / 1000 ) : -1;
+
+	mImpl->Events.resize( std::max<std::size_t>( mImpl->Sockets.size(), 1 ) );
+
+	int count = epoll_wait( mImpl->EpollHandle, mImpl->Events.data(),
+							static_cast<int>( mImpl->Events.size() ), timeoutMs );
+
+	for ( int i = 0; i < count; i++ ) {
+		auto it = mImpl->Sockets.find( mImpl->Events[i].data.fd );
+
+		if ( it != mImpl->Sockets.end() ) {
+			it->second.readyWait = mImpl->WaitCount;
+			mImpl->Ready.push_back( it->second.socket );
+		}
+	}
+
+	return count > 0;
+#else
 	// Setup the timeout
 	timeval time;
 	time.tv_sec = static_cast<long>( timeout.asMicroseconds() / 1000000 );
@@ -105,24 +231,48 @@ bool SocketSelector::wait( Time timeout ) {
 	int count = select( mImpl->MaxSocket + 1, &mImpl->SocketsReady, NULL, NULL,
 						timeout != Time::Zero ? &time : NULL );
 
+	if ( count > 0 ) {
+		for ( auto& socket : mImpl->Sockets ) {
+			if ( FD_ISSET( socket.first, &mImpl->SocketsReady ) ) {
+				socket.second.readyWait = mImpl->WaitCount;
+				mImpl->Ready.push_back( socket.second.socket );
+			}
+		}
+	}
+
 	return count > 0;
+#endif
 }
 
 bool SocketSelector::isReady( Socket& socket ) const {
 	SocketHandle handle = socket.getHandle();
 
 	if ( handle != Private::SocketImpl::invalidSocket() ) {
-#if EE_PLATFORM == EE_PLATFORM_WIN
-		if ( handle >= FD_SETSIZE )
-			return false;
-#endif
+		auto it = mImpl->Sockets.find( handle );
 
-		return FD_ISSET( handle, &mImpl->SocketsReady ) != 0;
+		return it != mImpl->Sockets.end() && mImpl->WaitCount > 0 &&
+			   it->second.readyWait == mImpl->WaitCount;
 	}
 
 	return false;
 }
 
+const std::vector<Socket*>& SocketSelector::getReadySockets() const {
+	return mImpl->Ready;
+}
+
+void SocketSelector::setEdgeTriggered( bool edgeTriggered ) {
+	mImpl->EdgeTriggered = edgeTriggered;
+}
+
+bool SocketSelector::isEdgeTriggered() const {
+	return mImpl->EdgeTriggered;
+}
+
+std::size_t SocketSelector::getSocketCount() const {
+	return mImpl->Sockets.size();
+}
+
 SocketSelector& SocketSelector::operator=( const SocketSelector& right ) {
 	SocketSelector temp( right );
 
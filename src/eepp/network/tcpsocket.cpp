@@ -4,12 +4,26 @@
 #include <eepp/network/platform/platformimpl.hpp>
 #include <eepp/network/tcpsocket.hpp>
 #include <eepp/system/clock.hpp>
+#include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/log.hpp>
 
 #if EE_PLATFORM == EE_PLATFORM_HAIKU
 #include <sys/select.h>
 #endif
 
+#if defined( EE_PLATFORM_POSIX )
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+#if EE_PLATFORM == EE_PLATFORM_LINUX || EE_PLATFORM == EE_PLATFORM_ANDROID
+#define EE_TCPSOCKET_SENDFILE
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <sys/sendfile.h>
+#endif
+
 #ifdef _MSC_VER
 #pragma warning( \
 	disable : 4127 ) // "conditional expression is constant" generated by the FD_SET macro
@@ -22,6 +36,55 @@ const int flags = MSG_NOSIGNAL;
 #else
 const int flags = 0;
 #endif
+
+// Platform buffer descriptor for scatter/gather I/O
+#if EE_PLATFORM == EE_PLATFORM_WIN
+typedef WSABUF IOVector;
+
+IOVector makeIOVector( const void* data, std::size_t size ) {
+	IOVector vec;
+	vec.buf = static_cast<char*>( const_cast<void*>( data ) );
+	vec.len = static_cast<ULONG>( size );
+	return vec;
+}
+
+std::size_t getIOVectorSize( const IOVector& vec ) {
+	return vec.len;
+}
+
+void advanceIOVector( IOVector& vec, std::size_t bytes ) {
+	vec.buf += bytes;
+	vec.len -= static_cast<ULONG>( bytes );
+}
+#else
+typedef iovec IOVector;
+
+IOVector makeIOVector( const void* data, std::size_t size ) {
+	IOVector vec;
+	vec.iov_base = const_cast<void*>( data );
+	vec.iov_len = size;
+	return vec;
+}
+
+std::size_t getIOVectorSize( const IOVector& vec ) {
+	return vec.iov_len;
+}
+
+void advanceIOVector( IOVector& vec, std::size_t bytes ) {
+	vec.iov_base = static_cast<char*>( vec.iov_base ) + bytes;
+	vec.iov_len -= bytes;
+}
+#endif
+
+// Maximum number of buffers accepted by a single vectored call
+#if defined( IOV_MAX )
+const std::size_t maxIOVectors = IOV_MAX;
+#else
+const std::size_t maxIOVectors = 1024;
+#endif
+
+// Size of the chunks used when the file can't be sent by the kernel
+const std::size_t sendFileChunkSize = 64 * 1024;
 } // namespace
 
 namespace EE { namespace Network {
@@ -235,35 +298,300 @@ Socket::Status TcpSocket::receive( void* data, std::size_t size, std::size_t& re
 	}
 }
 
+Socket::Status TcpSocket::sendv( const ConstBuffer* buffers, std::size_t count,
+								 std::size_t& sent ) {
+	sent = 0;
+
+	// Build the platform buffer list, skipping the empty buffers
+	std::vector<IOVector> vecs;
+	vecs.reserve( count );
+
+	for ( std::size_t i = 0; buffers && i < count; ++i ) {
+		if ( buffers[i].data && buffers[i].size > 0 )
+			vecs.push_back( makeIOVector( buffers[i].data, buffers[i].size ) );
+	}
+
+	// Check the parameters
+	if ( vecs.empty() ) {
+		Log::error( "Cannot send data over the network (no data to send)" );
+		return Error;
+	}
+
+	// Loop until every buffer has been sent
+	std::size_t first = 0;
+	while ( first < vecs.size() ) {
+		std::size_t vecCount = eemin( vecs.size() - first, maxIOVectors );
+		long long result;
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		DWORD bytes = 0;
+		result = WSASend( getHandle(), &vecs[first], static_cast<DWORD>( vecCount ), &bytes, 0,
+						  NULL, NULL ) == 0
+					 ? static_cast<long long>( bytes )
+					 : -1;
+#else
+		msghdr msg;
+		std::memset( &msg, 0, sizeof( msg ) );
+		msg.msg_iov = &vecs[first];
+		msg.msg_iovlen = vecCount;
+		result = sendmsg( getHandle(), &msg, flags );
+#endif
+
+		// Check for errors
+		if ( result < 0 ) {
+			Status status = Private::SocketImpl::getErrorStatus();
+
+			if ( ( status == NotReady ) && sent ) {
+				return Partial;
+			}
+
+			return status;
+		}
+
+		sent += static_cast<std::size_t>( result );
+
+		// Skip the buffers that were completely sent and advance the partially sent one
+		std::size_t bytes = static_cast<std::size_t>( result );
+		while ( bytes > 0 && first < vecs.size() ) {
+			std::size_t vecSize = getIOVectorSize( vecs[first] );
+
+			if ( bytes >= vecSize ) {
+				bytes -= vecSize;
+				++first;
+			} else {
+				advanceIOVector( vecs[first], bytes );
+				bytes = 0;
+			}
+		}
+	}
+
+	return Done;
+}
+
+Socket::Status TcpSocket::receivev( const MutableBuffer* buffers, std::size_t count,
+									std::size_t& received ) {
+	// First clear the variables to fill
+	received = 0;
+
+	// Check the destination buffers
+	std::vector<IOVector> vecs;
+	vecs.reserve( eemin( count, maxIOVectors ) );
+
+	for ( std::size_t i = 0; buffers && i < count && vecs.size() < maxIOVectors; ++i ) {
+		if ( buffers[i].data && buffers[i].size > 0 )
+			vecs.push_back( makeIOVector( buffers[i].data, buffers[i].size ) );
+	}
+
+	if ( vecs.empty() ) {
+		Log::error( "Cannot receive data from the network (the destination buffer is invalid)" );
+		return Error;
+	}
+
+	// Receive a chunk of bytes
+	long long sizeReceived;
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	DWORD bytes = 0;
+	DWORD recvFlags = 0;
+	sizeReceived = WSARecv( getHandle(), &vecs[0], static_cast<DWORD>( vecs.size() ), &bytes,
+							&recvFlags, NULL, NULL ) == 0
+					   ? static_cast<long long>( bytes )
+					   : -1;
+#else
+	msghdr msg;
+	std::memset( &msg, 0, sizeof( msg ) );
+	msg.msg_iov = &vecs[0];
+	msg.msg_iovlen = vecs.size();
+	sizeReceived = recvmsg( getHandle(), &msg, flags );
+#endif
+
+	// Check the number of bytes received
+	if ( sizeReceived > 0 ) {
+		received = static_cast<std::size_t>( sizeReceived );
+		return Done;
+	} else if ( sizeReceived == 0 ) {
+		return Socket::Disconnected;
+	} else {
+		return Private::SocketImpl::getErrorStatus();
+	}
+}
+
+Socket::Status TcpSocket::sendFile( IOStreamFile& file, Uint64 offset, Uint64 length ) {
+	if ( !isBlocking() )
+		Log::warning( "Partial sends might not be handled properly." );
+
+	Uint64 sent;
+
+	return sendFile( file, offset, length, sent );
+}
+
+Socket::Status TcpSocket::sendFile( IOStreamFile& file, Uint64 offset, Uint64 length,
+									Uint64& sent ) {
+	sent = 0;
+
+	// Check the parameters
+	if ( !file.isOpen() ) {
+		Log::error( "Cannot send file over the network (the file is not open)" );
+		return Error;
+	}
+
+	Uint64 fileSize = static_cast<Uint64>( file.getSize() );
+
+	if ( offset > fileSize ) {
+		Log::error( "Cannot send file over the network (the offset is past the end of the file)" );
+		return Error;
+	}
+
+	if ( 0 == length || length > fileSize - offset )
+		length = fileSize - offset;
+
+	if ( 0 == length )
+		return Done;
+
+#ifdef EE_TCPSOCKET_SENDFILE
+	// Make sure that pending writes are visible through the file descriptor
+	file.flush();
+
+	int fd = fileno( file.getFileHandle() );
+	off_t pos = static_cast<off_t>( offset );
+	bool fallback = false;
+
+	// sendfile doesn't accept MSG_NOSIGNAL: block SIGPIPE while sending and discard the signal
+	// if it was raised by a closed connection
+	sigset_t pipeSet, oldSet;
+	sigemptyset( &pipeSet );
+	sigaddset( &pipeSet, SIGPIPE );
+	pthread_sigmask( SIG_BLOCK, &pipeSet, &oldSet );
+
+	while ( sent < length ) {
+		// Linux transfers at most 0x7ffff000 bytes per call
+		std::size_t chunk = static_cast<std::size_t>( eemin<Uint64>( length - sent, 0x7ffff000 ) );
+		ssize_t result = ::sendfile( getHandle(), fd, &pos, chunk );
+
+		if ( result < 0 ) {
+			int error = errno;
+
+			// The file or the socket doesn't support sendfile, send it the usual way
+			if ( ( error == EINVAL || error == ENOSYS ) && 0 == sent ) {
+				fallback = true;
+				break;
+			}
+
+			if ( error == EPIPE && !sigismember( &oldSet, SIGPIPE ) ) {
+				timespec zero = { 0, 0 };
+				sigtimedwait( &pipeSet, NULL, &zero );
+			}
+
+			pthread_sigmask( SIG_SETMASK, &oldSet, NULL );
+
+			errno = error;
+			Status status = Private::SocketImpl::getErrorStatus();
+
+			if ( ( status == NotReady ) && sent ) {
+				return Partial;
+			}
+
+			return status;
+		}
+
+		// The file is shorter than expected
+		if ( 0 == result ) {
+			pthread_sigmask( SIG_SETMASK, &oldSet, NULL );
+			Log::error( "Cannot send file over the network (unexpected end of file)" );
+			return Error;
+		}
+
+		sent += static_cast<Uint64>( result );
+	}
+
+	pthread_sigmask( SIG_SETMASK, &oldSet, NULL );
+
+	if ( !fallback )
+		return Done;
+#endif
+
+	// Read the file in chunks and send them
+	std::vector<char> buffer( static_cast<std::size_t>(
+		eemin<Uint64>( length, static_cast<Uint64>( sendFileChunkSize ) ) ) );
+
+	file.seek( static_cast<ios_size>( offset ) );
+
+	while ( sent < length ) {
+		std::size_t chunk =
+			static_cast<std::size_t>( eemin<Uint64>( length - sent, buffer.size() ) );
+		std::size_t read = static_cast<std::size_t>( file.read( &buffer[0], chunk ) );
+
+		if ( 0 == read ) {
+			Log::error( "Cannot send file over the network (unexpected end of file)" );
+			return Error;
+		}
+
+		std::size_t chunkSent = 0;
+		Status status = send( &buffer[0], read, chunkSent );
+		sent += chunkSent;
+
+		if ( status != Done ) {
+			if ( ( status == NotReady ) && sent ) {
+				return Partial;
+			}
+
+			return status;
+		}
+	}
+
+	return Done;
+}
+
 Socket::Status TcpSocket::send( Packet& packet ) {
 	// TCP is a stream protocol, it doesn't preserve messages boundaries.
 	// This means that we have to send the packet size first, so that the
 	// receiver knows the actual end of the packet in the data stream.
 
-	// We allocate an extra memory block so that the size can be sent
-	// together with the data in a single call. This may seem inefficient,
-	// but it is actually required to avoid partial send, which could cause
-	// data corruption on the receiving end.
+	// The size and the data are sent together in a single gathered call,
+	// which is required to avoid partial sends that could cause data
+	// corruption on the receiving end, without copying the packet data.
 
 	// Get the data to send from the packet
+	std::vector<ConstBuffer> buffers( 1 );
 	std::size_t size = 0;
-	const void* data = packet.onSend( size );
 
-	// First convert the packet size to network byte order
-	Uint32 packetSize = htonl( static_cast<Uint32>( size ) );
+	if ( packet.hasReferences() ) {
+		// Send the referenced data from its original location
+		for ( const auto& segment : packet.mSegments ) {
+			const void* data = segment.Data ? static_cast<const void*>( segment.Data )
+											: &packet.mData[segment.Offset];
+			buffers.push_back( { data, segment.Size } );
+			size += segment.Size;
+		}
+	} else {
+		const void* data = packet.onSend( size );
 
-	// Allocate memory for the data block to send
-	std::vector<char> blockToSend( sizeof( packetSize ) + size );
+		if ( size > 0 )
+			buffers.push_back( { data, size } );
+	}
 
-	// Copy the packet size and data into the block to send
-	std::memcpy( &blockToSend[0], &packetSize, sizeof( packetSize ) );
-	if ( size > 0 )
-		std::memcpy( &blockToSend[0] + sizeof( packetSize ), data, size );
+	// First convert the packet size to network byte order
+	Uint32 packetSize = htonl( static_cast<Uint32>( size ) );
+	buffers[0] = { &packetSize, sizeof( packetSize ) };
+
+	// Skip what was already sent by a previous partial send
+	std::size_t skip = packet.mSendPos;
+	std::size_t first = 0;
+
+	while ( skip > 0 && first < buffers.size() ) {
+		if ( skip >= buffers[first].size ) {
+			skip -= buffers[first].size;
+			++first;
+		} else {
+			buffers[first].data = static_cast<const char*>( buffers[first].data ) + skip;
+			buffers[first].size -= skip;
+			skip = 0;
+		}
+	}
 
 	// Send the data block
 	std::size_t sent;
-	Status status =
-		send( &blockToSend[0] + packet.mSendPos, blockToSend.size() - packet.mSendPos, sent );
+	Status status = sendv( &buffers[first], buffers.size() - first, sent );
 
 	// In the case of a partial send, record the location to resume from
 	if ( status == Partial ) {
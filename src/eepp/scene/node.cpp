@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <functional>
+#include <eepp/graphics/drawcommandlist.hpp>
 #include <eepp/graphics/globalbatchrenderer.hpp>
 #include <eepp/graphics/pixeldensity.hpp>
+#include <eepp/graphics/renderer/clippingmask.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/scene/action.hpp>
 #include <eepp/scene/actionmanager.hpp>
@@ -9,6 +13,164 @@
 
 namespace EE { namespace Scene {
 
+struct Node::RetainedDraw {
+	DrawCommandList commands;
+	DrawCommandList* parentCapture{ nullptr };
+	Vector2f screenPos;
+	Rectf sceneBounds;
+	Uint64 rendererDrawCalls{ 0 };
+	Uint64 batchDrawCalls{ 0 };
+	bool dirty{ true };
+	// The last recording rendered something that can't be recorded, the subtree is drawn
+	// directly until it's invalidated
+	bool uncacheable{ false };
+	bool translatable{ false };
+	bool culled{ false };
+	Rectf cullingRect;
+};
+
+struct Node::SpatialIndex {
+	struct Entry {
+		Node* node;
+		Rectf bounds; // Relative to the parent screen position
+		Uint32 stamp;
+	};
+
+	static constexpr Int32 MaxCellsPerAxis = 256;
+
+	std::vector<Entry> entries;
+	std::vector<Uint32> unbounded; // Entries that can't be culled
+	std::vector<std::vector<Uint32>> cells;
+	std::vector<Uint32> result;
+	Rectf area;
+	Sizef cellSize;
+	Int32 columns{ 0 };
+	Int32 rows{ 0 };
+	Uint32 stamp{ 0 };
+	bool dirty{ true };
+
+	void build( Node* parent );
+
+	/** Fills result with the entries that can be visible in rect (relative to the parent screen
+	 * position), sorted by child order. */
+	void query( const Rectf& rect );
+
+	/** Fills result with the entries whose bounds contain point (relative to the parent screen
+	 * position), sorted from the last child to the first. */
+	void queryPoint( const Vector2f& point );
+
+	Int32 column( const Float& x ) const {
+		return eeclamp( static_cast<Int32>( ( x - area.Left ) / cellSize.x ), 0, columns - 1 );
+	}
+
+	Int32 row( const Float& y ) const {
+		return eeclamp( static_cast<Int32>( ( y - area.Top ) / cellSize.y ), 0, rows - 1 );
+	}
+};
+
+void Node::SpatialIndex::build( Node* parent ) {
+	entries.clear();
+	unbounded.clear();
+	cells.clear();
+	stamp = 0;
+	dirty = false;
+
+	Vector2f offset( parent->mScreenPos );
+
+	for ( Node* child = parent->mChild; NULL != child; child = child->mNext ) {
+		Rectf bounds( child->getWorldBounds() );
+		bounds.Left -= offset.x;
+		bounds.Right -= offset.x;
+		bounds.Top -= offset.y;
+		bounds.Bottom -= offset.y;
+
+		if ( entries.empty() ) {
+			area = bounds;
+		} else {
+			area.expand( bounds );
+		}
+
+		if ( !child->isDrawCullable() )
+			unbounded.push_back( static_cast<Uint32>( entries.size() ) );
+
+		entries.push_back( { child, bounds, 0 } );
+	}
+
+	if ( entries.empty() ) {
+		columns = rows = 0;
+		return;
+	}
+
+	// Aim for a few entries per cell, keeping the cells close to square
+	Float width = eemax( area.getWidth(), 1.f );
+	Float height = eemax( area.getHeight(), 1.f );
+	Float targetCells = eemax( 1.f, entries.size() / 4.f );
+	columns = eeclamp( static_cast<Int32>( eeceil( eesqrt( targetCells * width / height ) ) ), 1,
+					   MaxCellsPerAxis );
+	rows = eeclamp( static_cast<Int32>( eeceil( targetCells / columns ) ), 1, MaxCellsPerAxis );
+	cellSize = Sizef( width / columns, height / rows );
+	cells.resize( columns * rows );
+
+	for ( Uint32 i = 0; i < entries.size(); i++ ) {
+		const Rectf& bounds = entries[i].bounds;
+		Int32 x1 = column( bounds.Right );
+		Int32 y1 = row( bounds.Bottom );
+
+		for ( Int32 y = row( bounds.Top ); y <= y1; y++ )
+			for ( Int32 x = column( bounds.Left ); x <= x1; x++ )
+				cells[y * columns + x].push_back( i );
+	}
+}
+
+void Node::SpatialIndex::query( const Rectf& rect ) {
+	result.clear();
+
+	// The stamp marks the entries already added by this query
+	if ( ++stamp == 0 ) {
+		for ( Entry& entry : entries )
+			entry.stamp = 0;
+		stamp = 1;
+	}
+
+	for ( Uint32 index : unbounded ) {
+		entries[index].stamp = stamp;
+		result.push_back( index );
+	}
+
+	if ( 0 != columns && area.intersect( rect ) ) {
+		Int32 x1 = column( rect.Right );
+		Int32 y1 = row( rect.Bottom );
+
+		for ( Int32 y = row( rect.Top ); y <= y1; y++ ) {
+			for ( Int32 x = column( rect.Left ); x <= x1; x++ ) {
+				for ( Uint32 index : cells[y * columns + x] ) {
+					Entry& entry = entries[index];
+					if ( entry.stamp == stamp )
+						continue;
+					entry.stamp = stamp;
+					if ( entry.bounds.intersect( rect ) )
+						result.push_back( index );
+				}
+			}
+		}
+	}
+
+	std::sort( result.begin(), result.end() );
+}
+
+void Node::SpatialIndex::queryPoint( const Vector2f& point ) {
+	result.clear();
+
+	if ( 0 == columns || !area.contains( point ) )
+		return;
+
+	for ( Uint32 index : cells[row( point.y ) * columns + column( point.x )] )
+		if ( entries[index].bounds.contains( point ) )
+			result.push_back( index );
+
+	std::sort( result.begin(), result.end(), std::greater<Uint32>() );
+}
+
 Node* Node::New() {
 	return eeNew( Node, () );
 }
@@ -29,7 +191,9 @@ Node::Node() :
 	mNumCallBacks( 0 ),
 	mVisible( true ),
 	mEnabled( true ),
-	mAlpha( 255.f ) {}
+	mAlpha( 255.f ),
+	mRetainedDraw( NULL ),
+	mSpatialIndex( NULL ) {}
 
 Node::~Node() {
 	if ( !SceneManager::instance()->isShuttingDown() && NULL != mSceneNode ) {
@@ -48,6 +212,10 @@ Node::~Node() {
 	if ( NULL != mParentNode )
 		mParentNode->childRemove( this );
 
+	eeSAFE_DELETE( mRetainedDraw );
+
+	eeSAFE_DELETE( mSpatialIndex );
+
 	EventDispatcher* eventDispatcher = getEventDispatcher();
 
 	if ( NULL != eventDispatcher ) {
@@ -119,6 +287,7 @@ Uint32 Node::onMessage( const NodeMessage* ) {
 void Node::setInternalPosition( const Vector2f& Pos ) {
 	Transformable::setPosition( Vector2f( Pos.x, Pos.y ) );
 	setDirty();
+	invalidateDrawCulling();
 }
 
 void Node::setPosition( const Vector2f& Pos ) {
@@ -137,6 +306,7 @@ void Node::setInternalSize( const Sizef& size ) {
 	mSize = size;
 	mNodeFlags |= NODE_FLAG_POLYGON_DIRTY;
 	updateCenter();
+	invalidateDrawCulling();
 	sendCommonEvent( Event::OnSizeChange );
 	invalidateDraw();
 }
@@ -501,7 +671,13 @@ void Node::onEnabledChange() {
 
 void Node::onPositionChange() {
 	sendCommonEvent( Event::OnPositionChange );
-	invalidateDraw();
+
+	// A retained node that only moved can replay its draw translated
+	invalidateRetainedDraw( mParentNode );
+
+	if ( NULL != mNodeDrawInvalidator ) {
+		mNodeDrawInvalidator->invalidate( this );
+	}
 }
 
 void Node::onSizeChange() {
@@ -528,11 +704,40 @@ void Node::setNodeFlags( const Uint32& flags ) {
 }
 
 void Node::drawChilds() {
+	Rectf clip;
+	bool cull = getDrawCullingRect( clip );
+
+	if ( !cull ) {
+		// The world bounds could be scaled or rotated, the index must be rebuilt once it's usable
+		if ( NULL != mSpatialIndex )
+			mSpatialIndex->dirty = true;
+	} else if ( NULL != mSpatialIndex && NULL != mChild ) {
+		if ( mSpatialIndex->dirty )
+			mSpatialIndex->build( this );
+
+		mSpatialIndex->query( Rectf( clip.Left - mScreenPos.x, clip.Top - mScreenPos.y,
+									 clip.Right - mScreenPos.x, clip.Bottom - mScreenPos.y ) );
+
+		const std::vector<Uint32>& visible = mSpatialIndex->result;
+		size_t count = visible.size();
+
+		for ( size_t i = 0; i < count; i++ ) {
+			Node* child =
+				mSpatialIndex->entries[visible[isReverseDraw() ? count - 1 - i : i]].node;
+
+			if ( child->mVisible )
+				child->nodeDraw();
+		}
+
+		return;
+	}
+
 	if ( isReverseDraw() ) {
 		Node* child = mChildLast;
 
 		while ( NULL != child ) {
-			if ( child->mVisible ) {
+			if ( child->mVisible && ( !cull || !child->isDrawCullable() ||
+									  child->getWorldBounds().intersect( clip ) ) ) {
 				child->nodeDraw();
 			}
 
@@ -542,7 +747,8 @@ void Node::drawChilds() {
 		Node* child = mChild;
 
 		while ( NULL != child ) {
-			if ( child->mVisible ) {
+			if ( child->mVisible && ( !cull || !child->isDrawCullable() ||
+									  child->getWorldBounds().intersect( clip ) ) ) {
 				child->nodeDraw();
 			}
 
@@ -551,11 +757,68 @@ void Node::drawChilds() {
 	}
 }
 
+bool Node::isDrawCullable() const {
+	return isClipped();
+}
+
+bool Node::getDrawCullingRect( Rectf& rect ) const {
+	if ( isMeOrParentTreeScaledOrRotatedOrFrameBuffer() )
+		return false;
+
+	ClippingMask* clippingMask = GLi->getClippingMask();
+	const std::vector<Rectf>& scissors = clippingMask->getScissorsClipped();
+	const std::vector<Rectf>& planes = clippingMask->getPlanesClipped();
+
+	if ( scissors.empty() && planes.empty() )
+		return false;
+
+	if ( !scissors.empty() ) {
+		rect = scissors.back();
+		if ( !planes.empty() )
+			rect.shrink( planes.back() );
+	} else {
+		rect = planes.back();
+	}
+
+	return true;
+}
+
+void Node::setChildsSpatialIndexed( bool indexed ) {
+	if ( indexed == isChildsSpatialIndexed() )
+		return;
+
+	if ( indexed ) {
+		mSpatialIndex = eeNew( SpatialIndex, () );
+	} else {
+		eeSAFE_DELETE( mSpatialIndex );
+	}
+
+	invalidateDraw();
+}
+
+bool Node::isChildsSpatialIndexed() const {
+	return NULL != mSpatialIndex;
+}
+
+void Node::invalidateDrawCulling() {
+	if ( NULL != mParentNode && NULL != mParentNode->mSpatialIndex )
+		mParentNode->mSpatialIndex->dirty = true;
+}
+
 void Node::nodeDraw() {
 	if ( mVisible ) {
 		if ( mNodeFlags & NODE_FLAG_POSITION_DIRTY )
 			updateScreenPos();
 
+		bool recording = retainedDrawRecording();
+
+		if ( recording ) {
+			if ( retainedDrawPlay() )
+				return;
+
+			retainedDrawBegin();
+		}
+
 		matrixSet();
 
 		bool needsClipPlanes = isClipped() && isMeOrParentTreeScaledOrRotatedOrFrameBuffer();
@@ -569,6 +832,9 @@ void Node::nodeDraw() {
 		clipEnd( needsClipPlanes );
 
 		matrixUnset();
+
+		if ( recording )
+			retainedDrawEnd();
 	}
 }
 
@@ -609,6 +875,10 @@ void Node::matrixSet() {
 	if ( getScale() != 1.f || getRotation() != 0.f ) {
 		GlobalBatchRenderer::instance()->draw();
 
+		// The matrices aren't recorded
+		if ( NULL != GlobalBatchRenderer::instance()->getCapture() )
+			GlobalBatchRenderer::instance()->getCapture()->invalidate();
+
 		GLi->pushMatrix();
 
 		Vector2f scaleCenter = getScaleCenter();
@@ -652,6 +922,9 @@ void Node::childAdd( Node* node ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->dirty = true;
+
 	onChildCountChange( node, false );
 }
 
@@ -706,6 +979,9 @@ void Node::childAddAt( Node* node, Uint32 index ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->dirty = true;
+
 	onChildCountChange( node, false );
 }
 
@@ -738,6 +1014,9 @@ void Node::childRemove( Node* node ) {
 
 	eeASSERT( !( NULL == mChildLast && NULL != mChild ) );
 
+	if ( NULL != mSpatialIndex )
+		mSpatialIndex->dirty = true;
+
 	onChildCountChange( node, true );
 }
 
@@ -973,10 +1252,32 @@ Node* Node::overFind( const Vector2f& point ) {
 	if ( ( mNodeFlags & NODE_FLAG_OVER_FIND_ALLOWED ) && mEnabled && mVisible ) {
 		updateWorldPolygon();
 
-		if ( mWorldBounds.contains( point ) && mPoly.pointInside( point ) ) {
+		// The polygon is the bounds rectangle when nothing is rotated or scaled
+		if ( mWorldBounds.contains( point ) &&
+			 ( !( mNodeFlags & NODE_FLAG_POLYGON_TRANSFORMED ) || mPoly.pointInside( point ) ) ) {
 			writeNodeFlag( NODE_FLAG_MOUSEOVER_ME_OR_CHILD, 1 );
 			mSceneNode->addMouseOverNode( this );
 
+			if ( NULL != mSpatialIndex && !( mNodeFlags & NODE_FLAG_POLYGON_TRANSFORMED ) ) {
+				if ( mSpatialIndex->dirty )
+					mSpatialIndex->build( this );
+
+				mSpatialIndex->queryPoint( point - mScreenPos );
+
+				for ( Uint32 index : mSpatialIndex->result ) {
+					pOver = mSpatialIndex->entries[index].node->overFind( point );
+
+					if ( NULL != pOver )
+						break;
+				}
+
+				return NULL != pOver ? pOver : this;
+			}
+
+			// The index bounds could be transformed, it must be rebuilt once it's usable
+			if ( NULL != mSpatialIndex )
+				mSpatialIndex->dirty = true;
+
 			Node* child = mChildLast;
 
 			while ( NULL != child ) {
@@ -1152,17 +1453,24 @@ void Node::updateWorldPolygon() {
 	mPoly.rotate( getRotation(), getRotationCenter() );
 	mPoly.scale( getScale(), getScaleCenter() );
 
+	bool transformed = 0 != ( mNodeFlags & ( NODE_FLAG_SCALED | NODE_FLAG_ROTATED ) );
+
 	Node* tParent = getParent();
 
 	while ( tParent ) {
 		mPoly.rotate( tParent->getRotation(), tParent->getRotationCenter() );
 		mPoly.scale( tParent->getScale(), tParent->getScaleCenter() );
 
+		if ( tParent->mNodeFlags & ( NODE_FLAG_SCALED | NODE_FLAG_ROTATED ) )
+			transformed = true;
+
 		tParent = tParent->getParent();
 	};
 
 	mWorldBounds = mPoly.getBounds();
 
+	writeNodeFlag( NODE_FLAG_POLYGON_TRANSFORMED, transformed ? 1 : 0 );
+
 	mNodeFlags &= ~NODE_FLAG_POLYGON_DIRTY;
 }
 
@@ -1304,11 +1612,120 @@ void Node::setReverseDraw( bool reverseDraw ) {
 }
 
 void Node::invalidateDraw() {
+	invalidateRetainedDraw( this );
+
 	if ( NULL != mNodeDrawInvalidator ) {
 		mNodeDrawInvalidator->invalidate( this );
 	}
 }
 
+void Node::invalidateRetainedDraw( Node* node ) {
+	while ( NULL != node ) {
+		if ( NULL != node->mRetainedDraw ) {
+			node->mRetainedDraw->dirty = true;
+			node->mRetainedDraw->uncacheable = false;
+		}
+		node = node->mParentNode;
+	}
+}
+
+void Node::setRetainedDraw( bool retained ) {
+	if ( retained == isRetainedDraw() )
+		return;
+
+	if ( retained ) {
+		mRetainedDraw = eeNew( RetainedDraw, () );
+	} else {
+		eeSAFE_DELETE( mRetainedDraw );
+	}
+
+	invalidateDraw();
+}
+
+bool Node::isRetainedDraw() const {
+	return NULL != mRetainedDraw;
+}
+
+bool Node::retainedDrawRecording() const {
+	return NULL != mRetainedDraw && !mRetainedDraw->uncacheable;
+}
+
+bool Node::retainedDrawPlay() {
+	RetainedDraw& retained = *mRetainedDraw;
+
+	if ( retained.dirty || NULL == mSceneNode ||
+		 retained.sceneBounds != mSceneNode->getWorldBounds() )
+		return false;
+
+	Vector2f offset( mScreenPos - retained.screenPos );
+
+	if ( offset != Vector2f::Zero && !retained.translatable )
+		return false;
+
+	// Children culled while recording could be visible now
+	if ( retained.culled ) {
+		Rectf clip;
+		if ( offset != Vector2f::Zero || !getDrawCullingRect( clip ) ||
+			 clip != retained.cullingRect )
+			return false;
+	}
+
+	if ( !GlobalBatchRenderer::instance()->play( retained.commands, offset ) ) {
+		retained.dirty = true;
+		return false;
+	}
+
+	return true;
+}
+
+void Node::retainedDrawBegin() {
+	RetainedDraw& retained = *mRetainedDraw;
+	BatchRenderer* batchRenderer = GlobalBatchRenderer::instance();
+
+	retained.commands.clear();
+	retained.parentCapture = batchRenderer->getCapture();
+	batchRenderer->setCapture( &retained.commands );
+	retained.rendererDrawCalls = GLi->getDrawCallsCount();
+	retained.batchDrawCalls = batchRenderer->getDrawCallsCount();
+	retained.screenPos = mScreenPos;
+	retained.dirty = false;
+	retained.culled = getDrawCullingRect( retained.cullingRect ) &&
+					  !retained.cullingRect.contains( getWorldBounds() );
+}
+
+void Node::retainedDrawEnd() {
+	RetainedDraw& retained = *mRetainedDraw;
+	BatchRenderer* batchRenderer = GlobalBatchRenderer::instance();
+
+	batchRenderer->draw();
+
+	// Any draw call not issued by the global batch renderer wasn't recorded
+	if ( GLi->getDrawCallsCount() - retained.rendererDrawCalls !=
+		 batchRenderer->getDrawCallsCount() - retained.batchDrawCalls )
+		retained.commands.invalidate();
+
+	batchRenderer->setCapture( retained.parentCapture );
+
+	if ( NULL != retained.parentCapture )
+		retained.parentCapture->append( retained.commands );
+
+	retained.parentCapture = NULL;
+
+	if ( !retained.commands.isValid() || NULL == mSceneNode ) {
+		// Recording it again would fail the same way, stop trying until the subtree changes
+		retained.commands.clear();
+		retained.dirty = true;
+		retained.uncacheable = NULL != mSceneNode;
+		return;
+	}
+
+	// Anything culled by the scene bounds while recording could become visible after moving
+	Rectf bounds( getScreenBounds() );
+	retained.sceneBounds = mSceneNode->getWorldBounds();
+	retained.translatable = isClipped() && retained.sceneBounds.contains( bounds ) &&
+							getScale() == 1.f && getRotation() == 0.f;
+}
+
 SceneNode* Node::getSceneNode() const {
 	return mSceneNode;
 }
@@ -1442,6 +1859,8 @@ void Node::setRotation( float angle ) {
 
 	setDirty();
 
+	invalidateDrawCulling();
+
 	onAngleChange();
 }
 
@@ -1466,6 +1885,8 @@ void Node::setScale( const Vector2f& scale ) {
 
 	setDirty();
 
+	invalidateDrawCulling();
+
 	onScaleChange();
 }
 
@@ -1756,11 +2177,13 @@ Node* Node::center() {
 
 Node* Node::clipEnable() {
 	writeNodeFlag( NODE_FLAG_CLIP_ENABLE, 1 );
+	invalidateDrawCulling();
 	return this;
 }
 
 Node* Node::clipDisable() {
 	writeNodeFlag( NODE_FLAG_CLIP_ENABLE, 0 );
+	invalidateDrawCulling();
 	return this;
 }
 
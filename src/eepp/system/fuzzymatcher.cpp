@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <climits>
+#include <eepp/core/debug.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define EE_FUZZY_MATCHER_SSE2
+#include <emmintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#endif
+
+namespace EE { namespace System {
+
+static inline char asciiToLower( char c ) {
+	return ( c >= 'A' && c <= 'Z' ) ? c + ( 'a' - 'A' ) : c;
+}
+
+static inline char asciiToUpper( char c ) {
+	return ( c >= 'a' && c <= 'z' ) ? c - ( 'a' - 'A' ) : c;
+}
+
+static inline Uint64 charBit( char c ) {
+	unsigned char lc = static_cast<unsigned char>( asciiToLower( c ) );
+	if ( lc >= 'a' && lc <= 'z' )
+		return 1ULL << ( lc - 'a' );
+	if ( lc >= '0' && lc <= '9' )
+		return 1ULL << ( 26 + lc - '0' );
+	return 1ULL << ( 36 + lc % 28 );
+}
+
+#ifdef EE_FUZZY_MATCHER_SSE2
+static inline int countTrailingZeros( Uint32 v ) {
+#if defined( _MSC_VER )
+	unsigned long index;
+	_BitScanForward( &index, v );
+	return static_cast<int>( index );
+#else
+	return __builtin_ctz( v );
+#endif
+}
+
+static inline int popCount( Uint32 v ) {
+#if defined( _MSC_VER )
+	return static_cast<int>( __popcnt( v ) );
+#else
+	return __builtin_popcount( v );
+#endif
+}
+#endif
+
+/** Finds the next position >= pos where str contains lower or upper. Also counts the non-space
+ * characters skipped to reach it (spaces are skipped for free by the scoring). */
+static inline size_t findNext( const char* str, size_t pos, size_t len, char lower, char upper,
+							   size_t& skipped ) {
+#ifdef EE_FUZZY_MATCHER_SSE2
+	const __m128i vLower = _mm_set1_epi8( lower );
+	const __m128i vUpper = _mm_set1_epi8( upper );
+	const __m128i vSpace = _mm_set1_epi8( ' ' );
+	while ( pos + 16 <= len ) {
+		__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( str + pos ) );
+		Uint32 found = static_cast<Uint32>( _mm_movemask_epi8( _mm_or_si128(
+			_mm_cmpeq_epi8( chunk, vLower ), _mm_cmpeq_epi8( chunk, vUpper ) ) ) );
+		Uint32 spaces = static_cast<Uint32>( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, vSpace ) ) );
+		if ( found ) {
+			int offset = countTrailingZeros( found );
+			skipped += offset - popCount( spaces & ( ( 1u << offset ) - 1u ) );
+			return pos + offset;
+		}
+		skipped += 16 - popCount( spaces );
+		pos += 16;
+	}
+#endif
+	for ( ; pos < len; pos++ ) {
+		char c = str[pos];
+		if ( c == lower || c == upper )
+			return pos;
+		if ( c != ' ' )
+			skipped++;
+	}
+	return len;
+}
+
+static int fuzzyScore( const std::string_view& str, const std::string_view& pattern,
+					   bool allowUneven, bool permissive ) {
+	const char* s = str.data();
+	const size_t len = str.size();
+	size_t pos = 0;
+	int score = 0;
+	int run = 0;
+
+	for ( char pc : pattern ) {
+		size_t skipped = 0;
+		size_t next = findNext( s, pos, len, asciiToLower( pc ), asciiToUpper( pc ), skipped );
+		if ( skipped ) {
+			score -= static_cast<int>( skipped ) * 10;
+			run = 0;
+		}
+		if ( next == len ) {
+			if ( !allowUneven )
+				return INT_MIN;
+			return score;
+		}
+		score += run * 10 - ( s[next] != pc );
+		run++;
+		pos = next + 1;
+	}
+
+	return score - ( permissive ? 0 : static_cast<int>( len - pos ) );
+}
+
+static std::string normalizePattern( const std::string_view& pattern ) {
+	std::string normalized;
+	normalized.reserve( pattern.size() );
+	for ( char c : pattern )
+		if ( c != ' ' )
+			normalized.push_back( c );
+	return normalized;
+}
+
+int FuzzyMatcher::score( const std::string_view& string, const std::string_view& pattern,
+						 bool allowUneven, bool permissive ) {
+	return fuzzyScore( string, normalizePattern( pattern ), allowUneven, permissive );
+}
+
+Uint64 FuzzyMatcher::charMask( const std::string_view& string ) {
+	Uint64 mask = 0;
+	for ( char c : string )
+		if ( c != ' ' )
+			mask |= charBit( c );
+	return mask;
+}
+
+FuzzyMatcher::FuzzyMatcher( Uint32 fieldsPerCandidate, bool allowUneven, bool permissive ) :
+	mFieldsPerCandidate( fieldsPerCandidate > 0 ? fieldsPerCandidate : 1 ),
+	mAllowUneven( allowUneven ),
+	mPermissive( permissive ) {}
+
+void FuzzyMatcher::reserve( size_t candidatesCount ) {
+	mFields.reserve( candidatesCount * mFieldsPerCandidate );
+	mMasks.reserve( candidatesCount * mFieldsPerCandidate );
+}
+
+void FuzzyMatcher::clear() {
+	mFields.clear();
+	mMasks.clear();
+	mLastPattern.clear();
+	mLastSurvivors.clear();
+	mLastSurvivorsValid = false;
+}
+
+Uint32 FuzzyMatcher::add( const std::string_view& field ) {
+	return add( { field } );
+}
+
+Uint32 FuzzyMatcher::add( std::initializer_list<std::string_view> fields ) {
+	eeASSERT( fields.size() == mFieldsPerCandidate );
+	Uint32 index = static_cast<Uint32>( size() );
+	Uint32 count = 0;
+	for ( const auto& field : fields ) {
+		if ( count++ == mFieldsPerCandidate )
+			break;
+		mFields.push_back( field );
+		mMasks.push_back( charMask( field ) );
+	}
+	for ( ; count < mFieldsPerCandidate; count++ ) {
+		mFields.push_back( {} );
+		mMasks.push_back( 0 );
+	}
+	mLastSurvivorsValid = false;
+	return index;
+}
+
+int FuzzyMatcher::scoreCandidate( Uint32 index, const std::string_view& pattern,
+								  Uint64 patternMask ) const {
+	int best = INT_MIN;
+	size_t start = static_cast<size_t>( index ) * mFieldsPerCandidate;
+	for ( size_t i = start; i < start + mFieldsPerCandidate; i++ ) {
+		if ( !mAllowUneven && ( patternMask & ~mMasks[i] ) != 0 )
+			continue;
+		best = std::max( best, fuzzyScore( mFields[i], pattern, mAllowUneven, mPermissive ) );
+	}
+	return best;
+}
+
+static bool startsWithCaseInsensitive( const std::string& str, const std::string& prefix ) {
+	if ( prefix.size() > str.size() )
+		return false;
+	for ( size_t i = 0; i < prefix.size(); i++ )
+		if ( asciiToLower( str[i] ) != asciiToLower( prefix[i] ) )
+			return false;
+	return true;
+}
+
+std::vector<FuzzyMatcher::Match> FuzzyMatcher::match( const std::string_view& pattern,
+													  size_t max, bool includeUnmatched ) {
+	std::vector<Match> matches;
+	if ( max == 0 || empty() )
+		return matches;
+
+	std::string ptrn( normalizePattern( pattern ) );
+	Uint64 patternMask = charMask( ptrn );
+	const Uint32 count = static_cast<Uint32>( size() );
+
+	// A candidate that doesn't contain the previous pattern can't contain a pattern that
+	// extends it, so only the previous survivors need to be scored.
+	bool useSurvivors = !mAllowUneven && mLastSurvivorsValid &&
+						startsWithCaseInsensitive( ptrn, mLastPattern );
+	std::vector<Uint32> survivors;
+
+	auto test = [&]( Uint32 index ) {
+		int score = scoreCandidate( index, ptrn, patternMask );
+		if ( score != INT_MIN ) {
+			matches.push_back( { index, score } );
+			survivors.push_back( index );
+		}
+	};
+
+	if ( useSurvivors ) {
+		survivors.reserve( mLastSurvivors.size() );
+		for ( Uint32 index : mLastSurvivors )
+			test( index );
+	} else {
+		for ( Uint32 index = 0; index < count; index++ )
+			test( index );
+	}
+
+	mLastPattern = std::move( ptrn );
+	mLastSurvivors = std::move( survivors );
+	mLastSurvivorsValid = true;
+
+	const auto compare = []( const Match& left, const Match& right ) {
+		return left.score != right.score ? left.score > right.score : left.index < right.index;
+	};
+
+	if ( matches.size() > max ) {
+		std::partial_sort( matches.begin(), matches.begin() + max, matches.end(), compare );
+		matches.resize( max );
+	} else {
+		std::sort( matches.begin(), matches.end(), compare );
+	}
+
+	if ( includeUnmatched && matches.size() < max && matches.size() < count ) {
+		// mLastSurvivors is sorted by index, walk it to find the candidates that didn't match
+		size_t survivor = 0;
+		for ( Uint32 index = 0; index < count && matches.size() < max; index++ ) {
+			if ( survivor < mLastSurvivors.size() && mLastSurvivors[survivor] == index ) {
+				survivor++;
+				continue;
+			}
+			matches.push_back( { index, INT_MIN } );
+		}
+	}
+
+	return matches;
+}
+
+}} // namespace EE::System
@@ -86,4 +86,8 @@ void IOStreamFile::close() {
 	}
 }
 
+std::FILE* IOStreamFile::getFileHandle() const {
+	return mFS;
+}
+
 }} // namespace EE::System
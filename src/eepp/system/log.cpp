@@ -1,7 +1,14 @@
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
+#include <ctime>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/log.hpp>
+#include <eepp/system/thread.hpp>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
 #include <android/log.h>
@@ -21,6 +28,228 @@ namespace EE { namespace System {
 
 SINGLETON_DECLARE_IMPLEMENTATION( Log )
 
+static std::string logLevelToString( const LogLevel& level );
+
+static std::string dateTimeStr( const std::time_t& time ) {
+	char buf[64];
+	strftime( buf, sizeof( buf ), "%Y-%m-%d %X", localtime( &time ) );
+	return std::string( buf );
+}
+
+/** The asynchronous writer. The messages are pushed to a bounded multiple producers single
+ * consumer lock-free ring buffer ( every slot has a sequence number that tells if it can be written
+ * or read, the producers reserve the slots with a CAS on the enqueue position ). The writer thread
+ * formats the queued messages and writes them in a single batch to every output. */
+struct Log::AsyncWriter {
+	struct Record {
+		LogLevel level{ LogLevel::Info };
+		bool timestamp{ false };
+		bool newLine{ false };
+		std::time_t time{ 0 };
+		std::string text;
+		std::function<std::string()> format;
+	};
+
+	struct Slot {
+		std::atomic<size_t> sequence;
+		Record record;
+	};
+
+	static constexpr size_t Capacity = 4096; // Must be a power of two
+
+	Log* log;
+	std::unique_ptr<Slot[]> slots;
+	std::atomic<size_t> enqueuePos{ 0 };
+	size_t dequeuePos{ 0 };
+	std::atomic<size_t> written{ 0 };
+	std::atomic<bool> wake{ false };
+	std::atomic<std::thread::id> writerThreadId{};
+	bool stop{ false };
+	std::mutex mutex;
+	std::condition_variable wakeCond;
+	std::condition_variable writtenCond;
+	Thread thread;
+
+	explicit AsyncWriter( Log* log ) :
+		log( log ), slots( new Slot[Capacity] ), thread( &AsyncWriter::run, this ) {
+		for ( size_t i = 0; i < Capacity; i++ )
+			slots[i].sequence.store( i, std::memory_order_relaxed );
+		thread.launch();
+	}
+
+	~AsyncWriter() {
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			stop = true;
+		}
+		wakeCond.notify_one();
+		thread.wait();
+	}
+
+	bool tryPush( Record& record ) {
+		size_t pos = enqueuePos.load( std::memory_order_relaxed );
+		Slot* slot;
+
+		while ( true ) {
+			slot = &slots[pos & ( Capacity - 1 )];
+			size_t seq = slot->sequence.load( std::memory_order_acquire );
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+			if ( diff == 0 ) {
+				if ( enqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+					break;
+			} else if ( diff < 0 ) {
+				return false; // Full
+			} else {
+				pos = enqueuePos.load( std::memory_order_relaxed );
+			}
+		}
+
+		slot->record = std::move( record );
+		slot->sequence.store( pos + 1, std::memory_order_release );
+		return true;
+	}
+
+	bool tryPop( Record& record ) {
+		Slot& slot = slots[dequeuePos & ( Capacity - 1 )];
+		size_t seq = slot.sequence.load( std::memory_order_acquire );
+
+		if ( (intptr_t)seq - (intptr_t)( dequeuePos + 1 ) < 0 )
+			return false;
+
+		record = std::move( slot.record );
+		slot.sequence.store( dequeuePos + Capacity, std::memory_order_release );
+		dequeuePos++;
+		return true;
+	}
+
+	void notify() {
+		wake.store( true, std::memory_order_release );
+		wakeCond.notify_one();
+	}
+
+	void push( Record&& record ) {
+		record.time = std::time( nullptr );
+
+		bool flush = record.level >= log->mAsyncFlushLevel;
+
+		while ( !tryPush( record ) ) {
+			// The writer is behind, wake it up and wait for a free slot
+			notify();
+			std::this_thread::yield();
+		}
+
+		if ( flush )
+			notify();
+	}
+
+	/** Pushes the record to the writer of the log. The record is written synchronously if the
+	 * asynchronous mode was disabled, or if it's written from the writer thread ( a log reader
+	 * logging ), since it would wait forever for a free slot if the queue is full. The users
+	 * count lets setAsync( false ) wait until nobody can be using the writer before deleting it,
+	 * there are two counters so the one it waits for only drains ( the new users take the other
+	 * one and can only see the writer already removed ). */
+	static void push( Log* log, Record&& record ) {
+		std::atomic<Uint32>& users = log->mAsyncUsers[log->mAsyncEpoch.load() & 1];
+		users.fetch_add( 1 );
+		AsyncWriter* writer = log->mAsync.load();
+
+		if ( NULL != writer &&
+			 writer->writerThreadId.load( std::memory_order_relaxed ) !=
+				 std::this_thread::get_id() ) {
+			writer->push( std::move( record ) );
+		} else {
+			record.time = std::time( nullptr );
+			std::string text;
+			append( text, record );
+			log->writeToOutputs( text );
+		}
+
+		users.fetch_sub( 1 );
+	}
+
+	static void append( std::string& batch, Record& record ) {
+		if ( record.timestamp ) {
+			batch += dateTimeStr( record.time );
+			batch += " - ";
+			batch += logLevelToString( record.level );
+			batch += ": ";
+		}
+
+		if ( record.format ) {
+			batch += record.format();
+			record.format = nullptr;
+		} else {
+			batch += record.text;
+		}
+
+		if ( record.newLine )
+			batch += '\n';
+	}
+
+	void flush() {
+		size_t target = enqueuePos.load( std::memory_order_acquire );
+		std::unique_lock<std::mutex> lock( mutex );
+
+		while ( written.load( std::memory_order_acquire ) < target ) {
+			wake.store( true, std::memory_order_release );
+			wakeCond.notify_one();
+			writtenCond.wait_for( lock, std::chrono::milliseconds( 10 ) );
+		}
+	}
+
+	void run() {
+		std::string batch;
+		Record record;
+
+		writerThreadId.store( std::this_thread::get_id(), std::memory_order_relaxed );
+
+		bool pending = false;
+
+		while ( true ) {
+			bool stopping;
+
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				auto interval =
+					std::chrono::microseconds( log->mAsyncFlushInterval.asMicroseconds() );
+				if ( !pending ) {
+					wakeCond.wait_for( lock, interval, [this] {
+						return stop || wake.load( std::memory_order_acquire );
+					} );
+				}
+				wake.store( false, std::memory_order_relaxed );
+				stopping = stop;
+			}
+
+			// A batch is at most a full queue, otherwise with producers that never stop the
+			// messages would never be written and flush() would wait forever
+			size_t count = 0;
+
+			while ( count < Capacity && tryPop( record ) ) {
+				append( batch, record );
+				count++;
+			}
+
+			pending = count == Capacity;
+
+			if ( !batch.empty() ) {
+				log->writeToOutputs( batch );
+				batch.clear();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				written.store( dequeuePos, std::memory_order_release );
+			}
+			writtenCond.notify_all();
+
+			if ( stopping && !pending )
+				break;
+		}
+	}
+};
+
 std::unordered_map<std::string, LogLevel> Log::getMapFlag() {
 	return { { "debug", LogLevel::Debug },	 { "info", LogLevel::Info },
 			 { "notice", LogLevel::Notice }, { "warning", LogLevel::Warning },
@@ -65,6 +294,62 @@ Log::Log( const std::string& logPath, const LogLevel& level, bool stdOutLog, boo
 	writel( LogLevel::Info, "eepp initialized" );
 }
 
+size_t Log::getKeepLogMaxSize() const {
+	return mKeepLogMaxSize;
+}
+
+void Log::setKeepLogMaxSize( size_t maxSize ) {
+	mKeepLogMaxSize = maxSize;
+}
+
+bool Log::isAsync() const {
+	return NULL != mAsync.load( std::memory_order_relaxed );
+}
+
+void Log::setAsync( bool async ) {
+	Lock l( mAsyncMutex );
+
+	if ( async && NULL == mAsync ) {
+		mAsync = eeNew( AsyncWriter, ( this ) );
+	} else if ( !async && NULL != mAsync ) {
+		AsyncWriter* writer = mAsync.exchange( NULL );
+
+		// The threads that already got the writer are still pushing to it, and the new ones
+		// write synchronously. Both counters are drained, a thread could have read the epoch
+		// before the previous disable and still be using the counter that isn't current.
+		for ( int i = 0; i < 2; i++ ) {
+			Uint32 epoch = mAsyncEpoch.fetch_add( 1 );
+			while ( mAsyncUsers[epoch & 1].load() != 0 )
+				std::this_thread::yield();
+		}
+
+		eeDelete( writer );
+	}
+}
+
+const Time& Log::getAsyncFlushInterval() const {
+	return mAsyncFlushInterval;
+}
+
+void Log::setAsyncFlushInterval( const Time& interval ) {
+	mAsyncFlushInterval = interval;
+}
+
+const LogLevel& Log::getAsyncFlushLevel() const {
+	return mAsyncFlushLevel;
+}
+
+void Log::setAsyncFlushLevel( const LogLevel& level ) {
+	mAsyncFlushLevel = level;
+}
+
+void Log::flush() {
+	Lock l( mAsyncMutex );
+
+	if ( NULL != mAsync )
+		mAsync.load()->flush();
+}
+
 bool Log::getKeepLog() const {
 	return mKeepLog;
 }
@@ -87,6 +372,8 @@ void Log::setFilePath( const std::string& filePath ) {
 Log::~Log() {
 	writel( LogLevel::Info, "eepp stoped\n" );
 
+	setAsync( false );
+
 	if ( mSave && !mLiveWrite && mKeepLog ) {
 		openFS();
 
@@ -115,12 +402,18 @@ void Log::save( const std::string& filepath ) {
 }
 
 void Log::write( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		unlock();
+	if ( NULL != mAsync ) {
+		writeAsync( LogLevel::Info, false, false, std::string( text ) );
+		return;
 	}
 
+	writeToOutputs( text );
+}
+
+void Log::writeToOutputs( const std::string_view& text ) {
+	if ( mKeepLog )
+		appendToBuffer( text );
+
 	writeToReaders( text );
 
 	if ( mStdOutEnabled ) {
@@ -166,6 +459,40 @@ static std::string logLevelToString( const LogLevel& level ) {
 	}
 }
 
+void Log::appendToBuffer( const std::string_view& text ) {
+	lock();
+
+	mData += text;
+
+	// Trim a quarter over the limit so it's not trimmed on every write
+	if ( mKeepLogMaxSize > 0 && mData.size() > mKeepLogMaxSize + mKeepLogMaxSize / 4 ) {
+		size_t cut = mData.size() - mKeepLogMaxSize;
+		size_t newLine = mData.find( '\n', cut );
+		mData.erase( 0, newLine != std::string::npos ? newLine + 1 : cut );
+	}
+
+	unlock();
+}
+
+void Log::writeAsync( const LogLevel& level, bool timestamp, bool newLine, std::string&& text ) {
+	AsyncWriter::Record record;
+	record.level = level;
+	record.timestamp = timestamp;
+	record.newLine = newLine;
+	record.text = std::move( text );
+	AsyncWriter::push( this, std::move( record ) );
+}
+
+void Log::writeAsync( const LogLevel& level, bool timestamp, bool newLine,
+					  std::function<std::string()>&& format ) {
+	AsyncWriter::Record record;
+	record.level = level;
+	record.timestamp = timestamp;
+	record.newLine = newLine;
+	record.format = std::move( format );
+	AsyncWriter::push( this, std::move( record ) );
+}
+
 std::string Log::logLevelWithTimestamp( const LogLevel& level, const std::string_view& text,
 										bool appendNewLine ) {
 	return String::format( appendNewLine ? "%s - %s: %s\n" : "%s - %s: %s",
@@ -174,20 +501,34 @@ std::string Log::logLevelWithTimestamp( const LogLevel& level, const std::string
 }
 
 void Log::write( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
-		write( logLevelWithTimestamp( level, text, false ) );
+	if ( level < mLogLevelThreshold )
+		return;
+
+	if ( NULL != mAsync ) {
+		writeAsync( level, true, false, std::string( text ) );
+		return;
+	}
+
+	write( logLevelWithTimestamp( level, text, false ) );
 }
 
 void Log::writel( const std::string_view& text ) {
-	if ( mKeepLog ) {
-		lock();
-		mData += text;
-		mData += "\n";
-		unlock();
+	if ( NULL != mAsync ) {
+		writeAsync( LogLevel::Info, false, true, std::string( text ) );
+		return;
 	}
 
-	writeToReaders( text );
-	writeToReaders( "\n" );
+	// A single append, so a line written from another thread can't end up between the text and
+	// its line break
+	std::string line;
+	line.reserve( text.size() + 1 );
+	line.append( text );
+	line += '\n';
+
+	if ( mKeepLog )
+		appendToBuffer( line );
+
+	writeToReaders( line );
 
 	if ( mStdOutEnabled ) {
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
@@ -208,16 +549,22 @@ void Log::writel( const std::string_view& text ) {
 	if ( mLiveWrite ) {
 		openFS();
 
-		mFS->write( text.data(), text.size() );
-		mFS->write( "\n", 1 );
+		mFS->write( line.data(), line.size() );
 
 		mFS->flush();
 	}
 }
 
 void Log::writel( const LogLevel& level, const std::string_view& text ) {
-	if ( level >= mLogLevelThreshold )
-		write( logLevelWithTimestamp( level, text, true ) );
+	if ( level < mLogLevelThreshold )
+		return;
+
+	if ( NULL != mAsync ) {
+		writeAsync( level, true, true, std::string( text ) );
+		return;
+	}
+
+	write( logLevelWithTimestamp( level, text, true ) );
 }
 
 void Log::openFS() {
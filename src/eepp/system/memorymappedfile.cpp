@@ -0,0 +1,136 @@
+#include <eepp/core/string.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/memorymappedfile.hpp>
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined( EE_PLATFORM_POSIX )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace EE { namespace System {
+
+MemoryMappedFile::MemoryMappedFile() :
+	mData( NULL ), mSize( 0 ), mOpen( false ), mMapped( false ), mMapHandle( NULL ) {}
+
+MemoryMappedFile::~MemoryMappedFile() {
+	close();
+}
+
+bool MemoryMappedFile::open( const std::string& path ) {
+	close();
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	HANDLE file = CreateFileW( String::fromUtf8( path ).toWideString().c_str(), GENERIC_READ,
+							   FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+							   FILE_ATTRIBUTE_NORMAL, NULL );
+
+	if ( INVALID_HANDLE_VALUE != file ) {
+		LARGE_INTEGER size;
+
+		if ( GetFileSizeEx( file, &size ) && size.QuadPart > 0 ) {
+			HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+			if ( NULL != mapping ) {
+				void* data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+
+				if ( NULL != data ) {
+					mData = static_cast<const Uint8*>( data );
+					mSize = static_cast<size_t>( size.QuadPart );
+					mMapHandle = mapping;
+					mMapped = true;
+				} else {
+					CloseHandle( mapping );
+				}
+			}
+		}
+
+		// The mapping keeps its own reference to the file
+		CloseHandle( file );
+	}
+#elif defined( EE_PLATFORM_POSIX )
+	int fd = ::open( path.c_str(), O_RDONLY );
+
+	if ( -1 != fd ) {
+		struct stat st;
+
+		if ( 0 == fstat( fd, &st ) && st.st_size > 0 ) {
+			void* data =
+				mmap( NULL, static_cast<size_t>( st.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+
+			if ( MAP_FAILED != data ) {
+				mData = static_cast<const Uint8*>( data );
+				mSize = static_cast<size_t>( st.st_size );
+				mMapped = true;
+			}
+		}
+
+		// The mapping keeps its own reference to the file
+		::close( fd );
+	}
+#endif
+
+	if ( !mMapped ) {
+		if ( !FileSystem::fileExists( path ) || !FileSystem::fileGet( path, mBuffer ) )
+			return false;
+
+		mData = mBuffer.get();
+		mSize = mBuffer.length();
+	}
+
+	mOpen = true;
+
+	return true;
+}
+
+void MemoryMappedFile::close() {
+	if ( mMapped ) {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		UnmapViewOfFile( mData );
+		CloseHandle( static_cast<HANDLE>( mMapHandle ) );
+#elif defined( EE_PLATFORM_POSIX )
+		munmap( const_cast<Uint8*>( mData ), mSize );
+#endif
+	}
+
+	mBuffer.clear();
+	mData = NULL;
+	mSize = 0;
+	mOpen = false;
+	mMapped = false;
+	mMapHandle = NULL;
+}
+
+bool MemoryMappedFile::isOpen() const {
+	return mOpen;
+}
+
+bool MemoryMappedFile::isMapped() const {
+	return mMapped;
+}
+
+const Uint8* MemoryMappedFile::getData() const {
+	return mData;
+}
+
+size_t MemoryMappedFile::getSize() const {
+	return mSize;
+}
+
+std::string_view MemoryMappedFile::getView( size_t offset, size_t size ) const {
+	if ( NULL == mData || offset > mSize || size > mSize - offset )
+		return std::string_view();
+
+	return std::string_view( reinterpret_cast<const char*>( mData ) + offset, size );
+}
+
+}} // namespace EE::System
@@ -4,7 +4,7 @@
 
 namespace EE { namespace System {
 
-Pack::Pack() : Mutex(), mIsOpen( false ) {
+Pack::Pack() : Mutex(), mIsOpen( false ), mMemoryMapped( false ) {
 	PackManager::instance()->add( this );
 }
 
@@ -16,6 +16,33 @@ bool Pack::isOpen() const {
 	return mIsOpen;
 }
 
+void Pack::setMemoryMapped( bool memoryMapped ) {
+	mMemoryMapped = memoryMapped;
+}
+
+bool Pack::isMemoryMapped() const {
+	return mMemoryMapped;
+}
+
+std::string_view Pack::getFileView( const std::string& ) {
+	return std::string_view();
+}
+
+bool Pack::extractFilesToMemory( const std::vector<std::string>& paths,
+								 std::vector<std::vector<Uint8>>& data ) {
+	bool ret = true;
+
+	data.clear();
+	data.resize( paths.size() );
+
+	for ( size_t i = 0; i < paths.size(); i++ ) {
+		if ( !extractFileToMemory( paths[i], data[i] ) )
+			ret = false;
+	}
+
+	return ret;
+}
+
 void Pack::onPackOpened() {
 	VirtualFileSystem::instance()->onResourceAdd( this );
 }
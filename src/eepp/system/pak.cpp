@@ -1,10 +1,19 @@
+#include <cstring>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammemory.hpp>
 #include <eepp/system/iostreampak.hpp>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/log.hpp>
 #include <eepp/system/pak.hpp>
+#include <eepp/system/scopedop.hpp>
 
 namespace EE { namespace System {
 
+static std::string pakEntryName( const char* filename ) {
+	const char* end = static_cast<const char*>( std::memchr( filename, '\0', 56 ) );
+	return std::string( filename, NULL != end ? end - filename : 56 );
+}
+
 Pak* Pak::New() {
 	return eeNew( Pak, () );
 }
@@ -71,6 +80,15 @@ bool Pak::open( const std::string& path ) {
 				mPakFiles.push_back( Entry );
 			}
 
+			mPakFilesIndex.clear();
+			mPakFilesIndex.reserve( mPakFiles.size() );
+
+			for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
+				mPakFilesIndex.emplace( pakEntryName( mPakFiles[i].filename ), i );
+
+			if ( mMemoryMapped )
+				mMapping.open( path );
+
 			mIsOpen = true;
 
 			onPackOpened();
@@ -86,8 +104,12 @@ bool Pak::close() {
 	if ( mIsOpen ) {
 		eeSAFE_DELETE( mPak.fs );
 
+		mMapping.close();
+
 		mPakFiles.clear();
 
+		mPakFilesIndex.clear();
+
 		mIsOpen = false;
 
 		onPackClosed();
@@ -114,9 +136,10 @@ Int8 Pak::checkPack() {
 
 Int32 Pak::exists( const std::string& path ) {
 	if ( isOpen() ) {
-		for ( Uint32 i = 0; i < mPakFiles.size(); i++ )
-			if ( std::strncmp( path.c_str(), mPakFiles[i].filename, path.size() ) == 0 )
-				return i;
+		auto it = mPakFilesIndex.find( path );
+
+		if ( it != mPakFilesIndex.end() )
+			return it->second;
 	}
 
 	return -1;
@@ -163,8 +186,15 @@ bool Pak::extractFileToMemory( const std::string& path, std::vector<Uint8>& data
 		data.clear();
 		data.resize( mPakFiles[Pos].file_length );
 
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( &data[0] ), mPakFiles[Pos].file_length );
+		std::string_view view =
+			mMapping.getView( mPakFiles[Pos].file_position, mPakFiles[Pos].file_length );
+
+		if ( !view.empty() ) {
+			std::memcpy( &data[0], view.data(), view.size() );
+		} else {
+			mPak.fs->seek( mPakFiles[Pos].file_position );
+			mPak.fs->read( reinterpret_cast<char*>( &data[0] ), mPakFiles[Pos].file_length );
+		}
 
 		Ret = true;
 	}
@@ -188,8 +218,15 @@ bool Pak::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 	if ( Pos != -1 ) {
 		data.reset( mPakFiles[Pos].file_length );
 
-		mPak.fs->seek( mPakFiles[Pos].file_position );
-		mPak.fs->read( reinterpret_cast<char*>( data.get() ), data.length() );
+		std::string_view view =
+			mMapping.getView( mPakFiles[Pos].file_position, mPakFiles[Pos].file_length );
+
+		if ( !view.empty() ) {
+			std::memcpy( data.get(), view.data(), view.size() );
+		} else {
+			mPak.fs->seek( mPakFiles[Pos].file_position );
+			mPak.fs->read( reinterpret_cast<char*>( data.get() ), data.length() );
+		}
 
 		Ret = true;
 	}
@@ -206,6 +243,14 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 	Uint32 fsize = dataSize;
 
 	if ( NULL != mPak.fs && mPak.fs->isOpen() ) {
+		if ( exists( inpack ) != -1 ) // If the file already exists exit
+			return false;
+
+		// The mapping doesn't grow with the file, it's mapped again after the write
+		ScopedOpOptional remap(
+			mMapping.isOpen(), [this] { mMapping.close(); },
+			[this] { mMapping.open( mPak.pakPath ); } );
+
 		if ( mPak.header.dir_length == 1 ) {
 			mPak.header.dir_offset = sizeof( pakHeader ) + fsize;
 			mPak.header.dir_length = sizeof( pakEntry );
@@ -227,12 +272,10 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 			mPak.fs->write( reinterpret_cast<const char*>( &newFile ), sizeof( pakEntry ) );
 
 			mPakFiles.push_back( newFile );
+			mPakFilesIndex.emplace( pakEntryName( newFile.filename ), 0 );
 
 			return true;
 		} else {
-			if ( exists( inpack ) != -1 ) // If the file already exists exit
-				return false;
-
 			if ( mPak.header.dir_length % 64 != 0 ) // Corrupted file?
 				return false;
 
@@ -268,6 +311,8 @@ bool Pak::addFile( const Uint8* data, const Uint32& dataSize, const std::string&
 							( std::streamsize )( sizeof( pakEntry ) * pakE.size() ) );
 
 			mPakFiles.push_back( pakE[mPak.pakFilesNum] );
+			mPakFilesIndex.emplace( pakEntryName( pakE[mPak.pakFilesNum].filename ),
+									mPak.pakFilesNum );
 			mPak.pakFilesNum += 1;
 
 			pakE.clear();
@@ -396,9 +441,28 @@ std::string Pak::getPackPath() {
 }
 
 IOStream* Pak::getFileStream( const std::string& path ) {
+	std::string_view view = getFileView( path );
+
+	if ( !view.empty() )
+		return IOStreamMemory::New( view.data(), view.size() );
+
 	return eeNew( IOStreamPak, ( this, path ) );
 }
 
+std::string_view Pak::getFileView( const std::string& path ) {
+	Lock l( *this );
+
+	if ( !mMapping.isOpen() )
+		return std::string_view();
+
+	Int32 Pos = exists( path );
+
+	if ( Pos == -1 )
+		return std::string_view();
+
+	return mMapping.getView( mPakFiles[Pos].file_position, mPakFiles[Pos].file_length );
+}
+
 Pak::pakEntry Pak::getPackEntry( Uint32 index ) {
 	if ( isOpen() && index < mPakFiles.size() ) {
 		return mPakFiles[index];
@@ -1,3 +1,5 @@
+#include <eepp/system/clock.hpp>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/resourceloader.hpp>
 #include <eepp/system/sys.hpp>
 #include <eepp/system/threadpool.hpp>
@@ -47,6 +49,17 @@ void ResourceLoader::setThreaded( const bool& threaded ) {
 void ResourceLoader::add( const ObjectLoaderTask& objectLoaderTask ) {
 	if ( !mLoading ) {
 		mTasks.emplace_back( objectLoaderTask );
+		mUploadTasks.emplace_back();
+	}
+}
+
+void ResourceLoader::add( const ObjectLoaderTask& loadTask, const ObjectLoaderTask& uploadTask ) {
+	if ( !mLoading ) {
+		mTasks.emplace_back( loadTask );
+		mUploadTasks.emplace_back( uploadTask );
+
+		if ( uploadTask )
+			mUploadCount++;
 	}
 }
 
@@ -56,6 +69,11 @@ bool ResourceLoader::clear() {
 		mLoading = false;
 		mTotalLoaded = 0;
 		mTasks.clear();
+		mUploadTasks.clear();
+		mUploadQueue.clear();
+		mUploadCount = 0;
+		mTotalUploaded = 0;
+		mLoadStageDone = false;
 		return true;
 	}
 
@@ -108,30 +126,91 @@ void ResourceLoader::taskRunner() {
 	{
 		auto pool = ThreadPool::createUnique( eemin( mThreads, (Uint32)mTasks.size() ) );
 
-		for ( auto& task : mTasks ) {
-			pool->run( task, [this]( const auto& ) { mTotalLoaded++; } );
+		for ( size_t i = 0; i < mTasks.size(); i++ ) {
+			pool->run( mTasks[i], [this, i]( const auto& ) {
+				mTotalLoaded++;
+
+				if ( mUploadTasks[i] ) {
+					Lock l( mUploadMutex );
+					mUploadQueue.push_back( i );
+				}
+			} );
 		}
 	}
 
-	mLoading = false;
-	setLoaded();
+	// The upload tasks finish the loading from update()
+	if ( mUploadCount > 0 ) {
+		mLoadStageDone = true;
+		return;
+	}
+
+	finishLoading();
 }
 
 void ResourceLoader::serializedLoad() {
 	mLoading = true;
 
-	for ( auto& task : mTasks ) {
-		task();
+	for ( size_t i = 0; i < mTasks.size(); i++ ) {
+		mTasks[i]();
 
 		mTotalLoaded++;
+
+		if ( mUploadTasks[i] ) {
+			mUploadTasks[i]();
+
+			mTotalUploaded++;
+		}
 	}
 
+	finishLoading();
+}
+
+void ResourceLoader::finishLoading() {
+	mLoadStageDone = false;
 	mLoading = false;
 	setLoaded();
 }
 
+bool ResourceLoader::update( const Time& budget ) {
+	if ( !mLoading || !mThreaded || 0 == mUploadCount )
+		return mLoaded;
+
+	Clock clock;
+
+	do {
+		size_t index;
+
+		{
+			Lock l( mUploadMutex );
+
+			if ( mUploadQueue.empty() )
+				break;
+
+			index = mUploadQueue.front();
+			mUploadQueue.pop_front();
+		}
+
+		mUploadTasks[index]();
+
+		mTotalUploaded++;
+	} while ( clock.getElapsedTime() < budget );
+
+	if ( mLoadStageDone && mTotalUploaded == mUploadCount )
+		finishLoading();
+
+	return mLoaded;
+}
+
 Float ResourceLoader::getProgress() {
-	return mTotalLoaded / (float)mTasks.size() * 100.f;
+	return ( mTotalLoaded + mTotalUploaded ) / (float)( mTasks.size() + mUploadCount ) * 100.f;
+}
+
+Float ResourceLoader::getProgress( const Stage& stage ) {
+	if ( Stage::Load == stage )
+		return mTotalLoaded / (float)mTasks.size() * 100.f;
+
+	return 0 == mUploadCount ? ( mLoaded ? 100.f : 0.f )
+							 : mTotalUploaded / (float)mUploadCount * 100.f;
 }
 
 }} // namespace EE::System
@@ -18,9 +18,17 @@ ThreadPool* ThreadPool::createRaw( Uint32 numThreads, bool terminateOnClose ) {
 }
 
 ThreadPool::ThreadPool( Uint32 numThreads, bool terminateOnClose ) :
-	mTerminateOnClose( terminateOnClose ) {
+	mLastWorkId( 0 ), mTerminateOnClose( terminateOnClose ) {
+	// All the workers must exist before any of them starts stealing
 	for ( Uint32 i = 0; i < numThreads; ++i ) {
-		mThreads.emplace_back( std::make_unique<Thread>( &ThreadPool::threadFunc, this ) );
+		mWorkers.emplace_back( std::make_unique<Worker>() );
+		mWorkers.back()->index = i;
+	}
+
+	for ( Uint32 i = 0; i < numThreads; ++i ) {
+		Worker* worker = mWorkers[i].get();
+		mThreads.emplace_back(
+			std::make_unique<Thread>( [this, worker]() { threadFunc( worker ); } ) );
 		mThreads.back()->launch();
 	}
 }
@@ -42,28 +50,169 @@ ThreadPool::~ThreadPool() {
 	}
 }
 
-void ThreadPool::threadFunc() {
+void ThreadPool::threadFunc( Worker* worker ) {
+	mCurrentWorker = worker;
+
+	Work work;
+
 	while ( true ) {
-		std::unique_ptr<Work> work;
+		if ( pop( worker, work ) ) {
+			execute( work );
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock( mMutex );
+
+		mWorkAvailable.wait( lock, [this]() { return mPendingWork > 0 || mShuttingDown; } );
+
+		// The queued work is drained before leaving
+		if ( mShuttingDown && mPendingWork <= 0 )
+			return;
+	}
+}
+
+bool ThreadPool::pop( Worker* worker, Work& work, TaskGroup* group ) {
+	if ( mPendingWork <= 0 )
+		return false;
+
+	auto matches = [group]( const Work& w ) { return NULL == group || w.group == group; };
+
+	auto takeFront = [&work, &matches]( std::deque<Work>& queue ) {
+		auto it = std::find_if( queue.begin(), queue.end(), matches );
+		if ( it == queue.end() )
+			return false;
+		work = std::move( *it );
+		queue.erase( it );
+		return true;
+	};
+
+	auto takeBack = [&work, &matches]( std::deque<Work>& queue ) {
+		auto it = std::find_if( queue.rbegin(), queue.rend(), matches );
+		if ( it == queue.rend() )
+			return false;
+		work = std::move( *it );
+		queue.erase( std::next( it ).base() );
+		return true;
+	};
+
+	for ( std::size_t p = 0; p < PRIORITY_COUNT; ++p ) {
+		// Own queue first, in queue order
+		if ( NULL != worker ) {
+			std::lock_guard<std::mutex> lock( worker->queue.mutex );
+			if ( takeFront( worker->queue.work[p] ) )
+				break;
+		}
+
 		{
-			std::unique_lock<std::mutex> lock( mMutex );
+			std::lock_guard<std::mutex> lock( mQueue.mutex );
+			if ( takeFront( mQueue.work[p] ) )
+				break;
+		}
+
+		// Steal the newest task of another worker, starting from a different one each time to
+		// spread the thefts
+		bool stolen = false;
+		std::size_t count = mWorkers.size();
+		std::size_t start = mStealSeed++ % eemax<std::size_t>( 1, count );
 
-			mWorkAvailable.wait( lock, [this]() { return !mWork.empty() || mShuttingDown; } );
+		for ( std::size_t i = 0; i < count && !stolen; ++i ) {
+			Worker* victim = mWorkers[( start + i ) % count].get();
 
-			if ( mShuttingDown && mWork.empty() ) {
-				return;
-			}
+			if ( victim == worker )
+				continue;
 
-			work = std::move( mWork.front() );
-			mWork.pop_front();
+			std::lock_guard<std::mutex> lock( victim->queue.mutex );
+			stolen = takeBack( victim->queue.work[p] );
 		}
 
-		work->func();
+		if ( stolen )
+			break;
+
+		if ( p == PRIORITY_COUNT - 1 )
+			return false;
+	}
+
+	--mPendingWork;
 
-		if ( work->callback != nullptr ) {
-			work->callback( work->id );
+	return true;
+}
+
+void ThreadPool::execute( Work& work ) {
+	TaskGroup* group = work.group;
+
+	// The tasks of a cancelled group are discarded
+	if ( NULL == group || !group->isCancelled() ) {
+		work.func();
+
+		if ( work.callback != nullptr ) {
+			work.callback( work.id );
 		}
 	}
+
+	// Release the task resources before informing the group, the group may be gone after that
+	work.func = Task();
+	work.callback = nullptr;
+	work.group = NULL;
+
+	if ( NULL != group )
+		group->taskDone();
+}
+
+Uint64 ThreadPool::push( Task&& func, std::function<void( const Uint64& )>&& callback,
+						 const Uint64& tag, const Priority& priority, TaskGroup* group ) {
+	// The group tasks are still accepted while shutting down, the group waiter runs them if the
+	// workers are gone
+	if ( mShuttingDown && NULL == group )
+		return 0;
+
+	Uint64 id = ++mLastWorkId;
+
+	Worker* worker = mCurrentWorker;
+	Queue& queue = NULL != worker ? worker->queue : mQueue;
+	std::size_t lane = eemin( static_cast<std::size_t>( priority ), PRIORITY_COUNT - 1 );
+
+	{
+		std::lock_guard<std::mutex> lock( queue.mutex );
+		Work work;
+		work.id = id;
+		work.func = std::move( func );
+		work.callback = std::move( callback );
+		work.tag = tag;
+		work.group = group;
+		queue.work[lane].emplace_back( std::move( work ) );
+	}
+
+	{
+		// Taking the lock avoids a lost wake up between the sleeping worker check and its wait
+		std::unique_lock<std::mutex> lock( mMutex );
+		++mPendingWork;
+	}
+
+	mWorkAvailable.notify_one();
+
+	return id;
+}
+
+bool ThreadPool::runPendingTask() {
+	Work work;
+
+	if ( !pop( mCurrentWorker, work ) )
+		return false;
+
+	execute( work );
+
+	return true;
+}
+
+bool ThreadPool::runPendingTask( TaskGroup* group ) {
+	Work work;
+
+	if ( !pop( mCurrentWorker, work, group ) )
+		return false;
+
+	execute( work );
+
+	return true;
 }
 
 bool ThreadPool::terminateOnClose() const {
@@ -75,62 +224,104 @@ void ThreadPool::setTerminateOnClose( bool terminateOnClose ) {
 }
 
 bool ThreadPool::existsIdInQueue( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[id]( const std::unique_ptr<Work>& work ) { return work->id == id; } );
+	auto exists = [id]( Queue& queue ) {
+		std::lock_guard<std::mutex> lock( queue.mutex );
+		for ( const auto& lane : queue.work )
+			if ( std::any_of( lane.begin(), lane.end(),
+							  [id]( const Work& work ) { return work.id == id; } ) )
+				return true;
+		return false;
+	};
+
+	return exists( mQueue ) ||
+		   std::any_of( mWorkers.begin(), mWorkers.end(),
+						[&]( const std::unique_ptr<Worker>& w ) { return exists( w->queue ); } );
 }
 
 bool ThreadPool::existsTagInQueue( const Uint64& tag ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[tag]( const std::unique_ptr<Work>& work ) { return work->tag == tag; } );
+	auto exists = [tag]( Queue& queue ) {
+		std::lock_guard<std::mutex> lock( queue.mutex );
+		for ( const auto& lane : queue.work )
+			if ( std::any_of( lane.begin(), lane.end(),
+							  [tag]( const Work& work ) { return work.tag == tag; } ) )
+				return true;
+		return false;
+	};
+
+	return exists( mQueue ) ||
+		   std::any_of( mWorkers.begin(), mWorkers.end(),
+						[&]( const std::unique_ptr<Worker>& w ) { return exists( w->queue ); } );
 }
 
 bool ThreadPool::removeId( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	for ( auto it = mWork.begin(); it != mWork.end(); ++it ) {
-		if ( it->get()->id == id ) {
-			mWork.erase( it );
-			return true;
-		}
-	}
-	return false;
+	return removeIf( [id]( const Work& work ) { return work.id == id; }, true );
 }
 
 bool ThreadPool::removeWithTag( const Uint64& tag ) {
-	std::vector<Uint64> ids;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
-		for ( const auto& work : mWork )
-			if ( work->tag == tag )
-				ids.emplace_back( work->id );
-	}
-	for ( const auto& id : ids )
-		removeId( id );
-	return !ids.empty();
+	return removeIf( [tag]( const Work& work ) { return work.tag == tag; }, false );
 }
 
 Uint64 ThreadPool::run( const std::function<void()>& func,
 						const std::function<void( const Uint64& )>& doneCallback,
-						const Uint64& tag ) {
-	Uint64 id = ++mLastWorkId;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
+						const Uint64& tag, const Priority& priority ) {
+	if ( mShuttingDown )
+		return ++mLastWorkId;
+
+	std::function<void( const Uint64& )> callback( doneCallback );
 
-		if ( mShuttingDown )
-			return id;
+	return push( Task( func ), std::move( callback ), tag, priority, NULL );
+}
+
+Uint32 ThreadPool::numThreads() const {
+	std::unique_lock<std::mutex> lock( mMutex );
+	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
+}
 
-		mWork.emplace_back( new Work{ id, func, doneCallback, tag } );
+TaskGroup::TaskGroup( ThreadPool& pool, const ThreadPool::Priority& priority ) :
+	mPool( pool ), mPriority( priority ) {}
+
+TaskGroup::~TaskGroup() {
+	wait();
+}
+
+void TaskGroup::wait() {
+	while ( mPending > 0 ) {
+		// Help with the queued tasks of the group instead of blocking a pool worker. Other tasks
+		// aren't run here: they could be long or wait for something this thread holds.
+		if ( mPool.runPendingTask( this ) )
+			continue;
+
+		// The running tasks can still queue more tasks in the group, so it checks for them again
+		// from time to time
+		std::unique_lock<std::mutex> lock( mMutex );
+		mDone.wait_for( lock, std::chrono::milliseconds( 1 ), [this] { return 0 == mPending; } );
 	}
 
-	mWorkAvailable.notify_one();
+	// The last finished task may still be notifying, the group can be destroyed after this
+	std::lock_guard<std::mutex> lock( mMutex );
+}
 
-	return id;
+void TaskGroup::cancel() {
+	mToken.cancel();
 }
 
-Uint32 ThreadPool::numThreads() const {
+bool TaskGroup::isCancelled() const {
+	return mToken.isCancelled();
+}
+
+const CancellationToken& TaskGroup::getToken() const {
+	return mToken;
+}
+
+ThreadPool& TaskGroup::getPool() const {
+	return mPool;
+}
+
+void TaskGroup::taskDone() {
 	std::unique_lock<std::mutex> lock( mMutex );
-	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
+
+	if ( 0 == --mPending )
+		mDone.notify_all();
 }
 
 }} // namespace EE::System
@@ -13,6 +13,11 @@ static std::vector<std::string> vfsSplitPath( std::string& path ) {
 	return String::split( path, '/' );
 }
 
+static bool vfsIsNormalizedPath( const std::string& path ) {
+	return !path.empty() && path.front() != '/' && path.back() != '/' &&
+		   path.find( "//" ) == std::string::npos;
+}
+
 VirtualFileSystem::VirtualFileSystem() {}
 
 std::vector<std::string> VirtualFileSystem::filesGetInPath( std::string path ) {
@@ -45,30 +50,18 @@ std::vector<std::string> VirtualFileSystem::filesGetInPath( std::string path ) {
 }
 
 Pack* VirtualFileSystem::getPackFromFile( std::string path ) {
-	std::vector<std::string> paths = vfsSplitPath( path );
-	vfsDirectory* curDir = &mRoot;
-
-	if ( paths.size() >= 1 ) {
-		size_t pos = 0;
-
-		do {
-			if ( pos == paths.size() - 1 ) {
-				if ( curDir->files.find( paths[pos] ) != curDir->files.end() ) {
-					return curDir->files[paths[pos]].pack;
-				}
-			} else {
-				if ( curDir->directories.find( paths[pos] ) == curDir->directories.end() ) {
-					return NULL;
-				}
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	if ( path.find_first_of( '\\' ) != std::string::npos ) {
+		String::replaceAll( path, "\\", "/" );
+	}
+#endif
 
-				curDir = &curDir->directories[paths[pos]];
-			}
+	if ( !vfsIsNormalizedPath( path ) )
+		path = String::join( vfsSplitPath( path ), '/' );
 
-			pos++;
-		} while ( pos < paths.size() );
-	}
+	auto it = mFiles.find( path );
 
-	return NULL;
+	return it != mFiles.end() ? it->second : NULL;
 }
 
 IOStream* VirtualFileSystem::getFileFromPath( const std::string& path ) {
@@ -93,6 +86,14 @@ void VirtualFileSystem::onResourceAdd( Pack* resource ) {
 void VirtualFileSystem::onResourceRemove( Pack* resource ) {
 	remove( resource );
 	removePackFromDirectory( resource, mRoot );
+
+	for ( auto it = mFiles.begin(); it != mFiles.end(); ) {
+		if ( it->second == resource ) {
+			it = mFiles.erase( it );
+		} else {
+			++it;
+		}
+	}
 }
 
 void VirtualFileSystem::addFile( std::string path, Pack* pack ) {
@@ -102,6 +103,8 @@ void VirtualFileSystem::addFile( std::string path, Pack* pack ) {
 	if ( paths.size() >= 1 ) {
 		size_t pos = 0;
 
+		mFiles[String::join( paths, '/' )] = pack;
+
 		do {
 			if ( pos == paths.size() - 1 ) {
 				curDir->files[paths[pos]] = vfsFile( path, pack );
@@ -1,11 +1,41 @@
+#include <atomic>
+#include <cstring>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammemory.hpp>
 #include <eepp/system/iostreamzip.hpp>
+#include <eepp/system/lock.hpp>
+#include <eepp/system/sys.hpp>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/system/zip.hpp>
 #include <libzip/zip.h>
 #include <libzip/zipint.h>
+#include <zlib.h>
 
 namespace EE { namespace System {
 
+static Uint16 readUint16LE( const Uint8* data ) {
+	return static_cast<Uint16>( data[0] | ( data[1] << 8 ) );
+}
+
+static bool inflateRaw( const Uint8* src, size_t srcSize, Uint8* dst, size_t dstSize ) {
+	z_stream stream;
+	std::memset( &stream, 0, sizeof( stream ) );
+
+	if ( inflateInit2( &stream, -MAX_WBITS ) != Z_OK )
+		return false;
+
+	stream.next_in = const_cast<Bytef*>( src );
+	stream.avail_in = static_cast<uInt>( srcSize );
+	stream.next_out = dst;
+	stream.avail_out = static_cast<uInt>( dstSize );
+
+	int res = inflate( &stream, Z_FINISH );
+
+	inflateEnd( &stream );
+
+	return Z_STREAM_END == res && stream.total_out == dstSize;
+}
+
 Zip* Zip::New() {
 	return eeNew( Zip, () );
 }
@@ -24,6 +54,8 @@ bool Zip::create( const std::string& path ) {
 		if ( 0 == checkPack() ) {
 			mZipPath = path;
 
+			onZipOpened();
+
 			mIsOpen = true;
 
 			onPackOpened();
@@ -45,6 +77,8 @@ bool Zip::open( const std::string& path ) {
 		if ( 0 == checkPack() ) {
 			mZipPath = path;
 
+			onZipOpened();
+
 			mIsOpen = true;
 
 			onPackOpened();
@@ -60,6 +94,13 @@ bool Zip::open( const std::string& path ) {
 
 bool Zip::close() {
 	if ( 0 == checkPack() ) {
+		// zip_close writes the pending changes, the file can't be mapped meanwhile
+		mMapping.close();
+
+		mMappedEntries.clear();
+
+		mFilesIndex.clear();
+
 		zip_close( mZip );
 
 		mIsOpen = false;
@@ -135,6 +176,11 @@ bool Zip::eraseFiles( const std::vector<std::string>& paths ) {
 		else {
 			if ( zip_delete( mZip, Ex ) == -1 )
 				return false;
+
+			mFilesIndex.erase( paths[i] );
+
+			if ( Ex < (Int32)mMappedEntries.size() )
+				mMappedEntries[Ex].valid = false;
 		}
 	}
 
@@ -168,8 +214,17 @@ bool Zip::extractFileToMemory( const std::string& path, std::vector<Uint8>& data
 
 		data.clear();
 
+		if ( Pos < (Int32)mMappedEntries.size() && mMappedEntries[Pos].valid ) {
+			data.resize( mMappedEntries[Pos].size );
+
+			if ( data.empty() || extractMappedEntry( Pos, &data[0] ) ) {
+				unlock();
+				return true;
+			}
+		}
+
 		struct zip_stat zs;
-		int err = zip_stat( mZip, path.c_str(), 0, &zs );
+		int err = zip_stat_index( mZip, Pos, 0, &zs );
 
 		if ( !err ) {
 			struct zip_file* zf = zip_fopen_index( mZip, zs.index, 0 );
@@ -201,8 +256,17 @@ bool Zip::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 	Int32 Result = 0;
 
 	if ( 0 == checkPack() && -1 != Pos ) {
+		if ( Pos < (Int32)mMappedEntries.size() && mMappedEntries[Pos].valid ) {
+			data.reset( mMappedEntries[Pos].size );
+
+			if ( 0 == data.length() || extractMappedEntry( Pos, data.get() ) ) {
+				unlock();
+				return true;
+			}
+		}
+
 		struct zip_stat zs;
-		int err = zip_stat( mZip, path.c_str(), 0, &zs );
+		int err = zip_stat_index( mZip, Pos, 0, &zs );
 
 		if ( !err ) {
 			struct zip_file* zf = zip_fopen_index( mZip, zs.index, 0 );
@@ -226,8 +290,12 @@ bool Zip::extractFileToMemory( const std::string& path, ScopedBuffer& data ) {
 }
 
 Int32 Zip::exists( const std::string& path ) {
-	if ( isOpen() )
-		return zip_name_locate( mZip, path.c_str(), 0 );
+	if ( isOpen() ) {
+		auto it = mFilesIndex.find( path );
+
+		if ( it != mFilesIndex.end() )
+			return it->second;
+	}
 
 	return -1;
 }
@@ -260,11 +328,141 @@ std::string Zip::getPackPath() {
 }
 
 IOStream* Zip::getFileStream( const std::string& path ) {
+	std::string_view view = getFileView( path );
+
+	if ( !view.empty() )
+		return IOStreamMemory::New( view.data(), view.size() );
+
 	return eeNew( IOStreamZip, ( this, path ) );
 }
 
+std::string_view Zip::getFileView( const std::string& path ) {
+	Lock l( *this );
+
+	Int32 Pos = exists( path );
+
+	if ( -1 == Pos || Pos >= (Int32)mMappedEntries.size() )
+		return std::string_view();
+
+	const MappedEntry& entry = mMappedEntries[Pos];
+
+	if ( !entry.valid || ZIP_CM_STORE != entry.method )
+		return std::string_view();
+
+	return mMapping.getView( entry.offset, entry.size );
+}
+
+bool Zip::extractFilesToMemory( const std::vector<std::string>& paths,
+								std::vector<std::vector<Uint8>>& data ) {
+	if ( !mMapping.isOpen() )
+		return Pack::extractFilesToMemory( paths, data );
+
+	Lock l( *this );
+
+	std::atomic<bool> ret( true );
+	std::vector<std::pair<Int32, size_t>> deflated;
+
+	data.clear();
+	data.resize( paths.size() );
+
+	for ( size_t i = 0; i < paths.size(); i++ ) {
+		Int32 Pos = exists( paths[i] );
+
+		if ( -1 != Pos && Pos < (Int32)mMappedEntries.size() && mMappedEntries[Pos].valid &&
+			 ZIP_CM_DEFLATE == mMappedEntries[Pos].method ) {
+			data[i].resize( mMappedEntries[Pos].size );
+
+			if ( !data[i].empty() )
+				deflated.emplace_back( Pos, i );
+		} else if ( !extractFileToMemory( paths[i], data[i] ) ) {
+			ret = false;
+		}
+	}
+
+	if ( deflated.size() > 1 ) {
+		// The pool destructor waits for all the entries to be decompressed. The workers only read
+		// the mapping, libzip is not used from them.
+		auto pool = ThreadPool::createUnique(
+			eemin( eemax( (Uint32)Sys::getCPUCount(), 1u ), (Uint32)deflated.size() ) );
+
+		for ( const auto& entry : deflated ) {
+			pool->run( [this, &data, &ret, entry] {
+				if ( !extractMappedEntry( entry.first, &data[entry.second][0] ) )
+					ret = false;
+			} );
+		}
+	} else if ( !deflated.empty() ) {
+		if ( !extractMappedEntry( deflated[0].first, &data[deflated[0].second][0] ) )
+			ret = false;
+	}
+
+	return ret;
+}
+
 zip* Zip::getZip() {
 	return mZip;
 }
 
+void Zip::onZipOpened() {
+	zip_uint64_t numEntries = zip_get_num_entries( mZip, 0 );
+
+	mFilesIndex.clear();
+	mFilesIndex.reserve( numEntries );
+
+	for ( zip_uint64_t i = 0; i < numEntries; i++ ) {
+		const char* name = zip_get_name( mZip, i, 0 );
+
+		// zip_name_locate returns the first entry with the name
+		if ( NULL != name )
+			mFilesIndex.emplace( name, (Int32)i );
+	}
+
+	mMappedEntries.clear();
+
+	if ( !mMemoryMapped || NULL == mZip->cdir || !mMapping.open( mZipPath ) )
+		return;
+
+	const Uint8* mapData = mMapping.getData();
+	size_t mapSize = mMapping.getSize();
+
+	mMappedEntries.resize( mZip->cdir->nentry );
+
+	for ( int i = 0; i < mZip->cdir->nentry; i++ ) {
+		const struct zip_dirent& dirent = mZip->cdir->entry[i];
+		MappedEntry& entry = mMappedEntries[i];
+		size_t offset = dirent.offset;
+
+		// Encrypted entries are left to libzip
+		if ( ( dirent.bitflags & 1 ) || offset + LENTRYSIZE > mapSize ||
+			 0 != std::memcmp( mapData + offset, LOCAL_MAGIC, 4 ) )
+			continue;
+
+		// The local header name and extra field lengths can differ from the central directory
+		offset += LENTRYSIZE + readUint16LE( mapData + offset + 26 ) +
+				  readUint16LE( mapData + offset + 28 );
+
+		if ( offset + dirent.comp_size > mapSize )
+			continue;
+
+		entry.offset = (Uint32)offset;
+		entry.compSize = dirent.comp_size;
+		entry.size = dirent.uncomp_size;
+		entry.method = dirent.comp_method;
+		entry.valid = ( ZIP_CM_STORE == entry.method && entry.compSize == entry.size ) ||
+					  ZIP_CM_DEFLATE == entry.method;
+	}
+}
+
+bool Zip::extractMappedEntry( Int32 index, Uint8* data ) {
+	const MappedEntry& entry = mMappedEntries[index];
+	const Uint8* src = mMapping.getData() + entry.offset;
+
+	if ( ZIP_CM_STORE == entry.method ) {
+		std::memcpy( data, src, entry.size );
+		return true;
+	}
+
+	return inflateRaw( src, entry.compSize, data, entry.size );
+}
+
 }} // namespace EE::System
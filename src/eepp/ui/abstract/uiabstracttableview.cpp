@@ -1,3 +1,5 @@
+#include <eepp/system/lock.hpp>
+#include <eepp/system/scopedop.hpp>
 #include <eepp/system/thread.hpp>
 #include <eepp/ui/abstract/uiabstracttableview.hpp>
 #include <eepp/ui/uiimage.hpp>
@@ -706,6 +708,101 @@ void UIAbstractTableView::setRowHeaderWidth( Float rowHeaderWidth ) {
 	buildRowHeader();
 }
 
+const size_t& UIAbstractTableView::getColumnMeasureSampleSize() const {
+	return mColumnMeasureSampleSize;
+}
+
+void UIAbstractTableView::setColumnMeasureSampleSize( const size_t& sampleSize ) {
+	mColumnMeasureSampleSize = sampleSize;
+}
+
+Float UIAbstractTableView::getCachedTextWidth( const std::string& text,
+											   const FontStyleConfig& style ) {
+	if ( !( mTextWidthCacheStyle == style ) ) {
+		mTextWidthCache.clear();
+		mTextWidthCacheStyle = style;
+	}
+
+	auto it = mTextWidthCache.find( text );
+	if ( it != mTextWidthCache.end() )
+		return it->second;
+
+	// The cache only keeps the texts of the last measured models
+	if ( mTextWidthCache.size() >= 65536 )
+		mTextWidthCache.clear();
+
+	Float width = Text::getTextWidth( String::fromUtf8( text ), style );
+	mTextWidthCache[text] = width;
+	return width;
+}
+
+Float UIAbstractTableView::measureColumnContentWidth(
+	const size_t& rowCount, const std::function<std::pair<ModelIndex, size_t>( size_t )>& getRow,
+	const Float& indentWidth, bool sample ) {
+	static constexpr size_t LaidOutCells = 8;
+	Model* model = getModel();
+	if ( nullptr == model || 0 == rowCount )
+		return 0;
+
+	Lock l( model->resourceMutex() );
+	ScopedOp op( [this] { mUISceneNode->setIsLoading( true ); },
+				 [this] { mUISceneNode->setIsLoading( false ); } );
+	Float yOffset = getHeaderHeight();
+	size_t step = sample && mColumnMeasureSampleSize > 0 && rowCount > mColumnMeasureSampleSize
+					  ? rowCount / mColumnMeasureSampleSize
+					  : 1;
+
+	auto cellWidth = [&]( const std::pair<ModelIndex, size_t>& row ) -> Float {
+		UIWidget* widget = updateCell( { (Int64)0, (Int64)0 }, row.first, row.second, yOffset );
+		return widget->isType( UI_TYPE_PUSHBUTTON )
+				   ? widget->asType<UIPushButton>()->getContentSize().getWidth()
+				   : 0.f;
+	};
+
+	// A real cell provides the font of the column
+	std::pair<ModelIndex, size_t> firstRow( getRow( 0 ) );
+	UIWidget* widget = updateCell( { (Int64)0, (Int64)0 }, firstRow.first, firstRow.second,
+								   yOffset );
+
+	if ( !widget->isType( UI_TYPE_PUSHBUTTON ) ||
+		 nullptr == widget->asType<UIPushButton>()->getTextBox() ) {
+		Float maxWidth = 0;
+		for ( size_t i = 0; i < rowCount; i += step )
+			maxWidth = eemax( maxWidth, cellWidth( getRow( i ) ) );
+		return maxWidth;
+	}
+
+	FontStyleConfig style( widget->asType<UIPushButton>()->getTextBox()->getFontStyleConfig() );
+	std::vector<std::pair<Float, size_t>> widest;
+	widest.reserve( LaidOutCells + 1 );
+
+	for ( size_t i = 0; i < rowCount; i += step ) {
+		std::pair<ModelIndex, size_t> row( getRow( i ) );
+		Variant data( model->data( row.first, ModelRole::Display ) );
+		Float width = indentWidth * row.second;
+		if ( data.isValid() )
+			width += getCachedTextWidth( data.toString(), style );
+		if ( model->data( row.first, ModelRole::Icon ).isValid() )
+			width += mIconSize;
+
+		if ( widest.size() < LaidOutCells || width > widest.back().first ) {
+			auto pos = std::upper_bound(
+				widest.begin(), widest.end(), width,
+				[]( const Float& width, const std::pair<Float, size_t>& cell ) {
+					return width > cell.first;
+				} );
+			widest.insert( pos, { width, i } );
+			if ( widest.size() > LaidOutCells )
+				widest.pop_back();
+		}
+	}
+
+	Float maxWidth = 0;
+	for ( const auto& cell : widest )
+		maxWidth = eemax( maxWidth, cellWidth( getRow( cell.second ) ) );
+	return maxWidth;
+}
+
 void UIAbstractTableView::buildRowHeader() {
 	if ( mRowHeaderWidth == 0 ) {
 		if ( mRowHeader )
@@ -253,6 +253,7 @@ void StyleSheetSpecification::registerDefaultProperties() {
 	registerProperty( "column-width", "" ).setType( PropertyType::NumberLength );
 	registerProperty( "row-weight", "" ).setType( PropertyType::NumberFloat );
 	registerProperty( "reverse-draw", "" ).setType( PropertyType::Bool );
+	registerProperty( "retained-draw", "false" ).setType( PropertyType::Bool );
 
 	registerProperty( "orientation", "" );
 	registerProperty( "indeterminate", "" ).setType( PropertyType::Bool );
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <eepp/system/log.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/doc/syntaxhighlighter.hpp>
@@ -41,6 +42,7 @@ void SyntaxHighlighter::reset() {
 	}
 	Lock l( mLinesMutex );
 	mLines.clear();
+	clearSemanticTokens();
 	mFirstInvalidLine = 0;
 	mMaxWantedLine = 0;
 }
@@ -82,9 +84,24 @@ Mutex& SyntaxHighlighter::getLinesMutex() {
 	return mLinesMutex;
 }
 
-void SyntaxHighlighter::moveHighlight( const Int64& fromLine, const Int64& /*toLine*/,
+void SyntaxHighlighter::moveHighlight( const Int64& fromLine, const Int64& toLine,
 									   const Int64& numLines ) {
 	Lock l( mLinesMutex );
+	if ( !mSemanticLines.empty() && numLines != 0 ) {
+		// Lines after toLine are displaced, the removed lines lose their semantic tokens
+		const auto lineGreater = []( Int64 line, const SemanticLine& sline ) {
+			return line < sline.line;
+		};
+		auto it = std::upper_bound( mSemanticLines.begin(), mSemanticLines.end(), toLine,
+									lineGreater );
+		if ( numLines < 0 ) {
+			it = mSemanticLines.erase( std::upper_bound( mSemanticLines.begin(), it,
+														 toLine + numLines, lineGreater ),
+									   it );
+		}
+		for ( ; it != mSemanticLines.end(); ++it )
+			it->line += numLines;
+	}
 	if ( mLines.find( fromLine ) == mLines.end() )
 		return;
 	Int64 linesCount = mDoc->linesCount();
@@ -164,7 +181,7 @@ const std::vector<SyntaxTokenPosition>& SyntaxHighlighter::getLine( const size_t
 			( index < mDoc->linesCount() && mDoc->line( index ).getHash() != it->second.hash );
 		if ( !needsTokenize ) {
 			mMaxWantedLine = eemax<Int64>( mMaxWantedLine, index );
-			return it->second.tokens;
+			return resolveSemanticLine( index, it->second );
 		}
 	}
 
@@ -186,7 +203,7 @@ const std::vector<SyntaxTokenPosition>& SyntaxHighlighter::getLine( const size_t
 	mLines[index] = std::move( tokenizedLine );
 	mTokenizerLines[index] = mLines[index];
 	mMaxWantedLine = eemax<Int64>( mMaxWantedLine, index );
-	return mLines[index].tokens;
+	return resolveSemanticLine( index, mLines[index] );
 }
 
 Int64 SyntaxHighlighter::getFirstInvalidLine() const {
@@ -301,6 +318,40 @@ void SyntaxHighlighter::setLine( const size_t& line, const TokenizedLine& tokeni
 	mLines[line] = tokenization;
 }
 
+static void mergeTokens( std::vector<SyntaxTokenPosition>& tokens,
+						 const std::vector<SyntaxTokenPosition>& overlay ) {
+	size_t lastTokenPos = 0;
+	for ( const auto& token : overlay ) {
+		for ( size_t i = lastTokenPos; i < tokens.size(); ++i ) {
+			const auto ltoken = tokens[i];
+			if ( token.pos >= ltoken.pos && token.pos + token.len <= ltoken.pos + ltoken.len ) {
+				tokens.erase( tokens.begin() + i );
+				int iDiff = i;
+
+				if ( token.pos > ltoken.pos ) {
+					++iDiff;
+					tokens.insert( tokens.begin() + i,
+								   { ltoken.type, ltoken.pos,
+									 static_cast<SyntaxTokenLen>( token.pos - ltoken.pos ) } );
+				}
+
+				tokens.insert( tokens.begin() + iDiff, token );
+
+				if ( token.pos + token.len < ltoken.pos + ltoken.len ) {
+					tokens.insert(
+						tokens.begin() + iDiff + 1,
+						{ ltoken.type, static_cast<SyntaxTokenLen>( token.pos + token.len ),
+						  static_cast<SyntaxTokenLen>( ( ltoken.pos + ltoken.len ) -
+													   ( token.pos + token.len ) ) } );
+				}
+
+				lastTokenPos = i;
+				break;
+			}
+		}
+	}
+}
+
 void SyntaxHighlighter::mergeLine( const size_t& line, const TokenizedLine& tokenization ) {
 	TokenizedLine tline;
 	{
@@ -319,41 +370,196 @@ void SyntaxHighlighter::mergeLine( const size_t& line, const TokenizedLine& toke
 		}
 	}
 
-	size_t lastTokenPos = 0;
-	for ( const auto& token : tokenization.tokens ) {
-		for ( size_t i = lastTokenPos; i < tline.tokens.size(); ++i ) {
-			const auto ltoken = tline.tokens[i];
-			if ( token.pos >= ltoken.pos && token.pos + token.len <= ltoken.pos + ltoken.len ) {
-				tline.tokens.erase( tline.tokens.begin() + i );
-				int iDiff = i;
+	mergeTokens( tline.tokens, tokenization.tokens );
 
-				if ( token.pos > ltoken.pos ) {
-					++iDiff;
-					tline.tokens.insert(
-						tline.tokens.begin() + i,
-						{ ltoken.type, ltoken.pos,
-						  static_cast<SyntaxTokenLen>( token.pos - ltoken.pos ) } );
-				}
+	tline.signature = tokenization.signature;
+	Lock l( mLinesMutex );
+	mLines[line] = std::move( tline );
+}
 
-				tline.tokens.insert( tline.tokens.begin() + iDiff, token );
+void SyntaxHighlighter::setSemanticTokenTypes( std::vector<SyntaxStyleType>&& types ) {
+	Lock l( mLinesMutex );
+	if ( types == mSemanticTokenTypes )
+		return;
+	mSemanticTokenTypes = std::move( types );
+	mSemanticMergedLines.clear();
+}
 
-				if ( token.pos + token.len < ltoken.pos + ltoken.len ) {
-					tline.tokens.insert(
-						tline.tokens.begin() + iDiff + 1,
-						{ ltoken.type, static_cast<SyntaxTokenLen>( token.pos + token.len ),
-						  static_cast<SyntaxTokenLen>( ( ltoken.pos + ltoken.len ) -
-													   ( token.pos + token.len ) ) } );
-				}
+void SyntaxHighlighter::setSemanticTokens( std::vector<Int32>&& data ) {
+	Lock l( mLinesMutex );
+	mSemanticTokens = std::move( data );
+	updateSemanticLines();
+}
 
-				lastTokenPos = i;
-				break;
-			}
+void SyntaxHighlighter::mergeSemanticTokens( std::vector<Int32>&& data, Int64 fromLine,
+											 Int64 toLine ) {
+	Lock l( mLinesMutex );
+	if ( data.size() % 5 != 0 ) {
+		Log::warning( "SyntaxHighlighter::mergeSemanticTokens bad semantic tokens data format" );
+		return;
+	}
+
+	if ( mSemanticTokens.empty() ) {
+		mSemanticTokens = std::move( data );
+		updateSemanticLines();
+		return;
+	}
+
+	Int64 dataLastLine = 0;
+	for ( size_t i = 0; i < data.size(); i += 5 )
+		dataLastLine += data[i];
+	if ( !data.empty() ) {
+		fromLine = eemin<Int64>( fromLine, data[0] );
+		toLine = eemax( toLine, dataLastLine );
+	}
+
+	// Only whole lines are replaced, so the tokens after each seam only need their line delta
+	// fixed, the start of the first token of a line is never relative to another token
+	size_t prefixEnd = mSemanticTokens.size();
+	size_t suffixStart = mSemanticTokens.size();
+	Int64 prefixLastLine = 0;
+	Int64 suffixFirstLine = 0;
+	Int64 currentLine = 0;
+	for ( size_t i = 0; i < mSemanticTokens.size(); i += 5 ) {
+		currentLine += mSemanticTokens[i];
+		if ( currentLine < fromLine ) {
+			prefixLastLine = currentLine;
+		} else if ( prefixEnd == mSemanticTokens.size() ) {
+			prefixEnd = i;
+		}
+		if ( currentLine > toLine ) {
+			suffixStart = i;
+			suffixFirstLine = currentLine;
+			break;
 		}
 	}
 
-	tline.signature = tokenization.signature;
+	std::vector<Int32> tokens;
+	tokens.reserve( prefixEnd + data.size() + ( mSemanticTokens.size() - suffixStart ) );
+	tokens.insert( tokens.end(), mSemanticTokens.begin(), mSemanticTokens.begin() + prefixEnd );
+	Int64 lastLine = prefixLastLine;
+	if ( !data.empty() ) {
+		size_t first = tokens.size();
+		tokens.insert( tokens.end(), data.begin(), data.end() );
+		tokens[first] = static_cast<Int32>( data[0] - lastLine );
+		lastLine = dataLastLine;
+	}
+	if ( suffixStart < mSemanticTokens.size() ) {
+		size_t first = tokens.size();
+		tokens.insert( tokens.end(), mSemanticTokens.begin() + suffixStart,
+					   mSemanticTokens.end() );
+		tokens[first] = static_cast<Int32>( suffixFirstLine - lastLine );
+	}
+	mSemanticTokens = std::move( tokens );
+	updateSemanticLines();
+}
+
+void SyntaxHighlighter::editSemanticTokens( const std::vector<SemanticTokensEdit>& edits ) {
 	Lock l( mLinesMutex );
-	mLines[line] = std::move( tline );
+	for ( const auto& edit : edits ) {
+		if ( edit.start > mSemanticTokens.size() )
+			continue;
+		// Overwrite the overlapping part and only move the tail once
+		size_t deleteCount =
+			eemin<size_t>( edit.deleteCount, mSemanticTokens.size() - edit.start );
+		size_t replaceCount = eemin<size_t>( deleteCount, edit.data.size() );
+		auto pos = mSemanticTokens.begin() + edit.start;
+		std::copy( edit.data.begin(), edit.data.begin() + replaceCount, pos );
+		if ( deleteCount > replaceCount ) {
+			mSemanticTokens.erase( pos + replaceCount, pos + deleteCount );
+		} else if ( edit.data.size() > replaceCount ) {
+			mSemanticTokens.insert( pos + replaceCount, edit.data.begin() + replaceCount,
+									edit.data.end() );
+		}
+	}
+	updateSemanticLines();
+}
+
+void SyntaxHighlighter::clearSemanticTokens() {
+	Lock l( mLinesMutex );
+	mSemanticTokens.clear();
+	mSemanticLines.clear();
+	mSemanticMergedLines.clear();
+}
+
+bool SyntaxHighlighter::hasSemanticTokens() {
+	Lock l( mLinesMutex );
+	return !mSemanticTokens.empty();
+}
+
+void SyntaxHighlighter::updateSemanticLines() {
+	mSemanticLines.clear();
+
+	if ( mSemanticTokens.size() % 5 != 0 ) {
+		Log::warning( "SyntaxHighlighter::updateSemanticLines bad semantic tokens data format" );
+		mSemanticTokens.clear();
+		return;
+	}
+
+	const Int64 linesCount = mDoc->linesCount();
+	Int64 currentLine = 0;
+	for ( size_t i = 0; i < mSemanticTokens.size(); i += 5 ) {
+		if ( mSemanticTokens[i] < 0 ) {
+			Log::warning( "SyntaxHighlighter::updateSemanticLines bad semantic tokens line delta" );
+			mSemanticTokens.clear();
+			mSemanticLines.clear();
+			return;
+		}
+		currentLine += mSemanticTokens[i];
+		if ( currentLine >= linesCount )
+			break;
+		if ( mSemanticLines.empty() || mSemanticLines.back().line != currentLine ) {
+			mSemanticLines.push_back( { currentLine, mDoc->line( currentLine ).getHash(),
+										static_cast<Uint32>( i / 5 ), 0, 0 } );
+		}
+		mSemanticLines.back().count++;
+	}
+
+	// The line delta of the first token is skipped since it depends on the previous line, the
+	// rest of the line tokens are relative to the line start
+	for ( auto& sline : mSemanticLines ) {
+		sline.signature = String::hash(
+			reinterpret_cast<const char*>( &mSemanticTokens[sline.offset * 5 + 1] ),
+			( sline.count * 5 - 1 ) * sizeof( Int32 ) );
+	}
+}
+
+const std::vector<SyntaxTokenPosition>&
+SyntaxHighlighter::resolveSemanticLine( const size_t& index, const TokenizedLine& line ) {
+	if ( mSemanticLines.empty() )
+		return line.tokens;
+
+	auto sline = std::lower_bound(
+		mSemanticLines.begin(), mSemanticLines.end(), static_cast<Int64>( index ),
+		[]( const SemanticLine& sline, Int64 line ) { return sline.line < line; } );
+
+	if ( sline == mSemanticLines.end() || sline->line != static_cast<Int64>( index ) ||
+		 sline->hash != line.hash )
+		return line.tokens;
+
+	auto& merged = mSemanticMergedLines[index];
+	if ( !merged.tokens.empty() && merged.syntaxSignature == line.signature &&
+		 merged.semanticSignature == sline->signature )
+		return merged.tokens;
+
+	std::vector<SyntaxTokenPosition> semanticTokens;
+	semanticTokens.reserve( sline->count );
+	SyntaxTokenLen start = 0;
+	for ( Uint32 i = 0; i < sline->count; i++ ) {
+		const Int32* token = &mSemanticTokens[( sline->offset + i ) * 5];
+		start = i == 0 ? token[1] : start + token[1];
+		const Int32 type = token[3];
+		semanticTokens.emplace_back( type >= 0 && type < (Int32)mSemanticTokenTypes.size()
+										 ? mSemanticTokenTypes[type]
+										 : SyntaxStyleTypes::Normal,
+									 start, static_cast<SyntaxTokenLen>( token[2] ) );
+	}
+
+	merged.tokens = line.tokens;
+	mergeTokens( merged.tokens, semanticTokens );
+	merged.syntaxSignature = line.signature;
+	merged.semanticSignature = sline->signature;
+	return merged.tokens;
 }
 
 }}} // namespace EE::UI::Doc
@@ -1372,6 +1372,154 @@ bool TextDocument::replaceCurrentLine( const String& text ) {
 	return replaceLine( getSelection().start().line(), text );
 }
 
+// Edit distance limit for the line diff. Past this point it's cheaper to replace the whole
+// differing block than to keep tracing the edit graph.
+static constexpr Int64 MAX_TEXT_DIFF_DISTANCE = 1024;
+
+struct TextDiffHunk {
+	Int64 oldStart;
+	Int64 oldEnd;
+	Int64 newStart;
+	Int64 newEnd;
+};
+
+// Myers O(ND) line diff over the old lines [oldStart, oldEnd) and the new lines
+// [newStart, newEnd). Returns false if the edit distance exceeds MAX_TEXT_DIFF_DISTANCE.
+template <typename LineEquals>
+static bool textLineDiff( Int64 oldStart, Int64 oldEnd, Int64 newStart, Int64 newEnd,
+						  const LineEquals& equals, std::vector<TextDiffHunk>& hunks ) {
+	const Int64 n = oldEnd - oldStart;
+	const Int64 m = newEnd - newStart;
+	const Int64 maxD = eemin<Int64>( n + m, MAX_TEXT_DIFF_DISTANCE );
+	const Int64 offset = maxD + 1;
+	std::vector<Int64> v( 2 * offset + 1, 0 );
+	// trace[d] holds the furthest reaching x for the diagonals [-d, d] before round d
+	std::vector<std::vector<Int64>> trace;
+	Int64 foundD = -1;
+
+	for ( Int64 d = 0; d <= maxD && foundD == -1; d++ ) {
+		trace.emplace_back( v.begin() + offset - d, v.begin() + offset + d + 1 );
+		for ( Int64 k = -d; k <= d; k += 2 ) {
+			Int64 x = ( k == -d || ( k != d && v[offset + k - 1] < v[offset + k + 1] ) )
+						  ? v[offset + k + 1]
+						  : v[offset + k - 1] + 1;
+			Int64 y = x - k;
+			while ( x < n && y < m && equals( oldStart + x, newStart + y ) ) {
+				x++;
+				y++;
+			}
+			v[offset + k] = x;
+			if ( x >= n && y >= m ) {
+				foundD = d;
+				break;
+			}
+		}
+	}
+
+	if ( foundD == -1 )
+		return false;
+
+	// Backtrack the edit graph, collecting the non-diagonal runs as hunks (in reverse order).
+	std::vector<TextDiffHunk> rhunks;
+	Int64 x = n;
+	Int64 y = m;
+	for ( Int64 d = foundD; d > 0; d-- ) {
+		const auto& pv = trace[d];
+		Int64 k = x - y;
+		Int64 prevK =
+			( k == -d || ( k != d && pv[d + k - 1] < pv[d + k + 1] ) ) ? k + 1 : k - 1;
+		Int64 prevX = pv[d + prevK];
+		Int64 prevY = prevX - prevK;
+		while ( x > prevX && y > prevY ) {
+			x--;
+			y--;
+		}
+		// ( prevX, prevY ) -> ( x, y ) is a single line insertion or deletion
+		if ( !rhunks.empty() && rhunks.back().oldStart == oldStart + x &&
+			 rhunks.back().newStart == newStart + y ) {
+			rhunks.back().oldStart = oldStart + prevX;
+			rhunks.back().newStart = newStart + prevY;
+		} else {
+			rhunks.push_back( { oldStart + prevX, oldStart + x, newStart + prevY, newStart + y } );
+		}
+		x = prevX;
+		y = prevY;
+	}
+
+	hunks.insert( hunks.end(), rhunks.rbegin(), rhunks.rend() );
+	return true;
+}
+
+// Edits are applied from bottom to top so line numbers of pending hunks never shift.
+void TextDocument::applyTextDiff( String text ) {
+	if ( text.find_first_of( '\r' ) != String::InvalidPos )
+		text.replaceAll( "\r", "" );
+
+	std::vector<String> newLines = text.split( '\n', true );
+	std::vector<String::HashType> newHashes;
+	newHashes.reserve( newLines.size() );
+	for ( auto& newText : newLines ) {
+		newText.append( '\n' );
+		newHashes.push_back( newText.getHash() );
+	}
+
+	const Int64 oldCount = linesCount();
+	const Int64 newCount = newLines.size();
+	std::vector<String::HashType> oldHashes;
+	oldHashes.reserve( oldCount );
+	for ( Int64 i = 0; i < oldCount; i++ )
+		oldHashes.push_back( line( i ).getHash() );
+
+	const auto equals = [&, this]( Int64 oldIndex, Int64 newIndex ) {
+		return oldHashes[oldIndex] == newHashes[newIndex] &&
+			   line( oldIndex ).getText() == newLines[newIndex];
+	};
+
+	Int64 prefix = 0;
+	while ( prefix < oldCount && prefix < newCount && equals( prefix, prefix ) )
+		prefix++;
+
+	Int64 suffix = 0;
+	while ( suffix < oldCount - prefix && suffix < newCount - prefix &&
+			equals( oldCount - 1 - suffix, newCount - 1 - suffix ) )
+		suffix++;
+
+	std::vector<TextDiffHunk> hunks;
+	if ( prefix == oldCount && prefix == newCount )
+		return;
+
+	if ( !textLineDiff( prefix, oldCount - suffix, prefix, newCount - suffix, equals, hunks ) ) {
+		hunks.push_back( { prefix, oldCount - suffix, prefix, newCount - suffix } );
+	}
+
+	for ( auto hunk = hunks.rbegin(); hunk != hunks.rend(); ++hunk ) {
+		String replacement;
+		for ( Int64 i = hunk->newStart; i < hunk->newEnd; i++ )
+			replacement += newLines[i];
+
+		TextPosition start( hunk->oldStart, 0 );
+		TextPosition end( hunk->oldEnd, 0 );
+
+		// The last document line carries an implicit new line that can't be edited, so hunks
+		// touching the end of the document are shifted one character back.
+		if ( hunk->oldEnd == oldCount ) {
+			if ( !replacement.empty() )
+				replacement.pop_back();
+			if ( hunk->oldStart > 0 ) {
+				start = endOfLine( { hunk->oldStart - 1, 0 } );
+				if ( hunk->newEnd > hunk->newStart )
+					replacement = "\n" + replacement;
+			}
+			end = endOfDoc();
+		}
+
+		if ( start != end )
+			remove( 0, { start, end } );
+		if ( !replacement.empty() )
+			insert( 0, start, replacement );
+	}
+}
+
 TextPosition TextDocument::nextChar( TextPosition position ) const {
 	return positionOffset( position, TextPosition( 0, 1 ) );
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <eepp/scene/scenemanager.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/sys.hpp>
@@ -5,20 +6,100 @@
 #include <eepp/ui/models/filesystemmodel.hpp>
 #include <eepp/ui/uiiconthememanager.hpp>
 #include <eepp/ui/uiscenenode.hpp>
+#include <eepp/window/engine.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifndef INDEX_ALREADY_EXISTS
 #define INDEX_ALREADY_EXISTS eeINDEX_NOT_FOUND
 #endif
 
 using namespace EE::Scene;
+using namespace EE::Window;
 
 namespace EE { namespace UI { namespace Models {
 
+namespace {
+
+// Directory listings shared by all the models, so a directory read by another model ( or read
+// again after being collapsed ) doesn't stat all its files again. A listing is only reused while
+// the directory modification time is the same, and only for a few seconds, since modifying a file
+// doesn't change the directory modification time.
+class StatCache {
+  public:
+	static constexpr size_t MaxDirectories = 64;
+	static constexpr Uint64 MaxAge = 5000; // milliseconds
+
+	static StatCache& instance() {
+		static StatCache cache;
+		return cache;
+	}
+
+	std::vector<FileInfo> getFiles( std::string path, bool sortByName, bool foldersFirst,
+									bool ignoreHidden ) {
+		FileSystem::dirAddSlashAtEnd( path );
+		Uint8 flags = ( sortByName ? 1 : 0 ) | ( foldersFirst ? 2 : 0 ) | ( ignoreHidden ? 4 : 0 );
+		// FileInfo removes the trailing slash, stat fails with it on some platforms
+		Uint64 modificationTime = FileInfo( path ).getModificationTime();
+		Uint64 now = Sys::getTicks();
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			auto it = mEntries.find( path );
+			if ( it != mEntries.end() && it->second.flags == flags &&
+				 it->second.modificationTime == modificationTime && now - it->second.time < MaxAge )
+				return it->second.files;
+		}
+
+		auto files =
+			FileSystem::filesInfoGetInPath( path, false, sortByName, foldersFirst, ignoreHidden );
+
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		if ( mEntries.size() >= MaxDirectories && mEntries.find( path ) == mEntries.end() ) {
+			mEntries.erase( std::min_element( mEntries.begin(), mEntries.end(),
+											  []( const auto& a, const auto& b ) {
+												  return a.second.time < b.second.time;
+											  } ) );
+		}
+
+		mEntries[path] = { flags, modificationTime, now, files };
+
+		return files;
+	}
+
+	void invalidate( std::string path ) {
+		FileSystem::dirAddSlashAtEnd( path );
+		std::lock_guard<std::mutex> lock( mMutex );
+		mEntries.erase( path );
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> lock( mMutex );
+		mEntries.clear();
+	}
+
+  protected:
+	struct Entry {
+		Uint8 flags;
+		Uint64 modificationTime;
+		Uint64 time;
+		std::vector<FileInfo> files;
+	};
+
+	std::mutex mMutex;
+	std::unordered_map<std::string, Entry> mEntries;
+};
+
+} // namespace
+
 FileSystemModel::Node::Node( const std::string& rootPath, const FileSystemModel& model ) :
 	mInfo( FileSystem::getRealPath( rootPath ) ) {
 	mInfoDirty = false;
 	mName = FileSystem::fileNameFromPath( mInfo.getFilepath() );
 	mMimeType = "";
+	mMimeTypeResolved = true;
 	mHash = String::hash( mName );
 	mDisplayName = mName;
 	traverseIfNeeded( model );
@@ -30,7 +111,6 @@ FileSystemModel::Node::Node( FileInfo&& info, FileSystemModel::Node* parent ) :
 	mName = FileSystem::fileNameFromPath( mInfo.getFilepath() );
 	mHash = String::hash( mName );
 	mDisplayName = mName;
-	updateMimeType();
 }
 
 const std::string& FileSystemModel::Node::fullPath() const {
@@ -96,6 +176,7 @@ Int64 FileSystemModel::Node::findChildRowFromName( const std::string& name,
 }
 
 FileSystemModel::Node::~Node() {
+	cancelLoad();
 	cleanChildren();
 }
 
@@ -124,7 +205,7 @@ void FileSystemModel::Node::rename( const FileInfo& file ) {
 	mName = file.getFileName();
 	mHash = String::hash( mName );
 	mDisplayName = mName;
-	updateMimeType();
+	mMimeTypeResolved = false;
 }
 
 ModelIndex FileSystemModel::Node::index( const FileSystemModel& model, int column ) const {
@@ -158,15 +239,19 @@ static bool isAcceptedExtension( const std::vector<std::string>& acceptedExtensi
 }
 
 void FileSystemModel::Node::refresh( const FileSystemModel& model ) {
-	if ( !mInfo.isDirectory() )
+	// A node being loaded is already up to date
+	if ( !mInfo.isDirectory() || mLoading )
 		return;
 
 	auto oldFiles = mChildren;
 
 	const auto& displayCfg = model.getDisplayConfig();
 
-	auto files = FileSystem::filesInfoGetInPath( mInfo.getFilepath(), false, displayCfg.sortByName,
-												 displayCfg.foldersFirst, displayCfg.ignoreHidden );
+	StatCache::instance().invalidate( mInfo.getFilepath() );
+
+	auto files =
+		StatCache::instance().getFiles( mInfo.getFilepath(), displayCfg.sortByName,
+										displayCfg.foldersFirst, displayCfg.ignoreHidden );
 
 	std::vector<Node*> newChildren;
 	Node* node = nullptr;
@@ -210,46 +295,28 @@ void FileSystemModel::Node::traverseIfNeeded( const FileSystemModel& model ) {
 	if ( !mInfo.isDirectory() || mHasTraversed )
 		return;
 	mHasTraversed = true;
+	cancelLoad();
 	cleanChildren();
 
+	if ( model.loadChildrenAsync( this ) )
+		return;
+
 	const auto& displayCfg = model.getDisplayConfig();
 
-	auto files = FileSystem::filesInfoGetInPath( mInfo.getFilepath(), false, displayCfg.sortByName,
-												 displayCfg.foldersFirst, displayCfg.ignoreHidden );
+	auto files =
+		StatCache::instance().getFiles( mInfo.getFilepath(), displayCfg.sortByName,
+										displayCfg.foldersFirst, displayCfg.ignoreHidden );
 
-	const auto& patterns = displayCfg.acceptedExtensions;
-	bool accepted;
-	for ( auto file : files ) {
-		if ( ( model.getMode() == Mode::DirectoriesOnly &&
-			   ( file.isDirectory() || file.linksToDirectory() ) ) ||
-			 model.getMode() == Mode::FilesAndDirectories ) {
-			if ( file.isDirectory() || file.linksToDirectory() || patterns.empty() ) {
-				if ( displayCfg.fileIsVisibleFn &&
-					 !displayCfg.fileIsVisibleFn( file.getFilepath() ) )
-					continue;
-				mChildren.emplace_back( eeNew( Node, ( std::move( file ), this ) ) );
-			} else {
-				accepted = false;
-				if ( patterns.size() ) {
-					for ( size_t z = 0; z < patterns.size(); z++ ) {
-						if ( patterns[z] == FileSystem::fileExtension( file.getFilepath() ) ) {
-							accepted = true;
-							break;
-						}
-					}
-				} else {
-					if ( displayCfg.fileIsVisibleFn ) {
-						if ( displayCfg.fileIsVisibleFn( file.getFilepath() ) )
-							accepted = true;
-					} else {
-						accepted = true;
-					}
-				}
+	for ( auto& file : files ) {
+		if ( model.isFileVisible( file ) )
+			mChildren.emplace_back( eeNew( Node, ( std::move( file ), this ) ) );
+	}
+}
 
-				if ( accepted )
-					mChildren.emplace_back( eeNew( Node, ( std::move( file ), this ) ) );
-			}
-		}
+void FileSystemModel::Node::cancelLoad() {
+	if ( mLoading ) {
+		*mLoading = nullptr;
+		mLoading.reset();
 	}
 }
 
@@ -270,36 +337,205 @@ bool FileSystemModel::Node::fetchData( const String& fullPath ) {
 	return true;
 }
 
-void FileSystemModel::Node::updateMimeType() {
-	if ( !mInfo.isDirectory() ) {
-		mMimeType = UIIconThemeManager::getIconNameFromFileName( mName );
-	} else {
-		mMimeType = "folder";
+const std::string& FileSystemModel::Node::getMimeType() const {
+	if ( !mMimeTypeResolved ) {
+		mMimeType = !mInfo.isDirectory() ? UIIconThemeManager::getIconNameFromFileName( mName )
+										 : "folder";
+		mMimeTypeResolved = true;
 	}
+	return mMimeType;
 }
 
 std::shared_ptr<FileSystemModel> FileSystemModel::New( const std::string& rootPath,
 													   const FileSystemModel::Mode& mode,
 													   const DisplayConfig& displayConfig,
-													   Translator* translator ) {
+													   Translator* translator, bool asyncLoading ) {
 	return std::shared_ptr<FileSystemModel>(
-		new FileSystemModel( rootPath, mode, displayConfig, translator ) );
+		new FileSystemModel( rootPath, mode, displayConfig, translator, asyncLoading ) );
+}
+
+void FileSystemModel::clearStatCache() {
+	StatCache::instance().clear();
 }
 
 FileSystemModel::FileSystemModel( const std::string& rootPath, const FileSystemModel::Mode& mode,
-								  const DisplayConfig& displayConfig, Translator* translator ) :
+								  const DisplayConfig& displayConfig, Translator* translator,
+								  bool asyncLoading ) :
 	mRootPath( rootPath ),
 	mRealRootPath( FileSystem::getRealPath( rootPath ) ),
 	mMode( mode ),
-	mDisplayConfig( displayConfig ) {
+	mDisplayConfig( displayConfig ),
+	mAsyncLoading( asyncLoading ) {
+	// The placeholder text must be ready before the root is loaded
+	setupColumnNames( translator );
 	mRoot = std::make_unique<Node>( mRootPath, *this );
 	mInitOK = true;
-	setupColumnNames( translator );
 	invalidate();
 }
 
 FileSystemModel::~FileSystemModel() {
 	mInitOK = false;
+	mLoadToken.cancel();
+}
+
+bool FileSystemModel::isFileVisible( const FileInfo& file ) const {
+	const auto& displayCfg = getDisplayConfig();
+	bool isDirectory = file.isDirectory() || file.linksToDirectory();
+
+	if ( getMode() == Mode::DirectoriesOnly && !isDirectory )
+		return false;
+
+	const auto& patterns = displayCfg.acceptedExtensions;
+
+	if ( isDirectory || patterns.empty() )
+		return !displayCfg.fileIsVisibleFn || displayCfg.fileIsVisibleFn( file.getFilepath() );
+
+	return std::find( patterns.begin(), patterns.end(),
+					  FileSystem::fileExtension( file.getFilepath() ) ) != patterns.end();
+}
+
+bool FileSystemModel::loadChildrenAsync( Node* node ) const {
+	if ( !mAsyncLoading || !Engine::instance()->isMainThread() )
+		return false;
+
+	UISceneNode* scene = SceneManager::instance()->getUISceneNode();
+
+	if ( nullptr == scene || !scene->hasThreadPool() )
+		return false;
+
+	node->mLoading = std::make_shared<Node*>( node );
+
+	Node* placeholder = eeNew( Node, () );
+	placeholder->mParent = node;
+	placeholder->mPlaceholder = true;
+	placeholder->mHasTraversed = true;
+	placeholder->mInfoDirty = false;
+	placeholder->mMimeTypeResolved = true;
+	placeholder->mDisplayName = mLoadingText;
+	node->mChildren.emplace_back( placeholder );
+
+	// Only the directory listing runs in the pool, the model is only modified from the main
+	// thread and the visibility of the files is checked there too
+	FileSystemModel* model = const_cast<FileSystemModel*>( this );
+	std::shared_ptr<Node*> loading( node->mLoading );
+	std::string path( node->fullPath() );
+	CancellationToken token( mLoadToken );
+	bool sortByName = mDisplayConfig.sortByName;
+	bool foldersFirst = mDisplayConfig.foldersFirst;
+	bool ignoreHidden = mDisplayConfig.ignoreHidden;
+
+	scene->getThreadPool()->run( [scene, model, loading, path, token, sortByName, foldersFirst,
+								  ignoreHidden] {
+		if ( token.isCancelled() )
+			return;
+
+		auto files = std::make_shared<std::vector<FileInfo>>(
+			StatCache::instance().getFiles( path, sortByName, foldersFirst, ignoreHidden ) );
+
+		postLoadedChildren( model, scene, loading, token, files, 0, LoadChunkSize );
+	} );
+
+	return true;
+}
+
+void FileSystemModel::postLoadedChildren( FileSystemModel* model, UISceneNode* scene,
+										  const std::shared_ptr<Node*>& loading,
+										  const CancellationToken& token,
+										  const std::shared_ptr<std::vector<FileInfo>>& files,
+										  size_t from, size_t chunkSize ) {
+	// Each chunk posts the next one once it's inserted, so the main thread keeps handling events
+	// and drawing between them. The first chunk is small so the first files are displayed soon,
+	// the next ones grow so a huge directory only takes a few model updates.
+	scene->runOnMainThread( [model, scene, loading, token, files, from, chunkSize] {
+		if ( token.isCancelled() )
+			return;
+
+		size_t to = eemin( from + chunkSize, files->size() );
+
+		if ( model->insertLoadedChildren( loading, *files, from, to ) )
+			postLoadedChildren( model, scene, loading, token, files, to, chunkSize * 2 );
+	} );
+}
+
+bool FileSystemModel::insertLoadedChildren( const std::shared_ptr<Node*>& loading,
+											const std::vector<FileInfo>& files, size_t from,
+											size_t to ) {
+	bool last;
+
+	{
+		Lock l( resourceMutex() );
+
+		Node* node = *loading;
+
+		// The node was destroyed or it's being loaded again
+		if ( nullptr == node || node->mLoading != loading )
+			return false;
+
+		last = to == files.size();
+		ModelIndex parent = node->index( *this, 0 );
+		std::vector<Node*> children;
+
+		for ( size_t i = from; i < to; ++i ) {
+			if ( isFileVisible( files[i] ) )
+				children.emplace_back( eeNew( Node, ( FileInfo( files[i] ), node ) ) );
+		}
+
+		if ( !node->mChildren.empty() && node->mChildren.front()->mPlaceholder &&
+			 ( !children.empty() || last ) ) {
+			Node* placeholder = node->mChildren.front();
+
+			forEachView( [placeholder]( UIAbstractView* view ) {
+				view->getSelection().removeAllMatching( [placeholder]( auto& selectionIndex ) {
+					return selectionIndex.internalData() == placeholder;
+				} );
+			} );
+
+			if ( beginDeleteRows( parent, 0, 0 ) ) {
+				node->mChildren.erase( node->mChildren.begin() );
+				eeDelete( placeholder );
+				endDeleteRows();
+			}
+		}
+
+		if ( !children.empty() ) {
+			int first = static_cast<int>( node->mChildren.size() );
+			beginInsertRows( parent, first, first + static_cast<int>( children.size() ) - 1 );
+			node->mChildren.insert( node->mChildren.end(), children.begin(), children.end() );
+			endInsertRows();
+		}
+
+		if ( last )
+			node->mLoading.reset();
+	}
+
+	invalidate( UpdateFlag::DontInvalidateIndexes );
+
+	return !last;
+}
+
+void FileSystemModel::finishLoading( Node* node ) {
+	if ( !node->isLoading() )
+		return;
+
+	std::unordered_set<std::string> loaded;
+	for ( Node* child : node->mChildren ) {
+		if ( !child->isPlaceholder() )
+			loaded.insert( child->getName() );
+	}
+
+	// The listing was probably just cached by the background load
+	const auto& displayCfg = getDisplayConfig();
+	std::vector<FileInfo> files;
+	for ( auto& file :
+		  StatCache::instance().getFiles( node->fullPath(), displayCfg.sortByName,
+										  displayCfg.foldersFirst, displayCfg.ignoreHidden ) ) {
+		if ( loaded.find( FileSystem::fileNameFromPath( file.getFilepath() ) ) == loaded.end() )
+			files.emplace_back( std::move( file ) );
+	}
+
+	// Inserting the last chunk ends the load, the chunks still queued are dropped
+	std::shared_ptr<Node*> loading( node->mLoading );
+	insertLoadedChildren( loading, files, 0, files.size() );
 }
 
 const std::string& FileSystemModel::getRootPath() const {
@@ -333,11 +569,18 @@ FileSystemModel::Node* FileSystemModel::getNodeFromPath( std::string path, bool
 	if ( !folders.empty() ) {
 		for ( size_t i = 0; i < folders.size(); i++ ) {
 			auto& part = folders[i];
-			if ( ( foundNode = curNode->findChildName( part, *this, invalidateTree ) ) ) {
-				curNode = foundNode;
-			} else {
-				return nullptr;
+			foundNode = curNode->findChildName( part, *this, invalidateTree );
+
+			// An explicit lookup can't wait for a directory being loaded in background
+			if ( !foundNode && invalidateTree && curNode->isLoading() ) {
+				finishLoading( curNode );
+				foundNode = curNode->findChildName( part, *this, false );
 			}
+
+			if ( !foundNode )
+				return nullptr;
+
+			curNode = foundNode;
 		}
 	}
 
@@ -414,6 +657,12 @@ Variant FileSystemModel::data( const ModelIndex& index, ModelRole role ) const {
 
 	auto& node = this->nodeRef( index );
 
+	// The placeholder only displays its name
+	if ( node.isPlaceholder() &&
+		 !( index.column() == Column::Name &&
+			( role == ModelRole::Display || role == ModelRole::Sort ) ) )
+		return {};
+
 	switch ( role ) {
 		case ModelRole::Custom: {
 			return Variant( node.info().getFilepath().c_str() );
@@ -505,6 +754,8 @@ ModelIndex FileSystemModel::index( int row, int column, const ModelIndex& parent
 }
 
 UIIcon* FileSystemModel::iconFor( const Node& node, const ModelIndex& index ) const {
+	if ( node.isPlaceholder() )
+		return nullptr;
 	if ( index.column() == (Int64)treeColumn() || Column::Icon == index.column() ) {
 		auto* scene = SceneManager::instance()->getUISceneNode();
 		auto* d = scene->findIcon( node.getMimeType() );
@@ -607,6 +858,10 @@ bool FileSystemModel::handleFileEventLocked( const FileEvent& event ) {
 			if ( !parent )
 				return false;
 
+			// The directory listing being loaded provides the files of a loading directory
+			if ( parent->isLoading() )
+				return false;
+
 			auto* childNodeExists =
 				getNodeFromPath( file.getFilepath(), file.isDirectory(), false );
 			if ( childNodeExists )
@@ -826,6 +1081,8 @@ void FileSystemModel::setupColumnNames( Translator* translator ) {
 	mColumnNames[Column::Inode] = i18n( "inode", "Inode" );
 	mColumnNames[Column::Path] = i18n( "path", "Path" );
 	mColumnNames[Column::SymlinkTarget] = i18n( "symlink_target", "Symlink target" );
+	mLoadingText = translator ? translator->getString( "filesystemmodel_loading", "Loading..." )
+							  : "Loading...";
 }
 
 bool FileSystemModel::handleFileEvent( const FileEvent& event ) {
@@ -834,6 +1091,8 @@ bool FileSystemModel::handleFileEvent( const FileEvent& event ) {
 
 	bool ret;
 
+	StatCache::instance().invalidate( event.directory );
+
 	{
 		Lock l( resourceMutex() );
 
@@ -3,11 +3,77 @@
 #include <eepp/ui/models/modelselection.hpp>
 #include <eepp/ui/models/sortingproxymodel.hpp>
 #include <eepp/ui/models/variant.hpp>
+#include <iterator>
+#include <numeric>
 
 using namespace EE::UI::Abstract;
 
 namespace EE { namespace UI { namespace Models {
 
+namespace {
+
+template <typename Key> int compareSortKeys( const Key& key1, const Key& key2 ) {
+	// Rows of different kinds are grouped: empty values first, then numbers and then texts
+	if ( key1.kind != key2.kind )
+		return key1.kind < key2.kind ? -1 : 1;
+
+	if ( Key::Number == key1.kind )
+		return key1.number < key2.number ? -1 : ( key2.number < key1.number ? 1 : 0 );
+
+	return key1.text.compare( key2.text );
+}
+
+// Equal keys keep the source order, so the order is total and it doesn't depend on the previous
+// order of the rows
+template <typename Keys> auto rowComparator( const Keys& keys, bool descending ) {
+	return [&keys, descending]( int row1, int row2 ) {
+		int res = compareSortKeys( keys[row1], keys[row2] );
+		if ( 0 == res )
+			return row1 < row2;
+		return descending ? res > 0 : res < 0;
+	};
+}
+
+template <typename Less>
+void parallelSort( ThreadPool* pool, std::vector<int>& rows, const Less& less ) {
+	size_t chunks = 1;
+
+	if ( NULL != pool && rows.size() >= SortingProxyModel::ParallelSortThreshold ) {
+		chunks = eemin<size_t>( pool->numThreads() + 1,
+								rows.size() / ( SortingProxyModel::ParallelSortThreshold / 4 ) );
+	}
+
+	if ( chunks < 2 ) {
+		std::sort( rows.begin(), rows.end(), less );
+		return;
+	}
+
+	std::vector<size_t> bounds( chunks + 1 );
+	for ( size_t i = 0; i <= chunks; ++i )
+		bounds[i] = rows.size() * i / chunks;
+
+	auto at = [&rows, &bounds]( size_t chunk ) { return rows.begin() + bounds[chunk]; };
+
+	pool->parallelFor<size_t>(
+		0, chunks, [&]( size_t chunk ) { std::sort( at( chunk ), at( chunk + 1 ), less ); }, 1 );
+
+	// Merge the sorted chunks in pairs, doubling the width of the merged runs on each pass
+	for ( size_t width = 1; width < chunks; width *= 2 ) {
+		pool->parallelFor<size_t>(
+			0, ( chunks + 2 * width - 1 ) / ( 2 * width ),
+			[&]( size_t pair ) {
+				size_t first = pair * 2 * width;
+				size_t middle = eemin( first + width, chunks );
+				size_t last = eemin( first + 2 * width, chunks );
+				if ( middle < last )
+					std::inplace_merge( at( first ), at( middle ), at( last ), less );
+			},
+			1 );
+	}
+}
+
+} // namespace
+
 SortingProxyModel::SortingProxyModel( std::shared_ptr<Model> target ) :
 	mSource( target ), mKeyColumn( -1 ) {
 	mSource->registerClient( this );
@@ -32,9 +98,112 @@ void SortingProxyModel::invalidate( unsigned int flags ) {
 }
 
 void SortingProxyModel::onModelUpdated( unsigned flags ) {
+	// Any other source update can change the sorted data, but the keys of the mappings patched by
+	// the rows insertion or deletion that notified this update are still valid
+	for ( auto& it : mMappings ) {
+		if ( !it.second->keysPatched )
+			it.second->keysColumn = -1;
+
+		it.second->keysPatched = false;
+	}
+
 	invalidate( flags );
 }
 
+void SortingProxyModel::modelDidInsertRows( const ModelIndex& parent, int first, int last ) {
+	auto it = mMappings.find( parent );
+	if ( it == mMappings.end() )
+		return;
+
+	auto& mapping = *it->second;
+	mapping.keysPatched = true;
+	int count = last - first + 1;
+	std::vector<int> oldSourceRows( mapping.sourceRows );
+
+	if ( first < 0 || count <= 0 || first > static_cast<int>( oldSourceRows.size() ) ||
+		 source().rowCount( parent ) != oldSourceRows.size() + static_cast<size_t>( count ) ) {
+		mapping.keysColumn = -1;
+		sortMapping( mapping, mKeyColumn, mSortOrder );
+		return;
+	}
+
+	auto sourceRowMap = [first, count]( int row ) { return row >= first ? row + count : row; };
+
+	for ( auto& row : mapping.sourceRows )
+		row = sourceRowMap( row );
+
+	if ( mKeyColumn == -1 ) {
+		mapping.sourceRows.resize( oldSourceRows.size() + count );
+		std::iota( mapping.sourceRows.begin(), mapping.sourceRows.end(), 0 );
+	} else {
+		if ( mapping.keysColumn == mKeyColumn && mapping.keys.size() == oldSourceRows.size() ) {
+			// Only the inserted rows are fetched, the rest of the keys are still valid
+			std::vector<SortKey> keys( count );
+			for ( int i = 0; i < count; ++i ) {
+				keys[i] = makeSortKey( mSource->data(
+					mSource->index( first + i, mKeyColumn, mapping.sourceParent ), mSortRole ) );
+			}
+			mapping.keys.insert( mapping.keys.begin() + first,
+								 std::make_move_iterator( keys.begin() ),
+								 std::make_move_iterator( keys.end() ) );
+		} else {
+			updateSortKeys( mapping, mKeyColumn );
+		}
+
+		auto less = rowComparator( mapping.keys, SortOrder::Descending == mSortOrder );
+
+		for ( int row = first; row <= last; ++row ) {
+			mapping.sourceRows.insert(
+				std::upper_bound( mapping.sourceRows.begin(), mapping.sourceRows.end(), row, less ),
+				row );
+		}
+	}
+
+	updateProxyRows( mapping );
+	remapSelection( mapping, oldSourceRows, sourceRowMap );
+}
+
+void SortingProxyModel::modelDidDeleteRows( const ModelIndex& parent, int first, int last ) {
+	auto it = mMappings.find( parent );
+	if ( it == mMappings.end() )
+		return;
+
+	auto& mapping = *it->second;
+	mapping.keysPatched = true;
+	int count = last - first + 1;
+	std::vector<int> oldSourceRows( mapping.sourceRows );
+
+	if ( first < 0 || count <= 0 || last >= static_cast<int>( oldSourceRows.size() ) ||
+		 source().rowCount( parent ) + static_cast<size_t>( count ) != oldSourceRows.size() ) {
+		mapping.keysColumn = -1;
+		sortMapping( mapping, mKeyColumn, mSortOrder );
+		return;
+	}
+
+	auto sourceRowMap = [first, last, count]( int row ) {
+		return row < first ? row : ( row > last ? row - count : -1 );
+	};
+
+	// Removing rows doesn't change the order of the remaining ones
+	mapping.sourceRows.erase( std::remove_if( mapping.sourceRows.begin(), mapping.sourceRows.end(),
+											  [first, last]( int row ) {
+												  return row >= first && row <= last;
+											  } ),
+							  mapping.sourceRows.end() );
+
+	for ( auto& row : mapping.sourceRows )
+		row = sourceRowMap( row );
+
+	if ( mapping.keysColumn != -1 && mapping.keys.size() == oldSourceRows.size() ) {
+		mapping.keys.erase( mapping.keys.begin() + first, mapping.keys.begin() + last + 1 );
+	} else {
+		mapping.keysColumn = -1;
+	}
+
+	updateProxyRows( mapping );
+	remapSelection( mapping, oldSourceRows, sourceRowMap );
+}
+
 Model& SortingProxyModel::source() {
 	return *mSource;
 }
@@ -83,10 +252,6 @@ SortingProxyModel::buildMapping( const ModelIndex& sourceParent ) {
 
 	mapping->sourceParent = sourceParent;
 
-	int rowCount = source().rowCount( sourceParent );
-	mapping->sourceRows.resize( rowCount );
-	mapping->proxyRows.resize( rowCount );
-
 	sortMapping( *mapping, mKeyColumn, mSortOrder );
 
 	if ( sourceParent.isValid() ) {
@@ -124,7 +289,10 @@ ModelRole SortingProxyModel::sortRole() const {
 }
 
 void SortingProxyModel::setSortRrole( ModelRole role ) {
-	mSortRole = role;
+	if ( mSortRole != role ) {
+		mSortRole = role;
+		invalidateSortKeys();
+	}
 }
 
 std::string SortingProxyModel::columnName( const size_t& column ) const {
@@ -195,7 +363,10 @@ void SortingProxyModel::sort( const size_t& column, const SortOrder& sortOrder )
 }
 
 void SortingProxyModel::setSortingCaseSensitive( bool b ) {
-	mSortingCaseSensitive = b;
+	if ( mSortingCaseSensitive != b ) {
+		mSortingCaseSensitive = b;
+		invalidateSortKeys();
+	}
 }
 
 bool SortingProxyModel::isSortingCaseSensitive() {
@@ -214,76 +385,155 @@ bool SortingProxyModel::isColumnSortable( const size_t& columnIndex ) const {
 	return source().isColumnSortable( columnIndex );
 }
 
-bool SortingProxyModel::lessThan( const ModelIndex& index1, const ModelIndex& index2 ) const {
-	auto data1 = mSource->data( index1, mSortRole );
-	auto data2 = mSource->data( index2, mSortRole );
-	if ( data1.isString() && data2.isString() ) {
-		if ( data1.is( Variant::Type::StdString ) && data2.is( Variant::Type::StdString ) )
-			return String::toLower( data1.asStdString() ) < String::toLower( data2.asStdString() );
-		if ( data1.is( Variant::Type::String ) && data2.is( Variant::Type::String ) )
-			return String::toLower( data1.asString() ) < String::toLower( data2.asString() );
-		if ( data1.is( Variant::Type::cstr ) && data2.is( Variant::Type::cstr ) )
-			return String::toLower( std::string( data1.asCStr() ) ) <
-				   String::toLower( std::string( data2.asCStr() ) );
+std::shared_ptr<ThreadPool> SortingProxyModel::getThreadPool() const {
+	return mThreadPool;
+}
+
+void SortingProxyModel::setThreadPool( const std::shared_ptr<ThreadPool>& threadPool ) {
+	mThreadPool = threadPool;
+}
+
+SortingProxyModel::SortKey SortingProxyModel::makeSortKey( const Variant& data ) const {
+	SortKey key;
+
+	if ( !data.isValid() )
+		return key;
+
+	if ( data.is( Variant::Type::Bool ) || data.is( Variant::Type::Int ) ||
+		 data.is( Variant::Type::Uint ) || data.is( Variant::Type::Int64 ) ||
+		 data.is( Variant::Type::Uint64 ) || data.is( Variant::Type::Float ) ) {
+		key.kind = SortKey::Number;
+
+		if ( data.is( Variant::Type::Bool ) )
+			key.number = data.asBool() ? 1 : 0;
+		else if ( data.is( Variant::Type::Int ) )
+			key.number = data.asInt();
+		else if ( data.is( Variant::Type::Uint ) )
+			key.number = data.asUint();
+		else if ( data.is( Variant::Type::Int64 ) )
+			key.number = static_cast<double>( data.asInt64() );
+		else if ( data.is( Variant::Type::Uint64 ) )
+			key.number = static_cast<double>( data.asUint64() );
+		else
+			key.number = data.asFloat();
+
+		return key;
 	}
-	return data1 < data2;
+
+	// The texts are compared as UTF-8, which keeps the order of the codepoints
+	key.kind = SortKey::Text;
+
+	if ( data.is( Variant::Type::String ) || data.is( Variant::Type::StringPtr ) ) {
+		const String& string =
+			data.is( Variant::Type::String ) ? data.asString() : data.asStringPtr();
+		key.text = mSortingCaseSensitive ? string.toUtf8() : String::toLower( string ).toUtf8();
+	} else {
+		key.text = data.is( Variant::Type::cstr ) ? std::string( data.asCStr() ) : data.toString();
+
+		if ( !mSortingCaseSensitive && data.isString() )
+			String::toLowerInPlace( key.text );
+	}
+
+	return key;
+}
+
+void SortingProxyModel::updateSortKeys( Mapping& mapping, int column ) {
+	size_t rowCount = source().rowCount( mapping.sourceParent );
+
+	if ( mapping.keysColumn == column && mapping.keys.size() == rowCount )
+		return;
+
+	mapping.keys.resize( rowCount );
+
+	for ( size_t row = 0; row < rowCount; ++row ) {
+		mapping.keys[row] = makeSortKey(
+			mSource->data( mSource->index( row, column, mapping.sourceParent ), mSortRole ) );
+	}
+
+	mapping.keysColumn = column;
+}
+
+void SortingProxyModel::invalidateSortKeys() {
+	for ( auto& it : mMappings )
+		it.second->keysColumn = -1;
+}
+
+void SortingProxyModel::updateProxyRows( Mapping& mapping ) {
+	mapping.proxyRows.resize( mapping.sourceRows.size() );
+
+	for ( size_t i = 0; i < mapping.sourceRows.size(); ++i )
+		mapping.proxyRows[mapping.sourceRows[i]] = i;
+}
+
+bool SortingProxyModel::lessThan( const ModelIndex& index1, const ModelIndex& index2 ) const {
+	return compareSortKeys( makeSortKey( mSource->data( index1, mSortRole ) ),
+							makeSortKey( mSource->data( index2, mSortRole ) ) ) < 0;
 }
 
 void SortingProxyModel::sortMapping( SortingProxyModel::Mapping& mapping, int column,
 									 SortOrder sortOrder ) {
+	std::vector<int> oldSourceRows( mapping.sourceRows );
+	size_t rowCount = source().rowCount( mapping.sourceParent );
+
+	mapping.sourceRows.resize( rowCount );
+
 	if ( column == -1 ) {
-		int rowCount = source().rowCount( mapping.sourceParent );
-		for ( int i = 0; i < rowCount; ++i ) {
-			mapping.sourceRows[i] = i;
-			mapping.proxyRows[i] = i;
-		}
+		std::iota( mapping.sourceRows.begin(), mapping.sourceRows.end(), 0 );
+		updateProxyRows( mapping );
 		return;
 	}
 
-	auto oldSourceRows = mapping.sourceRows;
+	// The data is fetched only once per row, and only when it could have changed
+	updateSortKeys( mapping, column );
 
-	int rowCount = source().rowCount( mapping.sourceParent );
-	for ( int i = 0; i < rowCount; ++i )
-		mapping.sourceRows[i] = i;
+	auto less = rowComparator( mapping.keys, SortOrder::Descending == sortOrder );
 
-	std::stable_sort(
-		mapping.sourceRows.begin(), mapping.sourceRows.end(), [&]( auto row1, auto row2 ) -> bool {
-			bool isLessThan =
-				this->lessThan( mSource->index( row1, column, mapping.sourceParent ),
-								mSource->index( row2, column, mapping.sourceParent ) );
-			return sortOrder == SortOrder::Ascending ? isLessThan : !isLessThan;
-		} );
+	// An update that didn't change the order, or that was already applied incrementally, only
+	// needs to check it
+	if ( oldSourceRows.size() == rowCount &&
+		 std::is_sorted( oldSourceRows.begin(), oldSourceRows.end(), less ) )
+		return;
 
-	for ( int i = 0; i < rowCount; ++i )
-		mapping.proxyRows[mapping.sourceRows[i]] = i;
+	std::iota( mapping.sourceRows.begin(), mapping.sourceRows.end(), 0 );
+
+	parallelSort( mThreadPool.get(), mapping.sourceRows, less );
+
+	updateProxyRows( mapping );
+
+	remapSelection( mapping, oldSourceRows );
+}
 
+void SortingProxyModel::remapSelection( const Mapping& mapping,
+										const std::vector<int>& oldSourceRows,
+										const std::function<int( int )>& sourceRowMap ) {
 	// FIXME: I really feel like this should be done at the view layer somehow.
 	forEachView( [&]( UIAbstractView* view ) {
 		// Update the view's selection.
 		view->getSelection().changeFromModel( [&]( ModelSelection& selection ) {
-			std::vector<ModelIndex> selectedIndexesInSource;
+			std::vector<ModelIndex> newIndexes;
 			std::vector<ModelIndex> staleIndexesInSelection;
 			selection.forEachIndex( [&]( const ModelIndex& index ) {
-				if ( index.parent() == mapping.sourceParent ) {
-					staleIndexesInSelection.push_back( index );
-					selectedIndexesInSource.push_back( source().index(
-						oldSourceRows[index.row()], index.column(), mapping.sourceParent ) );
+				if ( index.parent() != mapping.sourceParent ||
+					 index.row() >= static_cast<Int64>( oldSourceRows.size() ) )
+					return;
+
+				staleIndexesInSelection.push_back( index );
+
+				int sourceRow = oldSourceRows[index.row()];
+				if ( sourceRowMap )
+					sourceRow = sourceRowMap( sourceRow );
+
+				if ( sourceRow >= 0 && sourceRow < static_cast<int>( mapping.proxyRows.size() ) ) {
+					newIndexes.push_back( this->index( mapping.proxyRows[sourceRow], index.column(),
+													   mapping.sourceParent ) );
 				}
 			} );
 
 			for ( auto& index : staleIndexesInSelection )
 				selection.remove( index );
 
-			for ( auto& index : selectedIndexesInSource ) {
-				for ( size_t i = 0; i < mapping.sourceRows.size(); ++i ) {
-					if ( mapping.sourceRows[i] == index.row() ) {
-						auto newSourceIndex =
-							this->index( i, index.column(), mapping.sourceParent );
-						selection.add( newSourceIndex );
-						break;
-					}
-				}
-			}
+			for ( auto& index : newIndexes )
+				selection.add( index );
 		} );
 	} );
 }
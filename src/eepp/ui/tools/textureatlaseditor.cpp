@@ -20,6 +20,9 @@ UIWidget* TextureAtlasEditor::createTextureAtlasTextureRegionEditor() {
 	return mTextureRegionEditor;
 }
 
+static constexpr String::HashType TEXTURE_ATLAS_LOADER_UPDATE_TAG =
+	String::hash( "TextureAtlasEditor::loadTextureAtlas" );
+
 TextureAtlasEditor* TextureAtlasEditor::New( UIWindow* attachTo,
 											 const TextureAtlasEditor::TGEditorCloseCb& callback ) {
 	return eeNew( TextureAtlasEditor, ( attachTo, callback ) );
@@ -27,6 +30,7 @@ TextureAtlasEditor* TextureAtlasEditor::New( UIWindow* attachTo,
 
 TextureAtlasEditor::TextureAtlasEditor( UIWindow* attachTo, const TGEditorCloseCb& callback ) :
 	mUIWindow( attachTo ),
+	mUIContainer( NULL ),
 	mCloseCb( callback ),
 	mTexturePacker( NULL ),
 	mTextureAtlasLoader( NULL ),
@@ -182,6 +186,8 @@ TextureAtlasEditor::TextureAtlasEditor( UIWindow* attachTo, const TGEditorCloseC
 }
 
 TextureAtlasEditor::~TextureAtlasEditor() {
+	if ( NULL != mUIContainer && !mUIContainer->isClosing() )
+		mUIContainer->removeActionsByTag( TEXTURE_ATLAS_LOADER_UPDATE_TAG );
 	eeSAFE_DELETE( mTexturePacker );
 	eeSAFE_DELETE( mTextureAtlasLoader );
 }
@@ -345,9 +351,7 @@ void TextureAtlasEditor::onTextureAtlasCreate( TexturePacker* TexPacker ) {
 	std::string FPath( FileSystem::fileRemoveExtension( mTexturePacker->getFilepath() +
 														EE_TEXTURE_ATLAS_EXTENSION ) );
 
-	mTextureAtlasLoader =
-		TextureAtlasLoader::New( FPath, Engine::instance()->isThreaded(),
-								 [this]( auto event ) { onTextureAtlasLoaded( event ); } );
+	loadTextureAtlas( FPath );
 }
 
 void TextureAtlasEditor::updateWidgets() {
@@ -444,9 +448,24 @@ void TextureAtlasEditor::onTextureRegionChange( const Event* Event ) {
 void TextureAtlasEditor::openTextureAtlas( const Event* Event ) {
 	eeSAFE_DELETE( mTextureAtlasLoader );
 
+	loadTextureAtlas( Event->getNode()->asType<UIFileDialog>()->getFullPath() );
+}
+
+void TextureAtlasEditor::loadTextureAtlas( const std::string& path ) {
 	mTextureAtlasLoader = TextureAtlasLoader::New(
-		Event->getNode()->asType<UIFileDialog>()->getFullPath(), Engine::instance()->isThreaded(),
+		path, Engine::instance()->isThreaded(),
 		[this]( auto event ) { onTextureAtlasLoaded( event ); } );
+
+	// The threaded loader creates the atlas textures from update()
+	if ( mTextureAtlasLoader->isLoading() ) {
+		mUIContainer->removeActionsByTag( TEXTURE_ATLAS_LOADER_UPDATE_TAG );
+		mUIContainer->setInterval(
+			[this] {
+				if ( NULL != mTextureAtlasLoader && mTextureAtlasLoader->isLoading() )
+					mTextureAtlasLoader->update();
+			},
+			Seconds( 0 ), TEXTURE_ATLAS_LOADER_UPDATE_TAG );
+	}
 }
 
 void TextureAtlasEditor::onTextureAtlasLoaded( TextureAtlasLoader* textureAtlasLoader ) {
@@ -160,6 +160,9 @@ void UIBorderDrawable::setBorderType( const BorderType& borderType ) {
 	if ( mBorderType != borderType ) {
 		mBorderType = borderType;
 		mNeedsUpdate = true;
+
+		if ( NULL != mOwner )
+			const_cast<UINode*>( mOwner )->invalidateDrawCulling();
 	}
 }
 
@@ -169,7 +169,17 @@ UIFileDialog::UIFileDialog( Uint32 dialogFlags, const std::string& defaultFilePa
 		}
 	} );
 	mMultiView->setOnSelectionChange( [this] {
-		if ( mMultiView->getSelection().isEmpty() || mDisplayingDrives ||
+		if ( mMultiView->getSelection().isEmpty() || mDisplayingDrives )
+			return;
+		// The placeholder row of a folder being loaded isn't a file, it can't be selected. Removing
+		// it notifies the selection change again.
+		int selected = mMultiView->getSelection().size();
+		auto* filterModel = (SortingProxyModel*)mMultiView->getModel().get();
+		mMultiView->getSelection().removeAllMatching(
+			[this, filterModel]( const ModelIndex& index ) {
+				return mModel->node( filterModel->mapToSource( index ) ).isPlaceholder();
+			} );
+		if ( selected != mMultiView->getSelection().size() ||
 			 ( isSaveDialog() && allowMultiFileSelect() ) )
 			return;
 		auto nodes = getSelectionNodes();
@@ -338,9 +348,6 @@ void UIFileDialog::refreshFolder( bool resetScroll ) {
 		mMultiView->getTableView()->setColumnsVisible( { FileSystemModel::Name } );
 		mMultiView->setModel( SortingProxyModel::New( mDiskDrivesModel ) );
 	} else {
-		std::vector<String> flist = FileSystem::filesGetInPath(
-			String( mCurPath ), getSortAlphabetically(), getFoldersFirst(), !getShowHidden() );
-		std::vector<String> files;
 		std::vector<std::string> patterns;
 
 		if ( "*" != mFiletype->getText() ) {
@@ -357,12 +364,16 @@ void UIFileDialog::refreshFolder( bool resetScroll ) {
 									 : FileSystemModel::Mode::FilesAndDirectories,
 				FileSystemModel::DisplayConfig( getSortAlphabetically(), getFoldersFirst(),
 												!getShowHidden(), patterns ),
-				&getUISceneNode()->getTranslator() );
+				&getUISceneNode()->getTranslator(), true );
 		} else {
 			mModel->setRootPath( mCurPath );
 		}
 
-		mMultiView->setModel( SortingProxyModel::New( mModel ) );
+		auto proxy = SortingProxyModel::New( mModel );
+		// Huge directories are sorted in parallel
+		if ( getUISceneNode()->hasThreadPool() )
+			proxy->setThreadPool( getUISceneNode()->getThreadPool() );
+		mMultiView->setModel( proxy );
 
 		mMultiView->getTableView()->setColumnsVisible(
 			{ FileSystemModel::Name, FileSystemModel::Size, FileSystemModel::ModificationTime } );
@@ -424,7 +435,8 @@ std::vector<const FileSystemModel::Node*> UIFileDialog::getSelectionNodes() cons
 	nodes.reserve( localIndexes.size() );
 	for ( const auto& localIndex : localIndexes ) {
 		const FileSystemModel::Node& node = mModel->node( localIndex );
-		nodes.push_back( &node );
+		if ( !node.isPlaceholder() )
+			nodes.push_back( &node );
 	}
 	return nodes;
 }
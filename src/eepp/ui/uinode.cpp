@@ -918,6 +918,7 @@ Uint32 UINode::getForegroundRadius() const {
 
 UIBorderDrawable* UINode::setBorderEnabled( bool enabled ) const {
 	const_cast<UINode*>( this )->writeFlag( UI_BORDER, enabled ? 1 : 0 );
+	const_cast<UINode*>( this )->invalidateDrawCulling();
 
 	if ( enabled && NULL == mBorder ) {
 		getBorder();
@@ -1008,6 +1009,12 @@ void UINode::drawBorder() {
 	}
 }
 
+bool UINode::isDrawCullable() const {
+	// Outside borders and outlines are drawn beyond the node bounds
+	return Node::isDrawCullable() && ( !( mFlags & UI_BORDER ) || NULL == mBorder ||
+									   mBorder->getBorderType() == BorderType::Inside );
+}
+
 void UINode::smartClipStart( const ClipType& reqClipType, bool needsClipPlanes ) {
 	if ( mClip.getClipType() != reqClipType )
 		return;
@@ -1061,6 +1068,15 @@ void UINode::nodeDraw() {
 		if ( mNodeFlags & NODE_FLAG_POLYGON_DIRTY )
 			updateWorldPolygon();
 
+		bool recording = retainedDrawRecording();
+
+		if ( recording ) {
+			if ( retainedDrawPlay() )
+				return;
+
+			retainedDrawBegin();
+		}
+
 		matrixSet();
 
 		bool needsClipPlanes =
@@ -1114,6 +1130,9 @@ void UINode::nodeDraw() {
 		smartClipEnd( ClipType::BorderBox, needsClipPlanes );
 
 		matrixUnset();
+
+		if ( recording )
+			retainedDrawEnd();
 	}
 }
 
@@ -131,48 +131,16 @@ Node* UITableView::overFind( const Vector2f& point ) {
 }
 
 Float UITableView::getMaxColumnContentWidth( const size_t& colIndex, bool bestGuess ) {
-	Float lWidth = 0;
 	ConditionalLock l( getModel() != nullptr, getModel() ? &getModel()->resourceMutex() : nullptr );
-	if ( nullptr == getModel() || getModel()->rowCount() == 0 )
-		return lWidth;
-	ScopedOp op( [this] { mUISceneNode->setIsLoading( true ); },
-				 [this] { mUISceneNode->setIsLoading( false ); } );
-	Float yOffset = getHeaderHeight();
-	auto worstCaseFunc = [&]( const ModelIndex& index ) {
-		UIWidget* widget = updateCell( { (Int64)0, (Int64)0 }, index, 0, yOffset );
-		if ( widget->isType( UI_TYPE_PUSHBUTTON ) ) {
-			Float w = widget->asType<UIPushButton>()->getContentSize().getWidth();
-			if ( w > lWidth )
-				lWidth = w;
-		}
-	};
-	// TODO: Improve best guess
-	if ( bestGuess && getItemCount() > 10 ) {
-		Variant dataTest( getModel()->data( getModel()->index( 0, colIndex ) ) );
-		if ( dataTest.isString() ) {
-			std::map<size_t, ModelIndex> lengths;
-			for ( size_t i = 0; i < getItemCount(); i++ ) {
-				ModelIndex index( getModel()->index( i, colIndex ) );
-				Variant data( getModel()->data( index ) );
-				if ( !data.isValid() )
-					continue;
-				size_t length = data.size();
-				if ( lengths.empty() || length > lengths.rbegin()->first )
-					lengths[length] = index;
-			}
-			size_t i = 0;
-			auto it = lengths.rbegin();
-			for ( ; it != lengths.rend() && i < 10; it++, i++ )
-				worstCaseFunc( it->second );
-		} else {
-			for ( size_t i = 0; i < getItemCount(); i++ )
-				worstCaseFunc( getModel()->index( i, colIndex ) );
-		}
-	} else {
-		for ( size_t i = 0; i < getItemCount(); i++ )
-			worstCaseFunc( getModel()->index( i, colIndex ) );
-	}
-	return lWidth;
+	if ( nullptr == getModel() )
+		return 0;
+	const Model& model = *getModel();
+	return measureColumnContentWidth(
+		model.rowCount(),
+		[&model, colIndex]( size_t row ) -> std::pair<ModelIndex, size_t> {
+			return { model.index( row, colIndex ), 0 };
+		},
+		0, bestGuess );
 }
 
 void UITableView::createOrUpdateColumns( bool resetColumnData ) {
@@ -25,6 +25,11 @@ UITreeView::UITreeView() :
 	mContractIcon = getUISceneNode()->findIcon( "tree-contracted" );
 }
 
+UITreeView::~UITreeView() {
+	if ( mClientModel )
+		mClientModel->unregisterClient( this );
+}
+
 Uint32 UITreeView::getType() const {
 	return UI_TYPE_TREEVIEW;
 }
@@ -47,46 +52,129 @@ void UITreeView::traverseTree( TreeViewCallback callback ) const {
 	if ( !getModel() )
 		return;
 	Lock l( const_cast<Model*>( getModel() )->resourceMutex() );
-	auto& model = *getModel();
-	int indentLevel = 0;
+	const auto& rows = getVisibleRows();
 	Float yOffset = getHeaderHeight();
-	int rowIndex = -1;
 	Float rowHeight = getRowHeight();
-	std::function<IterationDecision( const ModelIndex& )> traverseIndex =
-		[&]( const ModelIndex& index ) {
-			if ( index.isValid() ) {
-				const auto& metadata = getIndexMetadata( index );
-				rowIndex++;
-				IterationDecision decision = callback( rowIndex, index, indentLevel, yOffset );
-				if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
-					return decision;
-				yOffset += rowHeight;
-				if ( !metadata.open ) {
-					return IterationDecision::Continue;
-				}
-			}
-			if ( indentLevel >= 0 && !index.isValid() )
-				return IterationDecision::Continue;
-			++indentLevel;
-			int rowCount = model.rowCount( index );
-			for ( int i = 0; i < rowCount; ++i ) {
-				IterationDecision decision =
-					traverseIndex( model.index( i, model.treeColumn(), index ) );
-				if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
-					return decision;
-			}
-			--indentLevel;
-			return IterationDecision::Continue;
-		};
-	int rootCount = model.rowCount();
-	for ( int rootIndex = 0; rootIndex < rootCount; ++rootIndex ) {
+	for ( size_t i = 0; i < rows.size(); ++i ) {
 		IterationDecision decision =
-			traverseIndex( model.index( rootIndex, model.treeColumn(), ModelIndex() ) );
+			callback( i, rows[i].index, rows[i].indentLevel, yOffset + i * rowHeight );
 		if ( decision == IterationDecision::Break || decision == IterationDecision::Stop )
 			break;
 	}
 }
 
+const std::vector<UITreeView::VisibleRow>& UITreeView::getVisibleRows() const {
+	if ( !mVisibleRowsDirty )
+		return mVisibleRows;
+	ConditionalLock l( getModel() != nullptr,
+					   getModel() ? &const_cast<Model*>( getModel() )->resourceMutex() : nullptr );
+	// Cleared before rebuilding, so a change notified meanwhile triggers a new rebuild
+	mVisibleRowsDirty = false;
+	mVisibleRows.clear();
+	if ( getModel() )
+		collectVisibleRows( {}, 0, mVisibleRows );
+	return mVisibleRows;
+}
+
+void UITreeView::invalidateVisibleRows() {
+	mVisibleRowsDirty = true;
+}
+
+void UITreeView::collectVisibleRows( const ModelIndex& parent, size_t indentLevel,
+									 std::vector<VisibleRow>& rows ) const {
+	const Model& model = *getModel();
+	size_t rowCount = model.rowCount( parent );
+	for ( size_t i = 0; i < rowCount; ++i ) {
+		ModelIndex index( model.index( i, model.treeColumn(), parent ) );
+		rows.push_back( { index, indentLevel } );
+		// Only the nodes that were ever expanded have metadata
+		auto it = mViewMetadata.find( index.internalData() );
+		if ( it != mViewMetadata.end() && it->second.open )
+			collectVisibleRows( index, indentLevel + 1, rows );
+	}
+}
+
+Int64 UITreeView::findVisibleRow( const ModelIndex& index ) const {
+	if ( !getModel() || !index.isValid() )
+		return -1;
+	Lock l( const_cast<Model*>( getModel() )->resourceMutex() );
+	const Model& model = *getModel();
+	ModelIndex treeIndex( (Int64)model.treeColumn() == index.column()
+							  ? index
+							  : model.index( index.row(), model.treeColumn(), index.parent() ) );
+	const auto& rows = getVisibleRows();
+	for ( size_t i = 0; i < rows.size(); ++i ) {
+		if ( rows[i].index == treeIndex )
+			return i;
+	}
+	return -1;
+}
+
+size_t UITreeView::getFirstVisibleRow() const {
+	Float rowHeight = getRowHeight();
+	if ( rowHeight <= 0 )
+		return 0;
+	return eemax<Int64>( 0, eefloor( ( mScrollOffset.y - getHeaderHeight() ) / rowHeight ) - 1 );
+}
+
+Float UITreeView::getRowOffset( const size_t& row ) const {
+	return getHeaderHeight() + row * getRowHeight();
+}
+
+void UITreeView::setIndexOpen( const ModelIndex& index, bool open ) {
+	ConditionalLock l( getModel() != nullptr, getModel() ? &getModel()->resourceMutex() : nullptr );
+	auto& metadata = getIndexMetadata( index );
+	if ( metadata.open == open )
+		return;
+	metadata.open = open;
+	if ( mVisibleRowsDirty || !getModel() )
+		return;
+	Int64 row = findVisibleRow( index );
+	if ( row < 0 ) {
+		invalidateVisibleRows();
+		return;
+	}
+	size_t indentLevel = mVisibleRows[row].indentLevel;
+	if ( open ) {
+		std::vector<VisibleRow> rows;
+		collectVisibleRows( mVisibleRows[row].index, indentLevel + 1, rows );
+		mVisibleRows.insert( mVisibleRows.begin() + row + 1, rows.begin(), rows.end() );
+	} else {
+		size_t end = row + 1;
+		while ( end < mVisibleRows.size() && mVisibleRows[end].indentLevel > indentLevel )
+			++end;
+		mVisibleRows.erase( mVisibleRows.begin() + row + 1, mVisibleRows.begin() + end );
+	}
+}
+
+void UITreeView::onModelUpdate( unsigned flags ) {
+	if ( mClientModel != getModelShared() ) {
+		if ( mClientModel )
+			mClientModel->unregisterClient( this );
+		mClientModel = getModelShared();
+		if ( mClientModel )
+			mClientModel->registerClient( this );
+	}
+	invalidateVisibleRows();
+	UIAbstractTableView::onModelUpdate( flags );
+}
+
+void UITreeView::onModelUpdated( unsigned ) {
+	invalidateVisibleRows();
+}
+
+void UITreeView::modelDidInsertRows( ModelIndex const&, int, int ) {
+	invalidateVisibleRows();
+}
+
+void UITreeView::modelDidMoveRows( ModelIndex const&, int, int, ModelIndex const&, int ) {
+	invalidateVisibleRows();
+}
+
+void UITreeView::modelDidDeleteRows( ModelIndex const&, int, int ) {
+	invalidateVisibleRows();
+}
+
 void UITreeView::createOrUpdateColumns( bool resetColumnData ) {
 	updateContentSize();
 	if ( !getModel() )
@@ -95,12 +183,9 @@ void UITreeView::createOrUpdateColumns( bool resetColumnData ) {
 }
 
 size_t UITreeView::getItemCount() const {
-	size_t count = 0;
-	traverseTree( [&count]( const int&, const ModelIndex&, const size_t&, const Float& ) {
-		count++;
-		return IterationDecision::Continue;
-	} );
-	return count;
+	if ( !getModel() )
+		return 0;
+	return getVisibleRows().size();
 }
 
 void UITreeView::onColumnSizeChange( const size_t& colIndex, bool fromUserInteraction ) {
@@ -120,10 +205,10 @@ void UITreeView::bindNavigationClick( UIWidget* widget ) {
 		ConditionalLock l( getModel() != nullptr,
 						   getModel() ? &getModel()->resourceMutex() : nullptr );
 		if ( getModel()->rowCount( idx ) ) {
-			auto& data = getIndexMetadata( idx );
-			data.open = !data.open;
+			bool open = !isExpanded( idx );
+			setIndexOpen( idx, open );
 			createOrUpdateColumns( false );
-			onOpenTreeModelIndex( idx, data.open );
+			onOpenTreeModelIndex( idx, open );
 		} else {
 			onOpenModelIndex( idx, event );
 		}
@@ -162,12 +247,11 @@ bool UITreeView::tryOpenModelIndex( const ModelIndex& index, bool forceUpdate )
 		rowCount = getModel()->rowCount( index );
 	}
 	if ( rowCount ) {
-		auto& data = getIndexMetadata( index );
-		if ( !data.open ) {
-			data.open = true;
+		if ( !isExpanded( index ) ) {
+			setIndexOpen( index, true );
 			if ( forceUpdate )
 				createOrUpdateColumns( false );
-			onOpenTreeModelIndex( index, data.open );
+			onOpenTreeModelIndex( index, true );
 		}
 		return true;
 	}
@@ -196,10 +280,10 @@ UIWidget* UITreeView::setupCell( UITableCell* widget, UIWidget* rowWidget,
 								   getModel() ? &getModel()->resourceMutex() : nullptr );
 				auto idx = mouseEvent->getNode()->getParent()->asType<UITableRow>()->getCurIndex();
 				if ( getModel()->rowCount( idx ) ) {
-					auto& data = getIndexMetadata( idx );
-					data.open = !data.open;
+					bool open = !isExpanded( idx );
+					setIndexOpen( idx, open );
 					createOrUpdateColumns( false );
-					onOpenTreeModelIndex( idx, data.open );
+					onOpenTreeModelIndex( idx, open );
 				}
 			}
 		} );
@@ -356,13 +440,18 @@ void UITreeView::drawChilds() {
 	int realColIndex = 0;
 	Float rowHeight = getRowHeight();
 
-	traverseTree( [this, &realRowIndex, &realColIndex,
-				   rowHeight]( const int&, const ModelIndex& index, const size_t& indentLevel,
-							   const Float& yOffset ) {
+	ConditionalLock l( getModel() != nullptr, getModel() ? &getModel()->resourceMutex() : nullptr );
+	const auto& rows = getVisibleRows();
+
+	for ( size_t row = getFirstVisibleRow(); row < rows.size(); ++row ) {
+		// Copied since updating the cells can expand nodes and reallocate the rows
+		ModelIndex index( rows[row].index );
+		size_t indentLevel = rows[row].indentLevel;
+		Float yOffset = getRowOffset( row );
 		if ( yOffset - mScrollOffset.y > mSize.getHeight() )
-			return IterationDecision::Stop;
+			break;
 		if ( yOffset - mScrollOffset.y + rowHeight < 0 )
-			return IterationDecision::Continue;
+			continue;
 		Float xOffset = 0;
 		UITableRow* rowNode = updateRow( realRowIndex, index, yOffset );
 		rowNode->setChildsVisibility( false, false );
@@ -394,8 +483,7 @@ void UITreeView::drawChilds() {
 		}
 		rowNode->nodeDraw();
 		realRowIndex++;
-		return IterationDecision::Continue;
-	} );
+	}
 
 	if ( mHeader && mHeader->isVisible() )
 		mHeader->nodeDraw();
@@ -422,18 +510,20 @@ Node* UITreeView::overFind( const Vector2f& point ) {
 				return pOver;
 			int realIndex = 0;
 			Float rowHeight = getRowHeight();
-			traverseTree( [this, &pOver, &realIndex, point, rowHeight](
-							  int, const ModelIndex& index, const size_t&, const Float& yOffset ) {
+			ConditionalLock l( getModel() != nullptr,
+							   getModel() ? &getModel()->resourceMutex() : nullptr );
+			const auto& rows = getVisibleRows();
+			for ( size_t row = getFirstVisibleRow(); row < rows.size(); ++row ) {
+				Float yOffset = getRowOffset( row );
 				if ( yOffset - mScrollOffset.y > mSize.getHeight() )
-					return IterationDecision::Stop;
+					break;
 				if ( yOffset - mScrollOffset.y + rowHeight < 0 )
-					return IterationDecision::Continue;
-				pOver = updateRow( realIndex, index, yOffset )->overFind( point );
+					continue;
+				pOver = updateRow( realIndex, rows[row].index, yOffset )->overFind( point );
 				realIndex++;
 				if ( pOver )
-					return IterationDecision::Stop;
-				return IterationDecision::Continue;
-			} );
+					break;
+			}
 			if ( !pOver )
 				pOver = this;
 		}
@@ -454,7 +544,7 @@ void UITreeView::setExpanded( const std::vector<ModelIndex>& indexes, bool expan
 			continue;
 		size_t count = model.rowCount( index );
 		if ( count )
-			getIndexMetadata( index ).open = expanded;
+			setIndexOpen( index, expanded );
 	}
 	createOrUpdateColumns( false );
 }
@@ -472,6 +562,7 @@ void UITreeView::setAllExpanded( const ModelIndex& index, bool expanded ) {
 		if ( model.rowCount( curIndex ) > 0 )
 			setAllExpanded( curIndex, expanded );
 	}
+	invalidateVisibleRows();
 }
 
 void UITreeView::expandAll( const ModelIndex& index ) {
@@ -526,23 +617,20 @@ void UITreeView::setExpandersAsIcons( bool expandersAsIcons ) {
 	mExpandersAsIcons = expandersAsIcons;
 }
 
-Float UITreeView::getMaxColumnContentWidth( const size_t& colIndex, bool ) {
-	Float lWidth = 0;
-	ScopedOp op( [this] { mUISceneNode->setIsLoading( true ); },
-				 [this] { mUISceneNode->setIsLoading( false ); } );
-	traverseTree( [this, &lWidth, colIndex]( const int&, const ModelIndex& index,
-											 const size_t& indentLevel, const Float& yOffset ) {
-		UIWidget* widget = updateCell( { (Int64)0, (Int64)0 },
-									   getModel()->index( index.row(), colIndex, index.parent() ),
-									   indentLevel, yOffset );
-		if ( widget->isType( UI_TYPE_PUSHBUTTON ) ) {
-			Float w = widget->asType<UIPushButton>()->getContentSize().getWidth();
-			if ( w > lWidth )
-				lWidth = w;
-		}
-		return IterationDecision::Continue;
-	} );
-	return lWidth;
+Float UITreeView::getMaxColumnContentWidth( const size_t& colIndex, bool bestGuess ) {
+	if ( !getModel() )
+		return 0;
+	Lock l( getModel()->resourceMutex() );
+	const Model& model = *getModel();
+	const auto& rows = getVisibleRows();
+	return measureColumnContentWidth(
+		rows.size(),
+		[&model, &rows, colIndex]( size_t row ) -> std::pair<ModelIndex, size_t> {
+			const ModelIndex& index = rows[row].index;
+			return { model.index( index.row(), colIndex, index.parent() ),
+					 rows[row].indentLevel };
+		},
+		(Int64)colIndex == (Int64)model.treeColumn() ? getIndentWidth() : 0, bestGuess );
 }
 
 const size_t& UITreeView::getExpanderIconSize() const {
@@ -563,75 +651,59 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 
 	switch ( event.getKeyCode() ) {
 		case KEY_PAGEUP: {
-			int pageSize = eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1;
-			std::deque<std::pair<ModelIndex, Float>> deque;
+			int pageSize =
+				eemax<int>( 1, eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1 );
+			ModelIndex foundIndex;
 			Float curY;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					deque.push_back( { index, offsetY } );
-					if ( (int)deque.size() > pageSize )
-						deque.pop_front();
-					if ( index == curIndex )
-						return IterationDecision::Break;
-					return IterationDecision::Continue;
-				} );
-			curY = deque.front().second - getHeaderHeight();
-			getSelection().set( deque.front().first );
-			scrollToPosition(
-				{ { mScrollOffset.x, curY },
-				  { columnData( deque.front().first.column() ).width, getRowHeight() } } );
+			{
+				Lock l( getModel()->resourceMutex() );
+				const auto& rows = getVisibleRows();
+				if ( rows.empty() )
+					return 1;
+				Int64 row = findVisibleRow( curIndex );
+				if ( row < 0 )
+					row = rows.size() - 1;
+				row = eemax<Int64>( 0, row - pageSize + 1 );
+				foundIndex = rows[row].index;
+				curY = getRowOffset( row ) - getHeaderHeight();
+			}
+			getSelection().set( foundIndex );
+			scrollToPosition( { { mScrollOffset.x, curY },
+								{ columnData( foundIndex.column() ).width, getRowHeight() } } );
 			return 1;
 		}
 		case KEY_PAGEDOWN: {
-			int pageSize = eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1;
-			int counted = 0;
-			bool foundStart = false;
-			bool resultFound = false;
+			int pageSize =
+				eemax<int>( 1, eefloor( getVisibleArea().getHeight() / getRowHeight() ) - 1 );
 			ModelIndex foundIndex;
-			Float curY = 0;
-			Float lastOffsetY = 0;
-			ModelIndex lastIndex;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( index == curIndex ) {
-						foundStart = true;
-					} else if ( foundStart ) {
-						counted++;
-						if ( counted == pageSize ) {
-							foundIndex = index;
-							curY = offsetY;
-							resultFound = true;
-							return IterationDecision::Break;
-						}
-					}
-					lastOffsetY = offsetY;
-					lastIndex = index;
-					return IterationDecision::Continue;
-				} );
-			if ( !resultFound ) {
-				foundIndex = lastIndex;
-				curY = lastOffsetY;
+			Float curY;
+			{
+				Lock l( getModel()->resourceMutex() );
+				const auto& rows = getVisibleRows();
+				if ( rows.empty() )
+					return 1;
+				Int64 row = findVisibleRow( curIndex );
+				row = row < 0 ? rows.size() - 1
+							  : eemin<Int64>( row + pageSize, (Int64)rows.size() - 1 );
+				foundIndex = rows[row].index;
+				curY = getRowOffset( row ) + getRowHeight();
 			}
-			curY += getRowHeight();
 			getSelection().set( foundIndex );
 			scrollToPosition( { { mScrollOffset.x, curY },
 								{ columnData( foundIndex.column() ).width, getRowHeight() } } );
 			return 1;
 		}
 		case KEY_UP: {
-			ModelIndex prevIndex;
 			ModelIndex foundIndex;
 			Float curY = 0;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( index == curIndex ) {
-						foundIndex = prevIndex;
-						curY = offsetY;
-						return IterationDecision::Break;
-					}
-					prevIndex = index;
-					return IterationDecision::Continue;
-				} );
+			{
+				Lock l( getModel()->resourceMutex() );
+				Int64 row = findVisibleRow( curIndex );
+				if ( row > 0 ) {
+					foundIndex = getVisibleRows()[row - 1].index;
+					curY = getRowOffset( row );
+				}
+			}
 			if ( foundIndex.isValid() ) {
 				getSelection().set( foundIndex );
 				if ( curY < mScrollOffset.y + getHeaderHeight() + getRowHeight() ||
@@ -645,19 +717,18 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 			return 1;
 		}
 		case KEY_DOWN: {
-			ModelIndex prevIndex;
 			ModelIndex foundIndex;
 			Float curY = 0;
-			traverseTree(
-				[&]( const int&, const ModelIndex& index, const size_t&, const Float& offsetY ) {
-					if ( prevIndex == curIndex ) {
-						foundIndex = index;
-						curY = offsetY;
-						return IterationDecision::Break;
-					}
-					prevIndex = index;
-					return IterationDecision::Continue;
-				} );
+			{
+				Lock l( getModel()->resourceMutex() );
+				const auto& rows = getVisibleRows();
+				// Without a selection the first row is selected
+				Int64 row = curIndex.isValid() ? findVisibleRow( curIndex ) : -1;
+				if ( ( row >= 0 || !curIndex.isValid() ) && row + 1 < (Int64)rows.size() ) {
+					foundIndex = rows[row + 1].index;
+					curY = getRowOffset( row + 1 );
+				}
+			}
 			if ( foundIndex.isValid() ) {
 				getSelection().set( foundIndex );
 				if ( curY < mScrollOffset.y ||
@@ -675,10 +746,12 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 		case KEY_END: {
 			scrollToBottom();
 			ModelIndex lastIndex;
-			traverseTree( [&]( const int&, const ModelIndex& index, const size_t&, const Float& ) {
-				lastIndex = index;
-				return IterationDecision::Continue;
-			} );
+			{
+				Lock l( getModel()->resourceMutex() );
+				const auto& rows = getVisibleRows();
+				if ( !rows.empty() )
+					lastIndex = rows.back().index;
+			}
 			getSelection().set( lastIndex );
 			return 1;
 		}
@@ -689,9 +762,8 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 		}
 		case KEY_RIGHT: {
 			if ( curIndex.isValid() && getModel()->rowCount( curIndex ) ) {
-				auto& metadata = getIndexMetadata( curIndex );
-				if ( !metadata.open ) {
-					metadata.open = true;
+				if ( !isExpanded( curIndex ) ) {
+					setIndexOpen( curIndex, true );
 					createOrUpdateColumns( false );
 					return 0;
 				}
@@ -701,9 +773,8 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 		}
 		case KEY_LEFT: {
 			if ( curIndex.isValid() && getModel()->rowCount( curIndex ) ) {
-				auto& metadata = getIndexMetadata( curIndex );
-				if ( metadata.open ) {
-					metadata.open = false;
+				if ( isExpanded( curIndex ) ) {
+					setIndexOpen( curIndex, false );
 					createOrUpdateColumns( false );
 					return 0;
 				}
@@ -718,8 +789,7 @@ Uint32 UITreeView::onKeyDown( const KeyEvent& event ) {
 		case KEY_KP_ENTER: {
 			if ( curIndex.isValid() ) {
 				if ( getModel()->rowCount( curIndex ) ) {
-					auto& metadata = getIndexMetadata( curIndex );
-					metadata.open = !metadata.open;
+					setIndexOpen( curIndex, !isExpanded( curIndex ) );
 					createOrUpdateColumns( false );
 				} else {
 					onOpenModelIndex( curIndex, &event );
@@ -841,21 +911,10 @@ void UITreeView::setSelection( const ModelIndex& index, bool scrollToSelection,
 		if ( !scrollToSelection )
 			return;
 
-		ModelIndex prevIndex;
-		ModelIndex foundIndex;
-		Float curY = 0;
-		traverseTree(
-			[&]( const int&, const ModelIndex& _index, const size_t&, const Float& offsetY ) {
-				if ( index == _index ) {
-					foundIndex = prevIndex;
-					curY = offsetY;
-					return IterationDecision::Break;
-				}
-				prevIndex = index;
-				return IterationDecision::Continue;
-			} );
+		Int64 row = findVisibleRow( index );
+		Float curY = row > 0 ? getRowOffset( row ) : 0;
 
-		if ( foundIndex.isValid() ) {
+		if ( row > 0 ) {
 			if ( curY < mScrollOffset.y + getHeaderHeight() + getRowHeight() ||
 				 curY > mScrollOffset.y + getPixelsSize().getHeight() - mPaddingPx.Top -
 							mPaddingPx.Bottom - getRowHeight() ) {
@@ -1333,6 +1333,7 @@ std::vector<PropertyId> UIWidget::getPropertiesImplemented() const {
 			 PropertyId::Cursor,
 			 PropertyId::Visible,
 			 PropertyId::Enabled,
+			 PropertyId::RetainedDraw,
 			 PropertyId::Theme,
 			 PropertyId::Skin,
 			 PropertyId::Flags,
@@ -1434,6 +1435,8 @@ std::string UIWidget::getPropertyString( const PropertyDefinition* propertyDef,
 			return isVisible() ? "true" : "false";
 		case PropertyId::Enabled:
 			return isEnabled() ? "true" : "false";
+		case PropertyId::RetainedDraw:
+			return isRetainedDraw() ? "true" : "false";
 		case PropertyId::Theme:
 			return NULL != mTheme ? mTheme->getName() : "";
 		case PropertyId::Skin:
@@ -1618,6 +1621,9 @@ bool UIWidget::applyProperty( const StyleSheetProperty& attribute ) {
 		case PropertyId::Enabled:
 			setEnabled( attribute.asBool() );
 			break;
+		case PropertyId::RetainedDraw:
+			setRetainedDraw( attribute.asBool() );
+			break;
 		case PropertyId::Theme:
 			setThemeByName( attribute.value() );
 			if ( !mSkinName.empty() )
@@ -358,6 +358,11 @@ void UIWindow::drawHighlightInvalidation() {
 	}
 }
 
+bool UIWindow::isDrawCullable() const {
+	// The shadow is drawn outside the window bounds
+	return false;
+}
+
 void UIWindow::drawShadow() {
 	if ( mStyleConfig.WinFlags & UI_WIN_SHADOW ) {
 		UIWidget::matrixSet();
@@ -1375,14 +1375,14 @@ void EETest::loadTextures() {
 		std::string name( files[i] );
 
 		if ( "jpg" == FileSystem::fileExtension( name ) ) {
-			mResLoad.add( [=] { TextureFactory::instance()->loadFromPack( PakTest, name ); } );
+			auto loader = std::make_shared<TextureLoader>( PakTest, name );
+			mResLoad.add( [loader] { loader->decode(); }, [loader] { loader->upload(); } );
 		}
 	}
 #endif
 
 	SndMng.loadFromFile( "mysound", MyPath + "sounds/sound.ogg" );
 
-	mResLoad.setThreaded( EE->isSharedGLContextEnabled() );
 	mResLoad.load( [this]( auto event ) { onTextureLoaded( event ); } );
 
 	TN.resize( 12 );
@@ -2155,6 +2155,8 @@ void EETest::update() {
 
 	SceneManager::instance()->update();
 
+	mResLoad.update();
+
 	input();
 
 	mWindow->clear();
@@ -150,7 +150,51 @@ void mainLoop() {
 	}
 }
 
-EE_MAIN_FUNC int main( int, char*[] ) {
+// Hit tests a container with many absolutely positioned children, first walking the whole child
+// list and then using the children spatial index.
+// Run with --overfind-benchmark.
+static void overFindBenchmark( UISceneNode* uiSceneNode ) {
+	const int columns = 200;
+	const int rows = 100;
+	const size_t queries = 100000;
+
+	UIWidget* container = UIWidget::New();
+	container->setParent( uiSceneNode->getRoot() );
+	container->setPixelsSize( columns * 8, rows * 8 );
+
+	for ( int y = 0; y < rows; y++ ) {
+		for ( int x = 0; x < columns; x++ ) {
+			UIWidget* child = UIWidget::New();
+			child->setParent( container );
+			child->setPixelsPosition( x * 8, y * 8 );
+			child->setPixelsSize( 6, 6 );
+		}
+	}
+
+	std::vector<Vector2f> points;
+	points.reserve( queries );
+	for ( size_t i = 0; i < queries; i++ )
+		points.emplace_back( Math::randf( 0, columns * 8 ), Math::randf( 0, rows * 8 ) );
+
+	for ( bool indexed : { false, true } ) {
+		container->setChildsSpatialIndexed( indexed );
+
+		Clock clock;
+		size_t hits = 0;
+		for ( const Vector2f& point : points ) {
+			if ( container->overFind( container->getScreenPos() + point ) != container )
+				hits++;
+		}
+
+		Log::notice( "overFind %s (%d children, %zu queries): %.2fms, %zu hits",
+					 indexed ? "indexed" : "linear", columns * rows, queries,
+					 clock.getElapsedTime().asMilliseconds(), hits );
+	}
+
+	container->close();
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 	win = Engine::instance()->createWindow( WindowSettings( 1366, 768, "eepp - UI Perf Test" ),
 											ContextSettings( false ) );
 
@@ -376,6 +420,9 @@ EE_MAIN_FUNC int main( int, char*[] ) {
 		drop->getListBox()->setSelected( 0 );
 		wind->show();*/
 
+		if ( argc > 1 && std::string( argv[1] ) == "--overfind-benchmark" )
+			overFindBenchmark( uiSceneNode );
+
 		win->runMainLoop( &mainLoop );
 	}
 
@@ -0,0 +1,180 @@
+#include "utest.h"
+#include <eepp/core/compactstring.hpp>
+#include <stdexcept>
+
+using namespace EE;
+
+// A string mixing characters of every UTF-8 sequence length, long enough to span several index
+// checkpoints
+static String mixedString( std::size_t length ) {
+	static const String::StringBaseType chars[] = { 'a', 0xE9, 0x3A9, 'Z', 0x20AC, 0x1F600, ' ',
+													0xFF, 0x4E2D };
+	String string;
+	for ( std::size_t i = 0; i < length; i++ )
+		string.push_back( chars[( i * 7 + i / 5 ) % ( sizeof( chars ) / sizeof( chars[0] ) )] );
+	return string;
+}
+
+static bool sameCharacters( const CompactString& compact, const String& string ) {
+	if ( compact.size() != string.size() )
+		return false;
+	for ( std::size_t i = 0; i < string.size(); i++ )
+		if ( compact[i] != string[i] )
+			return false;
+	return compact.toString() == string && compact.toUtf8() == string.toUtf8();
+}
+
+UTEST( CompactString, encoding ) {
+	CompactString ascii( "hello world" );
+	EXPECT_EQ( ascii.getEncoding(), CompactString::Encoding::Latin1 );
+	EXPECT_TRUE( ascii.isAscii() );
+	EXPECT_TRUE( ascii.getBytes() == "hello world" );
+
+	CompactString latin1( "caf\xc3\xa9" );
+	EXPECT_EQ( latin1.getEncoding(), CompactString::Encoding::Latin1 );
+	EXPECT_FALSE( latin1.isAscii() );
+	EXPECT_EQ( latin1.size(), 4UL );
+	EXPECT_EQ( static_cast<Uint32>( latin1[3] ), 0xE9u );
+	EXPECT_TRUE( latin1.getBytes() == "caf\xe9" );
+	EXPECT_TRUE( latin1.toUtf8() == "caf\xc3\xa9" );
+	EXPECT_TRUE( CompactString::fromLatin1( "caf\xe9" ) == latin1 );
+
+	CompactString utf8( "\xe2\x82\xac 5" );
+	EXPECT_EQ( utf8.getEncoding(), CompactString::Encoding::Utf8 );
+	EXPECT_EQ( utf8.size(), 3UL );
+	EXPECT_EQ( static_cast<Uint32>( utf8[0] ), 0x20ACu );
+	EXPECT_TRUE( utf8.toUtf8() == "\xe2\x82\xac 5" );
+}
+
+UTEST( CompactString, indexingAcrossCheckpoints ) {
+	for ( std::size_t length : { 0, 1, 15, 16, 17, 31, 32, 33, 100, 257 } ) {
+		String string( mixedString( length ) );
+		CompactString compact( string );
+		ASSERT_TRUE( sameCharacters( compact, string ) );
+		ASSERT_TRUE( CompactString::fromUtf8( string.toUtf8() ) == compact );
+		bool outOfRange = false;
+		try {
+			compact.at( length );
+		} catch ( const std::out_of_range& ) {
+			outOfRange = true;
+		}
+		EXPECT_TRUE( outOfRange );
+		if ( length > 0 ) {
+			EXPECT_TRUE( compact.at( length - 1 ) == string[length - 1] );
+			EXPECT_TRUE( compact.view().back() == string[length - 1] );
+		}
+	}
+}
+
+UTEST( CompactString, substrAndBytes ) {
+	String string( mixedString( 70 ) );
+	CompactString compact( string );
+	CompactString latin1(
+		CompactString::fromLatin1( "The quick brown fox jumps over the lazy dog \xe9\xe8\xff" ) );
+	String latin1String( latin1.toString() );
+
+	const std::size_t counts[] = { 0, 1, 15, 16, 17, CompactString::InvalidPos };
+
+	for ( std::size_t pos = 0; pos <= string.size(); pos += 3 ) {
+		for ( std::size_t count : counts ) {
+			CompactString::View view( compact.substr( pos, count ) );
+			String expected( string.substr( pos, count ) );
+			ASSERT_EQ( view.size(), expected.size() );
+			ASSERT_TRUE( view.toString() == expected );
+			ASSERT_TRUE( std::string( view.getBytes() ) == expected.toUtf8() );
+			ASSERT_TRUE( CompactString( view ) == CompactString( expected ) );
+			for ( std::size_t i = 0; i < view.size(); i++ )
+				ASSERT_TRUE( view[i] == expected[i] );
+
+			if ( pos <= latin1String.size() ) {
+				CompactString::View latin1View( latin1.substr( pos, count ) );
+				String latin1Expected( latin1String.substr( pos, count ) );
+				ASSERT_TRUE( latin1View.toString() == latin1Expected );
+				ASSERT_EQ( latin1View.getBytes().size(), latin1Expected.size() );
+			}
+		}
+	}
+
+	// Views of substrings are compared by characters, regardless of the encoding
+	CompactString mixed( "\xe2\x82\xac caf\xc3\xa9" );
+	EXPECT_TRUE( mixed.substr( 2 ) == CompactString( "caf\xc3\xa9" ).view() );
+	EXPECT_TRUE( mixed.substr( 1 ) != CompactString( "caf\xc3\xa9" ).view() );
+}
+
+UTEST( CompactString, promotionToUtf8 ) {
+	CompactString compact;
+	String expected;
+	for ( int i = 0; i < 40; i++ ) {
+		String::StringBaseType c = i % 2 ? 0xC0 + i : 'a' + i % 26;
+		compact.push_back( c );
+		expected.push_back( c );
+	}
+	EXPECT_EQ( compact.getEncoding(), CompactString::Encoding::Latin1 );
+
+	// A character out of Latin-1 converts the whole string, the old characters must be kept
+	compact.push_back( 0x20AC );
+	expected.push_back( 0x20AC );
+	EXPECT_EQ( compact.getEncoding(), CompactString::Encoding::Utf8 );
+	ASSERT_TRUE( sameCharacters( compact, expected ) );
+
+	for ( int i = 0; i < 40; i++ ) {
+		compact += static_cast<String::StringBaseType>( 'A' + i % 26 );
+		expected.push_back( 'A' + i % 26 );
+	}
+	ASSERT_TRUE( sameCharacters( compact, expected ) );
+
+	// Appending a Latin-1 string to a UTF-8 one and the other way around
+	CompactString latin1( "\xc3\xa9t\xc3\xa9" );
+	compact.append( latin1.view() );
+	expected += latin1.toString();
+	ASSERT_TRUE( sameCharacters( compact, expected ) );
+	latin1.append( compact.view() );
+	ASSERT_TRUE( sameCharacters( latin1, String( "\xc3\xa9t\xc3\xa9" ) + expected ) );
+}
+
+UTEST( CompactString, appendToItself ) {
+	String latin1Expected( "abc\xc3\xa9" );
+	CompactString latin1( latin1Expected );
+	for ( int i = 0; i < 4; i++ ) {
+		latin1.append( latin1.view() );
+		latin1Expected += latin1Expected;
+	}
+	latin1.append( latin1.substr( 3, 20 ) );
+	latin1Expected += latin1Expected.substr( 3, 20 );
+	EXPECT_TRUE( sameCharacters( latin1, latin1Expected ) );
+
+	String utf8Expected( mixedString( 20 ) );
+	CompactString utf8( utf8Expected );
+	for ( int i = 0; i < 4; i++ ) {
+		utf8.append( utf8.view() );
+		utf8Expected += utf8Expected;
+	}
+	utf8.append( utf8.substr( 17, 40 ) );
+	utf8Expected += utf8Expected.substr( 17, 40 );
+	EXPECT_TRUE( sameCharacters( utf8, utf8Expected ) );
+}
+
+UTEST( CompactString, moves ) {
+	String string( mixedString( 50 ) );
+	CompactString source( string );
+	CompactString moved( std::move( source ) );
+	ASSERT_TRUE( sameCharacters( moved, string ) );
+	// The moved string is empty and still usable
+	EXPECT_TRUE( source.empty() );
+	EXPECT_EQ( source.getEncoding(), CompactString::Encoding::Latin1 );
+	EXPECT_TRUE( source == CompactString() );
+	source.push_back( 0x20AC );
+	EXPECT_EQ( source.size(), 1UL );
+	EXPECT_EQ( static_cast<Uint32>( source[0] ), 0x20ACu );
+
+	CompactString assigned( "previous value" );
+	assigned = std::move( moved );
+	ASSERT_TRUE( sameCharacters( assigned, string ) );
+	EXPECT_TRUE( moved.empty() );
+	EXPECT_TRUE( moved.toUtf8().empty() );
+	EXPECT_TRUE( moved.substr( 0 ).empty() );
+
+	CompactString copy( assigned );
+	EXPECT_TRUE( copy == assigned );
+	EXPECT_TRUE( sameCharacters( copy, string ) );
+}
@@ -0,0 +1,147 @@
+#include "utest.h"
+#include <eepp/graphics/drawcommandlist.hpp>
+
+using namespace EE;
+using namespace EE::Graphics;
+
+static DrawCommandState stateFor( const BlendMode& blend, PrimitiveType mode = PRIMITIVE_QUADS,
+								  Float primitiveSize = 1.f ) {
+	DrawCommandState state;
+	state.blend = blend;
+	state.mode = mode;
+	state.primitiveSize = primitiveSize;
+	return state;
+}
+
+static void addQuad( DrawCommandList& list, const DrawCommandState& state, const Rectf& rect ) {
+	VertexData vertices[4] = {
+		{ { rect.Left, rect.Top }, { 0, 0 }, Color::White },
+		{ { rect.Left, rect.Bottom }, { 0, 1 }, Color::White },
+		{ { rect.Right, rect.Bottom }, { 1, 1 }, Color::White },
+		{ { rect.Right, rect.Top }, { 1, 0 }, Color::White },
+	};
+	list.add( state, vertices, 4 );
+}
+
+static void addLine( DrawCommandList& list, const DrawCommandState& state, const Vector2f& from,
+					 const Vector2f& to ) {
+	VertexData vertices[2] = {
+		{ from, { 0, 0 }, Color::White },
+		{ to, { 0, 0 }, Color::White },
+	};
+	list.add( state, vertices, 2 );
+}
+
+UTEST( DrawCommandList, mergesNonOverlappingCommands ) {
+	const auto alpha = stateFor( BlendMode::Alpha() );
+	const auto add = stateFor( BlendMode::Add() );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	addQuad( list, alpha, { 0, 0, 10, 10 } );
+	addQuad( list, add, { 20, 0, 30, 10 } );
+	addQuad( list, alpha, { 40, 0, 50, 10 } );
+	ASSERT_EQ( list.getCommandsCount(), 3UL );
+
+	list.replay( recorder );
+	EXPECT_TRUE( list.empty() );
+	EXPECT_EQ( recorder.getDrawCalls(), 2u );
+	EXPECT_EQ( recorder.getBlendChanges(), 1u );
+	EXPECT_EQ( recorder.getVertexCount(), 12u );
+	ASSERT_EQ( recorder.getStates().size(), 2UL );
+	// The third quad was moved back into the first run
+	EXPECT_TRUE( recorder.getStates()[0] == alpha );
+	EXPECT_TRUE( recorder.getStates()[1] == add );
+}
+
+UTEST( DrawCommandList, keepsOrderOfOverlappingCommands ) {
+	const auto alpha = stateFor( BlendMode::Alpha() );
+	const auto add = stateFor( BlendMode::Add() );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	addQuad( list, alpha, { 0, 0, 10, 10 } );
+	addQuad( list, add, { 5, 5, 15, 15 } );
+	addQuad( list, alpha, { 10, 10, 20, 20 } );
+	list.replay( recorder );
+
+	ASSERT_EQ( recorder.getDrawCalls(), 3u );
+	EXPECT_TRUE( recorder.getStates()[0] == alpha );
+	EXPECT_TRUE( recorder.getStates()[1] == add );
+	EXPECT_TRUE( recorder.getStates()[2] == alpha );
+}
+
+UTEST( DrawCommandList, degenerateBoundsOverlap ) {
+	const auto alpha = stateFor( BlendMode::Alpha() );
+	const auto add = stateFor( BlendMode::Add() );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	// A zero width quad touching the edge of the next quad must keep it in place
+	addQuad( list, alpha, { 0, 0, 4, 10 } );
+	addQuad( list, add, { 5, 0, 5, 10 } );
+	addQuad( list, alpha, { 5, 0, 15, 10 } );
+	list.replay( recorder );
+
+	EXPECT_EQ( recorder.getDrawCalls(), 3u );
+}
+
+UTEST( DrawCommandList, lineWidthWidensBounds ) {
+	const auto lines = stateFor( BlendMode::Alpha(), PRIMITIVE_LINES );
+	const auto wideLines = stateFor( BlendMode::Add(), PRIMITIVE_LINES, 4.f );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	// The wide line is 1px below the others, its width makes it cover them
+	addLine( list, lines, { 0, 10 }, { 100, 10 } );
+	addLine( list, wideLines, { 0, 11 }, { 100, 11 } );
+	addLine( list, lines, { 0, 10 }, { 100, 10 } );
+	list.replay( recorder );
+	EXPECT_EQ( recorder.getDrawCalls(), 3u );
+
+	recorder.reset();
+	EXPECT_EQ( recorder.getDrawCalls(), 0u );
+
+	// Far enough, the lines can be merged
+	addLine( list, lines, { 0, 10 }, { 100, 10 } );
+	addLine( list, wideLines, { 0, 20 }, { 100, 20 } );
+	addLine( list, lines, { 0, 10 }, { 100, 10 } );
+	list.replay( recorder );
+	EXPECT_EQ( recorder.getDrawCalls(), 2u );
+}
+
+UTEST( DrawCommandList, neverMergesAcrossClipsOrStrips ) {
+	const auto alpha = stateFor( BlendMode::Alpha() );
+	const auto strip = stateFor( BlendMode::Alpha(), PRIMITIVE_TRIANGLE_STRIP );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	addQuad( list, alpha, { 0, 0, 10, 10 } );
+	list.addClipEnable( { 0, 0, 100, 100 } );
+	addQuad( list, alpha, { 20, 0, 30, 10 } );
+	list.addClipDisable();
+	addQuad( list, strip, { 40, 0, 50, 10 } );
+	addQuad( list, strip, { 60, 0, 70, 10 } );
+	list.replay( recorder );
+
+	EXPECT_EQ( recorder.getDrawCalls(), 4u );
+	EXPECT_EQ( recorder.getClipChanges(), 2u );
+	EXPECT_EQ( recorder.getModeChanges(), 1u );
+}
+
+UTEST( DrawCommandList, playKeepsRecordedOrder ) {
+	const auto alpha = stateFor( BlendMode::Alpha() );
+	const auto add = stateFor( BlendMode::Add() );
+	DrawCommandList list;
+	DrawCommandList::Recorder recorder;
+
+	addQuad( list, alpha, { 0, 0, 10, 10 } );
+	addQuad( list, add, { 20, 0, 30, 10 } );
+	addQuad( list, alpha, { 40, 0, 50, 10 } );
+
+	ASSERT_TRUE( list.play( recorder, { 5, 5 } ) );
+	EXPECT_EQ( recorder.getDrawCalls(), 3u );
+	EXPECT_EQ( recorder.getBlendChanges(), 2u );
+	// The list is kept after playing it
+	EXPECT_EQ( list.getCommandsCount(), 3UL );
+}
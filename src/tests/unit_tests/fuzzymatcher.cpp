@@ -0,0 +1,146 @@
+#include "utest.h"
+#include <climits>
+#include <eepp/core/string.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
+
+using namespace EE;
+using namespace EE::System;
+
+static const std::vector<std::string> FUZZY_CANDIDATES = {
+	"main.cpp",
+	"src/eepp/system/fuzzymatcher.cpp",
+	"include/eepp/system/fuzzymatcher.hpp",
+	"src/eepp/ui/doc/textdocument.cpp",
+	"FuzzyMatcher",
+	"fuzzy matcher",
+	"a very long candidate name that exceeds sixteen characters with the match at the end fzm",
+	"",
+	"FUZZY",
+};
+
+UTEST( FuzzyMatcher, scoreMatchesStringFuzzyMatch ) {
+	const std::vector<std::string> patterns = { "fzm", "fuzzy", "FM", "cpp", "fuzzy m", "xyz",
+												"src/eepp", "fzm.cpp", "" };
+	for ( const auto& candidate : FUZZY_CANDIDATES ) {
+		for ( const auto& pattern : patterns ) {
+			for ( int flags = 0; flags < 4; flags++ ) {
+				bool allowUneven = flags & 1;
+				bool permissive = flags & 2;
+				EXPECT_EQ( String::fuzzyMatch( candidate, pattern, allowUneven, permissive ),
+						   FuzzyMatcher::score( candidate, pattern, allowUneven, permissive ) );
+			}
+		}
+	}
+}
+
+UTEST( FuzzyMatcher, charMask ) {
+	EXPECT_EQ( FuzzyMatcher::charMask( "abc" ), FuzzyMatcher::charMask( "CBA" ) );
+	EXPECT_EQ( FuzzyMatcher::charMask( "a b" ), FuzzyMatcher::charMask( "ab" ) );
+	EXPECT_EQ( FuzzyMatcher::charMask( "" ), 0ULL );
+	Uint64 pattern = FuzzyMatcher::charMask( "fzm" );
+	EXPECT_EQ( pattern & ~FuzzyMatcher::charMask( "FuzzyMatcher" ), 0ULL );
+	EXPECT_NE( pattern & ~FuzzyMatcher::charMask( "main.cpp" ), 0ULL );
+}
+
+UTEST( FuzzyMatcher, matchRanking ) {
+	FuzzyMatcher matcher;
+	for ( const auto& candidate : FUZZY_CANDIDATES )
+		matcher.add( candidate );
+	ASSERT_EQ( matcher.size(), FUZZY_CANDIDATES.size() );
+
+	auto matches = matcher.match( "fuzzy", FUZZY_CANDIDATES.size() );
+	ASSERT_FALSE( matches.empty() );
+	for ( size_t i = 0; i < matches.size(); i++ ) {
+		EXPECT_EQ( matches[i].score,
+				   String::fuzzyMatch( FUZZY_CANDIDATES[matches[i].index], "fuzzy" ) );
+		EXPECT_NE( matches[i].score, INT_MIN );
+		if ( i > 0 ) {
+			EXPECT_TRUE( matches[i - 1].score > matches[i].score ||
+						 ( matches[i - 1].score == matches[i].score &&
+						   matches[i - 1].index < matches[i].index ) );
+		}
+	}
+
+	// Every candidate with a valid score must be present
+	size_t expected = 0;
+	for ( const auto& candidate : FUZZY_CANDIDATES )
+		if ( String::fuzzyMatch( candidate, "fuzzy" ) != INT_MIN )
+			expected++;
+	EXPECT_EQ( matches.size(), expected );
+
+	auto best = matcher.match( "fuzzy", 2 );
+	ASSERT_EQ( best.size(), 2UL );
+	EXPECT_EQ( best[0].index, matches[0].index );
+	EXPECT_EQ( best[1].index, matches[1].index );
+
+	EXPECT_TRUE( matcher.match( "fuzzy", 0 ).empty() );
+}
+
+UTEST( FuzzyMatcher, incrementalPatterns ) {
+	FuzzyMatcher matcher;
+	for ( const auto& candidate : FUZZY_CANDIDATES )
+		matcher.add( candidate );
+
+	// Extending, shrinking and replacing the pattern must give the same results as a fresh
+	// matcher, regardless of the previous query survivors.
+	const std::vector<std::string> queries = { "f", "fu", "fuz", "fuzzyc", "fu", "s", "src", "" };
+	for ( const auto& query : queries ) {
+		FuzzyMatcher fresh;
+		for ( const auto& candidate : FUZZY_CANDIDATES )
+			fresh.add( candidate );
+		auto expected = fresh.match( query, 100 );
+		auto got = matcher.match( query, 100 );
+		ASSERT_EQ( got.size(), expected.size() );
+		for ( size_t i = 0; i < got.size(); i++ ) {
+			EXPECT_EQ( got[i].index, expected[i].index );
+			EXPECT_EQ( got[i].score, expected[i].score );
+		}
+	}
+}
+
+UTEST( FuzzyMatcher, includeUnmatched ) {
+	FuzzyMatcher matcher;
+	for ( const auto& candidate : FUZZY_CANDIDATES )
+		matcher.add( candidate );
+
+	auto matches = matcher.match( "hpp", 100, true );
+	ASSERT_EQ( matches.size(), FUZZY_CANDIDATES.size() );
+	bool unmatched = false;
+	Uint32 lastUnmatched = 0;
+	for ( const auto& match : matches ) {
+		if ( match.score == INT_MIN ) {
+			// Unmatched candidates are appended after the matches, in insertion order
+			if ( unmatched )
+				EXPECT_GT( match.index, lastUnmatched );
+			unmatched = true;
+			lastUnmatched = match.index;
+		} else {
+			EXPECT_FALSE( unmatched );
+		}
+	}
+	EXPECT_TRUE( unmatched );
+}
+
+UTEST( FuzzyMatcher, multipleFields ) {
+	FuzzyMatcher matcher( 2 );
+	matcher.add( { "textdocument.cpp", "src/eepp/ui/doc/textdocument.cpp" } );
+	matcher.add( { "fuzzymatcher.cpp", "src/eepp/system/fuzzymatcher.cpp" } );
+	matcher.add( { "main.cpp", "src/tools/ecode/main.cpp" } );
+	ASSERT_EQ( matcher.size(), 3UL );
+
+	auto matches = matcher.match( "ecode", 10 );
+	ASSERT_EQ( matches.size(), 1UL );
+	EXPECT_EQ( matches[0].index, 2u );
+	EXPECT_EQ( matches[0].score, String::fuzzyMatch( "src/tools/ecode/main.cpp", "ecode" ) );
+
+	matches = matcher.match( "fuzzy", 10 );
+	ASSERT_EQ( matches.size(), 1UL );
+	EXPECT_EQ( matches[0].index, 1u );
+	EXPECT_EQ( matches[0].score,
+			   std::max( String::fuzzyMatch( "fuzzymatcher.cpp", "fuzzy" ),
+						 String::fuzzyMatch( "src/eepp/system/fuzzymatcher.cpp", "fuzzy" ) ) );
+
+	matcher.clear();
+	EXPECT_TRUE( matcher.empty() );
+	EXPECT_TRUE( matcher.match( "fuzzy", 10 ).empty() );
+}
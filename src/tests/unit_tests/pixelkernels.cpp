@@ -0,0 +1,205 @@
+#include "utest.h"
+#include "../../eepp/graphics/pixelkernels.hpp"
+#include <vector>
+
+using namespace EE;
+using namespace EE::Graphics::Private;
+
+// Every length up to a few SIMD blocks (to cover the vector loops and their scalar tails) and a
+// long one
+static std::vector<size_t> pixelCounts() {
+	std::vector<size_t> counts;
+	for ( size_t i = 0; i <= 67; i++ )
+		counts.push_back( i );
+	counts.push_back( 1021 );
+	return counts;
+}
+
+static std::vector<Uint8> randomPixels( size_t size, Uint32 seed ) {
+	std::vector<Uint8> pixels( size );
+	for ( auto& byte : pixels ) {
+		seed = seed * 1664525u + 1013904223u;
+		byte = static_cast<Uint8>( seed >> 24 );
+	}
+	return pixels;
+}
+
+static Uint8 colorComponent( const Color& color, Uint32 index ) {
+	switch ( index ) {
+		case 0:
+			return color.r;
+		case 1:
+			return color.g;
+		case 2:
+			return color.b;
+		default:
+			return color.a;
+	}
+}
+
+UTEST( PixelKernels, fill ) {
+	const Color color( 10, 20, 30, 40 );
+	for ( Uint32 channels = 1; channels <= 4; channels++ ) {
+		for ( size_t count : pixelCounts() ) {
+			// One extra pixel at the end must stay untouched
+			std::vector<Uint8> pixels( ( count + 1 ) * channels, 0xAB );
+			PixelKernels::fill( pixels.data(), count, channels, color );
+			for ( size_t i = 0; i < count * channels; i++ )
+				ASSERT_EQ( pixels[i], colorComponent( color, i % channels ) );
+			for ( size_t i = count * channels; i < pixels.size(); i++ )
+				ASSERT_EQ( pixels[i], 0xAB );
+		}
+	}
+}
+
+UTEST( PixelKernels, replaceColor ) {
+	const Color key( 1, 2, 3, 4 );
+	const Color value( 200, 201, 202, 203 );
+	for ( Uint32 channels = 1; channels <= 4; channels++ ) {
+		for ( size_t count : pixelCounts() ) {
+			std::vector<Uint8> pixels( randomPixels( count * channels, count + channels ) );
+			// Every third pixel is the key, every fifth only matches the key partially
+			for ( size_t i = 0; i < count; i++ ) {
+				for ( Uint32 c = 0; c < channels; c++ ) {
+					if ( i % 3 == 0 )
+						pixels[i * channels + c] = colorComponent( key, c );
+					else if ( i % 5 == 0 )
+						pixels[i * channels + c] = c == 0 ? colorComponent( key, c ) : 0;
+				}
+			}
+
+			std::vector<Uint8> expected( pixels );
+			for ( size_t i = 0; i < count; i++ ) {
+				bool match = true;
+				for ( Uint32 c = 0; c < channels; c++ )
+					match = match && expected[i * channels + c] == colorComponent( key, c );
+				if ( match ) {
+					for ( Uint32 c = 0; c < channels; c++ )
+						expected[i * channels + c] = colorComponent( value, c );
+				}
+			}
+
+			PixelKernels::replaceColor( pixels.data(), count, channels, key, value );
+			ASSERT_TRUE( pixels == expected );
+		}
+	}
+}
+
+static void referenceConvert( const Uint8* in, Uint32 srcChannels, Uint8* out,
+							  Uint32 dstChannels ) {
+	Uint8 r = in[0];
+	Uint8 g = srcChannels >= 3 ? in[1] : in[0];
+	Uint8 b = srcChannels >= 3 ? in[2] : in[0];
+	Uint8 a = srcChannels == 2 ? in[1] : ( srcChannels == 4 ? in[3] : 255 );
+	Uint8 gray =
+		srcChannels <= 2 ? in[0] : static_cast<Uint8>( ( r * 77 + g * 150 + b * 29 ) >> 8 );
+	switch ( dstChannels ) {
+		case 1:
+			out[0] = gray;
+			break;
+		case 2:
+			out[0] = gray;
+			out[1] = a;
+			break;
+		case 3:
+			out[0] = r;
+			out[1] = g;
+			out[2] = b;
+			break;
+		default:
+			out[0] = r;
+			out[1] = g;
+			out[2] = b;
+			out[3] = a;
+			break;
+	}
+}
+
+UTEST( PixelKernels, convertChannels ) {
+	for ( Uint32 srcChannels = 1; srcChannels <= 4; srcChannels++ ) {
+		for ( Uint32 dstChannels = 1; dstChannels <= 4; dstChannels++ ) {
+			for ( size_t count : pixelCounts() ) {
+				std::vector<Uint8> src( randomPixels( count * srcChannels, count ) );
+				std::vector<Uint8> dst( count * dstChannels );
+				std::vector<Uint8> expected( count * dstChannels );
+				for ( size_t i = 0; i < count; i++ )
+					referenceConvert( &src[i * srcChannels], srcChannels,
+									  &expected[i * dstChannels], dstChannels );
+				PixelKernels::convertChannels( src.data(), srcChannels, dst.data(), dstChannels,
+											   count );
+				ASSERT_TRUE( dst == expected );
+			}
+		}
+	}
+}
+
+UTEST( PixelKernels, premultiplyAlpha ) {
+	for ( size_t count : pixelCounts() ) {
+		std::vector<Uint8> pixels( randomPixels( count * 4, count * 7 ) );
+		// Make sure the alpha extremes are covered
+		if ( count > 1 ) {
+			pixels[3] = 0;
+			pixels[7] = 255;
+		}
+		std::vector<Uint8> expected( pixels );
+		for ( size_t i = 0; i < count; i++ ) {
+			Uint32 a = expected[i * 4 + 3];
+			// Exact rounding of c * a / 255
+			for ( Uint32 c = 0; c < 3; c++ ) {
+				Uint32 value = expected[i * 4 + c];
+				expected[i * 4 + c] = static_cast<Uint8>( ( value * a * 2 + 255 ) / 510 );
+			}
+		}
+		PixelKernels::premultiplyAlpha( pixels.data(), count );
+		ASSERT_TRUE( pixels == expected );
+	}
+
+	// Every component and alpha combination
+	std::vector<Uint8> all( 256 * 256 * 4 );
+	for ( Uint32 c = 0; c < 256; c++ ) {
+		for ( Uint32 a = 0; a < 256; a++ ) {
+			Uint8* px = &all[( c * 256 + a ) * 4];
+			px[0] = px[1] = px[2] = static_cast<Uint8>( c );
+			px[3] = static_cast<Uint8>( a );
+		}
+	}
+	PixelKernels::premultiplyAlpha( all.data(), 256 * 256 );
+	for ( Uint32 c = 0; c < 256; c++ ) {
+		for ( Uint32 a = 0; a < 256; a++ ) {
+			const Uint8* px = &all[( c * 256 + a ) * 4];
+			ASSERT_EQ( px[0], static_cast<Uint8>( ( c * a * 2 + 255 ) / 510 ) );
+			ASSERT_EQ( px[3], static_cast<Uint8>( a ) );
+		}
+	}
+}
+
+UTEST( PixelKernels, flipAndRotate ) {
+	const Uint32 sizes[][2] = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 5, 4 }, { 33, 65 }, { 64, 3 } };
+	for ( Uint32 channels = 1; channels <= 4; channels++ ) {
+		for ( const auto& size : sizes ) {
+			const Uint32 width = size[0];
+			const Uint32 height = size[1];
+			const std::vector<Uint8> src(
+				randomPixels( width * height * channels, width * 31 + height ) );
+
+			std::vector<Uint8> flipped( src );
+			PixelKernels::flipVertical( flipped.data(), width, height, channels );
+
+			std::vector<Uint8> rotated( src.size() );
+			PixelKernels::rotateClockwise( src.data(), width, height, channels, rotated.data() );
+
+			for ( Uint32 y = 0; y < height; y++ ) {
+				for ( Uint32 x = 0; x < width; x++ ) {
+					for ( Uint32 c = 0; c < channels; c++ ) {
+						Uint8 value = src[( y * width + x ) * channels + c];
+						ASSERT_EQ( flipped[( ( height - 1 - y ) * width + x ) * channels + c],
+								   value );
+						// The rotated image is height pixels wide
+						ASSERT_EQ( rotated[( x * height + ( height - 1 - y ) ) * channels + c],
+								   value );
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,119 @@
+#include "utest.h"
+#include "../../eepp/graphics/rectpacker.hpp"
+#include <vector>
+
+using namespace EE;
+using namespace EE::Graphics::Private;
+
+static const RectPacker::Method PACKING_METHODS[] = { RectPacker::Method::MaxRects,
+													  RectPacker::Method::Skyline };
+
+static std::vector<RectPacker::Item> randomItems( size_t count, Int32 maxSize, Uint32 seed ) {
+	std::vector<RectPacker::Item> items( count );
+	for ( auto& item : items ) {
+		seed = seed * 1664525u + 1013904223u;
+		item.width = 1 + static_cast<Int32>( ( seed >> 16 ) % maxSize );
+		seed = seed * 1664525u + 1013904223u;
+		item.height = 1 + static_cast<Int32>( ( seed >> 16 ) % maxSize );
+	}
+	return items;
+}
+
+// Checks that every placed item is inside the bin, that no two items overlap and that the result
+// totals match the placements
+static bool isValidPacking( const std::vector<RectPacker::Item>& items,
+							const RectPacker::Result& result, Int32 width, Int32 height,
+							bool allowRotation ) {
+	if ( result.placements.size() != items.size() )
+		return false;
+
+	std::vector<Rect> rects;
+	Int64 area = 0;
+	Uint32 count = 0;
+
+	for ( size_t i = 0; i < items.size(); i++ ) {
+		const RectPacker::Placement& placement = result.placements[i];
+		if ( !placement.placed )
+			continue;
+		if ( placement.rotated && !allowRotation )
+			return false;
+		Int32 w = placement.rotated ? items[i].height : items[i].width;
+		Int32 h = placement.rotated ? items[i].width : items[i].height;
+		if ( placement.x < 0 || placement.y < 0 || placement.x + w > width ||
+			 placement.y + h > height )
+			return false;
+		Rect rect( placement.x, placement.y, placement.x + w, placement.y + h );
+		for ( const Rect& other : rects ) {
+			if ( rect.Left < other.Right && other.Left < rect.Right && rect.Top < other.Bottom &&
+				 other.Top < rect.Bottom )
+				return false;
+		}
+		rects.push_back( rect );
+		area += (Int64)w * h;
+		count++;
+	}
+
+	return result.area == area && result.count == count;
+}
+
+UTEST( RectPacker, emptyInput ) {
+	for ( const auto& method : PACKING_METHODS ) {
+		auto result = RectPacker::pack( method, {}, 64, 64, true );
+		EXPECT_TRUE( result.placements.empty() );
+		EXPECT_EQ( result.count, 0u );
+		EXPECT_EQ( result.area, 0LL );
+	}
+}
+
+UTEST( RectPacker, randomItemsDontOverlap ) {
+	for ( const auto& method : PACKING_METHODS ) {
+		for ( int rotation = 0; rotation < 2; rotation++ ) {
+			for ( Uint32 seed = 1; seed <= 4; seed++ ) {
+				auto items = randomItems( 150, 48, seed );
+				auto result = RectPacker::pack( method, items, 256, 256, rotation );
+				ASSERT_TRUE( isValidPacking( items, result, 256, 256, rotation ) );
+				// The bin can't hold all of them, but it must be well used
+				EXPECT_LT( result.count, (Uint32)items.size() );
+				EXPECT_GT( result.area, 256LL * 256LL * 7 / 10 );
+			}
+		}
+	}
+}
+
+UTEST( RectPacker, identicalSquaresFillTheBin ) {
+	std::vector<RectPacker::Item> items( 64, { 16, 16 } );
+	for ( const auto& method : PACKING_METHODS ) {
+		auto result = RectPacker::pack( method, items, 128, 128, false );
+		ASSERT_TRUE( isValidPacking( items, result, 128, 128, false ) );
+		EXPECT_EQ( result.count, 64u );
+		EXPECT_EQ( result.area, 128LL * 128LL );
+	}
+}
+
+UTEST( RectPacker, rotationFitsTallItems ) {
+	// Only fit in a wide bin once rotated
+	std::vector<RectPacker::Item> items( 4, { 10, 60 } );
+	for ( const auto& method : PACKING_METHODS ) {
+		auto result = RectPacker::pack( method, items, 64, 40, true );
+		ASSERT_TRUE( isValidPacking( items, result, 64, 40, true ) );
+		EXPECT_EQ( result.count, 4u );
+		for ( const auto& placement : result.placements )
+			EXPECT_TRUE( placement.rotated );
+
+		result = RectPacker::pack( method, items, 64, 40, false );
+		ASSERT_TRUE( isValidPacking( items, result, 64, 40, false ) );
+		EXPECT_EQ( result.count, 0u );
+	}
+}
+
+UTEST( RectPacker, oversizedItemsAreSkipped ) {
+	std::vector<RectPacker::Item> items = { { 10, 10 }, { 100, 10 }, { 20, 20 }, { 0, 0 } };
+	for ( const auto& method : PACKING_METHODS ) {
+		auto result = RectPacker::pack( method, items, 64, 64, false );
+		ASSERT_TRUE( isValidPacking( items, result, 64, 64, false ) );
+		EXPECT_TRUE( result.placements[0].placed );
+		EXPECT_FALSE( result.placements[1].placed );
+		EXPECT_TRUE( result.placements[2].placed );
+		EXPECT_EQ( result.area, 500LL );
+	}
+}
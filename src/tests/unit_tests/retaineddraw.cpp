@@ -0,0 +1,116 @@
+#include "utest.h"
+#include <eepp/graphics/globalbatchrenderer.hpp>
+#include <eepp/graphics/primitives.hpp>
+#include <eepp/graphics/renderer/renderer.hpp>
+#include <eepp/ui/uinode.hpp>
+#include <eepp/ui/uiscenenode.hpp>
+#include <eepp/window/engine.hpp>
+
+using namespace EE;
+using namespace EE::Graphics;
+using namespace EE::UI;
+using namespace EE::Window;
+
+// The retained draw needs a GL context, the tests are skipped when a window can't be created
+static EE::Window::Window* getTestWindow() {
+	static EE::Window::Window* win = Engine::instance()->createWindow(
+		WindowSettings( 320, 240, "eepp - Unit Tests" ), ContextSettings( false ) );
+	return NULL != win && win->isOpen() ? win : NULL;
+}
+
+// Counts its draws and whether they were captured by a retained draw
+class DrawCounter : public UINode {
+  public:
+	int draws{ 0 };
+	bool captured{ false };
+	bool recordable{ true };
+
+	virtual void draw() {
+		draws++;
+		captured = NULL != GlobalBatchRenderer::instance()->getCapture();
+		if ( recordable ) {
+			Primitives p;
+			p.setColor( Color::White );
+			p.drawRectangle( getScreenBounds() );
+		} else {
+			// A draw call not issued by the batch renderer can't be recorded
+			GLi->drawArrays( PRIMITIVE_POINTS, 0, 0 );
+		}
+	}
+};
+
+static void drawFrame( UINode* node ) {
+	node->nodeDraw();
+	GlobalBatchRenderer::instance()->draw();
+}
+
+UTEST( RetainedDraw, replaysSubtree ) {
+	if ( NULL == getTestWindow() )
+		UTEST_SKIP( "No window available" );
+
+	UISceneNode* sceneNode = UISceneNode::New();
+	UINode* retained = UINode::New();
+	retained->setParent( sceneNode );
+	retained->setSize( 100, 100 );
+	retained->setRetainedDraw( true );
+	DrawCounter* child = eeNew( DrawCounter, () );
+	child->setParent( retained );
+	child->setSize( 50, 50 );
+
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 1 );
+	EXPECT_TRUE( child->captured );
+
+	// The recorded commands are replayed, the subtree isn't drawn again
+	drawFrame( retained );
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 1 );
+
+	// A change in the subtree records it again
+	child->invalidateDraw();
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 2 );
+	EXPECT_TRUE( child->captured );
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 2 );
+
+	eeDelete( sceneNode );
+}
+
+UTEST( RetainedDraw, uncacheableSubtreeIsDrawnDirectly ) {
+	if ( NULL == getTestWindow() )
+		UTEST_SKIP( "No window available" );
+
+	UISceneNode* sceneNode = UISceneNode::New();
+	UINode* retained = UINode::New();
+	retained->setParent( sceneNode );
+	retained->setSize( 100, 100 );
+	retained->setRetainedDraw( true );
+	DrawCounter* child = eeNew( DrawCounter, () );
+	child->setParent( retained );
+	child->setSize( 50, 50 );
+	child->recordable = false;
+
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 1 );
+	EXPECT_TRUE( child->captured );
+
+	// The recording failed, the subtree is drawn every frame without trying to record it again
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 2 );
+	EXPECT_FALSE( child->captured );
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 3 );
+	EXPECT_FALSE( child->captured );
+
+	// Once the subtree changes the recording is tried again
+	child->recordable = true;
+	child->invalidateDraw();
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 4 );
+	EXPECT_TRUE( child->captured );
+	drawFrame( retained );
+	EXPECT_EQ( child->draws, 4 );
+
+	eeDelete( sceneNode );
+}
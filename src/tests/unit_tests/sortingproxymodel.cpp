@@ -0,0 +1,177 @@
+#include "utest.h"
+#include <algorithm>
+#include <eepp/system/threadpool.hpp>
+#include <eepp/ui/models/sortingproxymodel.hpp>
+#include <random>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+using namespace EE::UI::Models;
+
+// A flat model with a text column and a number column that counts the sort data fetches
+class RowsModel : public Model {
+  public:
+	struct Row {
+		std::string text;
+		Int64 number;
+	};
+
+	enum Column { Text, Number };
+
+	mutable size_t sortDataFetches{ 0 };
+
+	std::vector<Row> rows;
+
+	virtual size_t rowCount( const ModelIndex& parent = ModelIndex() ) const {
+		return parent.isValid() ? 0 : rows.size();
+	}
+
+	virtual size_t columnCount( const ModelIndex& = ModelIndex() ) const { return 2; }
+
+	virtual Variant data( const ModelIndex& index, ModelRole role = ModelRole::Display ) const {
+		if ( role == ModelRole::Sort )
+			sortDataFetches++;
+		else if ( role != ModelRole::Display )
+			return {};
+		const Row& row = rows[index.row()];
+		return Text == index.column() ? Variant( row.text ) : Variant( row.number );
+	}
+
+	void insertRows( int first, const std::vector<Row>& newRows ) {
+		beginInsertRows( {}, first, first + newRows.size() - 1 );
+		rows.insert( rows.begin() + first, newRows.begin(), newRows.end() );
+		endInsertRows();
+	}
+
+	void deleteRows( int first, int last ) {
+		beginDeleteRows( {}, first, last );
+		rows.erase( rows.begin() + first, rows.begin() + last + 1 );
+		endDeleteRows();
+	}
+};
+
+static RowsModel::Row randomRow( std::mt19937& rng ) {
+	static const char* words[] = { "alpha", "Beta", "gamma", "Delta", "beta", "ALPHA", "omega" };
+	// Few distinct values, so there are many equal keys
+	return { std::string( words[rng() % 7] ) + std::to_string( rng() % 4 ),
+			 static_cast<Int64>( rng() % 50 ) - 25 };
+}
+
+static std::vector<int> proxyOrder( SortingProxyModel& proxy ) {
+	std::vector<int> order;
+	for ( size_t row = 0; row < proxy.rowCount(); row++ )
+		order.push_back( proxy.mapToSource( proxy.index( row ) ).row() );
+	return order;
+}
+
+// Checks that the proxy order is the same one than a fresh full sort of the current data, and
+// that the source to proxy mapping is its inverse
+static bool sameAsFullSort( const std::shared_ptr<RowsModel>& model, SortingProxyModel& proxy,
+							int column, SortOrder order ) {
+	auto fresh = SortingProxyModel::New( model );
+	fresh->sort( column, order );
+	std::vector<int> expected( proxyOrder( *fresh ) );
+	std::vector<int> current( proxyOrder( proxy ) );
+	if ( current != expected )
+		return false;
+	for ( size_t row = 0; row < current.size(); row++ )
+		if ( proxy.mapToProxy( model->index( current[row] ) ).row() != (Int64)row )
+			return false;
+	return true;
+}
+
+UTEST( SortingProxyModel, sortsByCachedKeys ) {
+	std::mt19937 rng( 7 );
+	auto model = std::make_shared<RowsModel>();
+	for ( int i = 0; i < 500; i++ )
+		model->rows.push_back( randomRow( rng ) );
+
+	auto proxy = SortingProxyModel::New( model );
+	proxy->index( 0 );
+
+	// The keys are fetched once per row, not on every comparison
+	proxy->sort( RowsModel::Text, SortOrder::Ascending );
+	EXPECT_EQ( model->sortDataFetches, model->rows.size() );
+
+	// The order is case insensitive and the equal keys keep the source order
+	std::vector<int> expected( model->rows.size() );
+	for ( size_t i = 0; i < expected.size(); i++ )
+		expected[i] = i;
+	std::stable_sort( expected.begin(), expected.end(), [&]( int a, int b ) {
+		return String::toLower( model->rows[a].text ) < String::toLower( model->rows[b].text );
+	} );
+	EXPECT_TRUE( proxyOrder( *proxy ) == expected );
+
+	// Changing the order of the same column reuses the keys
+	proxy->sort( RowsModel::Text, SortOrder::Descending );
+	EXPECT_EQ( model->sortDataFetches, model->rows.size() );
+	EXPECT_TRUE( sameAsFullSort( model, *proxy, RowsModel::Text, SortOrder::Descending ) );
+
+	size_t fetches = model->sortDataFetches;
+	proxy->sort( RowsModel::Number, SortOrder::Ascending );
+	EXPECT_EQ( model->sortDataFetches, fetches + model->rows.size() );
+	EXPECT_TRUE( sameAsFullSort( model, *proxy, RowsModel::Number, SortOrder::Ascending ) );
+
+	// A source update can change any value, the keys are fetched again
+	for ( auto& row : model->rows )
+		row.number = -row.number;
+	fetches = model->sortDataFetches;
+	model->invalidate( Model::UpdateFlag::DontInvalidateIndexes );
+	EXPECT_EQ( model->sortDataFetches, fetches + model->rows.size() );
+	EXPECT_TRUE( sameAsFullSort( model, *proxy, RowsModel::Number, SortOrder::Ascending ) );
+}
+
+UTEST( SortingProxyModel, incrementalInsertAndDelete ) {
+	std::mt19937 rng( 11 );
+	auto model = std::make_shared<RowsModel>();
+	for ( int i = 0; i < 200; i++ )
+		model->rows.push_back( randomRow( rng ) );
+
+	for ( int column : { (int)RowsModel::Text, (int)RowsModel::Number } ) {
+		for ( SortOrder order : { SortOrder::Ascending, SortOrder::Descending } ) {
+			auto proxy = SortingProxyModel::New( model );
+			proxy->index( 0 );
+			proxy->sort( column, order );
+
+			for ( int step = 0; step < 100; step++ ) {
+				size_t fetches = model->sortDataFetches;
+
+				if ( rng() % 2 || model->rows.size() < 10 ) {
+					std::vector<RowsModel::Row> newRows( 1 + rng() % 3 );
+					for ( auto& row : newRows )
+						row = randomRow( rng );
+					model->insertRows( rng() % ( model->rows.size() + 1 ), newRows );
+					// Only the inserted rows are fetched
+					ASSERT_EQ( model->sortDataFetches, fetches + newRows.size() );
+				} else {
+					int first = rng() % model->rows.size();
+					int last = eemin<int>( first + rng() % 3, model->rows.size() - 1 );
+					model->deleteRows( first, last );
+					ASSERT_EQ( model->sortDataFetches, fetches );
+				}
+
+				ASSERT_TRUE( sameAsFullSort( model, *proxy, column, order ) );
+			}
+		}
+	}
+}
+
+UTEST( SortingProxyModel, parallelSort ) {
+	std::mt19937 rng( 3 );
+	auto model = std::make_shared<RowsModel>();
+	for ( size_t i = 0; i < SortingProxyModel::ParallelSortThreshold * 3 + 17; i++ )
+		model->rows.push_back( randomRow( rng ) );
+
+	auto pool = ThreadPool::createShared( 3 );
+	auto proxy = SortingProxyModel::New( model );
+	proxy->setThreadPool( pool );
+	proxy->index( 0 );
+
+	for ( int column : { (int)RowsModel::Text, (int)RowsModel::Number } ) {
+		for ( SortOrder order : { SortOrder::Ascending, SortOrder::Descending } ) {
+			proxy->sort( column, order );
+			EXPECT_TRUE( sameAsFullSort( model, *proxy, column, order ) );
+		}
+	}
+}
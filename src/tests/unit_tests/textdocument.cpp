@@ -0,0 +1,76 @@
+#include "utest.h"
+#include <eepp/ui/doc/textdocument.hpp>
+
+using namespace EE;
+using namespace EE::UI::Doc;
+
+static bool textDiffApplies( const String& oldText, const String& newText ) {
+	TextDocument doc( false );
+	doc.textInput( oldText, false );
+	doc.applyTextDiff( newText );
+	String expected = newText;
+	expected.replaceAll( "\r", "" );
+	return doc.getText() == expected;
+}
+
+UTEST( TextDocument, applyTextDiff ) {
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "a\nb\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "a\nx\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "x\nb\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "a\nb\nx\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "a\nb\nc\nd\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\nd\n", "a\nb\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "b\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "" ) );
+	EXPECT_TRUE( textDiffApplies( "", "a\nb\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc", "a\nb\nc\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\n", "a\r\nx\r\nc\r\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\nc\nd\ne\nf\n", "a\nc\nb\nd\nf\ne\n" ) );
+	EXPECT_TRUE(
+		textDiffApplies( "int main() {\nreturn 0;\n}\n", "int main() {\n\treturn 0;\n}\n" ) );
+	EXPECT_TRUE( textDiffApplies( "a\nb\na\nb\na\nb\n", "b\na\nb\na\nb\na\n" ) );
+
+	// Past the distance limit the differing block is replaced as a whole
+	String oldText;
+	String newText;
+	for ( int i = 0; i < 3000; i++ ) {
+		oldText += String::format( "old line %d\n", i );
+		newText += String::format( "new line %d\n", i );
+	}
+	EXPECT_TRUE( textDiffApplies( oldText, newText ) );
+	EXPECT_TRUE(
+		textDiffApplies( "header\n" + oldText + "footer\n", "header\n" + newText + "footer\n" ) );
+}
+
+class TextDiffClient : public TextDocument::Client {
+  public:
+	std::vector<Int64> changedLines;
+
+	void onDocumentTextChanged( const DocumentContentChange& ) {}
+	void onDocumentUndoRedo( const TextDocument::UndoRedo& ) {}
+	void onDocumentCursorChange( const TextPosition& ) {}
+	void onDocumentSelectionChange( const TextRange& ) {}
+	void onDocumentLineCountChange( const size_t&, const size_t& ) {}
+	void onDocumentLineChanged( const Int64& lineIndex ) { changedLines.push_back( lineIndex ); }
+	void onDocumentSaved( TextDocument* ) {}
+	void onDocumentClosed( TextDocument* ) {}
+	void onDocumentDirtyOnFileSystem( TextDocument* ) {}
+	void onDocumentMoved( TextDocument* ) {}
+	void onDocumentReset( TextDocument* ) {}
+};
+
+UTEST( TextDocument, applyTextDiffKeepsUnchangedLines ) {
+	TextDocument doc( false );
+	doc.textInput( "a\nb\nc\nd\ne\nf\ng\n", false );
+	TextDiffClient client;
+	doc.registerClient( &client );
+	doc.applyTextDiff( "a\nb\nx\nd\ne\nf\ng\n" );
+	doc.unregisterClient( &client );
+	EXPECT_TRUE( doc.getText() == "a\nb\nx\nd\ne\nf\ng\n" );
+	// Only the replaced line (and the line the insertion pushes down) can be touched
+	ASSERT_FALSE( client.changedLines.empty() );
+	for ( Int64 line : client.changedLines ) {
+		EXPECT_GE( line, 2 );
+		EXPECT_LE( line, 3 );
+	}
+}
@@ -0,0 +1,203 @@
+#include "utest.h"
+#include <condition_variable>
+#include <eepp/system/threadpool.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+
+// Blocks the threads that wait for it until it's opened
+class Gate {
+  public:
+	void open() {
+		std::lock_guard<std::mutex> lock( mMutex );
+		mOpen = true;
+		mCond.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock( mMutex );
+		mCond.wait( lock, [this] { return mOpen; } );
+	}
+
+  protected:
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	bool mOpen{ false };
+};
+
+UTEST( ThreadPool, priorityOrder ) {
+	auto pool = ThreadPool::createUnique( 1 );
+	Gate started;
+	Gate release;
+	std::mutex mutex;
+	std::vector<int> order;
+
+	// Keep the only worker busy while the tasks are queued
+	pool->run( [&] {
+		started.open();
+		release.wait();
+	} );
+	started.wait();
+
+	auto record = [&]( int value ) {
+		return [&, value] {
+			std::lock_guard<std::mutex> lock( mutex );
+			order.push_back( value );
+		};
+	};
+
+	pool->run( record( 2 ), []( const Uint64& ) {}, 0, ThreadPool::Priority::Low );
+	pool->run( record( 1 ), []( const Uint64& ) {}, 0, ThreadPool::Priority::Normal );
+	pool->run( record( 0 ), []( const Uint64& ) {}, 0, ThreadPool::Priority::High );
+	pool->post( record( 3 ), ThreadPool::Priority::Low );
+
+	release.open();
+	// The destructor runs the queued tasks before leaving
+	pool.reset();
+
+	ASSERT_EQ( order.size(), 4UL );
+	EXPECT_EQ( order[0], 0 );
+	EXPECT_EQ( order[1], 1 );
+	EXPECT_EQ( order[2], 2 );
+	EXPECT_EQ( order[3], 3 );
+}
+
+UTEST( ThreadPool, removeWithTagFromAllQueues ) {
+	static constexpr Uint64 TAG = 42;
+	auto pool = ThreadPool::createUnique( 1 );
+	Gate queued;
+	Gate release;
+	std::atomic<int> taggedRuns{ 0 };
+	std::atomic<int> untaggedRuns{ 0 };
+	auto tagged = [&] { taggedRuns++; };
+	auto untagged = [&] { untaggedRuns++; };
+
+	// The tasks queued from a worker go to its own queue, the rest to the shared queue
+	pool->run( [&] {
+		pool->run( tagged, []( const Uint64& ) {}, TAG );
+		pool->run( untagged );
+		pool->post( tagged, ThreadPool::Priority::High, TAG );
+		queued.open();
+		release.wait();
+	} );
+	queued.wait();
+	pool->run( tagged, []( const Uint64& ) {}, TAG, ThreadPool::Priority::Low );
+	Uint64 untaggedId = pool->run( untagged );
+
+	EXPECT_TRUE( pool->existsTagInQueue( TAG ) );
+	EXPECT_TRUE( pool->removeWithTag( TAG ) );
+	EXPECT_FALSE( pool->existsTagInQueue( TAG ) );
+	EXPECT_FALSE( pool->removeWithTag( TAG ) );
+	EXPECT_TRUE( pool->existsIdInQueue( untaggedId ) );
+
+	release.open();
+	pool.reset();
+
+	EXPECT_EQ( taggedRuns.load(), 0 );
+	EXPECT_EQ( untaggedRuns.load(), 2 );
+}
+
+UTEST( ThreadPool, cancelledGroupDiscardsQueuedTasks ) {
+	auto pool = ThreadPool::createUnique( 1 );
+	Gate started;
+	Gate release;
+	std::atomic<int> runs{ 0 };
+
+	pool->run( [&] {
+		started.open();
+		release.wait();
+	} );
+	started.wait();
+
+	{
+		TaskGroup group( *pool );
+		CancellationToken token( group.getToken() );
+
+		for ( int i = 0; i < 16; i++ )
+			group.run( [&] { runs++; } );
+
+		EXPECT_FALSE( token.isCancelled() );
+		group.cancel();
+		EXPECT_TRUE( group.isCancelled() );
+		EXPECT_TRUE( token.isCancelled() );
+		group.wait();
+	}
+
+	release.open();
+	pool.reset();
+
+	EXPECT_EQ( runs.load(), 0 );
+}
+
+UTEST( ThreadPool, groupWaitOnlyRunsItsOwnTasks ) {
+	auto pool = ThreadPool::createUnique( 1 );
+	Gate started;
+	Gate release;
+	std::atomic<bool> otherRan{ false };
+	std::atomic<int> groupRuns{ 0 };
+
+	pool->run( [&] {
+		started.open();
+		release.wait();
+	} );
+	started.wait();
+
+	pool->run( [&] { otherRan = true; } );
+
+	{
+		// The worker is blocked, so wait() must run the group tasks in this thread, but not the
+		// task queued outside of the group
+		TaskGroup group( *pool );
+		for ( int i = 0; i < 8; i++ )
+			group.run( [&] { groupRuns++; } );
+		group.wait();
+	}
+
+	EXPECT_EQ( groupRuns.load(), 8 );
+	EXPECT_FALSE( otherRan.load() );
+
+	release.open();
+	pool.reset();
+
+	EXPECT_TRUE( otherRan.load() );
+}
+
+UTEST( ThreadPool, parallelFor ) {
+	auto pool = ThreadPool::createUnique( 4 );
+	std::vector<std::atomic<int>> visits( 1000 );
+
+	pool->parallelFor( 0, 1000, [&]( int i ) { visits[i]++; } );
+	for ( const auto& visit : visits )
+		ASSERT_EQ( visit.load(), 1 );
+
+	pool->parallelFor( 10, 10, [&]( int i ) { visits[i]++; } );
+	pool->parallelFor( 0, 1000, [&]( int i ) { visits[i]++; }, 7 );
+	for ( const auto& visit : visits )
+		ASSERT_EQ( visit.load(), 2 );
+}
+
+UTEST( ThreadPool, parallelReduce ) {
+	auto pool = ThreadPool::createUnique( 4 );
+	auto sum = []( Int64 a, Int64 b ) { return a + b; };
+	auto value = []( int i ) { return static_cast<Int64>( i ); };
+
+	for ( int grainSize : { 0, 1, 3, 64, 20000 } ) {
+		EXPECT_EQ( pool->parallelReduce( 0, 10000, Int64( 0 ), value, sum, grainSize ),
+				   Int64( 10000 ) * 9999 / 2 );
+	}
+
+	EXPECT_EQ( pool->parallelReduce( 5, 5, Int64( 7 ), value, sum ), Int64( 7 ) );
+
+	// Concatenation isn't commutative, the ranges must be reduced in order
+	std::string expected;
+	for ( int i = 0; i < 200; i++ )
+		expected += std::to_string( i % 10 );
+	std::string result = pool->parallelReduce(
+		0, 200, std::string(), []( int i ) { return std::to_string( i % 10 ); },
+		[]( const std::string& a, const std::string& b ) { return a + b; }, 3 );
+	EXPECT_TRUE( result == expected );
+}
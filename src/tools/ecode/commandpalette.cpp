@@ -25,7 +25,9 @@ CommandPalette::CommandPalette( const std::shared_ptr<ThreadPool>& pool ) : mPoo
 
 void CommandPalette::setCommandPalette( const std::vector<std::string>& commandList,
 										const UI::KeyBindings& keybindings ) {
+	Lock rl( mMatchingMutex );
 	mCommandPalette = build( commandList, keybindings );
+	buildMatcher( mMatcher, mCommandPalette );
 	mBaseModel = CommandPaletteModel::create( 3, mCommandPalette );
 	if ( !mCurModel )
 		mCurModel = mBaseModel;
@@ -41,7 +43,9 @@ const std::shared_ptr<CommandPaletteModel>& CommandPalette::getBaseModel() const
 
 void CommandPalette::setEditorCommandPalette( const std::vector<std::string>& commandList,
 											  const UI::KeyBindings& keybindings ) {
+	Lock rl( mMatchingMutex );
 	mCommandPaletteEditor = build( commandList, keybindings );
+	buildMatcher( mEditorMatcher, mCommandPaletteEditor );
 	mEditorModel = CommandPaletteModel::create( 3, mCommandPaletteEditor );
 	if ( !mCurModel )
 		mCurModel = mEditorModel;
@@ -57,13 +61,23 @@ const std::shared_ptr<CommandPaletteModel>& CommandPalette::getEditorModel() con
 
 void CommandPalette::setCommandPaletteEditor(
 	const std::vector<std::vector<std::string>>& commandPaletteEditor ) {
+	Lock rl( mMatchingMutex );
 	mCommandPaletteEditor = commandPaletteEditor;
+	buildMatcher( mEditorMatcher, mCommandPaletteEditor );
 }
 
 void CommandPalette::setCurModel( const std::shared_ptr<CommandPaletteModel>& curModel ) {
 	mCurModel = curModel;
 }
 
+void CommandPalette::buildMatcher( FuzzyMatcher& matcher,
+								   const std::vector<std::vector<std::string>>& cmdPalette ) {
+	matcher.clear();
+	matcher.reserve( cmdPalette.size() );
+	for ( const auto& cmd : cmdPalette )
+		matcher.add( { cmd[0], cmd[2] } );
+}
+
 std::shared_ptr<CommandPaletteModel>
 CommandPalette::fuzzyMatch( const std::vector<std::vector<std::string>>& cmdPalette,
 							const std::string& match, const size_t& max ) const {
@@ -71,31 +85,37 @@ CommandPalette::fuzzyMatch( const std::vector<std::vector<std::string>>& cmdPale
 		return {};
 
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
-	std::vector<std::vector<std::string>> ret;
-
-	for ( size_t i = 0; i < cmdPalette.size(); i++ ) {
-		int matchName = String::fuzzyMatch( cmdPalette[i][0], match );
-		int matchKeybind = String::fuzzyMatch( cmdPalette[i][2], match );
-		matchesMap.insert( { std::max( matchName, matchKeybind ), i } );
-	}
-	for ( auto& res : matchesMap ) {
-		if ( ret.size() < max )
-			ret.push_back( cmdPalette[res.second] );
+	FuzzyMatcher tmpMatcher( 2 );
+	FuzzyMatcher* matcher = &tmpMatcher;
+	if ( &cmdPalette == &mCommandPalette ) {
+		matcher = &mMatcher;
+	} else if ( &cmdPalette == &mCommandPaletteEditor ) {
+		matcher = &mEditorMatcher;
+	} else {
+		buildMatcher( tmpMatcher, cmdPalette );
 	}
+
+	std::vector<std::vector<std::string>> ret;
+	for ( const auto& res : matcher->match( match, max, true ) )
+		ret.push_back( cmdPalette[res.index] );
 	return CommandPaletteModel::create( 3, ret );
 }
 
+std::shared_ptr<CommandPaletteModel> CommandPalette::fuzzyMatch( const std::string& match,
+																 const size_t& max ) const {
+	if ( !mCurModel )
+		return {};
+	return fuzzyMatch( mCurModel.get() == mBaseModel.get() ? mCommandPalette
+														   : mCommandPaletteEditor,
+					   match, max );
+}
+
 void CommandPalette::asyncFuzzyMatch( const std::string& match, const size_t& max,
 									  MatchResultCb res ) const {
 	if ( !mCurModel )
 		return;
 
-	mPool->run( [this, match, max, res]() {
-		const std::vector<std::vector<std::string>>& cmdPalette =
-			mCurModel.get() == mBaseModel.get() ? mCommandPalette : mCommandPaletteEditor;
-		res( fuzzyMatch( cmdPalette, match, max ) );
-	} );
+	mPool->run( [this, match, max, res]() { res( fuzzyMatch( match, max ) ); } );
 }
 
 } // namespace ecode
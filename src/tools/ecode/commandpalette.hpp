@@ -2,6 +2,7 @@
 #define ECODE_COMMANDPALETTE_HPP
 
 #include <eepp/core.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/threadpool.hpp>
 #include <eepp/ui/keyboardshortcut.hpp>
@@ -33,6 +34,9 @@ class CommandPalette {
 	fuzzyMatch( const std::vector<std::vector<std::string>>& cmdPalette, const std::string& match,
 				const size_t& max ) const;
 
+	std::shared_ptr<CommandPaletteModel> fuzzyMatch( const std::string& match,
+													 const size_t& max ) const;
+
 	void setCommandPalette( const std::vector<std::string>& commandList,
 							const EE::UI::KeyBindings& keybindings );
 
@@ -64,6 +68,11 @@ class CommandPalette {
 	std::shared_ptr<CommandPaletteModel> mCurModel;
 	std::shared_ptr<CommandPaletteModel> mBaseModel;
 	std::shared_ptr<CommandPaletteModel> mEditorModel;
+	mutable FuzzyMatcher mMatcher{ 2 };
+	mutable FuzzyMatcher mEditorMatcher{ 2 };
+
+	static void buildMatcher( FuzzyMatcher& matcher,
+							  const std::vector<std::vector<std::string>>& cmdPalette );
 };
 
 } // namespace ecode
@@ -10,6 +10,7 @@
 #include <eepp/ui/uieventdispatcher.hpp>
 #include <eepp/ui/uiscenenode.hpp>
 #include <nlohmann/json.hpp>
+#include <unordered_set>
 using namespace EE::Graphics;
 using namespace EE::System;
 using json = nlohmann::json;
@@ -46,34 +47,47 @@ static json getURIAndPositionJSON( UICodeEditor* editor ) {
 	return data;
 }
 
+static constexpr size_t AUTO_COMPLETE_MAX_DICTIONARY_MATCHES = 100;
+
 static AutoCompletePlugin::SymbolsList
-fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& symbolsVec,
-				   const std::string& match, const size_t& max ) {
+fuzzyMatchSymbols( const AutoCompletePlugin::SymbolsList& suggestions, FuzzyMatcher* dictionary,
+				   const AutoCompletePlugin::SymbolsList* dictionarySymbols,
+				   const std::string& match ) {
 	AutoCompletePlugin::SymbolsList matches;
-	matches.reserve( max );
-	int score = 0;
-	for ( const auto& symbols : symbolsVec ) {
-		for ( const auto& symbol : *symbols ) {
-			if ( symbol.kind == LSPCompletionItemKind::Snippet ||
-				 ( score = String::fuzzyMatch( symbol.text, match, false,
-											   symbol.kind != LSPCompletionItemKind::Text ) ) >
-					 0 ) {
-				if ( std::find( matches.begin(), matches.end(), symbol ) == matches.end() ) {
-					symbol.setScore( score );
-					matches.push_back( symbol );
-				}
+	std::unordered_set<std::string> texts;
+
+	for ( const auto& suggestion : suggestions ) {
+		int score = FuzzyMatcher::score( suggestion.text, match, false,
+										 suggestion.kind != LSPCompletionItemKind::Text );
+		if ( suggestion.kind == LSPCompletionItemKind::Snippet || score > 0 ) {
+			if ( texts.insert( suggestion.text ).second ) {
+				suggestion.setScore( eemax( score, 0 ) );
+				matches.push_back( suggestion );
 			}
 		}
+	}
 
-		if ( matches.size() > max )
-			break;
+	if ( dictionary && dictionarySymbols ) {
+		for ( const auto& res : dictionary->match( match, AUTO_COMPLETE_MAX_DICTIONARY_MATCHES ) ) {
+			if ( res.score <= 0 )
+				break;
+			const auto& symbol = ( *dictionarySymbols )[res.index];
+			if ( texts.find( symbol.text ) == texts.end() ) {
+				symbol.setScore( res.score );
+				matches.push_back( symbol );
+			}
+		}
 	}
 
-	std::sort( matches.begin(), matches.end(),
-			   []( const AutoCompletePlugin::Suggestion& left,
-				   const AutoCompletePlugin::Suggestion& right ) {
-				   return left.score > right.score && left.kind != LSPCompletionItemKind::Text;
-			   } );
+	// Best scores first, on ties prefer the language server suggestions over the dictionary
+	std::stable_sort( matches.begin(), matches.end(),
+					  []( const AutoCompletePlugin::Suggestion& left,
+						  const AutoCompletePlugin::Suggestion& right ) {
+						  if ( left.score != right.score )
+							  return left.score > right.score;
+						  return left.kind != LSPCompletionItemKind::Text &&
+								 right.kind == LSPCompletionItemKind::Text;
+					  } );
 
 	return matches;
 }
@@ -255,11 +269,11 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 
 	listeners.push_back(
 		editor->addEventListener( Event::OnDocumentClosed, [this]( const Event* event ) {
-			Lock l( mDocMutex );
 			const DocEvent* docEvent = static_cast<const DocEvent*>( event );
 			TextDocument* doc = docEvent->getDoc();
+			eraseDocCache( doc );
+			Lock l( mDocMutex );
 			mDocs.erase( doc );
-			mDocCache.erase( doc );
 			mDirty = true;
 		} ) );
 
@@ -267,9 +281,9 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 		editor->addEventListener( Event::OnDocumentChanged, [this, editor]( const Event* ) {
 			TextDocument* oldDoc = mEditorDocs[editor];
 			TextDocument* newDoc = editor->getDocumentRef().get();
+			eraseDocCache( oldDoc );
 			Lock l( mDocMutex );
 			mDocs.erase( oldDoc );
-			mDocCache.erase( oldDoc );
 			mEditorDocs[editor] = newDoc;
 			mDirty = true;
 		} ) );
@@ -321,19 +335,22 @@ void AutoCompletePlugin::onUnregister( UICodeEditor* editor ) {
 		resetSuggestions( editor );
 	if ( mSignatureHelpEditor == editor )
 		resetSignatureHelp();
-	Lock l( mDocMutex );
-	TextDocument* doc = mEditorDocs[editor];
-	auto cbs = mEditors[editor];
-	for ( auto listener : cbs )
-		editor->removeEventListener( listener );
-	mEditors.erase( editor );
-	mEditorDocs.erase( editor );
-	for ( auto ceditor : mEditorDocs )
-		if ( ceditor.second == doc )
-			return;
-	mDocs.erase( doc );
-	mDocCache.erase( doc );
-	mDirty = true;
+	TextDocument* doc = nullptr;
+	{
+		Lock l( mDocMutex );
+		doc = mEditorDocs[editor];
+		auto cbs = mEditors[editor];
+		for ( auto listener : cbs )
+			editor->removeEventListener( listener );
+		mEditors.erase( editor );
+		mEditorDocs.erase( editor );
+		for ( auto ceditor : mEditorDocs )
+			if ( ceditor.second == doc )
+				return;
+		mDocs.erase( doc );
+		mDirty = true;
+	}
+	eraseDocCache( doc );
 }
 
 bool AutoCompletePlugin::onKeyDown( UICodeEditor* editor, const KeyEvent& event ) {
@@ -542,63 +559,174 @@ bool AutoCompletePlugin::onTextInput( UICodeEditor* editor, const TextInputEvent
 }
 
 void AutoCompletePlugin::updateDocCache( TextDocument* doc ) {
-	ScopedOp op(
-		[this, doc] {
-			Lock lu( mDocsUpdatingMutex );
-			mDocsUpdating[doc] = true;
-		},
-		[this, doc] {
-			Lock lu( mDocsUpdatingMutex );
-			mDocsUpdating[doc] = false;
-		} );
+	// The document is marked as updating when the update is queued
+	ScopedOp op( nullptr, [this, doc] {
+		Lock lu( mDocsUpdatingMutex );
+		mDocsUpdating[doc] = false;
+	} );
 
 	Clock clock;
-	std::unordered_map<TextDocument*, DocCache>::iterator docCache;
+	std::vector<LineSymbols> prevLines;
 	{
 		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
+		auto docCache = mDocCache.find( doc );
 		if ( docCache == mDocCache.end() || mShuttingDown )
 			return;
+		prevLines = std::move( docCache->second.lines );
 	}
 
 	auto changeId = doc->getCurrentChangeId();
-	auto symbols = getDocumentSymbols( doc );
+	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
+	std::vector<LineSymbols> lines;
+	std::vector<size_t> addedLines;
+	std::vector<const LineSymbols*> removedLines;
+
+	if ( doc->linesCount() > 0 && !doc->isHuge() ) {
+		// Lines are matched by content hash against the previous extraction, only new or
+		// modified lines are scanned again
+		std::unordered_map<String::HashType, std::pair<Uint32, const LineSymbols*>> reusable;
+		for ( const auto& line : prevLines ) {
+			if ( line.partial ) {
+				removedLines.push_back( &line );
+			} else {
+				auto& reuse = reusable[line.hash];
+				reuse.first++;
+				reuse.second = &line;
+			}
+		}
+
+		LuaPattern pattern( mSymbolPattern );
+		std::string current( getPartialSymbol( doc ) );
+		Int64 cursorLine = doc->getSelection().end().line();
+		lines.reserve( doc->linesCount() );
+
+		for ( Int64 i = 0; i < static_cast<Int64>( doc->linesCount() ); i++ ) {
+			LineSymbols line;
+			line.hash = doc->line( i ).getHash();
+			// Ignore the symbol if is actually the current symbol being written
+			if ( i == cursorLine && !current.empty() ) {
+				line.partial = true;
+				line.symbols = getLineSymbols( doc, pattern, i, current );
+			} else {
+				auto reuse = reusable.find( line.hash );
+				if ( reuse != reusable.end() && reuse->second.first > 0 ) {
+					reuse->second.first--;
+					line.symbols = reuse->second.second->symbols;
+					lines.emplace_back( std::move( line ) );
+					continue;
+				}
+				line.symbols = getLineSymbols( doc, pattern, i, "" );
+			}
+			addedLines.push_back( lines.size() );
+			lines.emplace_back( std::move( line ) );
+			if ( mShuttingDown )
+				return;
+		}
+
+		for ( const auto& reuse : reusable )
+			for ( Uint32 i = 0; i < reuse.second.first; i++ )
+				removedLines.push_back( reuse.second.second );
+	} else {
+		for ( const auto& line : prevLines )
+			removedLines.push_back( &line );
+	}
 
 	{
-		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
+		Lock l( mLangSymbolsMutex );
+		Lock l2( mDocMutex );
+		auto docCache = mDocCache.find( doc );
 		if ( docCache == mDocCache.end() || mShuttingDown )
 			return;
 		auto& cache = docCache->second;
-		cache.changeId = changeId;
-		cache.symbols = std::move( symbols );
-	}
 
-	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
-	{
-		Lock l( mLangSymbolsMutex );
+		if ( cache.langName != langName ) {
+			if ( !cache.langName.empty() ) {
+				auto& oldLang = mLangCache[cache.langName];
+				for ( const auto& symbol : cache.symbols )
+					removeLangSymbol( oldLang, symbol.first );
+			}
+			auto& newLang = mLangCache[langName];
+			for ( const auto& symbol : cache.symbols )
+				addLangSymbol( newLang, symbol.first );
+			cache.langName = langName;
+		}
+
 		auto& lang = mLangCache[langName];
-		lang.clear();
-		Lock l2( mDocMutex );
-		for ( const auto& d : mDocCache ) {
-			if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-				lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+
+		for ( const auto* line : removedLines ) {
+			for ( const auto& symbol : *line->symbols ) {
+				auto found = cache.symbols.find( symbol );
+				if ( found != cache.symbols.end() && --found->second == 0 ) {
+					cache.symbols.erase( found );
+					removeLangSymbol( lang, symbol );
+				}
+			}
+		}
+
+		for ( const auto& lineIdx : addedLines ) {
+			for ( const auto& symbol : *lines[lineIdx].symbols ) {
+				if ( ++cache.symbols[symbol] == 1 )
+					addLangSymbol( lang, symbol );
+			}
 		}
+
+		cache.changeId = changeId;
+		cache.lines = std::move( lines );
 	}
+
 	Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
 				clock.getElapsedTime().asMilliseconds() );
 }
 
+void AutoCompletePlugin::eraseDocCache( TextDocument* doc ) {
+	Lock l( mLangSymbolsMutex );
+	Lock l2( mDocMutex );
+	auto docCache = mDocCache.find( doc );
+	if ( docCache == mDocCache.end() )
+		return;
+	if ( !docCache->second.langName.empty() ) {
+		auto& lang = mLangCache[docCache->second.langName];
+		for ( const auto& symbol : docCache->second.symbols )
+			removeLangSymbol( lang, symbol.first );
+	}
+	mDocCache.erase( docCache );
+}
+
+void AutoCompletePlugin::addLangSymbol( LangDictionary& lang, const std::string& symbol ) {
+	if ( ++lang.refs[symbol] == 1 )
+		lang.dirty = true;
+}
+
+void AutoCompletePlugin::removeLangSymbol( LangDictionary& lang, const std::string& symbol ) {
+	auto ref = lang.refs.find( symbol );
+	if ( ref == lang.refs.end() || --ref->second > 0 )
+		return;
+	lang.refs.erase( ref );
+	lang.dirty = true;
+}
+
 void AutoCompletePlugin::updateLangCache( const std::string& langName ) {
 	Clock clock;
 	Lock l( mLangSymbolsMutex );
 	Lock l2( mDocMutex );
 	auto& lang = mLangCache[langName];
-	lang.clear();
-	for ( const auto& d : mDocCache ) {
-		if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-			lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+	lang.refs.clear();
+	lang.dirty = true;
+	for ( auto& d : mDocCache ) {
+		auto& cache = d.second;
+		if ( cache.langName == langName ) {
+			// The document has switched to another language, its symbols will be added to the
+			// new dictionary on its next update
+			if ( d.first->getSyntaxDefinition().getLanguageName() != langName ) {
+				cache.langName.clear();
+				cache.changeId = static_cast<Uint64>( -1 );
+				continue;
+			}
+			for ( const auto& symbol : cache.symbols )
+				addLangSymbol( lang, symbol.first );
+		}
 	}
+	mDirty = true;
 	Log::debug( "Lang dictionary for %s updated in: %.2fms", langName.c_str(),
 				clock.getElapsedTime().asMilliseconds() );
 }
@@ -779,7 +907,8 @@ AutoCompletePlugin::processCodeCompletion( const LSPCompletionList& completion )
 	{
 		Lock l2( mLangSymbolsMutex );
 		auto langSuggestions = mLangCache.find( lang );
-		hasLangSuggestions = langSuggestions != mLangCache.end();
+		hasLangSuggestions =
+			langSuggestions != mLangCache.end() && !langSuggestions->second.refs.empty();
 	}
 	if ( symbol.empty() || !hasLangSuggestions ) {
 		Lock l( mSuggestionsMutex );
@@ -788,9 +917,9 @@ AutoCompletePlugin::processCodeCompletion( const LSPCompletionList& completion )
 		SymbolsList fuzzySuggestions;
 		{
 			Lock l2( mLangSymbolsMutex );
-			auto& symbols = mLangCache[lang];
-			fuzzySuggestions = fuzzyMatchSymbols( { &suggestions, &symbols }, symbol,
-												  eemax<size_t>( 100UL, suggestions.size() ) );
+			auto& dictionary = mLangCache[lang];
+			fuzzySuggestions = fuzzyMatchSymbols(
+				suggestions, &getDictionaryMatcher( dictionary ), &dictionary.symbols, symbol );
 		}
 
 		if ( fuzzySuggestions.empty() && !suggestions.empty() ) {
@@ -905,10 +1034,12 @@ void AutoCompletePlugin::update( UICodeEditor* ) {
 			if ( !doc->isLoading() && mDocCache[doc].changeId != doc->getCurrentChangeId() ) {
 				{
 					Lock lu( mDocsUpdatingMutex );
-					auto du = mDocsUpdating.find( doc );
-					// Dont update the document cache if it's still updating the document
-					if ( du != mDocsUpdating.end() && du->second == true )
+					auto& updating = mDocsUpdating[doc];
+					// Dont update the document cache if the previous update is still queued or
+					// running, two updates of the same document can't run at the same time
+					if ( updating )
 						continue;
+					updating = true;
 				}
 #if AUTO_COMPLETE_THREADED
 				mThreadPool->run( [this, doc] { updateDocCache( doc ); } );
@@ -1299,34 +1430,23 @@ void AutoCompletePlugin::resetSignatureHelp() {
 	mSignatureHelpEditor = nullptr;
 }
 
-AutoCompletePlugin::SymbolsList AutoCompletePlugin::getDocumentSymbols( TextDocument* doc ) {
-	LuaPattern pattern( mSymbolPattern );
-	AutoCompletePlugin::SymbolsList symbols;
-	if ( doc->linesCount() == 0 || doc->isHuge() || mShuttingDown )
-		return symbols;
-	std::string current( getPartialSymbol( doc ) );
-	TextPosition end = doc->getSelection().end();
-	for ( Int64 i = 0; i < static_cast<Int64>( doc->linesCount() ); i++ ) {
-		auto string = doc->line( i ).toUtf8();
-		for ( auto& match : pattern.gmatch( string ) ) {
-			std::string matchStr( match[0] );
-			// Ignore the symbol if is actually the current symbol being written
-			if ( matchStr.size() < 3 || ( end.line() == i && current == matchStr ) )
-				continue;
-			if ( std::none_of( symbols.begin(), symbols.end(),
-							   [matchStr]( const Suggestion& suggestion ) {
-								   return suggestion.text == matchStr;
-							   } ) )
-				symbols.push_back( std::move( matchStr ) );
-		}
-		if ( mShuttingDown )
-			break;
+std::shared_ptr<const std::vector<std::string>>
+AutoCompletePlugin::getLineSymbols( TextDocument* doc, LuaPattern& pattern, Int64 line,
+									const std::string& current ) {
+	auto symbols = std::make_shared<std::vector<std::string>>();
+	auto string = doc->line( line ).toUtf8();
+	for ( auto& match : pattern.gmatch( string ) ) {
+		std::string matchStr( match[0] );
+		if ( matchStr.size() < 3 || ( !current.empty() && current == matchStr ) )
+			continue;
+		if ( std::find( symbols->begin(), symbols->end(), matchStr ) == symbols->end() )
+			symbols->emplace_back( std::move( matchStr ) );
 	}
 	return symbols;
 }
 
 void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
-											   const SymbolsList& symbols, UICodeEditor* editor ) {
+											   const std::string& lang, UICodeEditor* editor ) {
 	{
 		{
 			Lock l( mSuggestionsEditorMutex );
@@ -1334,30 +1454,55 @@ void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
 		}
 		if ( tryRequestCapabilities( editor ) )
 			requestCodeCompletion( editor );
-		if ( symbol.empty() || symbols.empty() )
+		if ( symbol.empty() )
 			return;
 		Lock l( mLangSymbolsMutex );
+		auto langSuggestions = mLangCache.find( lang );
+		if ( langSuggestions == mLangCache.end() || langSuggestions->second.refs.empty() )
+			return;
+		auto& dictionary = langSuggestions->second;
 		Lock l2( mSuggestionsMutex );
-		mSuggestions = fuzzyMatchSymbols( { &symbols }, symbol, mSuggestionsMaxVisible );
+		mSuggestions = fuzzyMatchSymbols( {}, &getDictionaryMatcher( dictionary ),
+										  &dictionary.symbols, symbol );
 	}
 	editor->runOnMainThread( [editor] { editor->invalidateDraw(); } );
 }
 
+FuzzyMatcher& AutoCompletePlugin::getDictionaryMatcher( LangDictionary& lang ) {
+	if ( lang.dirty ) {
+		// The refs keys are already unique, so the symbols are only sorted once per change batch
+		std::vector<std::string> texts;
+		texts.reserve( lang.refs.size() );
+		for ( const auto& ref : lang.refs )
+			texts.push_back( ref.first );
+		std::sort( texts.begin(), texts.end() );
+
+		lang.symbols.clear();
+		lang.symbols.reserve( texts.size() );
+		lang.matcher.clear();
+		lang.matcher.reserve( texts.size() );
+		for ( auto& text : texts ) {
+			lang.matcher.add( text );
+			lang.symbols.emplace_back( std::move( text ) );
+		}
+		lang.dirty = false;
+	}
+	return lang.matcher;
+}
+
 void AutoCompletePlugin::updateSuggestions( const std::string& symbol, UICodeEditor* editor ) {
 	const std::string& lang = editor->getDocument().getSyntaxDefinition().getLanguageName();
-	Lock l( mLangSymbolsMutex );
-	auto langSuggestions = mLangCache.find( lang );
-	if ( langSuggestions == mLangCache.end() )
-		return;
-	const auto& symbols = langSuggestions->second;
 	{
+		Lock l( mLangSymbolsMutex );
+		if ( mLangCache.find( lang ) == mLangCache.end() )
+			return;
+	}
 #if AUTO_COMPLETE_THREADED
-		mThreadPool->run(
-			[this, symbol, &symbols, editor] { runUpdateSuggestions( symbol, symbols, editor ); } );
+	mThreadPool->run(
+		[this, symbol, lang, editor] { runUpdateSuggestions( symbol, lang, editor ); } );
 #else
-		runUpdateSuggestions( symbol, symbols, editor );
+	runUpdateSuggestions( symbol, lang, editor );
 #endif
-	}
 }
 
 } // namespace ecode
@@ -6,6 +6,8 @@
 #include "../pluginmanager.hpp"
 #include <eepp/config.hpp>
 #include <eepp/system/clock.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
+#include <eepp/system/luapattern.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/sys.hpp>
 #include <eepp/system/threadpool.hpp>
@@ -128,12 +130,31 @@ class AutoCompletePlugin : public Plugin {
 	bool mReplacing{ false };
 	bool mSignatureHelpVisible{ false };
 	bool mHighlightSuggestions{ false };
+	struct LineSymbols {
+		String::HashType hash{ 0 };
+		// The line contained the symbol being written when extracted, so it can't be reused
+		bool partial{ false };
+		std::shared_ptr<const std::vector<std::string>> symbols;
+	};
 	struct DocCache {
 		Uint64 changeId{ static_cast<Uint64>( -1 ) };
+		std::string langName;
+		std::vector<LineSymbols> lines;
+		// symbol -> number of lines containing it
+		std::unordered_map<std::string, Uint32> symbols;
+	};
+	struct LangDictionary {
+		// symbol -> number of documents containing it
+		std::unordered_map<std::string, Uint32> refs;
+		// unique symbols sorted by text ( so equal scores keep a stable order ), rebuilt from refs
+		// on demand after the symbols change
 		SymbolsList symbols;
+		// indexes the symbols texts, rebuilt together with the symbols
+		FuzzyMatcher matcher;
+		bool dirty{ true };
 	};
 	std::unordered_map<TextDocument*, DocCache> mDocCache;
-	std::unordered_map<std::string, SymbolsList> mLangCache;
+	std::unordered_map<std::string, LangDictionary> mLangCache;
 	std::vector<Suggestion> mSuggestions;
 	Mutex mSuggestionsEditorMutex;
 	Mutex mSignatureHelpEditorMutex;
@@ -168,15 +189,25 @@ class AutoCompletePlugin : public Plugin {
 
 	void updateSuggestions( const std::string& symbol, UICodeEditor* editor );
 
-	SymbolsList getDocumentSymbols( TextDocument* );
+	std::shared_ptr<const std::vector<std::string>>
+	getLineSymbols( TextDocument* doc, LuaPattern& pattern, Int64 line,
+					const std::string& current );
 
 	void updateDocCache( TextDocument* doc );
 
+	void eraseDocCache( TextDocument* doc );
+
+	void addLangSymbol( LangDictionary& lang, const std::string& symbol );
+
+	void removeLangSymbol( LangDictionary& lang, const std::string& symbol );
+
 	std::string getPartialSymbol( TextDocument* doc );
 
-	void runUpdateSuggestions( const std::string& symbol, const SymbolsList& symbols,
+	void runUpdateSuggestions( const std::string& symbol, const std::string& lang,
 							   UICodeEditor* editor );
 
+	FuzzyMatcher& getDictionaryMatcher( LangDictionary& lang );
+
 	void updateLangCache( const std::string& langName );
 
 	void pickSuggestion( UICodeEditor* editor );
@@ -394,9 +394,8 @@ void FormatterPlugin::formatDoc( UICodeEditor* editor ) {
 					auto pos = doc->getSelection();
 					auto scroll = editor->getScroll();
 					doc->resetCursor();
-					doc->selectAll();
 					doc->setRunningTransaction( true );
-					doc->textInput( data, false );
+					doc->applyTextDiff( String::fromUtf8( data ) );
 					doc->setSelection( pos );
 					editor->setScroll( scroll );
 					if ( mAutoFormatOnSave && mPluginManager &&
@@ -433,9 +432,8 @@ void FormatterPlugin::runFormatter( UICodeEditor* editor, const Formatter& forma
 			TextPosition pos = doc->getSelection().start();
 			auto scroll = editor->getScroll();
 			doc->resetCursor();
-			doc->selectAll();
 			doc->setRunningTransaction( true );
-			doc->textInput( res.result, false );
+			doc->applyTextDiff( String::fromUtf8( res.result ) );
 			doc->setSelection( pos );
 			editor->setScroll( scroll );
 			doc->setRunningTransaction( false );
@@ -479,9 +477,8 @@ void FormatterPlugin::runFormatter( UICodeEditor* editor, const Formatter& forma
 					TextPosition pos = doc->getSelection().start();
 					auto scroll = editor->getScroll();
 					doc->resetCursor();
-					doc->selectAll();
 					doc->setRunningTransaction( true );
-					doc->textInput( data, false );
+					doc->applyTextDiff( String::fromUtf8( data ) );
 					doc->setSelection( pos );
 					editor->setScroll( scroll );
 					doc->setRunningTransaction( false );
@@ -2,6 +2,7 @@
 #include "../../version.hpp"
 #include <eepp/graphics/primitives.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
 #include <eepp/system/lock.hpp>
 #include <eepp/system/luapattern.hpp>
 #include <eepp/system/scopedop.hpp>
@@ -404,7 +405,7 @@ PluginRequestHandle LSPClientPlugin::processWorkspaceSymbol( const PluginMessage
 					if ( !query.empty() ) {
 						for ( auto& i : info ) {
 							if ( i.score == 0.f )
-								i.score = String::fuzzyMatch( i.name, query );
+								i.score = FuzzyMatcher::score( i.name, query );
 						}
 					}
 					mManager->sendResponse( this, PluginMessageType::WorkspaceSymbol,
@@ -416,7 +417,7 @@ PluginRequestHandle LSPClientPlugin::processWorkspaceSymbol( const PluginMessage
 					if ( !query.empty() ) {
 						for ( auto& i : info ) {
 							if ( i.score == 0.f )
-								i.score = String::fuzzyMatch( i.name, query );
+								i.score = FuzzyMatcher::score( i.name, query );
 						}
 					}
 					mManager->sendResponse( this, PluginMessageType::WorkspaceSymbol,
@@ -36,7 +36,8 @@ void LSPDocumentClient::setupFoldRangeService() {
 }
 
 LSPDocumentClient::~LSPDocumentClient() {
-	mDoc->getFoldRangeService().setProvider( nullptr );
+	TextDocument* doc = mDoc;
+	doc->getFoldRangeService().setProvider( nullptr );
 	mDoc = nullptr;
 	UISceneNode* sceneNode = getUISceneNode();
 	if ( nullptr != sceneNode && 0 != mTag )
@@ -46,6 +47,8 @@ LSPDocumentClient::~LSPDocumentClient() {
 	mShutdown = true;
 	while ( mRunningSemanticTokens )
 		Sys::sleep( Milliseconds( 0.1f ) );
+	// The document outlives the client, don't leave the server tokens drawn over it
+	doc->getHighlighter()->clearSemanticTokens();
 }
 
 bool LSPDocumentClient::tryRequestFoldRanges( bool requestFolds ) {
@@ -159,10 +162,14 @@ void LSPDocumentClient::requestSemanticHighlighting( bool reqFull ) {
 	TextRange range;
 	std::string reqId;
 	bool delta = false;
+	// The highlighter drops the tokens when it's reset, then the last result can't be used as the
+	// base of a delta request and a range response would leave the rest of the document empty
+	bool hasTokens = mDoc->getHighlighter()->hasSemanticTokens();
 	if ( cap.semanticTokenProvider.fullDelta ) {
 		delta = true;
-		reqId = reqFull ? "" : mSemanticeResultId;
-	} else if ( cap.semanticTokenProvider.range && !mFirstHighlight && !reqFull ) {
+		reqId = reqFull || !hasTokens ? "" : mSemanticeResultId;
+	} else if ( cap.semanticTokenProvider.range && !mFirstHighlight && !reqFull &&
+				( hasTokens || !cap.semanticTokenProvider.full ) ) {
 		range = mDoc->getActiveClientVisibleRange();
 	} else if ( mFirstHighlight || reqFull ) {
 		mFirstHighlight = false;
@@ -174,10 +181,10 @@ void LSPDocumentClient::requestSemanticHighlighting( bool reqFull ) {
 	Uint64 docModId = mDoc->getModificationId();
 	mServer->documentSemanticTokensFull(
 		mDoc->getURI(), delta, reqId, range,
-		[docClient, uri, server, docModId]( const auto&, LSPSemanticTokensDelta&& deltas ) {
+		[docClient, uri, server, docModId, range]( const auto&, LSPSemanticTokensDelta&& deltas ) {
 			if ( server->hasDocument( uri ) ) {
 				docClient->mWaitingSemanticTokensResponse = false;
-				docClient->processTokens( std::move( deltas ), docModId );
+				docClient->processTokens( std::move( deltas ), docModId, range );
 			}
 		} );
 }
@@ -277,7 +284,7 @@ static SyntaxStyleType semanticTokenTypeToSyntaxType( const std::string& type )
 }
 
 void LSPDocumentClient::processTokens( LSPSemanticTokensDelta&& tokens,
-									   const Uint64& docModificationId ) {
+									   const Uint64& docModificationId, const TextRange& range ) {
 	if ( mDoc == nullptr || mServer == nullptr )
 		return;
 
@@ -291,17 +298,32 @@ void LSPDocumentClient::processTokens( LSPSemanticTokensDelta&& tokens,
 	if ( !tokens.resultId.empty() )
 		mSemanticeResultId = tokens.resultId;
 
-	for ( const auto& edit : tokens.edits ) {
-		auto& curTokens = mSemanticTokens.data;
-		if ( edit.deleteCount > 0 ) {
-			curTokens.erase( curTokens.begin() + edit.start,
-							 curTokens.begin() + edit.start + edit.deleteCount );
-		}
-		curTokens.insert( curTokens.begin() + edit.start, edit.data.begin(), edit.data.end() );
+	// The tokens are kept as an overlay in the highlighter, lines are resolved when drawn
+	const auto& caps = mServer->getCapabilities().semanticTokenProvider;
+	std::vector<SyntaxStyleType> types;
+	types.reserve( caps.legend.tokenTypes.size() );
+	for ( const auto& type : caps.legend.tokenTypes )
+		types.push_back( semanticTokenTypeToSyntaxType( type ) );
+
+	Clock clock;
+	auto* highlighter = mDoc->getHighlighter();
+	highlighter->setSemanticTokenTypes( std::move( types ) );
+
+	if ( !tokens.edits.empty() )
+		highlighter->editSemanticTokens( tokens.edits );
+
+	if ( range.isValid() ) {
+		// A range response only covers the visible lines, the rest of the overlay is kept
+		TextRange lines( range.normalized() );
+		highlighter->mergeSemanticTokens( std::move( tokens.data ), lines.start().line(),
+										  lines.end().line() );
+	} else if ( !tokens.data.empty() ) {
+		highlighter->setSemanticTokens( std::move( tokens.data ) );
 	}
 
-	if ( !tokens.data.empty() ) {
-		mSemanticTokens = std::move( tokens );
+	if ( !mServer->isSilent() ) {
+		Log::debug( "LSPDocumentClient::processTokens took: %.2f ms. Applied %zu edits",
+					clock.getElapsedTime().asMilliseconds(), tokens.edits.size() );
 	}
 
 	highlight();
@@ -310,85 +332,13 @@ void LSPDocumentClient::processTokens( LSPSemanticTokensDelta&& tokens,
 }
 
 void LSPDocumentClient::highlight() {
-	if ( mShutdown )
-		return;
-	const auto& data = mSemanticTokens.data;
-
-	if ( data.size() % 5 != 0 ) {
-		Log::warning( "LSPDocumentClient::highlight bad data format for doc: %s",
-					  mDoc->getURI().toString().c_str() );
+	if ( mShutdown || nullptr == mDoc )
 		return;
-	}
-	Clock clock;
-	const auto& caps = mServer->getCapabilities().semanticTokenProvider;
-	Int64 firstLine = !data.empty() ? data[0] : -1;
-	Int64 currentLine = 0;
-	Uint32 start = 0;
-	std::unordered_map<size_t, TokenizedLine> tokenizerLines;
-	Int64 lastLine = 0;
-	TokenizedLine* lastLinePtr = nullptr;
-	Time diff;
-
-	for ( size_t i = 0; i < data.size(); i += 5 ) {
-		if ( mShutdown )
-			return;
-		const Uint32 deltaLine = data[i];
-		const Uint32 deltaStart = data[i + 1];
-		const Uint32 len = data[i + 2];
-		const int type = data[i + 3];
-		// const Uint32 mod = data[i + 4];
-		currentLine += deltaLine;
-
-		if ( deltaLine == 0 ) {
-			start += deltaStart;
-		} else {
-			start = deltaStart;
-		}
-
-		auto* line = &tokenizerLines[currentLine];
-		if ( type >= 0 && type < (int)caps.legend.tokenTypes.size() ) {
-			const auto& ltype = caps.legend.tokenTypes[type];
-			line->tokens.push_back( { semanticTokenTypeToSyntaxType( ltype ), start, len } );
-		} else {
-			line->tokens.push_back( { SyntaxStyleTypes::Normal, start, len } );
-		}
-		line->hash = mDoc->line( currentLine ).getHash();
-		line->updateSignature();
-
-		auto curSignature = mDoc->getHighlighter()->getTokenizedLineSignature( lastLine );
-		if ( lastLine != currentLine && lastLinePtr && lastLinePtr->signature == curSignature ) {
-			tokenizerLines.erase( lastLine );
-		}
-
-		lastLine = currentLine;
-		lastLinePtr = line;
-	}
-
-	diff = clock.getElapsedTime();
-
-	for ( auto& tline : tokenizerLines ) {
-		if ( mShutdown )
-			return;
-
-		mDoc->getHighlighter()->mergeLine( tline.first, tline.second );
-	}
-
-	if ( firstLine != -1 && lastLine >= firstLine && mDoc ) {
-		getServer()->getManager()->getPlugin()->getManager()->getSplitter()->forEachEditor(
-			[this, firstLine, lastLine]( UICodeEditor* editor ) {
-				if ( editor->isVisible() && &editor->getDocument() == mDoc &&
-					 editor->getVisibleRange().intersectsLineRange( firstLine, lastLine ) ) {
-					editor->invalidateDraw();
-				}
-			} );
-	}
-
-	if ( !mServer->isSilent() ) {
-		Log::debug(
-			"LSPDocumentClient::highlight took: %.2f ms. Diff analysis took: %.2f ms. Updated "
-			"%lld elements",
-			clock.getElapsedTime().asMilliseconds(), diff.asMilliseconds(), tokenizerLines.size() );
-	}
+	getServer()->getManager()->getPlugin()->getManager()->getSplitter()->forEachEditor(
+		[this]( UICodeEditor* editor ) {
+			if ( editor->isVisible() && &editor->getDocument() == mDoc )
+				editor->invalidateDraw();
+		} );
 }
 
 void LSPDocumentClient::notifyOpen() {
@@ -78,7 +78,6 @@ class LSPDocumentClient : public TextDocument::Client, public FoldRangeProvider
 	String::HashType mTagSemanticTokens{ 0 };
 	int mVersion{ 0 };
 	std::string mSemanticeResultId;
-	LSPSemanticTokensDelta mSemanticTokens;
 	std::vector<LSPCodeLens> mCodeLens;
 	bool mRunningSemanticTokens{ false };
 	bool mWaitingSemanticTokensResponse{ false };
@@ -91,7 +90,8 @@ class LSPDocumentClient : public TextDocument::Client, public FoldRangeProvider
 
 	UISceneNode* getUISceneNode();
 
-	void processTokens( LSPSemanticTokensDelta&& tokens, const Uint64& docModificationId );
+	void processTokens( LSPSemanticTokensDelta&& tokens, const Uint64& docModificationId,
+						const TextRange& range = {} );
 
 	void highlight();
 };
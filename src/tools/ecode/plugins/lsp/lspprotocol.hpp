@@ -1,6 +1,7 @@
 #ifndef ECODE_LSPCLIENTPROTOCOL_HPP
 #define ECODE_LSPCLIENTPROTOCOL_HPP
 
+#include <eepp/ui/doc/syntaxhighlighter.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <nlohmann/json.hpp>
 #include <string>
@@ -599,11 +600,7 @@ struct LSPApplyWorkspaceEditResponse {
 	std::string failureReason;
 };
 
-struct LSPSemanticTokensEdit {
-	Uint32 start = 0;
-	Uint32 deleteCount = 0;
-	std::vector<Int32> data;
-};
+using LSPSemanticTokensEdit = SemanticTokensEdit;
 
 struct LSPSemanticTokensDelta {
 	std::string resultId;
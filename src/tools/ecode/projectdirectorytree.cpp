@@ -80,6 +80,7 @@ void ProjectDirectoryTree::scan( const ProjectDirectoryTree::ScanCompleteEvent&
 				getDirectoryFiles( mFiles, mNames, mPath, info, ignoreHidden, mIgnoreMatcher,
 								   mAllowedMatcher.get() );
 			}
+			mFilesVersion++;
 			mIsReady = true;
 			if ( mPluginManager ) {
 				mPluginManager->subscribeMessages(
@@ -104,27 +105,48 @@ void ProjectDirectoryTree::scan( const ProjectDirectoryTree::ScanCompleteEvent&
 #endif
 }
 
+FuzzyMatcher& ProjectDirectoryTree::getMatcher() const {
+	// The matcher keeps views into mNames and mFiles, both the rebuild and the matching must be
+	// done holding mFilesMutex, and every change to the lists bumps mFilesVersion under it.
+	Uint64 version = mFilesVersion;
+	if ( mMatcherVersion != version || mMatcher.size() != mNames.size() ) {
+		mMatcher.clear();
+		mMatcher.reserve( mNames.size() );
+		for ( size_t i = 0; i < mNames.size(); i++ )
+			mMatcher.add( { mNames[i], mFiles[i] } );
+		mMatcherVersion = version;
+	}
+	return mMatcher;
+}
+
 std::shared_ptr<FileListModel>
 ProjectDirectoryTree::fuzzyMatchTree( const std::vector<std::string>& matches, const size_t& max,
 									  const std::string& basePath ) const {
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
-	std::vector<std::string> files;
-	std::vector<std::string> names;
+	Lock l( mFilesMutex );
+	auto& matcher = getMatcher();
+	std::unordered_map<Uint32, int> bestScores;
 	for ( const auto& match : matches ) {
-		for ( size_t i = 0; i < mNames.size(); i++ ) {
-			int matchName = String::fuzzyMatch( mNames[i], match );
-			int matchPath = String::fuzzyMatch( mFiles[i], match );
-			matchesMap.insert( { std::max( matchName, matchPath ), i } );
+		for ( const auto& res : matcher.match( match, max, true ) ) {
+			auto found = bestScores.find( res.index );
+			if ( found == bestScores.end() )
+				bestScores[res.index] = res.score;
+			else
+				found->second = std::max( found->second, res.score );
 		}
 	}
-	for ( auto& res : matchesMap ) {
-		if ( names.size() < max ) {
-			names.emplace_back( mNames[res.second] );
-			files.emplace_back( mFiles[res.second] );
-		} else {
-			break;
-		}
+	std::vector<FuzzyMatcher::Match> results;
+	results.reserve( bestScores.size() );
+	for ( const auto& best : bestScores )
+		results.push_back( { best.first, best.second } );
+	std::sort( results.begin(), results.end(), []( const auto& left, const auto& right ) {
+		return left.score != right.score ? left.score > right.score : left.index < right.index;
+	} );
+	std::vector<std::string> files;
+	std::vector<std::string> names;
+	for ( size_t i = 0; i < results.size() && i < max; i++ ) {
+		names.emplace_back( mNames[results[i].index] );
+		files.emplace_back( mFiles[results[i].index] );
 	}
 	auto model = std::make_shared<FileListModel>( files, names );
 	model->setBasePath( basePath );
@@ -135,21 +157,12 @@ std::shared_ptr<FileListModel>
 ProjectDirectoryTree::fuzzyMatchTree( const std::string& match, const size_t& max,
 									  const std::string& basePath ) const {
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
+	Lock l( mFilesMutex );
 	std::vector<std::string> files;
 	std::vector<std::string> names;
-	for ( size_t i = 0; i < mNames.size(); i++ ) {
-		int matchName = String::fuzzyMatch( mNames[i], match );
-		int matchPath = String::fuzzyMatch( mFiles[i], match );
-		matchesMap.insert( { std::max( matchName, matchPath ), i } );
-	}
-	for ( auto& res : matchesMap ) {
-		if ( names.size() < max ) {
-			names.emplace_back( mNames[res.second] );
-			files.emplace_back( mFiles[res.second] );
-		} else {
-			break;
-		}
+	for ( const auto& res : getMatcher().match( match, max, true ) ) {
+		names.emplace_back( mNames[res.index] );
+		files.emplace_back( mFiles[res.index] );
 	}
 	auto model = std::make_shared<FileListModel>( files, names );
 	model->setBasePath( basePath );
@@ -160,6 +173,7 @@ std::shared_ptr<FileListModel>
 ProjectDirectoryTree::matchTree( const std::string& match, const size_t& max,
 								 const std::string& basePath ) const {
 	Lock rl( mMatchingMutex );
+	Lock l( mFilesMutex );
 	std::vector<std::string> files;
 	std::vector<std::string> names;
 	std::string lowerMatch( String::toLower( match ) );
@@ -180,6 +194,7 @@ std::shared_ptr<FileListModel>
 ProjectDirectoryTree::globMatchTree( const std::string& match, const size_t& max,
 									 const std::string& basePath ) const {
 	Lock rl( mMatchingMutex );
+	Lock l( mFilesMutex );
 	std::vector<std::string> files;
 	std::vector<std::string> names;
 	for ( size_t i = 0; i < mNames.size(); i++ ) {
@@ -367,7 +382,7 @@ void ProjectDirectoryTree::onChange( const ProjectDirectoryTree::Action& action,
 			moveFile( file, oldFilename );
 			break;
 		case ProjectDirectoryTree::Action::Modified:
-			break;
+			return;
 	}
 }
 
@@ -394,6 +409,7 @@ void ProjectDirectoryTree::tryAddFile( const FileInfo& file ) {
 			if ( !exists ) {
 				mFiles.emplace_back( file.getFilepath() );
 				mNames.emplace_back( file.getFileName() );
+				mFilesVersion++;
 			}
 		}
 	}
@@ -432,6 +448,7 @@ void ProjectDirectoryTree::addFile( const FileInfo& file ) {
 			getDirectoryFiles( mFiles, mNames, mPath, info, false, mIgnoreMatcher,
 							   mAllowedMatcher.get() );
 		}
+		mFilesVersion++;
 	} else {
 		tryAddFile( file );
 	}
@@ -465,6 +482,7 @@ void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& ol
 		if ( wasDirIt != mDirectories.end() )
 			mDirectories.erase( wasDirIt );
 		mDirectories.emplace_back( std::move( dir ) );
+		mFilesVersion++;
 	} else {
 		std::string dir( file.getDirectoryPath() );
 		FileSystem::dirAddSlashAtEnd( dir );
@@ -479,6 +497,7 @@ void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& ol
 				mFiles.erase( mFiles.begin() + index );
 				mNames.erase( mNames.begin() + index );
 			}
+			mFilesVersion++;
 		} else {
 			tryAddFile( file );
 		}
@@ -502,11 +521,13 @@ void ProjectDirectoryTree::removeFile( const FileInfo& file ) {
 		mFiles = files;
 		mNames = names;
 		mDirectories.erase( wasDirIt );
+		mFilesVersion++;
 	} else {
 		size_t index = findFileIndex( file.getFilepath() );
 		if ( index != std::string::npos ) {
 			mFiles.erase( mFiles.begin() + index );
 			mNames.erase( mNames.begin() + index );
+			mFilesVersion++;
 		}
 	}
 }
@@ -580,7 +601,7 @@ PluginRequestHandle ProjectDirectoryTree::processMessage( const PluginMessage& m
 				std::string closestDataPath;
 				int max{ std::numeric_limits<int>::min() };
 				for ( const auto& paths : tentativePaths ) {
-					int res = String::fuzzyMatch( filePath.c_str(), paths.c_str(), true );
+					int res = FuzzyMatcher::score( filePath, paths, true );
 					if ( res > max ) {
 						closestDataPath = filePath;
 						max = res;
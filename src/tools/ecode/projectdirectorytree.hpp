@@ -4,6 +4,7 @@
 #include "ignorematcher.hpp"
 #include "plugins/pluginmanager.hpp"
 #include <eepp/scene/scenemanager.hpp>
+#include <eepp/system/fuzzymatcher.hpp>
 #include <eepp/system/luapattern.hpp>
 #include <eepp/system/mutex.hpp>
 #include <eepp/system/threadpool.hpp>
@@ -179,6 +180,9 @@ class ProjectDirectoryTree {
 	mutable Mutex mFilesMutex;
 	mutable Mutex mMatchingMutex;
 	Mutex mDoneMutex;
+	std::atomic<Uint64> mFilesVersion{ 0 };
+	mutable Uint64 mMatcherVersion{ static_cast<Uint64>( -1 ) };
+	mutable FuzzyMatcher mMatcher{ 2 };
 	IgnoreMatcherManager mIgnoreMatcher;
 	PluginManager* mPluginManager{ nullptr };
 	std::function<void( const std::string& )> mLoadFileFromPathOrFocusFn;
@@ -188,6 +192,8 @@ class ProjectDirectoryTree {
 							const bool& ignoreHidden, IgnoreMatcherManager& ignoreMatcher,
 							GitIgnoreMatcher* allowedMatcher );
 
+	FuzzyMatcher& getMatcher() const;
+
 	void addFile( const FileInfo& file );
 
 	void tryAddFile( const FileInfo& file );
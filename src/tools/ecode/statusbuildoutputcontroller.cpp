@@ -4,10 +4,22 @@
 
 namespace ecode {
 
+// The build output document keeps at most BUILD_OUTPUT_MAX_LINES lines, when exceeded the
+// oldest lines are moved to a temporary file until BUILD_OUTPUT_TRIM_LINES lines are below the
+// limit (a single flush can add far more than BUILD_OUTPUT_TRIM_LINES lines)
+static constexpr Int64 BUILD_OUTPUT_MAX_LINES = 50000;
+static constexpr Int64 BUILD_OUTPUT_TRIM_LINES = 10000;
+
 StatusBuildOutputController::StatusBuildOutputController( UISplitter* mainSplitter,
 														  UISceneNode* uiSceneNode, App* app ) :
 	StatusBarElement( mainSplitter, uiSceneNode, app ) {}
 
+StatusBuildOutputController::~StatusBuildOutputController() {
+	mSpillFile.reset();
+	if ( !mSpillPath.empty() )
+		FileSystem::fileRemove( mSpillPath );
+}
+
 static std::string getProjectOutputParserTypeToString( const ProjectOutputParserTypes& type ) {
 	switch ( type ) {
 		case ProjectOutputParserTypes::Error:
@@ -87,9 +99,8 @@ bool StatusBuildOutputController::searchFindAndAddStatusResult(
 				}
 			}
 
-			mStatusResults.emplace_back( status );
-			if ( mTableIssues->getModel() )
-				mTableIssues->getModel()->invalidate();
+			Lock l( mPendingMutex );
+			mPendingStatusResults.emplace_back( std::move( status ) );
 			return true;
 		}
 	}
@@ -100,6 +111,120 @@ static void safeInsertBuffer( TextDocument& doc, const std::string& buffer ) {
 	doc.insert( 0, doc.endOfDoc(), buffer );
 }
 
+void StatusBuildOutputController::queueOutput( std::string&& buffer,
+											   const ProjectBuildCommand* cmd ) {
+	// The issues are searched from the build thread, the UI thread only receives the results
+	if ( nullptr != cmd ) {
+		size_t start = 0;
+		size_t nl;
+		while ( ( nl = buffer.find( '\n', start ) ) != std::string::npos ) {
+			mCurLineBuffer.append( buffer, start, nl - start );
+			searchFindAndAddStatusResult( mPatternHolder, mCurLineBuffer, cmd );
+			mCurLineBuffer.clear();
+			start = nl + 1;
+		}
+		mCurLineBuffer.append( buffer, start, std::string::npos );
+	}
+
+	bool scheduleFlush = false;
+	{
+		Lock l( mPendingMutex );
+		mPendingOutput += buffer;
+		scheduleFlush = !mFlushScheduled;
+		mFlushScheduled = true;
+	}
+
+	// Everything received until the next frame is inserted at once
+	if ( scheduleFlush )
+		mBuildOutput->runOnMainThread( [this]() { flushOutput(); } );
+}
+
+void StatusBuildOutputController::flushOutput() {
+	std::string buffer;
+	std::vector<StatusMessage> statusResults;
+	{
+		Lock l( mPendingMutex );
+		mFlushScheduled = false;
+		buffer.swap( mPendingOutput );
+		statusResults.swap( mPendingStatusResults );
+	}
+
+	if ( !buffer.empty() ) {
+		safeInsertBuffer( mBuildOutput->getDocument(), buffer );
+		trimOutput();
+		// The output is read-only, there's no point in keeping the undo history
+		mBuildOutput->getDocument().resetUndoRedo();
+		if ( mScrollLocked )
+			mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
+	}
+
+	if ( !statusResults.empty() ) {
+		mStatusResults.insert( mStatusResults.end(),
+							   std::make_move_iterator( statusResults.begin() ),
+							   std::make_move_iterator( statusResults.end() ) );
+		if ( mTableIssues->getModel() )
+			mTableIssues->getModel()->invalidate();
+	}
+}
+
+void StatusBuildOutputController::trimOutput() {
+	TextDocument& doc = mBuildOutput->getDocument();
+	if ( (Int64)doc.linesCount() <= BUILD_OUTPUT_MAX_LINES )
+		return;
+
+	if ( mSpillPath.empty() ) {
+		mSpillPath = Sys::getTempPath() + "ecode-build-output-" +
+					 String::toString( Sys::getProcessID() ) + ".log";
+		mSpillFile = std::make_unique<IOStreamFile>( mSpillPath, "wb" );
+		if ( !mSpillFile->isOpen() )
+			mSpillFile.reset();
+
+		String header;
+		if ( mSpillFile ) {
+			header = String::format(
+				mApp->i18n( "build_output_moved_to", "Earlier output was moved to: %s" ).toUtf8(),
+				mSpillPath );
+		} else {
+			header = mApp->i18n( "build_output_discarded", "Earlier output was discarded" );
+		}
+		doc.insert( 0, doc.startOfDoc(), header + "\n" );
+	}
+
+	// The first line is the header pointing to the spill file, the last line is the document
+	// trailing line and can't be removed
+	const Int64 linesCount = doc.linesCount();
+	const Int64 first = 1;
+	const Int64 count = eemin( linesCount - BUILD_OUTPUT_MAX_LINES + BUILD_OUTPUT_TRIM_LINES,
+							   linesCount - 1 - first );
+	if ( count <= 0 )
+		return;
+	const Int64 last = first + count;
+	if ( mSpillFile ) {
+		for ( Int64 i = first; i < last; i++ ) {
+			std::string line( doc.line( i ).toUtf8() );
+			mSpillFile->write( line.data(), line.size() );
+		}
+		mSpillFile->flush();
+	}
+	doc.remove( 0, { { first, 0 }, { last, 0 } } );
+}
+
+void StatusBuildOutputController::resetOutput() {
+	{
+		Lock l( mPendingMutex );
+		mPendingOutput.clear();
+		mPendingStatusResults.clear();
+	}
+	mSpillFile.reset();
+	if ( !mSpillPath.empty() ) {
+		FileSystem::fileRemove( mSpillPath );
+		mSpillPath.clear();
+	}
+	mBuildOutput->getDocument().reset();
+	mBuildOutput->invalidateLongestLineWidth();
+	mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
+}
+
 void StatusBuildOutputController::runBuild( const std::string& buildName,
 											const std::string& buildType,
 											const ProjectBuildOutputParser& outputParser,
@@ -116,9 +241,7 @@ void StatusBuildOutputController::runBuild( const std::string& buildName,
 	mStatusResults.clear();
 	if ( !isClean && mTableIssues )
 		mTableIssues->getSelection().clear();
-	mBuildOutput->getDocument().reset();
-	mBuildOutput->invalidateLongestLineWidth();
-	mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
+	resetOutput();
 
 	std::vector<SyntaxPattern> patterns;
 
@@ -208,27 +331,7 @@ void StatusBuildOutputController::runBuild( const std::string& buildName,
 		buildName, [this]( const auto& key, const auto& def ) { return mApp->i18n( key, def ); },
 		buildType,
 		[this]( auto, std::string buffer, const ProjectBuildCommand* cmd ) {
-			mBuildOutput->runOnMainThread( [this, buffer]() {
-				safeInsertBuffer( mBuildOutput->getDocument(), buffer );
-				if ( mScrollLocked )
-					mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
-			} );
-
-			if ( nullptr == cmd )
-				return;
-
-			do {
-				auto nl = buffer.find_first_of( '\n' );
-				if ( nl != std::string::npos ) {
-					mCurLineBuffer += buffer.substr( 0, nl );
-					searchFindAndAddStatusResult( mPatternHolder, mCurLineBuffer, cmd );
-					buffer = buffer.substr( nl + 1 );
-					mCurLineBuffer.clear();
-				} else {
-					mCurLineBuffer += buffer;
-					buffer.clear();
-				}
-			} while ( !buffer.empty() );
+			queueOutput( std::move( buffer ), cmd );
 		},
 		[this, updateBuildButton, isClean, doneFn]( auto exitCode,
 													const ProjectBuildCommand* cmd ) {
@@ -246,11 +349,7 @@ void StatusBuildOutputController::runBuild( const std::string& buildName,
 								   : mApp->i18n( "build_failed", "Build run with errors\n" ) );
 			}
 
-			mBuildOutput->runOnMainThread( [this, buffer]() {
-				safeInsertBuffer( mBuildOutput->getDocument(), buffer );
-				if ( mScrollLocked )
-					mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
-			} );
+			queueOutput( buffer.toUtf8(), nullptr );
 
 			updateBuildButton();
 
@@ -545,11 +644,7 @@ void StatusBuildOutputController::createContainer() {
 	mContainer->bind( "build_output_find", mFindButton );
 	mContainer->bind( "build_output_configure", mConfigureButton );
 
-	mClearButton->onClick( [this]( auto ) {
-		mBuildOutput->getDocument().reset();
-		mBuildOutput->invalidateLongestLineWidth();
-		mBuildOutput->setScrollY( mBuildOutput->getMaxScroll().y );
-	} );
+	mClearButton->onClick( [this]( auto ) { resetOutput(); } );
 
 	mBuildButton->onClick( [this]( auto ) {
 		auto pbm = mApp->getProjectBuildManager();
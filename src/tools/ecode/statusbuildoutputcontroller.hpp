@@ -3,7 +3,9 @@
 
 #include "projectbuild.hpp"
 #include "uistatusbar.hpp"
+#include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/luapattern.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/ui/tools/uicodeeditorsplitter.hpp>
 #include <eepp/ui/uicodeeditor.hpp>
 #include <eepp/ui/uirelativelayout.hpp>
@@ -39,7 +41,7 @@ class StatusBuildOutputController : public StatusBarElement {
   public:
 	StatusBuildOutputController( UISplitter* mainSplitter, UISceneNode* uiSceneNode, App* app );
 
-	virtual ~StatusBuildOutputController(){};
+	virtual ~StatusBuildOutputController();
 
 	void runBuild( const std::string& buildName, const std::string& buildType,
 				   const ProjectBuildOutputParser& outputParser = {}, bool isClean = false,
@@ -72,6 +74,12 @@ class StatusBuildOutputController : public StatusBarElement {
 	std::vector<PatternHolder> mPatternHolder;
 	std::string mCurLineBuffer;
 	bool mScrollLocked{ true };
+	Mutex mPendingMutex;
+	std::string mPendingOutput;
+	std::vector<StatusMessage> mPendingStatusResults;
+	bool mFlushScheduled{ false };
+	std::string mSpillPath;
+	std::unique_ptr<IOStreamFile> mSpillFile;
 
 	void createContainer();
 
@@ -82,6 +90,14 @@ class StatusBuildOutputController : public StatusBarElement {
 	bool searchFindAndAddStatusResult( const std::vector<PatternHolder>& patterns,
 									   const std::string& text, const ProjectBuildCommand* cmd );
 
+	void queueOutput( std::string&& buffer, const ProjectBuildCommand* cmd );
+
+	void flushOutput();
+
+	void trimOutput();
+
+	void resetOutput();
+
 	void onLoadDone( const Variant& lineNum, const Variant& colNum );
 
 	void setHeaderWidth();
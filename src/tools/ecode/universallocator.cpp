@@ -4,6 +4,7 @@
 #include "settingsmenu.hpp"
 
 #include <algorithm>
+#include <eepp/system/fuzzymatcher.hpp>
 
 namespace ecode {
 
@@ -91,19 +92,14 @@ LSPSymbolInformationList fuzzyMatchTextDocumentSymbol( const LSPSymbolInformatio
 													   const std::string& query,
 													   const size_t& limit ) {
 	LSPSymbolInformationList nl;
-	std::map<int, LSPSymbolInformation, std::greater<int>> matchesMap;
-
-	for ( const auto& l : list ) {
-		int matchName = String::fuzzyMatch( l.name, query );
-		matchesMap.insert( { matchName, l } );
-	}
-
-	while ( matchesMap.size() > limit )
-		matchesMap.erase( std::prev( matchesMap.end() ) );
-
-	for ( auto& m : matchesMap ) {
-		m.second.score = m.first;
-		nl.emplace_back( std::move( m.second ) );
+	FuzzyMatcher matcher;
+	matcher.reserve( list.size() );
+	for ( const auto& l : list )
+		matcher.add( l.name );
+
+	for ( const auto& res : matcher.match( query, limit ) ) {
+		nl.emplace_back( list[res.index] );
+		nl.back().score = res.score;
 	}
 	return nl;
 }
@@ -736,20 +732,17 @@ std::shared_ptr<FileListModel> UniversalLocator::openDocumentsModel( const std::
 	if ( match.empty() )
 		return std::make_shared<FileListModel>( files, names );
 
-	std::multimap<int, int, std::greater<int>> matchesMap;
-
-	for ( size_t i = 0; i < names.size(); i++ ) {
-		int matchName = String::fuzzyMatch( names[i], match, true, true );
-		int matchPath = String::fuzzyMatch( files[i], match, true, true );
-		matchesMap.insert( { std::max( matchName, matchPath ), i } );
-	}
+	FuzzyMatcher matcher( 2, true, true );
+	matcher.reserve( names.size() );
+	for ( size_t i = 0; i < names.size(); i++ )
+		matcher.add( { names[i], files[i] } );
 
 	std::vector<std::string> ffiles;
 	std::vector<std::string> fnames;
 
-	for ( auto& res : matchesMap ) {
-		fnames.emplace_back( std::move( names[res.second] ) );
-		ffiles.emplace_back( std::move( files[res.second] ) );
+	for ( const auto& res : matcher.match( match, names.size(), true ) ) {
+		fnames.emplace_back( std::move( names[res.index] ) );
+		ffiles.emplace_back( std::move( files[res.index] ) );
 	}
 
 	return std::make_shared<FileListModel>( ffiles, fnames );
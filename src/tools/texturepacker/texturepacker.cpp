@@ -52,6 +52,21 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 		"When enabled in the case of an atlas not having enough space in the image to fit all the "
 		"source input images it will create new child atlas images to save them.",
 		{ "allow-childs" } );
+	args::Flag allowRotation(
+		parser, "allow-rotation",
+		"Allows rotating the images 90 degrees to pack them better. eepp can't draw rotated "
+		"texture regions, use it only for atlases consumed by other engines.",
+		{ "allow-rotation" } );
+	std::unordered_map<std::string, TexturePacker::PackingMethod> packingMethodMap{
+		{ "freelist", TexturePacker::PackingMethod::FreeList },
+		{ "maxrects", TexturePacker::PackingMethod::MaxRects },
+		{ "skyline", TexturePacker::PackingMethod::Skyline } };
+	args::MapFlag<std::string, TexturePacker::PackingMethod> packingMethod(
+		parser, "packing-method",
+		"Algorithm used to place the images. Available methods: \"maxrects\" (densest, default), "
+		"\"skyline\" (faster) or \"freelist\" (the legacy packer).",
+		{ "packing-method" }, packingMethodMap, TexturePacker::PackingMethod::MaxRects,
+		args::Options::Single );
 	args::ValueFlag<Uint32> height( parser, "max-width", "Texture Atlas maximum allowed height.",
 									{ 'h', "max-height" }, 4096, args::Options::Single );
 	args::ValueFlag<Uint32> width( parser, "max-width", "Texture Atlas maximum allowed width.",
@@ -140,7 +155,8 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 	if ( !FileSystem::fileExists( outputFile.Get() ) ) {
 		TexturePacker tp( width.Get(), height.Get(), PixelDensity::toFloat( pixelDensity.Get() ),
 						  forcePow2.Get(), scalableSVG.Get(), pixelsBorder.Get(),
-						  textureFilter.Get(), allowChilds.Get() );
+						  textureFilter.Get(), allowChilds.Get(), allowRotation.Get() );
+		tp.setPackingMethod( packingMethod.Get() );
 		std::cout << "Packing directory: " << texturesPathSafe << std::endl;
 		tp.addTexturesPath( texturesPathSafe );
 		for ( auto& image : imagesList ) {
@@ -156,8 +172,8 @@ EE_MAIN_FUNC int main( int argc, char* argv[] ) {
 	} else if ( update.Get() ) {
 		TextureAtlasLoader tgl;
 		std::cout << "Texture Atlas is already present, updating it." << std::endl;
-		if ( !tgl.updateTextureAtlas( outputFile.Get(), texturesPathSafe,
-									  Sizei( width, height ) ) ) {
+		if ( !tgl.updateTextureAtlas( outputFile.Get(), texturesPathSafe, Sizei( width, height ),
+									  packingMethod.Get() ) ) {
 			goto exit_error;
 		}
 		std::cout << "Texture Atlas updated." << std::endl;